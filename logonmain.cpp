@@ -0,0 +1,46 @@
+#include "utils/delayedstartlauncher.h"
+#include "utils/startupimpactsampler.h"
+#include "utils/startupsourcefactory.h"
+
+#include <QCoreApplication>
+#include <QTimer>
+
+// The logon helper: started by the Run value or autostart entries that
+// LogonCommand registers, headless and with the user's own rights. The main
+// executable requires administrator rights, and Windows does not start
+// elevated Run entries at logon, so this is a program of its own.
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    // The lists and measurements live in the main program's data directory
+    QCoreApplication::setApplicationName("Ratpro_Con");
+
+    const QStringList arguments = QCoreApplication::arguments();
+
+    // Starts the delayed entries one by one and exits
+    if (arguments.contains(DelayedStartList::launcherArgument())) {
+        DelayedStartLauncher launcher;
+        QObject::connect(&launcher, &DelayedStartLauncher::finished, &app, &QCoreApplication::quit);
+        launcher.start();
+        return app.exec();
+    }
+
+    // Measures the startup impact of this logon and saves it for the window
+    if (arguments.contains(StartupImpactSampler::measureArgument())) {
+        QList<StartupSource *> sources = StartupSourceFactory::createDefaultSources();
+        QList<StartupProgram> programs;
+        for (StartupSource *source : sources)
+            programs.append(source->scan());
+        qDeleteAll(sources);
+
+        StartupImpactSampler sampler;
+        sampler.setTargets(StartupImpactSampler::targetsFor(programs));
+        QObject::connect(&sampler, &StartupImpactSampler::finished, &app, &QCoreApplication::quit);
+        // Started from the event loop, so a window that already closed still quits it
+        QTimer::singleShot(0, &sampler, &StartupImpactSampler::start);
+        return app.exec();
+    }
+
+    return 1;
+}
@@ -15,6 +15,7 @@
 #include <QDateTime>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QAbstractProxyModel>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow)
@@ -91,8 +92,9 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->appsButton, &QPushButton::clicked, this, [this]()
             {
     if (ui->contentStackedWidget->currentWidget() == ui->appsPage) {
-        // Only refresh if we don't have data yet
-        if (ui->softwareTable->rowCount() == 0) {
+        // Only refresh if we don't have data yet; a search may be hiding every row
+        auto *filter = qobject_cast<QAbstractProxyModel *>(ui->softwareTable->model());
+        if ((filter ? filter->sourceModel() : ui->softwareTable->model())->rowCount() == 0) {
             on_scanSoftwareButton_clicked();
         }
     } });
@@ -382,11 +384,6 @@ void MainWindow::on_searchSoftwareInput_textChanged(const QString &searchText)
     m_softwareManager->searchSoftware(searchText);
 }
 
-void MainWindow::on_softwareTable_itemSelectionChanged()
-{
-    m_softwareManager->onSoftwareSelectionChanged();
-}
-
 void MainWindow::on_uninstallSoftwareButton_clicked()
 {
     m_softwareManager->uninstallSoftware();
@@ -428,57 +425,6 @@ void MainWindow::on_searchAppsInput_textChanged(const QString &searchText)
     m_appManager->searchApps(searchText);
 }
 
-void MainWindow::on_disableStartupButton_clicked()
-{
-    // Placeholder for disabling startup program
-    int row = ui->startupTable->currentRow();
-    if (row >= 0)
-    {
-        QTableWidgetItem *statusItem = ui->startupTable->item(row, 1);
-        if (statusItem && statusItem->text() == "Enabled")
-        {
-            statusItem->setText("Disabled");
-            statusItem->setForeground(QBrush(QColor("#e74c3c")));
-        }
-    }
-}
-
-void MainWindow::on_enableStartupButton_clicked()
-{
-    // Placeholder for enabling startup program
-    int row = ui->startupTable->currentRow();
-    if (row >= 0)
-    {
-        QTableWidgetItem *statusItem = ui->startupTable->item(row, 1);
-        if (statusItem && statusItem->text() == "Disabled")
-        {
-            statusItem->setText("Enabled");
-            statusItem->setForeground(QBrush(QColor("#2ecc71")));
-        }
-    }
-}
-
-void MainWindow::on_startupTable_itemSelectionChanged()
-{
-    QList<QTableWidgetItem *> selectedItems = ui->startupTable->selectedItems();
-    bool hasSelection = !selectedItems.isEmpty();
-
-    if (hasSelection)
-    {
-        int row = ui->startupTable->currentRow();
-        QTableWidgetItem *statusItem = ui->startupTable->item(row, 1);
-        bool isEnabled = statusItem && statusItem->text() == "Enabled";
-
-        ui->disableStartupButton->setEnabled(isEnabled);
-        ui->enableStartupButton->setEnabled(!isEnabled);
-    }
-    else
-    {
-        ui->disableStartupButton->setEnabled(false);
-        ui->enableStartupButton->setEnabled(false);
-    }
-}
-
 // WiFi Management slots - Delegated to WiFiManager
 void MainWindow::on_scanNetworksButton_clicked()
 {
@@ -953,6 +899,12 @@ void MainWindow::cancelAllOperations()
         m_filesChecker->cancelDuplicateFilesScan();
     }
 
+    // The cleaner page resumes its refresh when it is shown again
+    if (m_systemCleaner)
+    {
+        m_systemCleaner->suspendBackgroundRefresh();
+    }
+
     // Process events to ensure cancellation happens immediately
     QCoreApplication::processEvents();
 
@@ -977,6 +929,9 @@ void MainWindow::on_cleanerButton_clicked()
     setActiveButton(ui->cleanerButton);
     updateContent("System Cleaner");
     showCleanerPage();
+
+    // Cached totals are shown immediately and refreshed incrementally
+    m_systemCleaner->showCachedResults();
 }
 
 void MainWindow::on_optionsButton_clicked()
@@ -81,7 +81,6 @@ private slots:
     // Software Uninstaller slots
     void on_scanSoftwareButton_clicked();
     void on_searchSoftwareInput_textChanged(const QString &searchText);
-    void on_softwareTable_itemSelectionChanged();
     void on_uninstallSoftwareButton_clicked();
     void on_forceUninstallButton_clicked();
 
@@ -94,9 +93,6 @@ private slots:
 
     // General tab slots
     void on_refreshSystemInfoButton_clicked();
-    void on_disableStartupButton_clicked();
-    void on_enableStartupButton_clicked();
-    void on_startupTable_itemSelectionChanged();
 
     // WiFi Management slots
     void on_scanNetworksButton_clicked();
@@ -1,7 +1,6 @@
 #include "softwaremanager.h"
 #include "../mainwindow.h"
 #include "../ui_mainwindow.h"
-#include <QTableWidgetItem>
 #include <QHeaderView>
 #include <QMessageBox>
 #include <QDir>
@@ -11,14 +10,38 @@
 #include <QUrl>
 #include <QTimer>
 #include <QtConcurrent/QtConcurrent>
-#include <windows.h>
-#include <tlhelp32.h>
+#include "../utils/inventoryscanner.h"
+#include "../utils/registryinventorysource.h"
+#include "../utils/dpkginventorysource.h"
+#include "../utils/rpminventorysource.h"
+#include "../utils/keywordclassifier.h"
 
 SoftwareManager::SoftwareManager(MainWindow *mainWindow, QObject *parent)
-    : QObject(parent), m_mainWindow(mainWindow), m_cancelScan(false)
+    : QObject(parent), m_mainWindow(mainWindow), m_cancelScan(false), m_isCacheValid(false), m_uninstallRemoved(0), m_cancelLeftovers(false)
 {
-    m_scanWatcher = new QFutureWatcher<QList<InstalledSoftware>>(this);
+    m_scanWatcher = new QFutureWatcher<SoftwareInventory>(this);
+    m_softwareModel = new SoftwareTableModel(this);
+    m_filterModel = new SoftwareFilterProxyModel(m_softwareModel, this);
+    m_uninstallQueue = new UninstallQueue(this);
+    m_leftoverWatcher = new QFutureWatcher<QList<LeftoverCandidate>>(this);
+    m_leftoverCleaner = new CleaningPipeline(this);
+    m_sources = createDefaultSources();
+
+    // The view sorts through the model's precomputed keys; the proxy only filters
+    m_mainWindow->ui->softwareTable->setModel(m_filterModel);
+    m_mainWindow->ui->softwareTable->sortByColumn(SoftwareTableModel::NameColumn, Qt::AscendingOrder);
+
     setupConnections();
+
+    // Sizes from the last session make the first refresh mostly stat calls
+    m_sizeCache.load(DirectorySizeCache::defaultFilePath());
+
+    // The saved inventory is shown right away; the first refresh revalidates it
+    if (m_inventory.load(SoftwareInventory::defaultFilePath()))
+    {
+        m_installedSoftware = m_inventory.software();
+        m_cachedSoftware = m_installedSoftware;
+    }
 }
 
 SoftwareManager::~SoftwareManager()
@@ -29,13 +52,75 @@ SoftwareManager::~SoftwareManager()
         m_scanWatcher->waitForFinished();
         delete m_scanWatcher;
     }
+
+    m_cancelLeftovers = true;
+    m_leftoverWatcher->waitForFinished();
+    qDeleteAll(m_sources);
+}
+
+QList<InventorySource *> SoftwareManager::createDefaultSources()
+{
+    QList<InventorySource *> sources;
+
+#ifdef Q_OS_WIN
+    // Registry paths for installed software
+    sources.append(new RegistryInventorySource("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall"));
+    sources.append(new RegistryInventorySource("HKEY_LOCAL_MACHINE\\SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall"));
+    sources.append(new RegistryInventorySource("HKEY_CURRENT_USER\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall"));
+#else
+    if (DpkgInventorySource::isAvailable())
+        sources.append(new DpkgInventorySource());
+    if (RpmInventorySource::isAvailable())
+        sources.append(new RpmInventorySource());
+#endif
+
+    return sources;
 }
 
 void SoftwareManager::setupConnections()
 {
-    connect(m_scanWatcher, &QFutureWatcher<QList<InstalledSoftware>>::finished,
+    connect(m_scanWatcher, &QFutureWatcher<SoftwareInventory>::finished,
             this, &SoftwareManager::onScanFinished);
 
+    connect(m_mainWindow->ui->softwareTable->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &SoftwareManager::onSoftwareSelectionChanged);
+
+    connect(m_uninstallQueue, &UninstallQueue::jobStarted,
+            this, &SoftwareManager::updateUninstallStatus);
+    connect(m_uninstallQueue, &UninstallQueue::jobFinished,
+            this, [this](int id)
+            {
+                // Only the finished entry is re-read, not the whole inventory
+                InstalledSoftware software = m_uninstallJobs.take(id);
+                QList<InstalledSoftware> remaining = refreshEntries({software});
+                if (remaining.isEmpty())
+                {
+                    m_uninstallRemoved++;
+                    m_removedSoftware.append(software);
+                }
+                else
+                    m_uninstallRemaining.append(remaining);
+                updateUninstallStatus(); });
+    connect(m_uninstallQueue, &UninstallQueue::jobFailed,
+            this, [this](int id, const QString &)
+            {
+                m_uninstallFailed.append(m_uninstallJobs.take(id));
+                updateUninstallStatus(); });
+    connect(m_uninstallQueue, &UninstallQueue::finished,
+            this, &SoftwareManager::onUninstallFinished);
+
+    connect(m_leftoverWatcher, &QFutureWatcher<QList<LeftoverCandidate>>::finished,
+            this, &SoftwareManager::onLeftoversFound);
+    connect(m_leftoverCleaner, &CleaningPipeline::finished,
+            this, [this](bool canceled)
+            {
+                CleaningOutcome outcome = m_leftoverCleaner->outcome();
+                m_mainWindow->ui->selectedSoftwareInfo->setText(
+                    QString("%1 Leftovers removed: %2 files, %3 freed")
+                        .arg(canceled ? "⚠️" : "🧹")
+                        .arg(outcome.totals.filesDeleted)
+                        .arg(formatFileSize(outcome.totals.bytesFreed))); });
+
     connect(this, &SoftwareManager::scanProgressUpdated,
             this, [this](int progress, const QString &status)
             {
@@ -79,20 +164,32 @@ void SoftwareManager::refreshSoftware()
     // Reset cancel flag
     m_cancelScan = false;
 
-    // Update UI for scanning state
-    m_mainWindow->ui->selectedSoftwareInfo->setText("🔄 Scanning installed software...\nThis may take a few moments.");
-    m_mainWindow->ui->scanSoftwareButton->setEnabled(false);
-    m_mainWindow->ui->searchSoftwareInput->setEnabled(false);
-    m_mainWindow->ui->uninstallSoftwareButton->setEnabled(false);
-    m_mainWindow->ui->forceUninstallButton->setEnabled(false);
+    if (!m_installedSoftware.isEmpty())
+    {
+        // Show the known inventory while only changed uninstall entries are re-read
+        populateSoftwareTable();
+        m_mainWindow->ui->selectedSoftwareInfo->setText(
+            QString("🔄 Showing %1 saved applications, checking for changes...").arg(m_installedSoftware.size()));
+        m_mainWindow->ui->scanSoftwareButton->setEnabled(false);
+    }
+    else
+    {
+        // Update UI for scanning state
+        m_mainWindow->ui->selectedSoftwareInfo->setText("🔄 Scanning installed software...\nThis may take a few moments.");
+        m_mainWindow->ui->scanSoftwareButton->setEnabled(false);
+        m_mainWindow->ui->searchSoftwareInput->setEnabled(false);
+        m_mainWindow->ui->uninstallSoftwareButton->setEnabled(false);
+        m_mainWindow->ui->forceUninstallButton->setEnabled(false);
 
-    // Clear previous results but keep table structure
-    m_mainWindow->ui->softwareTable->setRowCount(0);
-    m_mainWindow->ui->softwareTable->setSortingEnabled(false);
+        // Clear previous results but keep table structure
+        m_softwareModel->clear();
+        m_searchIndex.clear();
+    }
 
     // Start background scan
-    QFuture<QList<InstalledSoftware>> future = QtConcurrent::run([this]()
-                                                                 { return this->getInstalledSoftwareFromRegistry(); });
+    SoftwareInventory previous = m_inventory;
+    QFuture<SoftwareInventory> future = QtConcurrent::run([this, previous]()
+                                                          { return this->scanInventorySources(previous); });
 
     m_scanWatcher->setFuture(future);
 
@@ -102,7 +199,7 @@ void SoftwareManager::refreshSoftware()
     progressTimer->start(100); // Update every 100ms
 
     // Auto-cleanup timer
-    connect(m_scanWatcher, &QFutureWatcher<QList<InstalledSoftware>>::finished,
+    connect(m_scanWatcher, &QFutureWatcher<SoftwareInventory>::finished,
             progressTimer, &QTimer::deleteLater);
 }
 
@@ -142,23 +239,21 @@ void SoftwareManager::updateScanProgress()
 
 void SoftwareManager::onScanFinished()
 {
-    if (m_scanWatcher->isCanceled()) {
+    if (m_scanWatcher->isCanceled() || m_cancelScan) {
         emit scanFinished(false, "Scan cancelled by user.");
         return;
     }
 
     try {
-        m_installedSoftware = m_scanWatcher->result();
+        // Every source was read to the end, so the result replaces the saved inventory
+        m_inventory = m_scanWatcher->result();
+        m_inventory.save(SoftwareInventory::defaultFilePath());
+
+        m_installedSoftware = m_inventory.software();
         m_cachedSoftware = m_installedSoftware; // Update cache
         m_lastScanTime = QDateTime::currentDateTime();
         m_isCacheValid = true;
 
-        // Sort by name
-        std::sort(m_installedSoftware.begin(), m_installedSoftware.end(),
-                  [](const InstalledSoftware &a, const InstalledSoftware &b) {
-                      return a.name.toLower() < b.name.toLower();
-                  });
-
         emit scanFinished(true, QString("✅ Scan completed! Found %1 installed applications.").arg(m_installedSoftware.size()));
         
     } catch (const std::exception &e) {
@@ -168,63 +263,59 @@ void SoftwareManager::onScanFinished()
 
 void SoftwareManager::searchSoftware(const QString &searchText)
 {
-    if (searchText.isEmpty())
-    {
-        // Show all items
-        for (int i = 0; i < m_mainWindow->ui->softwareTable->rowCount(); ++i)
-        {
-            m_mainWindow->ui->softwareTable->setRowHidden(i, false);
-        }
-    }
-    else
+    // Ranked ids; extending the previous query only re-examines its candidates
+    QVector<int> matches = m_searchIndex.search(searchText);
+    m_filterModel->setMatches(matches, m_searchIndex.documentCount());
+
+    if (searchText.isEmpty() || matches.isEmpty())
+        return;
+
+    // Bring the best match into view without changing the selection
+    for (int i = 0; i < m_softwareModel->rowCount(); ++i)
     {
-        // Hide non-matching items
-        for (int i = 0; i < m_mainWindow->ui->softwareTable->rowCount(); ++i)
+        if (m_softwareModel->sourceIndex(i) == matches.first())
         {
-            QTableWidgetItem *item = m_mainWindow->ui->softwareTable->item(i, 0); // Name column
-            bool match = item && item->text().contains(searchText, Qt::CaseInsensitive);
-            m_mainWindow->ui->softwareTable->setRowHidden(i, !match);
+            QModelIndex best = m_softwareModel->index(i, SoftwareTableModel::NameColumn);
+            m_mainWindow->ui->softwareTable->scrollTo(m_filterModel->mapFromSource(best));
+            break;
         }
     }
 }
 
 void SoftwareManager::onSoftwareSelectionChanged()
 {
-    QList<QTableWidgetItem *> selectedItems = m_mainWindow->ui->softwareTable->selectedItems();
-    bool hasSelection = !selectedItems.isEmpty();
+    QModelIndexList selectedRows = m_mainWindow->ui->softwareTable->selectionModel()->selectedRows();
+    bool hasSelection = !selectedRows.isEmpty();
 
     m_mainWindow->ui->uninstallSoftwareButton->setEnabled(hasSelection);
     m_mainWindow->ui->forceUninstallButton->setEnabled(hasSelection);
 
-    if (hasSelection)
+    if (selectedRows.size() > 1)
     {
-        int row = m_mainWindow->ui->softwareTable->currentRow();
-        QString name = m_mainWindow->ui->softwareTable->item(row, 0)->text();
-        QString version = m_mainWindow->ui->softwareTable->item(row, 1)->text();
-        QString size = m_mainWindow->ui->softwareTable->item(row, 2)->text();
-        QString date = m_mainWindow->ui->softwareTable->item(row, 3)->text();
-
-        // Find the software details
-        for (const auto &software : m_installedSoftware)
+        qint64 totalSize = 0;
+        for (const QModelIndex &index : selectedRows)
         {
-            if (software.name == name && software.version == version)
-            {
-                QString details = QString("📱 Selected: %1 %2\n💾 Size: %3\n📅 Installed: %4\n🏢 Publisher: %5")
-                                      .arg(software.name)
-                                      .arg(software.version)
-                                      .arg(size)
-                                      .arg(software.installDate)
-                                      .arg(software.publisher);
-
-                if (software.isSystemComponent)
-                {
-                    details += "\n⚠️ System Component - Use Force Uninstall with caution";
-                }
+            totalSize += m_softwareModel->software(m_filterModel->mapToSource(index).row()).size;
+        }
+        m_mainWindow->ui->selectedSoftwareInfo->setText(
+            QString("📱 Selected: %1 applications\n💾 Total size: %2").arg(selectedRows.size()).arg(formatFileSize(totalSize)));
+    }
+    else if (hasSelection)
+    {
+        const InstalledSoftware &software = m_softwareModel->software(m_filterModel->mapToSource(selectedRows.first()).row());
+        QString details = QString("📱 Selected: %1 %2\n💾 Size: %3\n📅 Installed: %4\n🏢 Publisher: %5")
+                              .arg(software.name)
+                              .arg(software.version)
+                              .arg(formatFileSize(software.size))
+                              .arg(software.installDate)
+                              .arg(software.publisher);
 
-                m_mainWindow->ui->selectedSoftwareInfo->setText(details);
-                break;
-            }
+        if (software.isSystemComponent)
+        {
+            details += "\n⚠️ System Component - Use Force Uninstall with caution";
         }
+
+        m_mainWindow->ui->selectedSoftwareInfo->setText(details);
     }
     else
     {
@@ -234,112 +325,82 @@ void SoftwareManager::onSoftwareSelectionChanged()
 
 void SoftwareManager::uninstallSoftware()
 {
-    int row = m_mainWindow->ui->softwareTable->currentRow();
-    if (row < 0)
+    QList<int> rows = selectedRows();
+    if (rows.isEmpty())
     {
         QMessageBox::information(m_mainWindow, "Uninstall", "Please select software to uninstall.");
         return;
     }
 
-    QString softwareName = m_mainWindow->ui->softwareTable->item(row, 0)->text();
-    QString softwareVersion = m_mainWindow->ui->softwareTable->item(row, 1)->text();
-
-    // Find the software in our list
-    InstalledSoftware selectedSoftware;
-    bool found = false;
-
-    for (const auto &software : m_installedSoftware)
+    // One snapshot answers for the whole selection
+    QHash<int, QList<ProcessInfo>> runningByEntry = runningSoftware(ProcessSnapshot::capture());
+    QList<InstalledSoftware> selected;
+    QList<ProcessInfo> running;
+    for (int row : rows)
     {
-        if (software.name == softwareName && software.version == softwareVersion)
-        {
-            selectedSoftware = software;
-            found = true;
-            break;
-        }
-    }
-
-    if (!found)
-    {
-        QMessageBox::warning(m_mainWindow, "Uninstall", "Selected software not found.");
-        return;
+        selected.append(m_softwareModel->software(row));
+        running.append(runningByEntry.value(m_softwareModel->sourceIndex(row)));
     }
 
     // Check if software is running
-    if (isSoftwareRunning(selectedSoftware.name))
+    if (!running.isEmpty())
     {
+        QStringList processNames;
+        for (const ProcessInfo &process : running)
+        {
+            processNames.append(process.name);
+        }
+        processNames.removeDuplicates();
+
+        QString subject = selected.size() == 1 ? selected.first().name : QString("Some of the selected software");
         QMessageBox::StandardButton reply = QMessageBox::question(
             m_mainWindow,
             "Software Running",
-            QString("%1 appears to be running. Do you want to close it and continue uninstall?").arg(selectedSoftware.name),
+            QString("%1 appears to be running (%2). Do you want to close it and continue uninstall?")
+                .arg(subject)
+                .arg(processNames.join(", ")),
             QMessageBox::Yes | QMessageBox::No);
 
-        if (reply == QMessageBox::Yes)
-        {
-            terminateProcess(selectedSoftware.name);
-        }
-        else
+        if (reply != QMessageBox::Yes)
         {
             return;
         }
     }
 
     // Confirm uninstall
+    QString question = selected.size() == 1
+                           ? QString("Are you sure you want to uninstall %1 %2?").arg(selected.first().name).arg(selected.first().version)
+                           : QString("Are you sure you want to uninstall %1 applications?\n\n%2").arg(selected.size()).arg(softwareNames(selected));
     QMessageBox::StandardButton confirm = QMessageBox::question(
         m_mainWindow,
         "Confirm Uninstall",
-        QString("Are you sure you want to uninstall %1 %2?").arg(selectedSoftware.name).arg(selectedSoftware.version),
+        question,
         QMessageBox::Yes | QMessageBox::No);
 
     if (confirm == QMessageBox::Yes)
     {
-        m_mainWindow->ui->selectedSoftwareInfo->setText(
-            QString("🔧 Uninstalling %1...").arg(selectedSoftware.name));
-
-        executeUninstall(selectedSoftware.uninstallString.isEmpty() ? selectedSoftware.quietUninstallString : selectedSoftware.uninstallString);
-
-        // Refresh the list after a delay
-        QTimer::singleShot(3000, this, [this]()
-                           { refreshSoftware(); });
+        // Only now that both questions were answered with Yes
+        terminateProcesses(running);
+        queueUninstall(selected, false);
     }
 }
 
 void SoftwareManager::forceUninstallSoftware()
 {
-    int row = m_mainWindow->ui->softwareTable->currentRow();
-    if (row < 0)
+    QList<int> rows = selectedRows();
+    if (rows.isEmpty())
     {
         QMessageBox::information(m_mainWindow, "Force Uninstall", "Please select software to uninstall.");
         return;
     }
 
-    QString softwareName = m_mainWindow->ui->softwareTable->item(row, 0)->text();
-    QString softwareVersion = m_mainWindow->ui->softwareTable->item(row, 1)->text();
-
-    // Find the software in our list
-    InstalledSoftware selectedSoftware;
-    bool found = false;
-
-    for (const auto &software : m_installedSoftware)
-    {
-        if (software.name == softwareName && software.version == softwareVersion)
-        {
-            selectedSoftware = software;
-            found = true;
-            break;
-        }
-    }
-
-    if (!found)
+    QHash<int, QList<ProcessInfo>> runningByEntry = runningSoftware(ProcessSnapshot::capture());
+    QList<InstalledSoftware> selected;
+    QList<ProcessInfo> running;
+    for (int row : rows)
     {
-        QMessageBox::warning(m_mainWindow, "Force Uninstall", "Selected software not found.");
-        return;
-    }
-
-    // Force close the software if running
-    if (isSoftwareRunning(selectedSoftware.name))
-    {
-        terminateProcess(selectedSoftware.name);
-        QThread::msleep(1000); // Wait a bit for process to terminate
+        selected.append(m_softwareModel->software(row));
+        running.append(runningByEntry.value(m_softwareModel->sourceIndex(row)));
     }
 
     // Warning for force uninstall
@@ -352,129 +413,292 @@ void SoftwareManager::forceUninstallSoftware()
                 "• Cause instability\n"
                 "• Leave residual files\n\n"
                 "Are you sure you want to continue?")
-            .arg(selectedSoftware.name),
+            .arg(selected.size() == 1 ? selected.first().name : QString("%1 applications").arg(selected.size())),
         QMessageBox::Yes | QMessageBox::No);
 
     if (confirm == QMessageBox::Yes)
     {
-        m_mainWindow->ui->selectedSoftwareInfo->setText(
-            QString("⚡ Force uninstalling %1...").arg(selectedSoftware.name));
-
-        executeUninstall(selectedSoftware.quietUninstallString.isEmpty() ? selectedSoftware.uninstallString : selectedSoftware.quietUninstallString, true);
+        // Force close the software if running
+        terminateProcesses(running);
+        queueUninstall(selected, true);
+    }
+}
 
-        // Refresh the list after a delay
-        QTimer::singleShot(3000, this, [this]()
-                           { refreshSoftware(); });
+QList<int> SoftwareManager::selectedRows() const
+{
+    QList<int> rows;
+    for (const QModelIndex &index : m_mainWindow->ui->softwareTable->selectionModel()->selectedRows())
+    {
+        rows.append(m_filterModel->mapToSource(index).row());
     }
+    std::sort(rows.begin(), rows.end());
+    return rows;
 }
 
-void SoftwareManager::populateSoftwareTable()
+QString SoftwareManager::softwareNames(const QList<InstalledSoftware> &softwareList)
 {
-    // Clear existing items
-    m_mainWindow->ui->softwareTable->setRowCount(0);
-    m_mainWindow->ui->softwareTable->setSortingEnabled(false);
+    // Long selections are cut short to keep the dialog on screen
+    const int maxNames = 10;
+    QStringList names;
+    for (int i = 0; i < softwareList.size() && i < maxNames; ++i)
+    {
+        names.append("• " + softwareList[i].name);
+    }
+    if (softwareList.size() > maxNames)
+        names.append(QString("... and %1 more").arg(softwareList.size() - maxNames));
+    return names.join("\n");
+}
 
-    for (int i = 0; i < m_installedSoftware.size(); ++i)
+void SoftwareManager::queueUninstall(const QList<InstalledSoftware> &softwareList, bool force)
+{
+    if (m_uninstallQueue->isIdle())
     {
-        const InstalledSoftware &software = m_installedSoftware[i];
+        m_uninstallRemoved = 0;
+        m_uninstallFailed.clear();
+        m_uninstallRemaining.clear();
+    }
 
-        int row = m_mainWindow->ui->softwareTable->rowCount();
-        m_mainWindow->ui->softwareTable->insertRow(row);
+    // Batches run unattended so they do not wait on one wizard after another
+    bool quiet = softwareList.size() > 1;
+    for (const InstalledSoftware &software : softwareList)
+    {
+        int id = m_uninstallQueue->enqueue(uninstallCommand(software, force, quiet));
+        m_uninstallJobs.insert(id, software);
+    }
 
-        // Software Name
-        QTableWidgetItem *nameItem = new QTableWidgetItem(software.name);
-        if (software.isSystemComponent)
-        {
-            nameItem->setBackground(QBrush(QColor(255, 243, 205))); // Light yellow for system components
-            nameItem->setToolTip("System Component - Use Force Uninstall with caution");
-        }
-        m_mainWindow->ui->softwareTable->setItem(row, 0, nameItem);
+    updateUninstallStatus();
+}
 
-        // Version
-        QTableWidgetItem *versionItem = new QTableWidgetItem(software.version);
-        m_mainWindow->ui->softwareTable->setItem(row, 1, versionItem);
+void SoftwareManager::updateUninstallStatus()
+{
+    m_mainWindow->ui->selectedSoftwareInfo->setText(
+        QString("🔧 Uninstalling: %1 running, %2 queued, %3 removed")
+            .arg(m_uninstallQueue->runningCount())
+            .arg(m_uninstallQueue->pendingCount())
+            .arg(m_uninstallRemoved));
+}
 
-        // Size
-        QTableWidgetItem *sizeItem = new QTableWidgetItem(formatFileSize(software.size));
-        sizeItem->setTextAlignment(Qt::AlignRight);
-        m_mainWindow->ui->softwareTable->setItem(row, 2, sizeItem);
+void SoftwareManager::onUninstallFinished()
+{
+    QString summary = QString("✅ Uninstall finished: %1 removed").arg(m_uninstallRemoved);
+    if (!m_uninstallRemaining.isEmpty())
+        summary += QString(", %1 still installed").arg(m_uninstallRemaining.size());
+    m_mainWindow->ui->selectedSoftwareInfo->setText(summary);
 
-        // Install Date
-        QTableWidgetItem *dateItem = new QTableWidgetItem(software.installDate);
-        m_mainWindow->ui->softwareTable->setItem(row, 3, dateItem);
+    if (!m_uninstallFailed.isEmpty())
+    {
+        QMessageBox::warning(m_mainWindow, "Uninstall Error",
+                             QString("These uninstallers could not be started or did not succeed:\n\n%1\n\n"
+                                     "You may need to run this application as Administrator.")
+                                 .arg(softwareNames(m_uninstallFailed)));
     }
 
-    // Resize columns to content and enable sorting
-    m_mainWindow->ui->softwareTable->resizeColumnsToContents();
-    m_mainWindow->ui->softwareTable->setSortingEnabled(true);
-
-    // Sort by name by default
-    m_mainWindow->ui->softwareTable->sortByColumn(0, Qt::AscendingOrder);
+    findLeftovers();
 }
 
-QList<SoftwareManager::InstalledSoftware> SoftwareManager::getInstalledSoftwareFromRegistry()
+void SoftwareManager::findLeftovers()
 {
-    return getInstalledSoftwareFromRegistryFast();
+    if (m_removedSoftware.isEmpty() || m_leftoverWatcher->isRunning())
+        return;
+
+    QList<InstalledSoftware> removed = m_removedSoftware;
+    m_removedSoftware.clear();
+    m_cancelLeftovers = false;
+
+    // Removed entries are already out of the location index, so their own folders are not protected
+    PathPrefixTrie installedLocations = m_locationIndex;
+
+    m_mainWindow->ui->selectedSoftwareInfo->setText("🔍 Looking for leftover folders...");
+    m_leftoverWatcher->setFuture(QtConcurrent::run([this, removed, installedLocations]()
+                                                   {
+        // A few levels of the usual application folders; seconds, not a volume walk
+        if (m_fileIndex.isEmpty() || m_fileIndex.builtAt().secsTo(QDateTime::currentDateTime()) > 300)
+            m_fileIndex.build(FileIndex::defaultRoots(), 2, m_cancelLeftovers);
+
+        LeftoverFinder finder(m_fileIndex, installedLocations);
+        QMap<QString, LeftoverCandidate> byPath;
+        for (const InstalledSoftware &software : removed)
+        {
+            for (const LeftoverCandidate &candidate : finder.find(software, m_cancelLeftovers))
+            {
+                byPath.insert(candidate.path, candidate);
+            }
+        }
+
+        // Sorted by path, so a folder inside another candidate follows it
+        QList<LeftoverCandidate> candidates;
+        QString lastKept;
+        for (const LeftoverCandidate &candidate : byPath)
+        {
+            if (!lastKept.isEmpty() && candidate.path.startsWith(lastKept + "/", Qt::CaseInsensitive))
+                continue;
+            lastKept = candidate.path;
+            candidates.append(candidate);
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end(), [](const LeftoverCandidate &a, const LeftoverCandidate &b)
+                         { return a.plan.totalSize > b.plan.totalSize; });
+        return candidates; }));
 }
 
-QString SoftwareManager::getSoftwareSize(const QString &installPath)
+void SoftwareManager::onLeftoversFound()
 {
-    if (installPath.isEmpty() || !QDir(installPath).exists() || m_cancelScan)
+    QList<LeftoverCandidate> candidates = m_cancelLeftovers ? QList<LeftoverCandidate>() : m_leftoverWatcher->result();
+
+    if (candidates.isEmpty())
     {
-        return "0";
+        m_mainWindow->ui->selectedSoftwareInfo->setText("✅ No leftover folders found.");
     }
-
-    qint64 totalSize = 0;
-    QDir dir(installPath);
-
-    // Get file sizes recursively with cancellation check
-    QFileInfoList entries = dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo &entry : entries)
+    else if (m_leftoverCleaner->isRunning())
     {
-        if (m_cancelScan)
-            break;
+        m_mainWindow->ui->selectedSoftwareInfo->setText("Leftover folders found; cleaning is already in progress.");
+    }
+    else
+    {
+        qint64 totalSize = 0;
+        QStringList lines;
+        for (int i = 0; i < candidates.size(); ++i)
+        {
+            totalSize += candidates[i].plan.totalSize;
+            if (i < 10)
+                lines.append(QString("• %1 (%2) - %3")
+                                 .arg(QDir::toNativeSeparators(candidates[i].path))
+                                 .arg(formatFileSize(candidates[i].plan.totalSize))
+                                 .arg(candidates[i].reason));
+        }
+        if (candidates.size() > 10)
+            lines.append(QString("... and %1 more").arg(candidates.size() - 10));
+
+        QMessageBox::StandardButton reply = QMessageBox::question(
+            m_mainWindow,
+            "Leftover Folders",
+            QString("The uninstalled software left %1 folder(s) behind (%2):\n\n%3\n\n"
+                    "Do you want to delete them?")
+                .arg(candidates.size())
+                .arg(formatFileSize(totalSize))
+                .arg(lines.join("\n")),
+            QMessageBox::Yes | QMessageBox::No);
 
-        if (entry.isDir())
+        if (reply == QMessageBox::Yes)
         {
-            totalSize += getSoftwareSize(entry.absoluteFilePath()).toLongLong();
+            // Same path as the system cleaner: per-file stat checks, then empty folders
+            CleanManifest manifest;
+            manifest.setCreatedAt(QDateTime::currentDateTime());
+            for (const LeftoverCandidate &candidate : candidates)
+            {
+                manifest.setCategory(candidate.plan);
+            }
+            m_leftoverCleaner->start(manifest, manifest.categories());
+            m_mainWindow->ui->selectedSoftwareInfo->setText("🧹 Removing leftover folders...");
         }
         else
         {
-            totalSize += entry.size();
+            m_mainWindow->ui->selectedSoftwareInfo->setText("Leftover folders were kept.");
         }
     }
 
-    return QString::number(totalSize);
+    // Entries removed while this analysis ran
+    findLeftovers();
 }
 
-QString SoftwareManager::formatFileSize(qint64 bytes)
+QList<InstalledSoftware> SoftwareManager::refreshEntries(const QList<InstalledSoftware> &entries)
 {
-    if (bytes == 0)
-        return "0 B";
+    QList<InstalledSoftware> remaining;
+    QList<InstalledSoftware> softwareList = m_inventory.software();
+    bool changed = false;
 
-    const QString sizes[] = {"B", "KB", "MB", "GB"};
-    int i = 0;
-    double size = bytes;
+    for (const InstalledSoftware &entry : entries)
+    {
+        int position = -1;
+        for (int i = 0; i < softwareList.size(); ++i)
+        {
+            if (softwareList[i].source == entry.source && softwareList[i].guid == entry.guid)
+            {
+                position = i;
+                break;
+            }
+        }
+        if (position < 0)
+            continue;
+
+        const InventorySource *source = nullptr;
+        for (const InventorySource *candidate : m_sources)
+        {
+            if (candidate->id() == entry.source)
+                source = candidate;
+        }
+        if (!source)
+            continue;
+
+        // Re-read just this entry; it is gone once the uninstaller removed its key
+        QList<InventoryRecord> records = source->readEntries(QStringList{entry.guid});
+        InstalledSoftware software;
+        if (!records.isEmpty() && InventoryScanner::softwareFromRecord(records.first(), software))
+        {
+            software.source = entry.source;
+            software.size = softwareList[position].size;
+            softwareList[position] = software;
+            remaining.append(software);
+        }
+        else
+        {
+            softwareList.removeAt(position);
+        }
+        changed = true;
+    }
 
-    while (size >= 1024 && i < 3)
+    if (changed)
     {
-        size /= 1024;
-        i++;
+        // Source fingerprints still differ from the new listing, so the next scan rechecks these sources
+        m_inventory.setSoftware(softwareList);
+        m_inventory.save(SoftwareInventory::defaultFilePath());
+        m_installedSoftware = softwareList;
+        m_cachedSoftware = softwareList;
+        populateSoftwareTable();
     }
 
-    return QString("%1 %2").arg(size, 0, 'f', 1).arg(sizes[i]);
+    return remaining;
 }
 
-void SoftwareManager::executeUninstall(const QString &uninstallString, bool force)
+void SoftwareManager::populateSoftwareTable()
 {
-    if (uninstallString.isEmpty())
+    bool firstPopulation = m_softwareModel->rowCount() == 0;
+
+    // Only rows that were added, removed or changed since the last refresh are signalled
+    m_softwareModel->setSoftware(m_installedSoftware);
+
+    // Search and location ids match positions in m_installedSoftware, like the model's source indexes
+    m_searchIndex.clear();
+    m_locationIndex.clear();
+    for (int i = 0; i < m_installedSoftware.size(); ++i)
     {
-        QMessageBox::warning(m_mainWindow, "Uninstall Error", "No uninstall command available for this software.");
-        return;
+        const InstalledSoftware &software = m_installedSoftware[i];
+        m_searchIndex.addDocument({software.name, software.publisher, software.version});
+
+        QString location = attributionDirectory(software);
+        if (!location.isEmpty())
+            m_locationIndex.insert(location, i);
     }
 
-    QProcess process;
-    QString command = uninstallString;
+    if (firstPopulation)
+        m_mainWindow->ui->softwareTable->resizeColumnsToContents();
+
+    // Keep the current filter applied to the new rows
+    searchSoftware(m_mainWindow->ui->searchSoftwareInput->text());
+}
+
+QString SoftwareManager::formatFileSize(qint64 bytes)
+{
+    return SoftwareTableModel::formatSize(bytes);
+}
+
+QString SoftwareManager::uninstallCommand(const InstalledSoftware &software, bool force, bool quiet)
+{
+    QString command = software.uninstallString.isEmpty() ? software.quietUninstallString : software.uninstallString;
+    if ((force || quiet) && !software.quietUninstallString.isEmpty())
+        command = software.quietUninstallString;
+    if (command.isEmpty())
+        return QString();
 
     // Handle MsiExec uninstall
     if (command.contains("MsiExec.exe", Qt::CaseInsensitive))
@@ -483,6 +707,10 @@ void SoftwareManager::executeUninstall(const QString &uninstallString, bool forc
         {
             command += " /quiet /norestart";
         }
+        else if (quiet)
+        {
+            command += " /passive /norestart";
+        }
         else
         {
             command += " /passive";
@@ -501,246 +729,101 @@ void SoftwareManager::executeUninstall(const QString &uninstallString, bool forc
         }
     }
 
-    // Execute the uninstall command
-    bool started = process.startDetached(command);
-
-    if (started)
-    {
-        m_mainWindow->ui->selectedSoftwareInfo->setText(
-            QString("✅ Uninstall command executed successfully.\nThe software uninstaller should open shortly."));
-    }
-    else
-    {
-        QMessageBox::warning(m_mainWindow, "Uninstall Error",
-                             "Failed to start uninstall process. You may need to run this application as Administrator.");
-    }
+    return command;
 }
 
-bool SoftwareManager::isSoftwareRunning(const QString &softwareName)
+QHash<int, QList<ProcessInfo>> SoftwareManager::runningSoftware(const ProcessSnapshot &snapshot) const
 {
-    // Simple check for common processes
-    QString processName = softwareName.split(" ").first() + ".exe";
-    processName = processName.replace("/", "").replace("\\", "");
-
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE)
+    // Each process belongs to the deepest install location containing its executable
+    QHash<int, QList<ProcessInfo>> running;
+    for (const ProcessInfo &process : snapshot.processes())
     {
-        return false;
-    }
-
-    PROCESSENTRY32 pe;
-    pe.dwSize = sizeof(PROCESSENTRY32);
+        if (process.executablePath.isEmpty())
+            continue;
 
-    if (Process32First(hSnapshot, &pe))
-    {
-        do
+        for (int index : m_locationIndex.longestPrefixValues(process.executablePath))
         {
-            QString currentProcess = QString::fromWCharArray(pe.szExeFile);
-            if (currentProcess.compare(processName, Qt::CaseInsensitive) == 0)
-            {
-                CloseHandle(hSnapshot);
-                return true;
-            }
-        } while (Process32Next(hSnapshot, &pe));
+            running[index].append(process);
+        }
     }
-
-    CloseHandle(hSnapshot);
-    return false;
+    return running;
 }
 
-void SoftwareManager::terminateProcess(const QString &processName)
+void SoftwareManager::terminateProcesses(const QList<ProcessInfo> &processes)
 {
-    QString cleanProcessName = processName.split(" ").first() + ".exe";
-    cleanProcessName = cleanProcessName.replace("/", "").replace("\\", "");
-
-    HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-    if (hSnapshot == INVALID_HANDLE_VALUE)
-    {
-        return;
-    }
-
-    PROCESSENTRY32 pe;
-    pe.dwSize = sizeof(PROCESSENTRY32);
-
-    if (Process32First(hSnapshot, &pe))
+    for (const ProcessInfo &process : processes)
     {
-        do
-        {
-            QString currentProcess = QString::fromWCharArray(pe.szExeFile);
-            if (currentProcess.compare(cleanProcessName, Qt::CaseInsensitive) == 0)
-            {
-                HANDLE hProcess = OpenProcess(PROCESS_TERMINATE, FALSE, pe.th32ProcessID);
-                if (hProcess)
-                {
-                    TerminateProcess(hProcess, 0);
-                    CloseHandle(hProcess);
-                }
-                break;
-            }
-        } while (Process32Next(hSnapshot, &pe));
+        ProcessSnapshot::terminate(process.pid);
     }
-
-    CloseHandle(hSnapshot);
 }
 
-QList<SoftwareManager::InstalledSoftware> SoftwareManager::getInstalledSoftwareFromRegistryFast()
+QString SoftwareManager::attributionDirectory(const InstalledSoftware &software)
 {
-    QList<InstalledSoftware> softwareList;
+    QString directory = software.installLocation;
 
-    if (m_cancelScan)
+    // Many entries leave InstallLocation empty but ship their uninstaller in the install folder
+    if (directory.isEmpty())
     {
-        return softwareList;
-    }
-
-    // Registry paths for installed software
-    QStringList registryPaths = {
-        "HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall",
-        "HKEY_LOCAL_MACHINE\\SOFTWARE\\WOW6432Node\\Microsoft\\Windows\\CurrentVersion\\Uninstall",
-        "HKEY_CURRENT_USER\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Uninstall"};
-
-    // Scan all registry locations in parallel (much faster)
-    QVector<QList<InstalledSoftware>> results(registryPaths.size());
-    QVector<QFuture<void>> futures;
+        QString program;
+        QString arguments;
+        if (!UninstallQueue::parseCommand(software.uninstallString, program, arguments))
+            return QString();
 
-    for (int i = 0; i < registryPaths.size(); ++i)
-    {
-        if (m_cancelScan)
-            break;
-
-        futures.append(QtConcurrent::run([this, i, &registryPaths, &results]()
-                                         { this->scanRegistryLocation(registryPaths[i], results[i]); }));
+        // Relative programs (msiexec, rundll32) are shared system tools
+        QFileInfo programInfo(program);
+        if (programInfo.isRelative())
+            return QString();
+        directory = programInfo.absolutePath();
     }
 
-    // Wait for all scans to complete
-    for (auto &future : futures)
-    {
-        if (m_cancelScan)
-            break;
-        future.waitForFinished();
-    }
+    // Shallow paths such as "C:/Program Files" or "/usr" would claim unrelated processes
+    if (PathPrefixTrie::pathComponents(directory).size() < 3)
+        return QString();
 
-    // Combine results
-    for (const auto &result : results)
-    {
-        softwareList.append(result);
-    }
+    QString systemRoot = QDir::fromNativeSeparators(qEnvironmentVariable("SystemRoot"));
+    if (!systemRoot.isEmpty() && QDir::fromNativeSeparators(directory).startsWith(systemRoot, Qt::CaseInsensitive))
+        return QString();
 
-    return softwareList;
+    return directory;
 }
 
-void SoftwareManager::scanRegistryLocation(const QString &registryPath, QList<InstalledSoftware> &softwareList)
+SoftwareInventory SoftwareManager::scanInventorySources(const SoftwareInventory &previous)
 {
-    QSettings registry(registryPath, QSettings::NativeFormat);
-    QStringList groups = registry.childGroups();
-    
-    for (const QString &group : groups) {
-        if (m_cancelScan) break;
-        
-        registry.beginGroup(group);
-        
-        InstalledSoftware software;
-        software.guid = group;
-        software.name = registry.value("DisplayName").toString();
-        
-        // Skip if no display name
-        if (software.name.isEmpty()) {
-            registry.endGroup();
-            continue;
-        }
-        
-        software.version = registry.value("DisplayVersion").toString();
-        software.publisher = registry.value("Publisher").toString();
-        software.uninstallString = registry.value("UninstallString").toString();
-        software.quietUninstallString = registry.value("QuietUninstallString").toString();
-        
-        // Get install date (fast)
-        QString installDate = registry.value("InstallDate").toString();
-        if (!installDate.isEmpty() && installDate.length() == 8) {
-            software.installDate = QString("%1-%2-%3")
-                .arg(installDate.left(4))
-                .arg(installDate.mid(4, 2))
-                .arg(installDate.mid(6, 2));
-        } else {
-            software.installDate = "Unknown";
-        }
-        
-        // PERFORMANCE OPTIMIZATION: Skip disk size calculation for system components
-        bool shouldSkipSizeScan = software.publisher.contains("Microsoft", Qt::CaseInsensitive) ||
-                                 software.name.contains("Windows", Qt::CaseInsensitive) ||
-                                 software.name.contains("Update", Qt::CaseInsensitive) ||
-                                 software.name.contains("Security", Qt::CaseInsensitive) ||
-                                 software.name.contains("Runtime", Qt::CaseInsensitive) ||
-                                 software.name.contains("Visual C++", Qt::CaseInsensitive) ||
-                                 software.name.contains(".NET", Qt::CaseInsensitive);
-
-        if (shouldSkipSizeScan) {
-            // Use registry estimated size or default to 0 for system components
-            QVariant sizeVar = registry.value("EstimatedSize");
-            software.size = sizeVar.isValid() ? sizeVar.toLongLong() * 1024 : 0;
-        } else {
-            // Do disk size calculation only for non-system software
-            QString installLocation = registry.value("InstallLocation").toString();
-            if (!installLocation.isEmpty() && QDir(installLocation).exists()) {
-                software.size = getSoftwareSizeFast(installLocation).toLongLong();
-            } else {
-                // Fall back to registry estimated size
-                QVariant sizeVar = registry.value("EstimatedSize");
-                software.size = sizeVar.isValid() ? sizeVar.toLongLong() * 1024 : 0;
-            }
-        }
-        
-        // Check if system component
-        software.isSystemComponent = registry.value("SystemComponent").toBool() || 
-                                    software.publisher.contains("Microsoft", Qt::CaseInsensitive) ||
-                                    software.name.contains("Update", Qt::CaseInsensitive);
-        
-        // Only add if it has uninstall capability
-        if (!software.uninstallString.isEmpty() || !software.quietUninstallString.isEmpty()) {
-            softwareList.append(software);
-        }
-        
-        registry.endGroup();
-    }
-}
-QString SoftwareManager::getSoftwareSizeFast(const QString &installPath)
-{
-    if (installPath.isEmpty() || !QDir(installPath).exists() || m_cancelScan)
-    {
-        return "0";
-    }
+    SoftwareInventory inventory = InventoryScanner::scan(m_sources, previous, m_cancelScan);
+
+    QList<InstalledSoftware> softwareList = inventory.software();
+    measureInstallSizes(softwareList);
+    inventory.setSoftware(softwareList);
 
-    return QString::number(calculateDirectorySizeFast(installPath));
+    return inventory;
 }
 
-qint64 SoftwareManager::calculateDirectorySizeFast(const QString &path)
+void SoftwareManager::measureInstallSizes(QList<InstalledSoftware> &softwareList)
 {
     if (m_cancelScan)
-        return 0;
+        return;
 
-    qint64 totalSize = 0;
-    QDir dir(path);
+    // Exact sizes, one install directory per pool thread; unchanged
+    // directories are answered from the size cache
+    QtConcurrent::blockingMap(softwareList, [this](InstalledSoftware &software)
+                              {
+        if (m_cancelScan || software.installLocation.isEmpty() || shouldSkipSizeScan(software))
+            return;
 
-    // Use QDirIterator for faster directory traversal
-    QDirIterator it(path, QDir::Files | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+        if (QDir(software.installLocation).exists())
+            software.size = m_sizeCache.directorySize(software.installLocation, m_cancelScan); });
 
-    int fileCount = 0;
-    while (it.hasNext() && !m_cancelScan)
+    if (!m_cancelScan)
     {
-        it.next();
-        totalSize += it.fileInfo().size();
-        fileCount++;
-
-        // Sample files after first 100 to speed up large directories
-        if (fileCount > 100)
-        {
-            // Estimate remaining size based on average file size
-            double avgFileSize = totalSize / (double)fileCount;
-            QDir tempDir(it.path());
-            int remainingFiles = tempDir.entryList(QDir::Files | QDir::NoDotAndDotDot).size();
-            totalSize += (qint64)(avgFileSize * remainingFiles);
-            break;
-        }
+        m_sizeCache.save(DirectorySizeCache::defaultFilePath());
     }
+}
 
-    return totalSize;
-}
\ No newline at end of file
+bool SoftwareManager::shouldSkipSizeScan(const InstalledSoftware &software)
+{
+    // PERFORMANCE OPTIMIZATION: Skip disk size calculation for system components
+    const KeywordClassifier &classifier = KeywordClassifier::standard();
+    quint32 categories = classifier.classify(software.name, KeywordClassifier::Name) |
+                         classifier.classify(software.publisher, KeywordClassifier::Publisher);
+    return categories & KeywordCategory::SystemSoftware;
+}
@@ -8,6 +8,18 @@
 #include <QFutureWatcher>
 #include <QAtomicInteger>
 #include <QDateTime>
+#include "../utils/directorysizecache.h"
+#include "../utils/softwareinventory.h"
+#include "../utils/inventorysource.h"
+#include "../utils/fuzzysearchindex.h"
+#include "../utils/softwaretablemodel.h"
+#include "../utils/softwarefilterproxymodel.h"
+#include "../utils/pathprefixtrie.h"
+#include "../utils/processsnapshot.h"
+#include "../utils/uninstallqueue.h"
+#include "../utils/fileindex.h"
+#include "../utils/leftoverfinder.h"
+#include "../utils/cleaningpipeline.h"
 
 class MainWindow;
 
@@ -27,36 +39,26 @@ public:
     void populateSoftwareTable();
     void cancelScan();
 
+    // Processes per installed entry (keys are positions in the installed software list)
+    QHash<int, QList<ProcessInfo>> runningSoftware(const ProcessSnapshot &snapshot) const;
+
 signals:
     void scanProgressUpdated(int progress, const QString &status);
     void scanFinished(bool success, const QString &message);
 
 private:
-    struct InstalledSoftware
-    {
-        QString name;
-        QString version;
-        QString publisher;
-        qint64 size;
-        QString installDate;
-        QString uninstallString;
-        QString quietUninstallString;
-        QString guid;
-        bool isSystemComponent;
-    };
-
     MainWindow *m_mainWindow;
     QList<InstalledSoftware> m_installedSoftware;
-    QFutureWatcher<QList<InstalledSoftware>> *m_scanWatcher;
+    QFutureWatcher<SoftwareInventory> *m_scanWatcher;
     QAtomicInteger<bool> m_cancelScan;
+    DirectorySizeCache m_sizeCache;
+    QList<InventorySource *> m_sources;
 
     void scanInstalledSoftware();
-    QList<InstalledSoftware> getInstalledSoftwareFromRegistry();
-    QString getSoftwareSize(const QString &uninstallPath);
     QString formatFileSize(qint64 bytes);
-    void executeUninstall(const QString &uninstallString, bool force = false);
-    bool isSoftwareRunning(const QString &softwareName);
-    void terminateProcess(const QString &processName);
+    static QString uninstallCommand(const InstalledSoftware &software, bool force, bool quiet);
+    void terminateProcesses(const QList<ProcessInfo> &processes);
+    static QString attributionDirectory(const InstalledSoftware &software);
 
     void setupConnections();
     void onScanFinished();
@@ -64,12 +66,41 @@ private:
     QList<InstalledSoftware> m_cachedSoftware;
     QDateTime m_lastScanTime;
     bool m_isCacheValid;
+    SoftwareInventory m_inventory; // last scan, also persisted between launches
+    SoftwareTableModel *m_softwareModel;
+    SoftwareFilterProxyModel *m_filterModel; // what the table shows: the search result
+    FuzzySearchIndex m_searchIndex; // ids are positions in m_installedSoftware
+    PathPrefixTrie m_locationIndex;  // install locations to positions in m_installedSoftware
+
+    // Batch uninstall
+    UninstallQueue *m_uninstallQueue;
+    QHash<int, InstalledSoftware> m_uninstallJobs; // by queue job id
+    int m_uninstallRemoved;
+    QList<InstalledSoftware> m_uninstallRemaining;
+    QList<InstalledSoftware> m_uninstallFailed;
+
+    QList<int> selectedRows() const;
+    static QString softwareNames(const QList<InstalledSoftware> &softwareList);
+    void queueUninstall(const QList<InstalledSoftware> &softwareList, bool force);
+    void updateUninstallStatus();
+    void onUninstallFinished();
+    QList<InstalledSoftware> refreshEntries(const QList<InstalledSoftware> &entries);
+
+    // Leftovers of removed software
+    FileIndex m_fileIndex; // only touched by the leftover job
+    QFutureWatcher<QList<LeftoverCandidate>> *m_leftoverWatcher;
+    QAtomicInteger<bool> m_cancelLeftovers;
+    CleaningPipeline *m_leftoverCleaner;
+    QList<InstalledSoftware> m_removedSoftware; // uninstalled since the last analysis
+
+    void findLeftovers();
+    void onLeftoversFound();
 
     // Fast scanning methods
-    QList<InstalledSoftware> getInstalledSoftwareFromRegistryFast();
-    QString getSoftwareSizeFast(const QString &uninstallPath);
-    void scanRegistryLocation(const QString &registryPath, QList<InstalledSoftware> &softwareList);
-    qint64 calculateDirectorySizeFast(const QString &path);
+    static QList<InventorySource *> createDefaultSources();
+    SoftwareInventory scanInventorySources(const SoftwareInventory &previous);
+    void measureInstallSizes(QList<InstalledSoftware> &softwareList);
+    static bool shouldSkipSizeScan(const InstalledSoftware &software);
 
 private slots:
     void updateScanProgress();
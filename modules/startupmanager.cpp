@@ -1,37 +1,91 @@
 #include "startupmanager.h"
 #include "../mainwindow.h"
 #include "../ui_mainwindow.h"
+#include "../utils/startupimpactsampler.h"
+#include "../utils/hivestartupsource.h"
+#include "../utils/startupsourcefactory.h"
+#include "../utils/logoncommand.h"
+#include "../utils/systemdunitsource.h"
+#include "../utils/delayedstartlauncher.h"
+#include "../utils/startupchangetransaction.h"
+#include "../utils/prefetchparser.h"
+#include "../utils/bootcriticalpath.h"
+#include "../utils/journalactivationsource.h"
 #include <QTableWidget>
-#include <QHeaderView>
 #include <QMessageBox>
-#include <QSettings>
+#include <QFileDialog>
+#include <QCheckBox>
+#include <QSignalBlocker>
+#include <QSet>
 #include <QDir>
 #include <QFileInfo>
-#include <QProcess>
-#include <QRegularExpression>
-#include <windows.h>
-#include <tlhelp32.h>
-#include <wincrypt.h>
-#include <psapi.h>
-#include <shlobj.h>
-
-#pragma comment(lib, "crypt32.lib")
-#pragma comment(lib, "advapi32.lib")
-#pragma comment(lib, "shell32.lib")
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+
+namespace
+{
+    // "'Name'" for one program, "3 programs" for a batch
+    QString describePrograms(const QList<StartupProgram> &programs)
+    {
+        return programs.size() == 1 ? QString("'%1'").arg(programs.first().name)
+                                    : QString("%1 programs").arg(programs.size());
+    }
+}
 
 StartupManager::StartupManager(MainWindow *mainWindow, QObject *parent)
-    : QObject(parent), m_mainWindow(mainWindow)
+    : QObject(parent), m_mainWindow(mainWindow), m_offline(false),
+      m_impactSampler(new StartupImpactSampler(this)), m_rescanPending(false)
 {
+    m_sources = StartupSourceFactory::createDefaultSources();
+    m_delayedStart.load();
+
+    m_scanWatcher = new QFutureWatcher<QList<StartupProgram>>(this);
+    connect(m_scanWatcher, &QFutureWatcher<QList<StartupProgram>>::finished,
+            this, &StartupManager::onScanFinished);
+    connect(m_impactSampler, &StartupImpactSampler::impactsUpdated, this, &StartupManager::onImpactsUpdated);
 }
 
 StartupManager::~StartupManager()
 {
+    m_scanWatcher->waitForFinished();
+    qDeleteAll(m_sources);
+}
+
+void StartupManager::setSources(const QList<StartupSource *> &sources)
+{
+    // Sources are read from the scan threads, so they can only be swapped between scans
+    if (m_scanWatcher->isRunning())
+        m_scanWatcher->waitForFinished();
+
+    qDeleteAll(m_sources);
+    m_sources = sources;
 }
 
 void StartupManager::initialize()
 {
     setupConnections();
+
+    // A batch cut short by a crash is undone before anything is listed
+    if (StartupChangeTransaction::hasPendingJournal())
+    {
+        QString error;
+        if (!StartupChangeTransaction::recover(m_sources, error))
+            QMessageBox::warning(m_mainWindow, "Startup Changes", error);
+    }
+
+    // Entries written by earlier builds started the elevated main executable,
+    // which Windows skips at logon; registering again points them at the helper
+    QString error;
+    if (!m_delayedStart.isEmpty() && !DelayedStartList::setLauncherRegistered(true, error))
+        QMessageBox::warning(m_mainWindow, "Delayed Start", error);
+    if (StartupImpactSampler::isMeasurerRegistered() && !StartupImpactSampler::setMeasurerRegistered(true, error))
+        QMessageBox::warning(m_mainWindow, "Startup Impact", error);
+
     refreshStartupPrograms();
+    updateMeasureAtLogon();
+
+    // Measures the programs launched at this logon, or loads the last measurement
+    m_impactSampler->start();
 }
 
 void StartupManager::setupConnections()
@@ -43,6 +97,12 @@ void StartupManager::setupConnections()
             this, &StartupManager::onDisableButtonClicked);
     connect(m_mainWindow->ui->enableStartupButton, &QPushButton::clicked,
             this, &StartupManager::onEnableButtonClicked);
+    connect(m_mainWindow->ui->delayStartupButton, &QPushButton::clicked,
+            this, &StartupManager::onDelayButtonClicked);
+    connect(m_mainWindow->ui->offlineStartupButton, &QPushButton::clicked,
+            this, &StartupManager::onOfflineButtonClicked);
+    connect(m_mainWindow->ui->measureAtLogonCheckBox, &QCheckBox::toggled,
+            this, &StartupManager::onMeasureAtLogonToggled);
     connect(m_mainWindow->ui->startupTable, &QTableWidget::itemSelectionChanged,
             this, &StartupManager::onStartupTableSelectionChanged);
 }
@@ -52,116 +112,393 @@ void StartupManager::refreshStartupPrograms()
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
 
-    m_startupPrograms = getRealStartupPrograms();
+    // A change made during a scan may not be in its results, so scan again afterwards
+    if (m_scanWatcher->isRunning()) {
+        m_rescanPending = true;
+        return;
+    }
+
+    m_scanWatcher->setFuture(QtConcurrent::run([this]() { return scanSources(); }));
+}
+
+QList<StartupProgram> StartupManager::scanSources() const
+{
+    // Every source runs on its own pool thread, so the slowest one sets the pace
+    QVector<QList<StartupProgram>> results(m_sources.size());
+    QVector<QFuture<void>> futures;
+
+    for (int i = 0; i < m_sources.size(); ++i)
+    {
+        futures.append(QtConcurrent::run([this, i, &results]()
+                                         { results[i] = m_sources[i]->scan(); }));
+    }
+
+    for (auto &future : futures)
+    {
+        future.waitForFinished();
+    }
+
+    QList<StartupProgram> programs;
+    for (const auto &result : results)
+    {
+        programs.append(result);
+    }
+
+    // The live system's launch history says nothing about an offline image
+    if (!m_offline)
+        applyLaunchHistory(programs);
+    applyBootCriticalPath(programs);
+    return programs;
+}
+
+void StartupManager::applyLaunchHistory(QList<StartupProgram> &programs)
+{
+    QHash<QString, PrefetchInfo> history = PrefetchParser::scanDirectory(PrefetchParser::defaultDirectory());
+    if (history.isEmpty())
+        return;
+
+    for (StartupProgram &program : programs) {
+        QString executable = StartupImpactSampler::executableFromCommand(
+            program.target.isEmpty() ? program.command : program.target);
+        auto info = history.constFind(PrefetchParser::executableKey(executable));
+        if (info == history.constEnd())
+            continue;
+
+        program.launchCount = info->runCount;
+        program.lastLaunch = info->lastRun();
+        program.launchFiles = info->loadedFiles.size();
+        program.launchReadBytes = info->estimatedReadBytes();
+    }
+}
+
+void StartupManager::applyBootCriticalPath(QList<StartupProgram> &programs)
+{
+    bool hasSystemUnits = false;
+    for (const StartupProgram &program : programs)
+        hasSystemUnits |= program.source == "systemd:system";
+    if (!hasSystemUnits)
+        return;
+
+    // Without a readable journal the units simply keep no boot role
+    BootCriticalPath analysis(SystemdUnitSource::searchPath(SystemdUnitSource::System));
+    JournalActivationSource journal;
+    QHash<QString, UnitActivation> activations;
+    QString error;
+    if (!analysis.loadUnits() || !journal.read(activations, error) || !analysis.analyze(activations))
+        return;
+
+    for (StartupProgram &program : programs) {
+        if (program.source != "systemd:system")
+            continue;
+
+        QString unit = QFileInfo(program.location).fileName();
+        UnitActivation activation = analysis.activation(unit);
+        program.bootRole = BootCriticalPath::roleName(analysis.role(unit));
+        program.activationMs = activation.activeUs >= 0 ? (activation.activeUs - activation.activatingUs) / 1000 : 0;
+    }
+}
+
+void StartupManager::onScanFinished()
+{
+    if (m_rescanPending) {
+        m_rescanPending = false;
+        m_scanWatcher->setFuture(QtConcurrent::run([this]() { return scanSources(); }));
+        return;
+    }
+
+    m_startupPrograms = m_scanWatcher->result();
+    removeDuplicates(m_startupPrograms);
+    sortProgramsByName(m_startupPrograms);
+    applyDelayedStart();
+
+    m_impactSampler->setTargets(m_offline ? QHash<QString, QString>()
+                                          : StartupImpactSampler::targetsFor(m_startupPrograms));
+    applyMeasuredImpact();
+
     populateTable();
     updateImpactLabel();
 }
 
+void StartupManager::onImpactsUpdated()
+{
+    if (!m_mainWindow || !m_mainWindow->ui)
+        return;
+
+    applyMeasuredImpact();
+
+    // Only the impact cells change, so the selection survives periodic samples
+    QTableWidget *table = m_mainWindow->ui->startupTable;
+    table->setSortingEnabled(false);
+    for (int row = 0; row < table->rowCount(); ++row) {
+        QTableWidgetItem *nameItem = table->item(row, 0);
+        int index = nameItem ? nameItem->data(Qt::UserRole).toInt() : -1;
+        if (index >= 0 && index < m_startupPrograms.size())
+            table->setItem(row, 2, createImpactItem(m_startupPrograms[index]));
+    }
+    table->setSortingEnabled(true);
+
+    updateImpactLabel();
+}
+
+void StartupManager::applyMeasuredImpact()
+{
+    QHash<QString, StartupImpact> impacts = m_impactSampler->impacts();
+    for (StartupProgram &program : m_startupPrograms) {
+        auto impact = impacts.constFind(StartupImpactSampler::entryKey(program));
+        program.measured = impact != impacts.constEnd();
+        if (program.measured) {
+            program.impact = impact->level();
+            program.cpuMs = impact->cpuMs;
+            program.diskReadBytes = impact->diskReadBytes;
+            program.memoryBytes = impact->peakResidentBytes;
+        } else {
+            // Disabled entries, services and tasks did not run under observation;
+            // a traced launch still gives an estimate from its reads
+            StartupImpact estimate;
+            estimate.diskReadBytes = program.launchReadBytes;
+            program.impact = program.launchCount > 0 ? estimate.level() : "Not measured";
+            program.cpuMs = 0;
+            program.diskReadBytes = 0;
+            program.memoryBytes = 0;
+        }
+    }
+}
+
+QTableWidgetItem *StartupManager::createImpactItem(const StartupProgram &program)
+{
+    QString text = program.impact;
+    if (program.measured)
+        text += QString(" (%1 s, %2 MB)")
+                    .arg(program.cpuMs / 1000.0, 0, 'f', 1)
+                    .arg(program.diskReadBytes / (1024.0 * 1024.0), 0, 'f', 1);
+    else if (program.launchCount > 0)
+        text += " (est.)";
+
+    QStringList details;
+    if (program.measured)
+        details << QString("CPU time: %1 s\nDisk read: %2 MB\nMemory: %3 MB")
+                       .arg(program.cpuMs / 1000.0, 0, 'f', 2)
+                       .arg(program.diskReadBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                       .arg(program.memoryBytes / (1024.0 * 1024.0), 0, 'f', 1);
+    if (program.launchCount > 0)
+        details << QString("Prefetch: launched %1 times, last on %2\n%3 files and about %4 MB read per launch")
+                       .arg(program.launchCount)
+                       .arg(program.lastLaunch.toString("yyyy-MM-dd hh:mm"))
+                       .arg(program.launchFiles)
+                       .arg(program.launchReadBytes / (1024.0 * 1024.0), 0, 'f', 1);
+
+    QTableWidgetItem *impactItem = new QTableWidgetItem(text);
+    impactItem->setToolTip(details.join("\n"));
+
+    if (program.impact == "High")
+    {
+        impactItem->setForeground(QBrush(QColor("#e74c3c")));
+    }
+    else if (program.impact == "Medium")
+    {
+        impactItem->setForeground(QBrush(QColor("#f39c12")));
+    }
+    else if (program.impact == "Low")
+    {
+        impactItem->setForeground(QBrush(QColor("#2ecc71")));
+    }
+    else
+    {
+        impactItem->setForeground(QBrush(QColor("#95a5a6")));
+    }
+    return impactItem;
+}
+
+void StartupManager::setOfflineHives(const QString &softwareHivePath, const QString &userHivePath)
+{
+    QList<StartupSource *> sources;
+    m_offline = !softwareHivePath.isEmpty() || !userHivePath.isEmpty();
+    if (m_offline) {
+        // Startup folders of an offline image are not resolved, only its Run keys
+        if (!userHivePath.isEmpty())
+            sources.append(new HiveStartupSource(userHivePath, "Software\\Microsoft\\Windows\\CurrentVersion\\Run"));
+        if (!softwareHivePath.isEmpty())
+            sources.append(new HiveStartupSource(softwareHivePath, "Microsoft\\Windows\\CurrentVersion\\Run"));
+    } else {
+        sources = StartupSourceFactory::createDefaultSources();
+    }
+
+    setSources(sources);
+    if (m_mainWindow && m_mainWindow->ui)
+        m_mainWindow->ui->offlineStartupButton->setText(m_offline ? "Live System" : "Offline Image...");
+    refreshStartupPrograms();
+}
+
+void StartupManager::openOfflineImage()
+{
+    if (m_offline) {
+        setOfflineHives(QString(), QString());
+        return;
+    }
+
+    QString root = QFileDialog::getExistingDirectory(m_mainWindow, "Select the Root of a Mounted Windows Image");
+    if (root.isEmpty())
+        return;
+
+    QString softwareHive = root + "/Windows/System32/config/SOFTWARE";
+    if (!QFileInfo(softwareHive).isFile()) {
+        QMessageBox::warning(m_mainWindow, "Offline Image",
+                             QString("%1 does not contain Windows/System32/config/SOFTWARE.").arg(root));
+        return;
+    }
+
+    // A user's own Run key is optional; cancelling lists the machine-wide one only
+    QString userHive = QFileDialog::getOpenFileName(m_mainWindow, "Select a User's NTUSER.DAT (Optional)",
+                                                    root + "/Users", "User hives (NTUSER.DAT);;All files (*)");
+    setOfflineHives(softwareHive, userHive);
+}
+
 void StartupManager::onDisableButtonClicked()
 {
-    disableSelectedProgram();
+    disableSelectedPrograms();
 }
 
 void StartupManager::onEnableButtonClicked()
 {
-    enableSelectedProgram();
+    enableSelectedPrograms();
+}
+
+void StartupManager::onDelayButtonClicked()
+{
+    delaySelectedProgram();
+}
+
+void StartupManager::onOfflineButtonClicked()
+{
+    openOfflineImage();
+}
+
+int StartupManager::selectedProgramIndex() const
+{
+    // Rows are sortable, so the program index is kept on the name cell
+    QTableWidget *table = m_mainWindow->ui->startupTable;
+    int row = table->currentRow();
+    QTableWidgetItem *nameItem = row >= 0 ? table->item(row, 0) : nullptr;
+    int index = nameItem ? nameItem->data(Qt::UserRole).toInt() : -1;
+    return index >= 0 && index < m_startupPrograms.size() ? index : -1;
+}
+
+QList<StartupProgram> StartupManager::selectedPrograms() const
+{
+    QList<StartupProgram> programs;
+    const QModelIndexList rows = m_mainWindow->ui->startupTable->selectionModel()->selectedRows(0);
+    for (const QModelIndex &row : rows)
+    {
+        int index = row.data(Qt::UserRole).toInt();
+        if (index >= 0 && index < m_startupPrograms.size())
+            programs.append(m_startupPrograms[index]);
+    }
+    return programs;
+}
+
+void StartupManager::onMeasureAtLogonToggled(bool checked)
+{
+    // Later logons are measured headless, so the window need not be open right after them;
+    // without the registration only sessions it is opened in early are measured
+    QString error;
+    if (!StartupImpactSampler::setMeasurerRegistered(checked, error))
+        QMessageBox::warning(m_mainWindow, "Startup Impact", error);
+
+    updateMeasureAtLogon();
+    refreshStartupPrograms();
 }
 
-void StartupManager::disableSelectedProgram()
+void StartupManager::updateMeasureAtLogon()
 {
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
 
-    int row = m_mainWindow->ui->startupTable->currentRow();
-    if (row < 0)
+    // The registration itself is the setting, so removing the entry elsewhere unticks the box
+    QSignalBlocker blocker(m_mainWindow->ui->measureAtLogonCheckBox);
+    m_mainWindow->ui->measureAtLogonCheckBox->setChecked(StartupImpactSampler::isMeasurerRegistered());
+}
+
+void StartupManager::disableSelectedPrograms()
+{
+    if (!m_mainWindow || !m_mainWindow->ui)
+        return;
+
+    QList<StartupProgram> programs = selectedPrograms();
+    if (programs.isEmpty())
     {
         QMessageBox::information(m_mainWindow, "Disable Program", "Please select a program to disable.");
         return;
     }
 
-    QString programName = m_mainWindow->ui->startupTable->item(row, 0)->text();
-    QString location = m_startupPrograms[row].location;
-    QString startupType = m_startupPrograms[row].startupType;
-
     QMessageBox::StandardButton reply = QMessageBox::question(
         m_mainWindow,
         "Confirm Disable",
-        QString("Are you sure you want to disable '%1' from starting up with Windows?").arg(programName),
+        QString("Are you sure you want to disable %1 from starting automatically?").arg(describePrograms(programs)),
         QMessageBox::Yes | QMessageBox::No);
 
-    if (reply == QMessageBox::Yes)
-    {
-        if (changeStartupProgramState(programName, location, startupType, false))
-        {
-            // Don't show immediate success - let the refresh show the actual state
-            refreshStartupPrograms();
-
-            // Check if it actually got disabled
-            bool actuallyDisabled = false;
-            for (const auto &program : m_startupPrograms)
-            {
-                if (program.name == programName && !program.isEnabled)
-                {
-                    actuallyDisabled = true;
-                    break;
-                }
-            }
+    if (reply != QMessageBox::Yes)
+        return;
 
-            if (actuallyDisabled)
-            {
-                QMessageBox::information(m_mainWindow, "Success",
-                                         QString("'%1' has been disabled from startup.").arg(programName));
-            }
-            else
-            {
-                QMessageBox::warning(m_mainWindow, "Warning",
-                                     QString("'%1' may still appear as enabled. The change might require a restart to take effect.").arg(programName));
-            }
-        }
+    // A delayed entry is already disabled in its own location; the launcher just stops starting it
+    QList<StartupProgram> changes;
+    bool delayedChanged = false;
+    for (const StartupProgram &program : programs)
+    {
+        if (program.status == "Delayed")
+            delayedChanged |= m_delayedStart.remove(program.source, program.name);
         else
-        {
-            QMessageBox::warning(m_mainWindow, "Error",
-                                 QString("Failed to disable '%1'. You may need to run as Administrator.").arg(programName));
-        }
+            changes.append(program);
     }
+
+    bool success = changeStartupProgramStates(changes, false);
+    if (delayedChanged)
+        success = saveDelayedStart() && success;
+
+    // One rescan for the whole batch
+    refreshStartupPrograms();
+    if (success)
+        QMessageBox::information(m_mainWindow, "Success",
+                                 QString("%1 %2 been disabled from startup.")
+                                     .arg(describePrograms(programs), programs.size() == 1 ? "has" : "have"));
 }
 
-void StartupManager::enableSelectedProgram()
+void StartupManager::enableSelectedPrograms()
 {
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
 
-    int row = m_mainWindow->ui->startupTable->currentRow();
-    if (row < 0)
+    QList<StartupProgram> programs = selectedPrograms();
+    if (programs.isEmpty())
     {
         QMessageBox::information(m_mainWindow, "Enable Program", "Please select a program to enable.");
         return;
     }
 
-    QString programName = m_mainWindow->ui->startupTable->item(row, 0)->text();
-    QString location = m_startupPrograms[row].location;
-    QString startupType = m_startupPrograms[row].startupType;
-
     QMessageBox::StandardButton reply = QMessageBox::question(
         m_mainWindow,
         "Confirm Enable",
-        QString("Are you sure you want to enable '%1' to start with Windows?").arg(programName),
+        QString("Are you sure you want to enable %1 to start automatically?").arg(describePrograms(programs)),
         QMessageBox::Yes | QMessageBox::No);
 
-    if (reply == QMessageBox::Yes)
+    if (reply != QMessageBox::Yes)
+        return;
+
+    bool success = changeStartupProgramStates(programs, true);
+    if (success)
     {
-        if (changeStartupProgramState(programName, location, startupType, true))
-        {
-            refreshStartupPrograms();
-            QMessageBox::information(m_mainWindow, "Success",
-                                     QString("'%1' has been enabled for startup.").arg(programName));
-        }
-        else
-        {
-            QMessageBox::warning(m_mainWindow, "Error",
-                                 QString("Failed to enable '%1'. You may need to run as Administrator.").arg(programName));
-        }
+        // Enabled in their own location again, so the launcher must not start them a second time
+        bool delayedChanged = false;
+        for (const StartupProgram &program : programs)
+            delayedChanged |= m_delayedStart.remove(program.source, program.name);
+        if (delayedChanged)
+            saveDelayedStart();
     }
+
+    refreshStartupPrograms();
+    if (success)
+        QMessageBox::information(m_mainWindow, "Success",
+                                 QString("%1 %2 been enabled for startup.")
+                                     .arg(describePrograms(programs), programs.size() == 1 ? "has" : "have"));
 }
 
 void StartupManager::onStartupTableSelectionChanged()
@@ -187,7 +524,23 @@ void StartupManager::populateTable()
 
         // Program Name
         QTableWidgetItem *nameItem = new QTableWidgetItem(program.name);
-        nameItem->setToolTip(program.command);
+        nameItem->setToolTip(program.target.isEmpty() ? program.command : program.command + "\n" + program.target);
+        nameItem->setData(Qt::UserRole, i);
+
+        // Units the last boot waited for stand out from those that ran alongside
+        if (program.bootRole == "Critical path") {
+            QFont font = nameItem->font();
+            font.setBold(true);
+            nameItem->setFont(font);
+            nameItem->setForeground(QBrush(QColor("#e74c3c")));
+            nameItem->setToolTip(nameItem->toolTip() + QString("\nOn the boot critical path: activating took %1 s")
+                                                           .arg(program.activationMs / 1000.0, 0, 'f', 2));
+        } else if (program.bootRole == "Parallel") {
+            nameItem->setToolTip(nameItem->toolTip() + QString("\nStarted in parallel, did not delay boot (%1 s)")
+                                                           .arg(program.activationMs / 1000.0, 0, 'f', 2));
+        } else if (program.bootRole == "After boot") {
+            nameItem->setToolTip(nameItem->toolTip() + "\nStarted after boot had finished");
+        }
         table->setItem(row, 0, nameItem);
 
         // Status
@@ -196,6 +549,11 @@ void StartupManager::populateTable()
         {
             statusItem->setForeground(QBrush(QColor("#2ecc71")));
         }
+        else if (program.status == "Delayed")
+        {
+            statusItem->setForeground(QBrush(QColor("#3498db")));
+            statusItem->setToolTip("Started by the delayed start launcher after logon");
+        }
         else
         {
             statusItem->setForeground(QBrush(QColor("#e74c3c")));
@@ -203,20 +561,7 @@ void StartupManager::populateTable()
         table->setItem(row, 1, statusItem);
 
         // Impact
-        QTableWidgetItem *impactItem = new QTableWidgetItem(program.impact);
-        if (program.impact == "High")
-        {
-            impactItem->setForeground(QBrush(QColor("#e74c3c")));
-        }
-        else if (program.impact == "Medium")
-        {
-            impactItem->setForeground(QBrush(QColor("#f39c12")));
-        }
-        else
-        {
-            impactItem->setForeground(QBrush(QColor("#2ecc71")));
-        }
-        table->setItem(row, 2, impactItem);
+        table->setItem(row, 2, createImpactItem(program));
 
         // Startup Type
         QTableWidgetItem *typeItem = new QTableWidgetItem(program.startupType);
@@ -234,23 +579,22 @@ void StartupManager::updateButtonStates()
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
 
-    QList<QTableWidgetItem *> selectedItems = m_mainWindow->ui->startupTable->selectedItems();
-    bool hasSelection = !selectedItems.isEmpty();
-
-    if (hasSelection)
-    {
-        int row = m_mainWindow->ui->startupTable->currentRow();
-        QTableWidgetItem *statusItem = m_mainWindow->ui->startupTable->item(row, 1);
-        bool isEnabled = statusItem && statusItem->text() == "Enabled";
-
-        m_mainWindow->ui->disableStartupButton->setEnabled(isEnabled);
-        m_mainWindow->ui->enableStartupButton->setEnabled(!isEnabled);
-    }
-    else
+    QList<StartupProgram> programs = selectedPrograms();
+    bool canDisable = false;
+    bool canEnable = false;
+    for (const StartupProgram &program : programs)
     {
-        m_mainWindow->ui->disableStartupButton->setEnabled(false);
-        m_mainWindow->ui->enableStartupButton->setEnabled(false);
+        canDisable |= program.isEnabled || program.status == "Delayed";
+        canEnable |= !program.isEnabled;
     }
+
+    // Delaying asks about one program at a time
+    bool delayable = programs.size() == 1 && programs.first().status != "Delayed" && canDelay(programs.first());
+
+    // Offline hives are opened read-only
+    m_mainWindow->ui->disableStartupButton->setEnabled(canDisable && !m_offline);
+    m_mainWindow->ui->enableStartupButton->setEnabled(canEnable && !m_offline);
+    m_mainWindow->ui->delayStartupButton->setEnabled(delayable);
 }
 
 void StartupManager::updateImpactLabel()
@@ -259,446 +603,66 @@ void StartupManager::updateImpactLabel()
         return;
 
     double impactSeconds = calculateBootImpact();
+    qint64 diskReadBytes = 0;
     int enabledCount = 0;
     int highImpactCount = 0;
+    int measuredCount = 0;
+    int delayedCount = 0;
+    int criticalCount = 0;
 
     for (const auto &program : m_startupPrograms)
     {
-        if (program.isEnabled)
+        if (program.status == "Delayed")
         {
-            enabledCount++;
-            if (program.impact == "High")
-            {
-                highImpactCount++;
-            }
-        }
-    }
-
-    QString impactText = QString("Startup Impact: %1 programs enabled (%2 high impact) - %3s boot time")
-                             .arg(enabledCount)
-                             .arg(highImpactCount)
-                             .arg(impactSeconds, 0, 'f', 1);
-
-    m_mainWindow->ui->startupImpactLabel->setText(impactText);
-}
-
-QList<StartupProgram> StartupManager::getRealStartupPrograms()
-{
-    QList<StartupProgram> programs;
-
-    qDebug() << "Scanning startup locations that Task Manager monitors...";
-    
-    // Debug first to see actual state
-    debugActualRegistryState();
-    
-    // Then scan normally
-    scanRegistryStartup(programs, "HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", "Registry", "Current User");
-    scanRegistryStartup(programs, "HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run", "Registry", "Local Machine");
-    scanStartupFolders(programs);
-    
-    qDebug() << "Total programs found:" << programs.size();
-    
-    removeDuplicates(programs);
-    sortProgramsByName(programs);
-
-    return programs;
-}
-
-bool StartupManager::shouldSkipProgram(const QString &name, const QString &command)
-{
-    QString lowerName = name.toLower();
-    QString lowerCommand = command.toLower();
-    
-    // Only skip truly system-critical entries
-    if (lowerName.contains("securityhealth") ||
-        lowerName.contains("windowsdefender") ||
-        lowerCommand.contains("system32\\securityhealth")) {
-        return true;
-    }
-    
-    // Don't skip Microsoft Store apps, Riot, Steam, etc.
-    // Let Task Manager decide what to show
-    
-    return false;
-}
-
-void StartupManager::scanRegistryStartup(QList<StartupProgram> &programs, const QString &registryPath, const QString &startupType, const QString &location)
-{
-    QSettings registry(registryPath, QSettings::NativeFormat);
-    QStringList keys = registry.childKeys();
-
-    for (const QString &key : keys) {
-        QString value = registry.value(key).toString();
-        if (value.isEmpty()) continue;
-        
-        // For now, let's assume ALL programs in the main registry are ENABLED
-        // and ALL programs in Disabled key are DISABLED
-        // This is the simplest approach that should match Task Manager
-        
-        StartupProgram program;
-        program.name = key;
-        program.status = "Enabled";
-        program.startupType = startupType;
-        program.command = value;
-        program.location = registryPath;
-        program.isEnabled = true;
-        program.impact = calculateProgramImpact(key, value);
-        programs.append(program);
-        
-        qDebug() << "Found in MAIN registry (ENABLED):" << key;
-    }
-    
-    // Check Disabled key
-    QSettings disabledReg(registryPath + "Disabled", QSettings::NativeFormat);
-    QStringList disabledKeys = disabledReg.childKeys();
-    
-    for (const QString &key : disabledKeys) {
-        QString originalValue = disabledReg.value(key).toString();
-        
-        StartupProgram program;
-        program.name = key;
-        program.status = "Disabled";
-        program.startupType = startupType;
-        program.command = originalValue;
-        program.location = registryPath + " (Disabled)";
-        program.isEnabled = false;
-        program.impact = calculateProgramImpact(key, originalValue);
-        programs.append(program);
-        qDebug() << "Found in DISABLED registry:" << key;
-    }
-}
-
-bool StartupManager::isProgramEnabledInTaskManager(const QString &programName, const QString &registryPath, const QString &value)
-{
-    // Method 1: Check if value indicates it's disabled
-    if (value.startsWith("DISABLED_") || 
-        value.contains("--disabled") || 
-        value.contains("/disabled")) {
-        return false;
-    }
-    
-    // Method 2: Check if it's in the official Windows Disabled key
-    QSettings disabledReg(registryPath + "Disabled", QSettings::NativeFormat);
-    if (disabledReg.contains(programName)) {
-        return false;
-    }
-    
-    // Method 3: Check common patterns that indicate disabled state
-    if (programName.contains("(disabled)", Qt::CaseInsensitive)) {
-        return false;
-    }
-    
-    // If none of the above, assume it's enabled
-    return true;
-}
-
-
-void StartupManager::scanStartupFolders(QList<StartupProgram> &programs)
-{
-    // Get actual startup folder paths
-    wchar_t* startupPath = nullptr;
-    
-    // Current User startup folder
-    if (SHGetKnownFolderPath(FOLDERID_Startup, 0, nullptr, &startupPath) == S_OK) {
-        QString folderPath = QString::fromWCharArray(startupPath);
-        CoTaskMemFree(startupPath);
-        
-        QDir startupFolder(folderPath);
-        if (startupFolder.exists()) {
-            scanStartupFolder(programs, startupFolder, "Startup Folder", "Current User");
-        } else {
-            qDebug() << "Startup folder doesn't exist:" << folderPath;
-        }
-    }
-    
-    // All Users startup folder
-    if (SHGetKnownFolderPath(FOLDERID_CommonStartup, 0, nullptr, &startupPath) == S_OK) {
-        QString folderPath = QString::fromWCharArray(startupPath);
-        CoTaskMemFree(startupPath);
-        
-        QDir startupFolder(folderPath);
-        if (startupFolder.exists()) {
-            scanStartupFolder(programs, startupFolder, "Startup Folder", "All Users");
-        } else {
-            qDebug() << "Common startup folder doesn't exist:" << folderPath;
+            delayedCount++;
         }
-    }
-}
-
-void StartupManager::scanStartupFolder(QList<StartupProgram> &programs, QDir &startupFolder, const QString &startupType, const QString &location)
-{
-    QString actualPath = startupFolder.absolutePath();
-    qDebug() << "Scanning startup folder:" << actualPath;
-    
-    // Check for disabled folder
-    QDir disabledFolder(startupFolder.absolutePath() + "/Disabled");
-    
-    // Scan ENABLED items (in main folder)
-    QFileInfoList entries = startupFolder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::System);
-    for (const QFileInfo &entry : entries) {
-        QString suffix = entry.suffix().toLower();
-        if (suffix == "lnk" || suffix == "exe" || suffix == "bat" || suffix == "cmd") {
-            StartupProgram program;
-            program.name = entry.baseName();
-            program.status = "Enabled";
-            program.startupType = startupType;
-            program.command = entry.absoluteFilePath();
-            program.location = location;
-            program.isEnabled = true;
-            program.impact = calculateProgramImpact(program.name, program.command);
-            
-            programs.append(program);
-            qDebug() << "Found ENABLED startup folder:" << program.name;
-        }
-    }
-    
-    // Scan DISABLED items (in disabled subfolder)
-    if (disabledFolder.exists()) {
-        QFileInfoList disabledEntries = disabledFolder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::System);
-        for (const QFileInfo &entry : disabledEntries) {
-            QString suffix = entry.suffix().toLower();
-            if (suffix == "lnk" || suffix == "exe" || suffix == "bat" || suffix == "cmd") {
-                StartupProgram program;
-                program.name = entry.baseName();
-                program.status = "Disabled";
-                program.startupType = startupType;
-                program.command = entry.absoluteFilePath();
-                program.location = location + " (Disabled)";
-                program.isEnabled = false;
-                program.impact = calculateProgramImpact(program.name, program.command);
-                
-                programs.append(program);
-                qDebug() << "Found DISABLED startup folder:" << program.name;
-            }
-        }
-    }
-}
-
-void StartupManager::scanServices(QList<StartupProgram> &programs)
-{
-    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_ENUMERATE_SERVICE);
-    if (!scManager)
-        return;
-
-    DWORD bytesNeeded = 0;
-    DWORD serviceCount = 0;
-    DWORD resumeHandle = 0;
-
-    // First call to get required buffer size
-    EnumServicesStatusEx(
-        scManager,
-        SC_ENUM_PROCESS_INFO,
-        SERVICE_WIN32,
-        SERVICE_STATE_ALL,
-        nullptr,
-        0,
-        &bytesNeeded,
-        &serviceCount,
-        &resumeHandle,
-        nullptr);
-
-    if (GetLastError() != ERROR_MORE_DATA)
-    {
-        CloseServiceHandle(scManager);
-        return;
-    }
-
-    BYTE *buffer = new BYTE[bytesNeeded];
-    ENUM_SERVICE_STATUS_PROCESS *services = reinterpret_cast<ENUM_SERVICE_STATUS_PROCESS *>(buffer);
-
-    if (EnumServicesStatusEx(
-            scManager,
-            SC_ENUM_PROCESS_INFO,
-            SERVICE_WIN32,
-            SERVICE_STATE_ALL,
-            buffer,
-            bytesNeeded,
-            &bytesNeeded,
-            &serviceCount,
-            &resumeHandle,
-            nullptr))
-    {
-        for (DWORD i = 0; i < serviceCount; i++)
+        if (program.bootRole == "Critical path")
         {
-            ENUM_SERVICE_STATUS_PROCESS &service = services[i];
-
-            QString serviceName = QString::fromWCharArray(service.lpDisplayName);
-            QString lowerName = serviceName.toLower();
-
-            // Filter out critical system services - SIMPLIFIED VERSION
-            if (lowerName.contains("windows") ||
-                lowerName.contains("microsoft") ||
-                lowerName.contains("system32") ||
-                lowerName.contains("svchost") ||
-                lowerName.contains("runtime") ||
-                lowerName.contains("kernel") ||
-                lowerName.contains("driver") ||
-                lowerName.contains("network") ||
-                lowerName.contains("security") ||
-                lowerName.contains("update") ||
-                lowerName.contains("defender") ||
-                lowerName.contains("firewall"))
-            {
-                continue; // Skip system services
-            }
-
-            // Open service to query configuration
-            SC_HANDLE hService = OpenService(scManager, service.lpServiceName, SERVICE_QUERY_CONFIG);
-            if (hService)
-            {
-                DWORD bytesNeededConfig = 0;
-                QueryServiceConfig(hService, nullptr, 0, &bytesNeededConfig);
-
-                if (bytesNeededConfig > 0)
-                {
-                    BYTE *configBuffer = new BYTE[bytesNeededConfig];
-                    QUERY_SERVICE_CONFIG *serviceConfig = reinterpret_cast<QUERY_SERVICE_CONFIG *>(configBuffer);
-
-                    if (QueryServiceConfig(hService, serviceConfig, bytesNeededConfig, &bytesNeededConfig))
-                    {
-                        // Check if service starts automatically and is not disabled
-                        bool isEnabled = (serviceConfig->dwStartType == SERVICE_AUTO_START);
-
-                        StartupProgram program;
-                        program.name = serviceName;
-                        program.status = isEnabled ? "Enabled" : "Disabled";
-                        program.startupType = "Service";
-                        program.command = QString::fromWCharArray(service.lpServiceName);
-                        program.location = "Services";
-                        program.isEnabled = isEnabled;
-                        program.impact = calculateProgramImpact(program.name, program.command);
-
-                        programs.append(program);
-                    }
-
-                    delete[] configBuffer;
-                }
-                CloseServiceHandle(hService);
-            }
+            criticalCount++;
         }
-    }
-
-    delete[] buffer;
-    CloseServiceHandle(scManager);
-}
-
-void StartupManager::scanScheduledTasks(QList<StartupProgram> &programs)
-{
-    // Use schtasks command to get scheduled tasks
-    QProcess process;
-    process.start("schtasks", QStringList() << "/query" << "/fo" << "csv" << "/nh");
-    process.waitForFinished(3000); // 3 second timeout
-
-    if (process.exitCode() != 0)
-        return;
-
-    QString output = process.readAllStandardOutput();
-    QStringList lines = output.split('\n', Qt::SkipEmptyParts);
-
-    for (const QString &line : lines)
-    {
-        QStringList fields = line.split(',');
-        if (fields.size() >= 3)
+        if (program.isEnabled)
         {
-            QString taskName = fields[0].trimmed();
-            if (taskName.startsWith('"') && taskName.endsWith('"'))
-            {
-                taskName = taskName.mid(1, taskName.length() - 2);
-            }
-
-            QString status = fields.size() > 2 ? fields[2].trimmed() : "";
-            if (status.startsWith('"') && status.endsWith('"'))
+            enabledCount++;
+            if (program.impact == "High")
             {
-                status = status.mid(1, status.length() - 2);
+                highImpactCount++;
             }
-
-            // Look for tasks that run at startup, logon, or are user applications
-            if ((taskName.contains("Startup", Qt::CaseInsensitive) ||
-                 taskName.contains("Logon", Qt::CaseInsensitive) ||
-                 taskName.contains("AtStartup", Qt::CaseInsensitive) ||
-                 taskName.contains("AtLogon", Qt::CaseInsensitive)) &&
-                !taskName.contains("Microsoft", Qt::CaseInsensitive))
+            if (program.measured)
             {
-
-                bool isEnabled = (status != "Disabled");
-
-                StartupProgram program;
-                program.name = taskName;
-                program.status = isEnabled ? "Enabled" : "Disabled";
-                program.startupType = "Scheduled Task";
-                program.command = "";
-                program.location = "Task Scheduler";
-                program.isEnabled = isEnabled;
-                program.impact = "Low";
-
-                programs.append(program);
+                measuredCount++;
+                diskReadBytes += program.diskReadBytes;
             }
         }
     }
-}
 
-bool StartupManager::isUserService(const QString &serviceName)
-{
-    QString lowerName = serviceName.toLower();
-
-    // Filter out critical system services
-    if (lowerName.contains("windows") ||
-        lowerName.contains("microsoft") ||
-        lowerName.contains("system32") ||
-        lowerName.contains("svchost") ||
-        lowerName.contains("runtime") ||
-        lowerName.contains("kernel") ||
-        lowerName.contains("driver") ||
-        lowerName.contains("network") ||
-        lowerName.contains("security") ||
-        lowerName.contains("update") ||
-        lowerName.contains("defender") ||
-        lowerName.contains("firewall"))
+    QString impactText;
+    if (measuredCount == 0)
     {
-        return false;
+        impactText = QString("Startup Impact: %1 programs enabled - not measured yet")
+                         .arg(enabledCount);
     }
-
-    return true;
-}
-
-QString StartupManager::calculateProgramImpact(const QString &programName, const QString &command)
-{
-    QString lowerName = programName.toLower();
-    QString lowerCommand = command.toLower();
-
-    // High impact programs
-    if (lowerName.contains("adobe") || lowerCommand.contains("adobe") ||
-        lowerName.contains("creative") || lowerCommand.contains("creative") ||
-        lowerName.contains("steam") || lowerCommand.contains("steam") ||
-        lowerName.contains("spotify") || lowerCommand.contains("spotify") ||
-        lowerName.contains("discord") || lowerCommand.contains("discord") ||
-        lowerName.contains("teams") || lowerCommand.contains("teams") ||
-        lowerName.contains("zoom") || lowerCommand.contains("zoom") ||
-        lowerName.contains("skype") || lowerCommand.contains("skype"))
+    else
     {
-        return "High";
+        impactText = QString("Startup Impact: %1 programs enabled (%2 high impact) - %3 s CPU, %4 MB read by %5 measured programs")
+                         .arg(enabledCount)
+                         .arg(highImpactCount)
+                         .arg(impactSeconds, 0, 'f', 1)
+                         .arg(diskReadBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                         .arg(measuredCount);
     }
 
-    // Medium impact programs
-    else if (lowerName.contains("google") || lowerCommand.contains("google") ||
-             lowerName.contains("dropbox") || lowerCommand.contains("dropbox") ||
-             lowerName.contains("onedrive") || lowerCommand.contains("onedrive") ||
-             lowerName.contains("icloud") || lowerCommand.contains("icloud"))
-    {
-        return "Medium";
-    }
+    if (delayedCount > 0)
+        impactText += QString(", %1 delayed").arg(delayedCount);
+    if (criticalCount > 0)
+        impactText += QString(", %1 on the boot critical path").arg(criticalCount);
 
-    // Low impact programs
-    else if (lowerName.contains("update") || lowerCommand.contains("update") ||
-             lowerName.contains("nvidia") || lowerCommand.contains("nvidia") ||
-             lowerName.contains("realtek") || lowerCommand.contains("realtek") ||
-             lowerName.contains("security") || lowerCommand.contains("security") ||
-             lowerName.contains("windows") || lowerCommand.contains("windows"))
-    {
-        return "Low";
-    }
+    QDateTime session = m_impactSampler->sessionStart();
+    if (m_impactSampler->isSampling())
+        impactText += " (measuring...)";
+    else if (measuredCount > 0 && session.isValid())
+        impactText += " at logon " + session.toString("yyyy-MM-dd hh:mm");
 
-    return "Medium";
+    m_mainWindow->ui->startupImpactLabel->setText(impactText);
 }
 
 void StartupManager::removeDuplicates(QList<StartupProgram> &programs)
@@ -728,399 +692,169 @@ void StartupManager::sortProgramsByName(QList<StartupProgram> &programs)
               });
 }
 
-bool StartupManager::changeStartupProgramState(const QString &programName, const QString &location, const QString &startupType, bool enable)
+bool StartupManager::changeStartupProgramStates(const QList<StartupProgram> &programs, bool enable)
 {
-    qDebug() << "Attempting to" << (enable ? "enable" : "disable") << programName 
-             << "Type:" << startupType << "Location:" << location;
-    
-    bool success = false;
-    
-    if (startupType == "Registry") {
-        success = changeRegistryStartupState(programName, location, enable);
-    } else if (startupType == "Startup Folder") {
-        success = changeStartupFolderState(programName, location, enable);
-    } else {
-        QMessageBox::warning(m_mainWindow, "Error", 
-            QString("Cannot %1 '%2' - unsupported startup type: %3")
-                .arg(enable ? "enable" : "disable")
-                .arg(programName)
-                .arg(startupType));
-        return false;
-    }
-    
-    if (success) {
-        // Refresh to show updated state
-        refreshStartupPrograms();
-        QMessageBox::information(m_mainWindow, "Success", 
-            QString("'%1' has been %2. Changes should appear in Task Manager after restarting it.")
-                .arg(programName)
-                .arg(enable ? "enabled" : "disabled"));
-    } else {
-        QMessageBox::warning(m_mainWindow, "Error", 
-            QString("Failed to %1 '%2'. Please ensure you're running as Administrator.")
-                .arg(enable ? "enable" : "disable")
-                .arg(programName));
-    }
-    
-    return success;
-}
+    // All or nothing: a failure undoes the changes made before it
+    StartupChangeTransaction transaction(m_sources);
+    for (const StartupProgram &program : programs)
+        transaction.add(program, enable);
 
-bool StartupManager::changeRegistryStartupState(const QString &programName, const QString &registryPath, bool enable)
-{
-    QSettings registry(registryPath, QSettings::NativeFormat);
-    
-    if (enable) {
-        // ENABLE: Task Manager moves entries from "Disabled" back to main
-        QSettings disabledReg(registryPath + "Disabled", QSettings::NativeFormat);
-        if (disabledReg.contains(programName)) {
-            QString originalValue = disabledReg.value(programName).toString();
-            registry.setValue(programName, originalValue);
-            disabledReg.remove(programName);
-            qDebug() << "Enabled by moving from Disabled key:" << programName;
-            return true;
-        } else {
-            QMessageBox::warning(m_mainWindow, "Error", 
-                QString("Cannot enable '%1' - not found in disabled registry.").arg(programName));
-            return false;
-        }
-    } else {
-        // DISABLE: Task Manager moves entries to a "Disabled" subkey
-        if (registry.contains(programName)) {
-            QString originalValue = registry.value(programName).toString();
-            
-            // Move to Disabled key (this is what Task Manager does)
-            QSettings disabledReg(registryPath + "Disabled", QSettings::NativeFormat);
-            disabledReg.setValue(programName, originalValue);
-            
-            // Remove from main key
-            registry.remove(programName);
-            
-            qDebug() << "Disabled by moving to Disabled key:" << programName;
-            return true;
-        } else {
-            QMessageBox::warning(m_mainWindow, "Error", 
-                QString("Cannot disable '%1' - not found in registry.").arg(programName));
-            return false;
-        }
-    }
-}
+    if (transaction.commit())
+        return true;
 
-bool StartupManager::setWindowsStartupState(const QString &programName, const QString &registryPath, bool enable)
-{
-    // Windows Task Manager looks at specific registry values to determine disabled state
-    // For HKEY_CURRENT_USER, it uses a different approach than HKEY_LOCAL_MACHINE
-    
-    if (registryPath.contains("HKEY_CURRENT_USER")) {
-        return setUserStartupState(programName, enable);
-    } else if (registryPath.contains("HKEY_LOCAL_MACHINE")) {
-        return setSystemStartupState(programName, enable);
-    }
-    
+    QString message = transaction.wasRolledBack()
+                          ? QString("Could not %1 %2; no changes were kept.\n\n%3")
+                          : QString("Could not %1 %2, and some changes could not be undone.\n\n%3");
+    QMessageBox::warning(m_mainWindow, "Error",
+                         message.arg(enable ? "enable" : "disable", describePrograms(programs), transaction.errorString()));
     return false;
 }
 
-bool StartupManager::setUserStartupState(const QString &programName, bool enable)
+double StartupManager::calculateBootImpact()
 {
-    // For current user startup, Task Manager uses the registry value itself
-    // If the value exists and is not empty, it's enabled
-    // If we want to disable but keep it visible in Task Manager, we need a different approach
-    
-    if (enable) {
-        // Restore from backup
-        QSettings backup("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-        if (backup.contains(programName)) {
-            QString value = backup.value(programName).toString();
-            QSettings registry("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-            registry.setValue(programName, value);
-            backup.remove(programName);
-            return true;
-        }
-    } else {
-        // Disable by moving to backup but keep a placeholder
-        QSettings registry("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-        if (registry.contains(programName)) {
-            QString value = registry.value(programName).toString();
-            
-            // Save to backup
-            QSettings backup("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-            backup.setValue(programName, value);
-            
-            // Set a special value that indicates disabled but keeps it visible
-            registry.setValue(programName, "");
-            return true;
+    // CPU seconds the enabled programs used in the window after logon
+    double totalImpact = 0.0;
+
+    for (const auto &program : m_startupPrograms)
+    {
+        if (program.isEnabled && program.measured)
+        {
+            totalImpact += program.cpuMs / 1000.0;
         }
     }
-    
-    return false;
+
+    return totalImpact;
 }
 
-bool StartupManager::setSystemStartupState(const QString &programName, bool enable)
+const StartupSource *StartupManager::findSource(const QString &id) const
 {
-    // For system-wide startup, we need to use the proper Windows method
-    // Task Manager looks at both the registry and policy settings
-    
-    if (enable) {
-        // Enable: Restore original value
-        QSettings backup("HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-        if (backup.contains(programName)) {
-            QString value = backup.value(programName).toString();
-            QSettings registry("HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-            registry.setValue(programName, value);
-            backup.remove(programName);
-            return true;
-        }
-    } else {
-        // Disable: Use Windows standard method - remove from registry
-        QSettings registry("HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-        if (registry.contains(programName)) {
-            QString value = registry.value(programName).toString();
-            
-            // Save to backup
-            QSettings backup("HKEY_LOCAL_MACHINE\\Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-            backup.setValue(programName, value);
-            
-            // Remove from registry (this is what Task Manager expects)
-            registry.remove(programName);
-            return true;
-        }
+    for (const StartupSource *source : m_sources)
+    {
+        if (source->id() == id)
+            return source;
     }
-    
-    return false;
+    return nullptr;
 }
 
-
-bool StartupManager::changeStartupFolderState(const QString &programName, const QString &folderType, bool enable)
+bool StartupManager::canDelay(const StartupProgram &program) const
 {
-    // Get the actual folder path based on folderType
-    QString folderPath;
-    wchar_t* startupPath = nullptr;
-    
-    if (folderType == "Current User") {
-        if (SHGetKnownFolderPath(FOLDERID_Startup, 0, nullptr, &startupPath) == S_OK) {
-            folderPath = QString::fromWCharArray(startupPath);
-            CoTaskMemFree(startupPath);
-        }
-    } else if (folderType == "All Users") {
-        if (SHGetKnownFolderPath(FOLDERID_CommonStartup, 0, nullptr, &startupPath) == S_OK) {
-            folderPath = QString::fromWCharArray(startupPath);
-            CoTaskMemFree(startupPath);
-        }
-    }
-    
-    if (folderPath.isEmpty()) {
-        qDebug() << "Could not find startup folder path for:" << folderType;
-        return false;
-    }
-    
-    QDir startupFolder(folderPath);
-    if (!startupFolder.exists()) {
-        qDebug() << "Startup folder doesn't exist:" << folderPath;
-        return false;
-    }
-
-    QDir disabledFolder(startupFolder.absolutePath() + "/Disabled");
-    
-    if (enable) {
-        // Enable: Move from disabled folder back to startup folder
-        if (!disabledFolder.exists()) {
-            qDebug() << "No disabled folder found for enabling:" << programName;
-            return false;
-        }
-        
-        QFileInfoList disabledEntries = disabledFolder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-        for (const QFileInfo &entry : disabledEntries) {
-            if (entry.baseName().compare(programName, Qt::CaseInsensitive) == 0) {
-                QString newPath = startupFolder.absolutePath() + "/" + entry.fileName();
-                bool success = QFile::rename(entry.absoluteFilePath(), newPath);
-                qDebug() << "Enabled startup folder item:" << programName << "Success:" << success;
-                return success;
-            }
-        }
-        qDebug() << "Program not found in disabled folder:" << programName;
-        return false;
-        
-    } else {
-        // Disable: Move from startup folder to disabled folder
-        if (!disabledFolder.exists()) {
-            if (!disabledFolder.mkpath(".")) {
-                qDebug() << "Failed to create disabled folder";
-                return false;
-            }
-        }
-        
-        QFileInfoList entries = startupFolder.entryInfoList(QDir::Files | QDir::NoDotAndDotDot);
-        for (const QFileInfo &entry : entries) {
-            if (entry.baseName().compare(programName, Qt::CaseInsensitive) == 0) {
-                QString newPath = disabledFolder.absolutePath() + "/" + entry.fileName();
-                bool success = QFile::rename(entry.absoluteFilePath(), newPath);
-                qDebug() << "Disabled startup folder item:" << programName << "Success:" << success;
-                return success;
-            }
-        }
-        qDebug() << "Program not found in startup folder:" << programName;
-        return false;
-    }
+    // Only programs of the user's session can be started by the launcher; it and the measurer are not delayed
+    return !m_offline && !program.command.contains(DelayedStartList::launcherArgument()) &&
+           !program.command.contains(StartupImpactSampler::measureArgument()) &&
+           (program.startupType == "Registry" || program.startupType == "Startup Folder" ||
+            program.startupType == "Autostart");
 }
 
-bool StartupManager::changeServiceState(const QString &programName, bool enable)
+void StartupManager::applyDelayedStart()
 {
-    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_ALL_ACCESS);
-    if (!scManager)
+    bool changed = false;
+    for (StartupProgram &program : m_startupPrograms)
     {
-        qDebug() << "Failed to open Service Control Manager";
-        return false;
-    }
+        if (!m_delayedStart.find(program.source, program.name))
+            continue;
 
-    // Try to find the service
-    SC_HANDLE service = nullptr;
-    QString serviceName = programName;
-
-    // Remove common suffixes to get the actual service name
-    if (serviceName.endsWith(" Service"))
-    {
-        serviceName.chop(9); // Remove " Service"
-    }
-
-    // Try opening with the modified name first
-    service = OpenService(scManager, serviceName.toStdWString().c_str(), SERVICE_CHANGE_CONFIG);
-    if (!service)
-    {
-        // Try with the original name
-        service = OpenService(scManager, programName.toStdWString().c_str(), SERVICE_CHANGE_CONFIG);
-    }
-
-    if (!service)
-    {
-        qDebug() << "Failed to open service:" << programName;
-        CloseServiceHandle(scManager);
-        return false;
+        if (program.isEnabled)
+        {
+            // Re-enabled somewhere else; starting it twice would help nobody
+            m_delayedStart.remove(program.source, program.name);
+            changed = true;
+        }
+        else
+        {
+            program.status = "Delayed";
+        }
     }
 
-    DWORD startType = enable ? SERVICE_AUTO_START : SERVICE_DISABLED;
-    BOOL success = ChangeServiceConfig(
-        service,
-        SERVICE_NO_CHANGE, // service type
-        startType,         // start type
-        SERVICE_NO_CHANGE, // error control
-        nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    if (changed)
+        saveDelayedStart();
+}
 
-    if (success)
-    {
-        qDebug() << (enable ? "Enabled" : "Disabled") << "service:" << programName;
-    }
-    else
-    {
-        qDebug() << "Failed to change service state:" << programName << "Error:" << GetLastError();
-    }
+bool StartupManager::saveDelayedStart()
+{
+    QString error;
+    bool saved = m_delayedStart.save();
+    if (!saved)
+        error = "The delayed start list could not be saved.";
+    else if (!DelayedStartList::setLauncherRegistered(!m_delayedStart.isEmpty(), error))
+        saved = false;
 
-    CloseServiceHandle(service);
-    CloseServiceHandle(scManager);
-    return success;
+    if (!saved)
+        QMessageBox::warning(m_mainWindow, "Delayed Start", error);
+    return saved;
 }
 
-bool StartupManager::changeScheduledTaskState(const QString &programName, bool enable)
+void StartupManager::delaySelectedProgram()
 {
-    QProcess process;
-    process.setProcessChannelMode(QProcess::MergedChannels);
+    if (!m_mainWindow || !m_mainWindow->ui)
+        return;
 
-    QStringList args;
-    if (enable)
+    int index = selectedProgramIndex();
+    if (index < 0)
     {
-        args << "/change" << "/tn" << programName << "/enable";
-    }
-    else
-    {
-        args << "/change" << "/tn" << programName << "/disable";
+        QMessageBox::information(m_mainWindow, "Delay Start", "Please select a program to delay.");
+        return;
     }
 
-    process.start("schtasks", args);
-
-    if (!process.waitForStarted(3000))
+    const StartupProgram program = m_startupPrograms[index];
+    if (!canDelay(program))
     {
-        qDebug() << "Failed to start schtasks process";
-        return false;
+        QMessageBox::information(m_mainWindow, "Delay Start",
+                                 "Only Registry, Startup Folder and Autostart entries can be delayed.");
+        return;
     }
 
-    if (!process.waitForFinished(10000))
-    { // 10 second timeout
-        qDebug() << "schtasks process timed out";
-        process.kill();
-        return false;
-    }
+    DelayedStartSettings settings = m_delayedStart.settings();
+    QMessageBox::StandardButton reply = QMessageBox::question(
+        m_mainWindow,
+        "Confirm Delayed Start",
+        QString("'%1' will be started after logon, one program at a time, at least %2 s apart and once CPU use "
+                "is below %3% and disk traffic below %4 MB/s. Continue?")
+            .arg(program.name)
+            .arg(settings.gapSeconds)
+            .arg(settings.cpuThresholdPercent)
+            .arg(settings.diskThresholdKBps / 1024.0, 0, 'f', 1),
+        QMessageBox::Yes | QMessageBox::No);
 
-    bool success = (process.exitCode() == 0);
+    if (reply != QMessageBox::Yes)
+        return;
 
-    if (success)
-    {
-        qDebug() << (enable ? "Enabled" : "Disabled") << "scheduled task:" << programName;
-    }
-    else
+    // The entry is taken out of its own location below, so nothing may start it if the helper is missing
+    if (!QFileInfo(LogonCommand::helperPath()).isFile())
     {
-        QString errorOutput = process.readAllStandardError();
-        if (errorOutput.isEmpty())
-        {
-            errorOutput = process.readAllStandardOutput();
-        }
-        qDebug() << "Failed to change task state:" << programName << "Error:" << errorOutput;
+        QMessageBox::warning(m_mainWindow, "Delayed Start",
+                             QString("The logon helper %1 is missing, so delayed programs could not be started.")
+                                 .arg(QDir::toNativeSeparators(LogonCommand::helperPath())));
+        return;
     }
 
-    return success;
-}
-
-double StartupManager::calculateBootImpact()
-{
-    double totalImpact = 2.5; // Base Windows boot time
+    if (program.isEnabled && !changeStartupProgramStates(QList<StartupProgram>() << program, false))
+        return;
 
-    for (const auto &program : m_startupPrograms)
+    // Disabling may move the entry (startup folder items go to "Disabled"), so
+    // the launcher gets the command its source lists for the disabled copy
+    DelayedStartEntry entry;
+    entry.name = program.name;
+    entry.command = program.command;
+    entry.startupType = program.startupType;
+    entry.source = program.source;
+    if (const StartupSource *source = findSource(program.source))
     {
-        if (program.isEnabled)
+        for (const StartupProgram &listed : source->scan())
         {
-            if (program.impact == "High")
+            if (!listed.isEnabled && listed.name.compare(program.name, Qt::CaseInsensitive) == 0)
             {
-                totalImpact += 1.5;
-            }
-            else if (program.impact == "Medium")
-            {
-                totalImpact += 0.8;
-            }
-            else
-            {
-                totalImpact += 0.3;
+                entry.command = listed.command;
+                break;
             }
         }
     }
 
-    return totalImpact;
-}
-
+    // Light programs first, so the desktop becomes usable sooner
+    entry.priority = program.impact == "Low" ? 0 : program.impact == "High" ? 2 : 1;
 
-void StartupManager::debugActualRegistryState()
-{
-    qDebug() << "=== ACTUAL REGISTRY STATE ===";
-    
-    // Check HKEY_CURRENT_USER
-    QSettings hkcuRun("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-    QStringList hkcuKeys = hkcuRun.childKeys();
-    qDebug() << "HKCU Run (" << hkcuKeys.size() << "items):";
-    for (const QString &key : hkcuKeys) {
-        QString value = hkcuRun.value(key).toString();
-        qDebug() << "  " << key << "=" << value;
-    }
-    
-    // Check HKEY_LOCAL_MACHINE  
-    QSettings hklmRun("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
-    QStringList hklmKeys = hklmRun.childKeys();
-    qDebug() << "HKLM Run (" << hklmKeys.size() << "items):";
-    for (const QString &key : hklmKeys) {
-        QString value = hklmRun.value(key).toString();
-        qDebug() << "  " << key << "=" << value;
-    }
-    
-    // Check Disabled keys
-    QSettings hkcuDisabled("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-    QSettings hklmDisabled("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\RunDisabled", QSettings::NativeFormat);
-    
-    qDebug() << "HKCU Disabled:" << hkcuDisabled.childKeys();
-    qDebug() << "HKLM Disabled:" << hklmDisabled.childKeys();
-    qDebug() << "=== END REGISTRY STATE ===";
-}
\ No newline at end of file
+    m_delayedStart.add(entry);
+    if (saveDelayedStart())
+        QMessageBox::information(m_mainWindow, "Success",
+                                 QString("'%1' will be started by the delayed start launcher.").arg(program.name));
+    refreshStartupPrograms();
+}
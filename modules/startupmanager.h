@@ -6,20 +6,12 @@
 #include <QPushButton>
 #include <QLabel>
 #include <QList>
-#include <QDir>
+#include <QFutureWatcher>
+#include "../utils/startupsource.h"
+#include "../utils/delayedstartlist.h"
 
 class MainWindow;
-
-struct StartupProgram
-{
-    QString name;
-    QString status;      // "Enabled" or "Disabled"
-    QString impact;      // "High", "Medium", "Low"
-    QString startupType; // "Registry", "Startup Folder", "Service", "Scheduled Task"
-    QString command;
-    QString location;
-    bool isEnabled;
-};
+class StartupImpactSampler;
 
 class StartupManager : public QObject
 {
@@ -31,54 +23,61 @@ public:
 
     void initialize();
     void refreshStartupPrograms();
-    void disableSelectedProgram();
-    void enableSelectedProgram();
+    // Both act on every selected row as one batch
+    void disableSelectedPrograms();
+    void enableSelectedPrograms();
+    // Moves the selected entry under the delayed start launcher
+    void delaySelectedProgram();
     void onStartupTableSelectionChanged();
 
+    // Reads Run keys from offline hive files (e.g. a mounted image's SOFTWARE
+    // and NTUSER.DAT) instead of the live registry; empty paths switch back.
+    // Programs listed this way are read-only.
+    void setOfflineHives(const QString &softwareHivePath, const QString &userHivePath);
+    // Asks for a mounted image and lists its Run keys, or switches back to the live system
+    void openOfflineImage();
+
 private slots:
     void onDisableButtonClicked();
     void onEnableButtonClicked();
+    void onDelayButtonClicked();
+    void onOfflineButtonClicked();
+    void onMeasureAtLogonToggled(bool checked);
+    void onImpactsUpdated();
+    void onScanFinished();
 
 private:
     MainWindow *m_mainWindow;
     QList<StartupProgram> m_startupPrograms;
+    QList<StartupSource *> m_sources;
+    bool m_offline;
+    StartupImpactSampler *m_impactSampler;
+    QFutureWatcher<QList<StartupProgram>> *m_scanWatcher;
+    bool m_rescanPending;
+    DelayedStartList m_delayedStart;
 
     void setupConnections();
+    void setSources(const QList<StartupSource *> &sources);
+    QList<StartupProgram> scanSources() const;
+    static void applyLaunchHistory(QList<StartupProgram> &programs);
+    static void applyBootCriticalPath(QList<StartupProgram> &programs);
     void populateTable();
     void updateButtonStates();
     void updateImpactLabel();
-    QList<StartupProgram> getRealStartupPrograms();
-    bool changeStartupProgramState(const QString &programName, const QString &location, const QString &startupType, bool enable);
+    void updateMeasureAtLogon();
+    bool changeStartupProgramStates(const QList<StartupProgram> &programs, bool enable);
+    const StartupSource *findSource(const QString &id) const;
+    bool canDelay(const StartupProgram &program) const;
+    void applyDelayedStart();
+    bool saveDelayedStart();
     double calculateBootImpact();
 
-    void scanRegistryStartup(QList<StartupProgram> &programs, const QString &registryPath,
-                             const QString &startupType, const QString &location);
-    void scanStartupFolders(QList<StartupProgram> &programs);
-    void scanStartupFolder(QList<StartupProgram> &programs, QDir &startupFolder, const QString &startupType, const QString &location);
-    void scanServices(QList<StartupProgram> &programs);
-    void scanScheduledTasks(QList<StartupProgram> &programs);
-    QString calculateProgramImpact(const QString &programName, const QString &command);
+    void applyMeasuredImpact();
+    static QTableWidgetItem *createImpactItem(const StartupProgram &program);
     void removeDuplicates(QList<StartupProgram> &programs);
     void sortProgramsByName(QList<StartupProgram> &programs);
-
-    bool isProgramEnabledInTaskManager(const QString &programName, const QString &registryPath, const QString &value);
-
-
-    void debugActualRegistryState();
-
-
-    // Real implementation methods for changing startup states
-    bool changeRegistryStartupState(const QString &programName, const QString &registryPath, bool enable);
-    bool changeStartupFolderState(const QString &programName, const QString &folderPath, bool enable);
-    bool changeServiceState(const QString &programName, bool enable);
-    bool changeScheduledTaskState(const QString &programName, bool enable);
-    bool shouldSkipProgram(const QString &name, const QString &command);
-    // Helper method for service filtering
-    bool isUserService(const QString &serviceName);
-
-    bool setWindowsStartupState(const QString &programName, const QString &registryPath, bool enable);
-    bool setUserStartupState(const QString &programName, bool enable);
-    bool setSystemStartupState(const QString &programName, bool enable);
+    int selectedProgramIndex() const;
+    QList<StartupProgram> selectedPrograms() const;
 };
 
 #endif // STARTUPMANAGER_H
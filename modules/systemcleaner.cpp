@@ -7,60 +7,115 @@
 #include <QtConcurrent/QtConcurrent>
 #include <QListWidgetItem>
 #include <QProgressDialog>
-#include <QApplication>
-#include <QThread>
 #include <QRegularExpression>
 
 SystemCleaner::SystemCleaner(MainWindow *mainWindow, QObject *parent)
-    : QObject(parent), m_mainWindow(mainWindow), m_isScanning(false), m_isSystemScanning(false)
+    : QObject(parent), m_mainWindow(mainWindow), m_cleanProgress(nullptr), m_isQuickCleaning(false),
+      m_cleanCategoryIndex(0), m_cleanCategoryCount(0), m_isScanning(false)
 {
-    m_scanWatcher = new QFutureWatcher<QVector<double>>(this);
-    m_systemScanWatcher = new QFutureWatcher<QVector<double>>(this);
+    m_windowsUtils = new WindowsUtils(this);
+    m_quickCache = new CleanCategoryCache("quick_clean", m_windowsUtils->cleanerItems(), this);
+    m_systemCache = new CleanCategoryCache("system_clean", m_windowsUtils->systemCleanerItems(), this);
+    m_cleaningPipeline = new CleaningPipeline(this);
     setupConnections();
+
+    // Totals from the previous session are shown until the caches revalidate them
+    m_quickCache->load();
+    m_systemCache->load();
 }
 
 SystemCleaner::~SystemCleaner()
 {
-    delete m_scanWatcher;
-    delete m_systemScanWatcher;
+    m_cleaningPipeline->cancel();
+    delete m_cleaningPipeline;
+    delete m_quickCache;
+    delete m_systemCache;
 }
 
 void SystemCleaner::setupConnections()
 {
-    connect(m_scanWatcher, &QFutureWatcher<QVector<double>>::finished,
+    connect(m_quickCache, &CleanCategoryCache::refreshStarted,
+            this, &SystemCleaner::onQuickScanStarted);
+    connect(m_quickCache, &CleanCategoryCache::refreshFinished,
             this, &SystemCleaner::onQuickScanFinished);
-    connect(m_systemScanWatcher, &QFutureWatcher<QVector<double>>::finished,
+    connect(m_systemCache, &CleanCategoryCache::refreshStarted,
+            this, &SystemCleaner::onSystemScanStarted);
+    connect(m_systemCache, &CleanCategoryCache::refreshFinished,
             this, &SystemCleaner::onSystemScanFinished);
+
+    connect(m_cleaningPipeline, &CleaningPipeline::categoryStarted,
+            this, [this](const QString &, int index, int count)
+            {
+                m_cleanCategoryIndex = index;
+                m_cleanCategoryCount = count; });
+    connect(m_cleaningPipeline, &CleaningPipeline::progressUpdated,
+            this, &SystemCleaner::onCleaningProgress);
+    connect(m_cleaningPipeline, &CleaningPipeline::finished,
+            this, &SystemCleaner::onCleaningFinished);
+}
+
+void SystemCleaner::showCachedResults()
+{
+    // Show the cached totals right away, then refresh only what changed
+    if (!m_quickCache->manifest().isEmpty() && !m_cleaningPipeline->isRunning())
+    {
+        QDateTime scannedAt = m_quickCache->manifest().createdAt();
+        updateQuickScanResults(QString("Last scanned %1").arg(scannedAt.toString("yyyy-MM-dd hh:mm")));
+    }
+
+    if (!m_systemCache->manifest().isEmpty() && !m_cleaningPipeline->isRunning())
+    {
+        updateSystemScanResults();
+    }
+
+    m_quickCache->setAutoRefresh(true);
+    m_systemCache->setAutoRefresh(true);
+}
+
+void SystemCleaner::suspendBackgroundRefresh()
+{
+    // Watches keep marking categories dirty; they are refreshed when the page is shown again
+    m_quickCache->setAutoRefresh(false);
+    m_systemCache->setAutoRefresh(false);
 }
 
 void SystemCleaner::performQuickScan()
 {
-    if (m_isScanning)
+    if (m_quickCache->isRefreshing() || m_cleaningPipeline->isRunning())
     {
         m_mainWindow->ui->quickCleanResults->setPlainText("Scan already in progress...");
         return;
     }
 
-    m_mainWindow->ui->quickCleanResults->setPlainText("Scanning for junk files...\n(You can navigate to other tabs while scanning)");
-    m_mainWindow->ui->scanQuickButton->setEnabled(false);
-    m_mainWindow->ui->cleanQuickButton->setEnabled(false);
-    m_mainWindow->ui->quickCleanProgressBar->setValue(0);
-
     m_isScanning = true;
 
-    // Start the scan in background thread using lambda
-    QFuture<QVector<double>> future = QtConcurrent::run([]()
-                                                        { return SystemCleaner::performScan(); });
-
-    m_scanWatcher->setFuture(future);
+    // An explicit scan rebuilds every category; only background refreshes trust the mtimes
+    m_quickCache->invalidateAll();
+    m_quickCache->refresh();
 }
 
 void SystemCleaner::performQuickClean()
 {
+    if (m_cleaningPipeline->isRunning())
+    {
+        return;
+    }
+
+    CleanManifest manifest = m_quickCache->manifest();
+    if (manifest.isEmpty())
+    {
+        QMessageBox::information(m_mainWindow, "Quick Clean", "Please run a scan first.");
+        return;
+    }
+
+    QStringList categories = manifest.categories();
+
     QMessageBox::StandardButton reply;
     reply = QMessageBox::question(m_mainWindow, "Confirm Clean",
-                                  "This will delete temporary files, cache, and other junk files.\n\n"
-                                  "Are you sure you want to continue?",
+                                  QString("This will delete %1 files found by the last scan (%2).\n\n"
+                                          "Are you sure you want to continue?")
+                                      .arg(manifest.fileCount(categories))
+                                      .arg(CleanManifest::formatSize(manifest.totalSize(categories))),
                                   QMessageBox::Yes | QMessageBox::No);
 
     if (reply == QMessageBox::No)
@@ -68,55 +123,20 @@ void SystemCleaner::performQuickClean()
         return;
     }
 
-    m_mainWindow->ui->quickCleanResults->append("\n\nCleaning in progress...");
+    m_mainWindow->ui->quickCleanResults->append("\n\nCleaning in progress...\n(You can navigate to other tabs while cleaning)");
     m_mainWindow->ui->cleanQuickButton->setEnabled(false);
+    m_mainWindow->ui->scanQuickButton->setEnabled(false);
+    m_mainWindow->ui->quickCleanProgressBar->setValue(0);
 
-    QProcess process;
-
-    // Clean temporary files
-    process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path $env:TEMP -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } "
-                                                               "catch { Write-Warning \"Failed to remove: $($_.FullName)\" } "
-                                                               "}");
-    process.waitForFinished();
-
-    // Clean Windows Temp
-    process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\Temp' -Recurse -File -ErrorAction SilentlyContinue | Where-Object { "
-                                                               "$_.CreationTime -lt (Get-Date).AddDays(-1) } | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-    process.waitForFinished();
-
-    // Clean Memory Dump Files
-    process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\*.dmp' -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }; "
-                                                               "Get-ChildItem -Path 'C:\\Windows\\LiveKernelReports\\*.dmp' -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-    process.waitForFinished();
-
-    // Clean Thumbnail Cache (this requires Explorer restart)
-    process.start("powershell", QStringList() << "-Command" << "Stop-Process -Name 'explorer' -Force -ErrorAction SilentlyContinue; "
-                                                               "Start-Sleep -Seconds 2; "
-                                                               "Get-ChildItem -Path '$env:LOCALAPPDATA\\Microsoft\\Windows\\Explorer\\thumbcache_*.db' -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }; ");
-    process.waitForFinished();
-
-    // Clean Prefetch Files (only old ones)
-    process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\Prefetch\\*.pf' -ErrorAction SilentlyContinue | Where-Object { "
-                                                               "$_.LastWriteTime -lt (Get-Date).AddDays(-7) } | ForEach-Object { "
-                                                               "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-    process.waitForFinished();
-
-    m_mainWindow->ui->quickCleanResults->append("Cleaning completed! Rescanning to verify...");
-    m_mainWindow->ui->spaceSavedLabel->setText("Cleaning process finished");
-
-    // Rescan after a delay to show new sizes
-    QTimer::singleShot(3000, this, [this]()
-                       { performQuickScan(); });
+    // Apply exactly what the scan found on the cleaning pipeline's worker thread
+    m_isQuickCleaning = true;
+    m_cleanCategoryCount = 0;
+    m_cleaningPipeline->start(manifest, categories);
 }
 
 void SystemCleaner::performSystemScan()
 {
-    if (m_isSystemScanning)
+    if (m_systemCache->isRefreshing() || m_cleaningPipeline->isRunning())
     {
         return;
     }
@@ -124,31 +144,8 @@ void SystemCleaner::performSystemScan()
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
 
-    QListWidget *systemList = m_mainWindow->ui->systemCleanerList;
-    if (!systemList)
-        return;
-
-    // Show scanning message - remove checkmarks during scan
-    for (int i = 0; i < systemList->count(); ++i)
-    {
-        QListWidgetItem *item = systemList->item(i);
-        QString text = item->text();
-        // Remove any existing checkmark and show scanning
-        text.replace("✅", "");
-        text.replace("❌", "");
-        text.replace(QRegularExpression("\\(.*\\)"), "(Scanning...)");
-        item->setText(text);
-    }
-
-    m_mainWindow->ui->scanSystemButton->setEnabled(false);
-    m_mainWindow->ui->cleanSystemButton->setEnabled(false);
-    m_isSystemScanning = true;
-
-    // Start system scan in background
-    QFuture<QVector<double>> future = QtConcurrent::run([]()
-                                                        { return SystemCleaner::performSystemScanInternal(); });
-
-    m_systemScanWatcher->setFuture(future);
+    m_systemCache->invalidateAll();
+    m_systemCache->refresh();
 }
 
 void SystemCleaner::performSystemClean()
@@ -160,41 +157,12 @@ void SystemCleaner::performSystemClean()
     if (!systemList)
         return;
 
-    // Get selected items - now we'll check which items have checkmarks
-    QList<QListWidgetItem *> itemsToClean;
-    double totalSelectedSize = 0;
-
-    for (int i = 0; i < systemList->count(); ++i)
-    {
-        QListWidgetItem *item = systemList->item(i);
-        QString itemText = item->text();
-
-        // Check if item has checkmark (✅) and extract size
-        if (itemText.contains("✅"))
-        {
-            itemsToClean.append(item);
-
-            // Extract size for total calculation
-            QRegularExpression sizeRegex("\\(([0-9.]+) ([KMG]B)\\)");
-            QRegularExpressionMatch match = sizeRegex.match(itemText);
-
-            if (match.hasMatch())
-            {
-                double size = match.captured(1).toDouble();
-                QString unit = match.captured(2);
-
-                // Convert to MB for total
-                if (unit == "KB")
-                    size /= 1024;
-                else if (unit == "GB")
-                    size *= 1024;
+    if (m_cleaningPipeline->isRunning())
+        return;
 
-                totalSelectedSize += size;
-            }
-        }
-    }
+    QStringList categoriesToClean = selectedSystemCategories();
 
-    if (itemsToClean.isEmpty())
+    if (categoriesToClean.isEmpty())
     {
         QMessageBox::information(m_mainWindow, "System Cleaner",
                                  "Please select items to clean by clicking on them first.\n\n"
@@ -202,24 +170,16 @@ void SystemCleaner::performSystemClean()
         return;
     }
 
-    // Show confirmation dialog with selected items
-    QString confirmationText = QString("This will delete the following %1 selected items:\n\n").arg(itemsToClean.size());
+    // Show confirmation dialog with a dry-run preview of the manifest
+    CleanManifest manifest = m_systemCache->manifest();
+    QString confirmationText = QString("This will delete %1 files from the following %2 selected items:\n\n")
+                                   .arg(manifest.fileCount(categoriesToClean))
+                                   .arg(categoriesToClean.size());
 
-    for (int i = 0; i < itemsToClean.size() && i < 5; ++i)
-    {
-        QString itemText = itemsToClean[i]->text();
-        // Clean up the text for display
-        itemText = itemText.replace("✅", "").replace("❌", "").trimmed();
-        confirmationText += "• " + itemText + "\n";
-    }
-
-    if (itemsToClean.size() > 5)
-    {
-        confirmationText += QString("• ... and %1 more items\n").arg(itemsToClean.size() - 5);
-    }
+    confirmationText += manifest.preview(categoriesToClean, 2);
 
-    confirmationText += QString("\nTotal size: %1 MB\n\nAre you sure you want to continue?")
-                            .arg(totalSelectedSize, 0, 'f', 1);
+    confirmationText += QString("\nTotal size: %1\n\nAre you sure you want to continue?")
+                            .arg(CleanManifest::formatSize(manifest.totalSize(categoriesToClean)));
 
     QMessageBox::StandardButton reply;
     reply = QMessageBox::question(m_mainWindow, "Confirm System Clean",
@@ -231,200 +191,184 @@ void SystemCleaner::performSystemClean()
         return;
     }
 
-    // Show cleaning progress
-    QProgressDialog progress("Cleaning selected system files...", "Cancel", 0, itemsToClean.size(), m_mainWindow);
-    progress.setWindowModality(Qt::WindowModal);
-    progress.show();
-
-    double totalCleaned = 0;
-    QProcess process;
-
-    for (int i = 0; i < itemsToClean.size(); ++i)
-    {
-        if (progress.wasCanceled())
-            break;
+    m_mainWindow->ui->cleanSystemButton->setEnabled(false);
+    m_mainWindow->ui->scanSystemButton->setEnabled(false);
 
-        QListWidgetItem *item = itemsToClean[i];
-        QString itemText = item->text();
+    // Non-modal progress so the rest of the window stays usable while cleaning
+    m_cleanProgress = new QProgressDialog("Cleaning selected system files...", "Cancel", 0, 1000, m_mainWindow);
+    m_cleanProgress->setWindowModality(Qt::NonModal);
+    m_cleanProgress->setAutoClose(false);
+    m_cleanProgress->setAutoReset(false);
+    m_cleanProgress->setMinimumDuration(0);
+    connect(m_cleanProgress, &QProgressDialog::canceled, this, [this]()
+            {
+        m_cleaningPipeline->cancel();
+        if (m_cleanProgress)
+            m_cleanProgress->setLabelText("Cancelling..."); });
+    m_cleanProgress->show();
+
+    m_isQuickCleaning = false;
+    m_cleanCategoryCount = 0;
+    m_cleaningPipeline->start(manifest, categoriesToClean);
+}
 
-        // Extract size from item text for reporting
-        QRegularExpression sizeRegex("\\(([0-9.]+) ([KMG]B)\\)");
-        QRegularExpressionMatch match = sizeRegex.match(itemText);
+void SystemCleaner::onCleaningProgress(const QString &category, int filesDone, int filesTotal,
+                                       qint64 bytesFreed, qint64 bytesTotal)
+{
+    if (m_cleanCategoryCount <= 0)
+        return;
 
-        if (match.hasMatch())
-        {
-            double size = match.captured(1).toDouble();
-            QString unit = match.captured(2);
+    // Overall progress: finished categories plus the fraction of the current one
+    double categoryFraction = filesTotal > 0 ? double(filesDone) / filesTotal : 1.0;
+    double overall = (m_cleanCategoryIndex + categoryFraction) / m_cleanCategoryCount;
 
-            // Convert to MB for total
-            if (unit == "KB")
-                size /= 1024;
-            else if (unit == "GB")
-                size *= 1024;
+    QString status = QString("Cleaning %1 (%2 of %3)\n%4 / %5 files, %6 of %7 freed")
+                         .arg(category)
+                         .arg(m_cleanCategoryIndex + 1)
+                         .arg(m_cleanCategoryCount)
+                         .arg(filesDone)
+                         .arg(filesTotal)
+                         .arg(CleanManifest::formatSize(bytesFreed))
+                         .arg(CleanManifest::formatSize(bytesTotal));
 
-            totalCleaned += size;
-        }
+    if (m_isQuickCleaning)
+    {
+        m_mainWindow->ui->quickCleanProgressBar->setValue(int(overall * 100));
+        m_mainWindow->ui->spaceSavedLabel->setText(status.replace("\n", " - "));
+    }
+    else if (m_cleanProgress && !m_cleanProgress->wasCanceled())
+    {
+        m_cleanProgress->setValue(int(overall * 1000));
+        m_cleanProgress->setLabelText(status);
+    }
+}
 
-        // Clean based on category
-        if (itemText.contains("Temporary Files"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path $env:TEMP, 'C:\\Windows\\Temp' -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Windows Update Cache"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\SoftwareDistribution\\Download' -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("System Log Files"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\Logs' -Recurse -File -ErrorAction SilentlyContinue | Where-Object { "
-                                                                       "$_.LastWriteTime -lt (Get-Date).AddDays(-30) } | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Memory Dump Files"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\*.dmp', 'C:\\Windows\\LiveKernelReports\\*.dmp' -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Thumbnail Cache"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Stop-Process -Name 'explorer' -Force -ErrorAction SilentlyContinue; "
-                                                                       "Start-Sleep -Seconds 2; "
-                                                                       "Get-ChildItem -Path '$env:LOCALAPPDATA\\Microsoft\\Windows\\Explorer\\thumbcache_*.db' -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }; ");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Error Reports"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\ProgramData\\Microsoft\\Windows\\WER', '$env:LOCALAPPDATA\\Microsoft\\Windows\\WER' -Recurse -File -ErrorAction SilentlyContinue | Where-Object { "
-                                                                       "$_.LastWriteTime -lt (Get-Date).AddDays(-7) } | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Recycle Bin"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Clear-RecycleBin -Force -ErrorAction SilentlyContinue");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Prefetch Files"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path 'C:\\Windows\\Prefetch\\*.pf' -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Font Cache"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\FontCache\" -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Delivery Optimization"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\DeliveryOptimization\" -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Error Reporting Archive"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\WER\\ReportArchive\" -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
-        else if (itemText.contains("Windows Defender Scans"))
-        {
-            process.start("powershell", QStringList() << "-Command" << "Get-ChildItem -Path \"C:\\ProgramData\\Microsoft\\Windows Defender\\Scans\" -Recurse -File -ErrorAction SilentlyContinue | ForEach-Object { "
-                                                                       "try { Remove-Item $_.FullName -Force -ErrorAction Stop } catch { } }");
-            process.waitForFinished();
-        }
+void SystemCleaner::onCleaningFinished(bool canceled)
+{
+    CleaningOutcome outcome = m_cleaningPipeline->outcome();
+    CleanCategoryCache *cache = m_isQuickCleaning ? m_quickCache : m_systemCache;
 
-        // Update progress
-        progress.setValue(i + 1);
-        QApplication::processEvents();
-        QThread::msleep(300);
-    }
+    // The pipeline's manifest only holds what is still on disk; the cleaned
+    // categories are then rescanned on their own instead of the whole set
+    cache->mergeCategories(outcome.manifest, outcome.cleanedCategories);
+    cache->invalidate(outcome.cleanedCategories);
 
-    progress.close();
+    const CleanApplyResult &total = outcome.totals;
+    QString freedText = CleanManifest::formatSize(total.bytesFreed);
 
-    // Show completion message
-    QString sizeText;
-    if (totalCleaned < 1)
+    if (m_isQuickCleaning)
     {
-        sizeText = QString("%1 KB").arg(int(totalCleaned * 1024));
+        updateQuickScanResults(QString("%1 Freed %2 (%3 files deleted, %4 changed since scan, %5 in use).")
+                                   .arg(canceled ? "Cleaning cancelled." : "Cleaning completed!")
+                                   .arg(freedText)
+                                   .arg(total.filesDeleted)
+                                   .arg(total.filesSkipped)
+                                   .arg(total.filesFailed));
+        m_mainWindow->ui->spaceSavedLabel->setText(QString("Space freed: %1").arg(freedText));
+        m_mainWindow->ui->scanQuickButton->setEnabled(true);
+        m_mainWindow->ui->quickCleanProgressBar->setValue(100);
+        cache->refresh();
+        return;
     }
-    else if (totalCleaned < 1024)
+
+    if (m_cleanProgress)
     {
-        sizeText = QString("%1 MB").arg(totalCleaned, 0, 'f', 1);
+        m_cleanProgress->close();
+        m_cleanProgress->deleteLater();
+        m_cleanProgress = nullptr;
     }
-    else
+
+    QString message = canceled ? QString("Cleaning cancelled. %1 of data was cleaned before stopping.").arg(freedText)
+                               : QString("Successfully cleaned %1 of data!").arg(freedText);
+    if (total.filesSkipped > 0 || total.filesFailed > 0)
     {
-        sizeText = QString("%1 GB").arg(totalCleaned / 1024, 0, 'f', 1);
+        message += QString("\n\n%1 files changed since the scan and were kept.\n%2 files were in use and could not be deleted.")
+                       .arg(total.filesSkipped)
+                       .arg(total.filesFailed);
     }
 
-    QMessageBox::information(m_mainWindow, "System Cleaner",
-                             QString("Successfully cleaned %1 of data!").arg(sizeText));
+    // The manifest already reflects what is left, so show it before the refresh confirms it
+    updateSystemScanResults();
+    cache->refresh();
 
-    // Reset the UI
-    m_mainWindow->ui->cleanSystemButton->setEnabled(false);
+    QMessageBox::information(m_mainWindow, "System Cleaner", message);
+}
 
-    // Rescan to show new sizes
-    performSystemScan();
+void SystemCleaner::onQuickScanStarted()
+{
+    // A finished clean keeps its summary while the cleaned categories are rescanned
+    if (!m_isScanning)
+        return;
+
+    m_mainWindow->ui->quickCleanResults->setPlainText("Scanning for junk files...\n(You can navigate to other tabs while scanning)");
+    m_mainWindow->ui->scanQuickButton->setEnabled(false);
+    m_mainWindow->ui->cleanQuickButton->setEnabled(false);
+    m_mainWindow->ui->quickCleanProgressBar->setValue(0);
 }
 
 void SystemCleaner::onQuickScanFinished()
 {
-    m_isScanning = false;
-
-    // Get results from the future
-    QVector<double> results = m_scanWatcher->result();
+    if (m_cleaningPipeline->isRunning() && m_isQuickCleaning)
+        return;
 
-    if (results.size() >= 6)
+    if (m_isScanning)
     {
-        double tempSize = results[0];
-        double updateSize = results[1];
-        double logSize = results[2];
-        double dumpSize = results[3];
-        double thumbSize = results[4];
-        double prefetchSize = results[5];
-
-        double totalSize = tempSize + updateSize + logSize + dumpSize + thumbSize + prefetchSize;
-
-        QString resultsText = QString("Scanning completed!\n\n"
-                                      "• Temporary Files: %1 MB\n"
-                                      "• Windows Update Cache: %2 MB\n"
-                                      "• System Log Files: %3 MB\n"
-                                      "• Memory Dump Files: %4 MB\n"
-                                      "• Thumbnail Cache: %5 MB\n"
-                                      "• Prefetch Files: %6 MB\n\n"
-                                      "Total: %7 MB")
-                                  .arg(tempSize, 0, 'f', 1)
-                                  .arg(updateSize, 0, 'f', 1)
-                                  .arg(logSize, 0, 'f', 1)
-                                  .arg(dumpSize, 0, 'f', 1)
-                                  .arg(thumbSize, 0, 'f', 1)
-                                  .arg(prefetchSize, 0, 'f', 1)
-                                  .arg(totalSize, 0, 'f', 1);
-
-        m_mainWindow->ui->quickCleanResults->setPlainText(resultsText);
-        m_mainWindow->ui->spaceSavedLabel->setText(QString("Total space to be freed: %1 MB").arg(totalSize, 0, 'f', 1));
-        m_mainWindow->ui->cleanQuickButton->setEnabled(totalSize > 0);
+        m_isScanning = false;
+        m_quickHeader = "Scanning completed!";
     }
 
+    updateQuickScanResults(m_quickHeader);
+
     m_mainWindow->ui->scanQuickButton->setEnabled(true);
     m_mainWindow->ui->quickCleanProgressBar->setValue(100);
 }
 
+void SystemCleaner::updateQuickScanResults(const QString &header)
+{
+    m_quickHeader = header;
+    CleanManifest manifest = m_quickCache->manifest();
+    QString resultsText = header + "\n\n";
+
+    for (const QString &name : manifest.categories())
+    {
+        double sizeMB = manifest.totalSize(QStringList{name}) / (1024.0 * 1024.0);
+        resultsText += QString("• %1: %2 MB\n").arg(name).arg(sizeMB, 0, 'f', 1);
+    }
+
+    double totalSize = manifest.totalSize() / (1024.0 * 1024.0);
+    resultsText += QString("\nTotal: %1 MB").arg(totalSize, 0, 'f', 1);
+
+    m_mainWindow->ui->quickCleanResults->setPlainText(resultsText);
+    m_mainWindow->ui->spaceSavedLabel->setText(QString("Total space to be freed: %1 MB").arg(totalSize, 0, 'f', 1));
+    m_mainWindow->ui->cleanQuickButton->setEnabled(manifest.totalSize() > 0);
+}
+
+void SystemCleaner::onSystemScanStarted(const QStringList &categories)
+{
+    QListWidget *systemList = m_mainWindow->ui->systemCleanerList;
+    QList<CleanerItem> items = m_windowsUtils->systemCleanerItems();
+
+    // Only the rows being rescanned change; selections are kept
+    for (int i = 0; i < systemList->count() && i < items.size(); ++i)
+    {
+        if (!categories.contains(items[i].name()))
+            continue;
+
+        QListWidgetItem *item = systemList->item(i);
+        QString text = item->text();
+        text.replace(QRegularExpression("\\(.*\\)"), "(Scanning...)");
+        item->setText(text);
+    }
+
+    m_mainWindow->ui->scanSystemButton->setEnabled(false);
+}
+
 void SystemCleaner::onSystemScanFinished()
 {
-    m_isSystemScanning = false;
+    if (m_cleaningPipeline->isRunning() && !m_isQuickCleaning)
+        return;
 
-    // Get results from the future
-    QVector<double> results = m_systemScanWatcher->result();
-    updateSystemScanResults(results);
+    updateSystemScanResults();
 }
 
 void SystemCleaner::updateScanProgress(int value)
@@ -432,133 +376,25 @@ void SystemCleaner::updateScanProgress(int value)
     m_mainWindow->ui->quickCleanProgressBar->setValue(value);
 }
 
-QVector<double> SystemCleaner::performScan()
+QStringList SystemCleaner::selectedSystemCategories() const
 {
-    QVector<double> results;
-    results.resize(6);
-
-    QProcess process;
-
-    // Get temporary files size
-    process.start("powershell", QStringList() << "-Command" << "(Get-ChildItem $env:TEMP -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB");
-    process.waitForFinished();
-    results[0] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Get Windows Update cache size
-    process.start("powershell", QStringList() << "-Command" << "(Get-ChildItem 'C:\\Windows\\Temp' -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB");
-    process.waitForFinished();
-    results[1] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Get system log files size
-    process.start("powershell", QStringList() << "-Command" << "(Get-ChildItem 'C:\\Windows\\Logs' -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB");
-    process.waitForFinished();
-    results[2] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Get memory dump files size
-    process.start("powershell", QStringList() << "-Command" << "((Get-ChildItem 'C:\\Windows\\*.dmp' -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum + (Get-ChildItem 'C:\\Windows\\LiveKernelReports\\*.dmp' -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum) / 1MB");
-    process.waitForFinished();
-    results[3] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Get thumbnail cache size
-    process.start("powershell", QStringList() << "-Command" << "(Get-ChildItem \"$env:LOCALAPPDATA\\Microsoft\\Windows\\Explorer\\thumbcache_*.db\" -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB");
-    process.waitForFinished();
-    results[4] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Get prefetch files size
-    process.start("powershell", QStringList() << "-Command" << "(Get-ChildItem 'C:\\Windows\\Prefetch\\*.pf' -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB");
-    process.waitForFinished();
-    results[5] = process.readAllStandardOutput().trimmed().toDouble();
-
-    return results;
-}
+    QStringList categories;
+    QListWidget *systemList = m_mainWindow->ui->systemCleanerList;
 
-QVector<double> SystemCleaner::performSystemScanInternal()
-{
-    QVector<double> results;
-    results.resize(12);
-
-    QProcess process;
-
-    // 1. Temporary Files (%TEMP% and Windows Temp)
-    process.start("powershell", QStringList() << "-Command" << "try { ((Get-ChildItem -Path $env:TEMP -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum + "
-                                                               "(Get-ChildItem -Path 'C:\\Windows\\Temp' -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum) / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[0] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 2. Windows Update Cache
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path 'C:\\Windows\\SoftwareDistribution\\Download' -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[1] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 3. System Log Files (only old logs > 30 days)
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path 'C:\\Windows\\Logs' -Recurse -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-30) } | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[2] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 4. Memory Dump Files
-    process.start("powershell", QStringList() << "-Command" << "try { ((Get-ChildItem -Path 'C:\\Windows\\*.dmp' -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum + "
-                                                               "(Get-ChildItem -Path 'C:\\Windows\\LiveKernelReports\\*.dmp' -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum) / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[3] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 5. Thumbnail Cache
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\Explorer\\thumbcache_*.db\" -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[4] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 6. Error Reports
-    process.start("powershell", QStringList() << "-Command" << "try { ((Get-ChildItem -Path 'C:\\ProgramData\\Microsoft\\Windows\\WER' -Recurse -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-7) } | Measure-Object -Property Length -Sum).Sum + "
-                                                               "(Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\WER\" -Recurse -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-7) } | Measure-Object -Property Length -Sum).Sum) / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[5] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 7. Recycle Bin - Use COM object to get accurate size
-    process.start("powershell", QStringList() << "-Command" << "try { "
-                                                               "$shell = New-Object -ComObject Shell.Application; "
-                                                               "$recycleBin = $shell.NameSpace(0x0a); "
-                                                               "$totalSize = 0; "
-                                                               "foreach ($item in $recycleBin.Items()) { $totalSize += $item.Size }; "
-                                                               "$totalSize / 1MB "
-                                                               "} catch { 0 }");
-    process.waitForFinished();
-    results[6] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 8. Windows Prefetch
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path 'C:\\Windows\\Prefetch\\*.pf' -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-7) } | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[7] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 9. Windows Font Cache
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\FontCache\" -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[8] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 10. Delivery Optimization Files
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\DeliveryOptimization\\Cache\" -Recurse -File -ErrorAction SilentlyContinue | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[9] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 11. Windows Error Reporting Archive
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path \"$env:LOCALAPPDATA\\Microsoft\\Windows\\WER\\ReportArchive\" -Recurse -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-7) } | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[10] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // 12. Windows Defender Scans
-    process.start("powershell", QStringList() << "-Command" << "try { (Get-ChildItem -Path \"C:\\ProgramData\\Microsoft\\Windows Defender\\Scans\\History\" -Recurse -File -ErrorAction SilentlyContinue | Where-Object { $_.LastWriteTime -lt (Get-Date).AddDays(-30) } | Measure-Object -Property Length -Sum).Sum / 1MB } catch { 0 }");
-    process.waitForFinished();
-    results[11] = process.readAllStandardOutput().trimmed().toDouble();
-
-    // Debug: Print results to console
-    qDebug() << "Scan results:";
-    for (int i = 0; i < results.size(); ++i)
+    for (int i = 0; i < systemList->count(); ++i)
     {
-        qDebug() << "Category" << i << ":" << results[i] << "MB";
+        QListWidgetItem *item = systemList->item(i);
+        QString category = item->data(Qt::UserRole).toString();
+        if (item->text().contains("✅") && !category.isEmpty())
+        {
+            categories.append(category);
+        }
     }
 
-    return results;
+    return categories;
 }
 
-void SystemCleaner::updateSystemScanResults(const QVector<double> &results)
+void SystemCleaner::updateSystemScanResults()
 {
     if (!m_mainWindow || !m_mainWindow->ui)
         return;
@@ -567,60 +403,40 @@ void SystemCleaner::updateSystemScanResults(const QVector<double> &results)
     if (!systemList)
         return;
 
-    // Define category names matching your UI - now with more options
-    QStringList categories = {
-        "Temporary Files",
-        "Windows Update Cache",
-        "System Log Files",
-        "Memory Dump Files",
-        "Thumbnail Cache",
-        "Error Reports",
-        "Recycle Bin",
-        "Prefetch Files",
-        "Font Cache",
-        "Delivery Optimization",
-        "Error Reporting Archive",
-        "Windows Defender Scans"};
-
-    double totalSize = 0;
-
-    for (int i = 0; i < systemList->count() && i < results.size(); ++i)
+    // Category names come from the cleaner items, in the same order as the UI rows
+    QList<CleanerItem> items = m_windowsUtils->systemCleanerItems();
+    CleanManifest manifest = m_systemCache->manifest();
+
+    for (int i = 0; i < systemList->count() && i < items.size(); ++i)
     {
         QListWidgetItem *item = systemList->item(i);
-        double sizeMB = results[i];
-        totalSize += sizeMB;
+        QString category = items[i].name();
+        CleanCategoryPlan plan = manifest.category(category);
 
-        QString sizeText;
-        if (sizeMB < 1)
-        {
-            sizeText = QString("(%1 KB)").arg(int(sizeMB * 1024));
-        }
-        else if (sizeMB < 1024)
-        {
-            sizeText = QString("(%1 MB)").arg(sizeMB, 0, 'f', 1);
-        }
-        else
-        {
-            sizeText = QString("(%1 GB)").arg(sizeMB / 1024, 0, 'f', 1);
-        }
+        QString sizeText = "(" + CleanManifest::formatSize(plan.totalSize) + ")";
 
-        // Start with empty checkmark - user can click to toggle
-        QString itemText = "❌ " + categories[i] + " " + sizeText;
+        // Keep the user's selection across refreshes - user can click to toggle
+        QString mark = item->text().contains("✅") ? "✅" : "❌";
+        QString itemText = mark + " " + category + " " + sizeText;
         item->setText(itemText);
+        item->setData(Qt::UserRole, category);
 
         // Add tooltip with more info
-        QString description = getCategoryDescription(categories[i]);
-        item->setToolTip(QString("Category: %1\n%2\nEstimated size: %3\nClick to toggle selection ✅/❌")
-                             .arg(categories[i])
+        QString description = getCategoryDescription(category);
+        item->setToolTip(QString("Category: %1\n%2\nFiles found: %3\nEstimated size: %4\nClick to toggle selection ✅/❌")
+                             .arg(category)
                              .arg(description)
+                             .arg(plan.files.size())
                              .arg(sizeText));
     }
 
+    qint64 totalSize = manifest.totalSize();
+
     // Enable clean button and scan button
     m_mainWindow->ui->cleanSystemButton->setEnabled(totalSize > 0);
     m_mainWindow->ui->scanSystemButton->setEnabled(true);
 
-    qDebug() << "System scan completed. Total size:" << totalSize << "MB";
+    qDebug() << "System scan completed. Total size:" << CleanManifest::formatSize(totalSize);
 }
 
 // Add this helper function for category descriptions:
@@ -634,7 +450,7 @@ QString SystemCleaner::getCategoryDescription(const QString &category)
         {"Thumbnail Cache", "File thumbnail cache. Will rebuild automatically. Safe to delete."},
         {"Error Reports", "Windows Error Reporting files. Safe to delete."},
         {"Recycle Bin", "Deleted files waiting for permanent removal. Safe to empty."},
-        {"Prefetch Files", "Application launch optimization files. Safe to delete."},
+        {"Prefetch Files", "Application launch optimization files. Those of programs still launched regularly are kept. Safe to delete."},
         {"Font Cache", "Cached font data. Will rebuild automatically. Safe to delete."},
         {"Delivery Optimization", "Windows Update cache for peer-to-peer sharing. Safe to delete."},
         {"Error Reporting Archive", "Archived error reports. Safe to delete."},
@@ -6,6 +6,10 @@
 #include <QVector>
 #include <QListWidgetItem>
 #include <QProgressDialog>
+#include "../utils/windowsutils.h"
+#include "../utils/cleanmanifest.h"
+#include "../utils/cleaningpipeline.h"
+#include "../utils/cleancategorycache.h"
 
 class MainWindow;
 
@@ -21,26 +25,38 @@ public:
     void performQuickClean();
     void performSystemScan();
     void performSystemClean();
+    void showCachedResults();
+    void suspendBackgroundRefresh();
 
 private slots:
+    void onQuickScanStarted();
     void onQuickScanFinished();
     void updateScanProgress(int value);
+    void onSystemScanStarted(const QStringList &categories);
     void onSystemScanFinished();
+    void onCleaningProgress(const QString &category, int filesDone, int filesTotal,
+                            qint64 bytesFreed, qint64 bytesTotal);
+    void onCleaningFinished(bool canceled);
 
 private:
     QString getCategoryDescription(const QString& category);
 
     MainWindow *m_mainWindow;
-    QFutureWatcher<QVector<double>> *m_scanWatcher;
-    QFutureWatcher<QVector<double>> *m_systemScanWatcher;
+    WindowsUtils *m_windowsUtils;
+    CleanCategoryCache *m_quickCache;
+    CleanCategoryCache *m_systemCache;
+    CleaningPipeline *m_cleaningPipeline;
+    QProgressDialog *m_cleanProgress;
+    bool m_isQuickCleaning;
+    int m_cleanCategoryIndex;
+    int m_cleanCategoryCount;
     bool m_isScanning;
-    bool m_isSystemScanning;
+    QString m_quickHeader;
 
-    static QVector<double> performScan();
-    static QVector<double> performSystemScanInternal();
     void setupConnections();
-    void updateSystemScanResults(const QVector<double>& results);
-    void performSystemCleanInternal(QList<QListWidgetItem*> selectedItems, QProgressDialog* progress);
+    void updateQuickScanResults(const QString &header);
+    void updateSystemScanResults();
+    QStringList selectedSystemCategories() const;
 };
 
-#endif // SYSTEMCLEANER_H
\ No newline at end of file
+#endif // SYSTEMCLEANER_H
@@ -4,11 +4,11 @@
 #include <QObject>
 #include <QTimer>
 #include <QFutureWatcher>
-#include <windows.h>
-#include <dxgi.h>
-#include <comdef.h>
+#include "../utils/systemspecs.h"
 
 class MainWindow;
+class SystemSpecsProbe;
+class MetricsSampler;
 
 class SystemInfoManager : public QObject
 {
@@ -29,44 +29,23 @@ signals:
     void updateFinished(bool success, const QString &message);
 
 private:
-
-    QString getOSInfoFromRegistry();
-    QString getDisplayVersion();
-    QString getBuildNumber();
-    struct SystemSpecs {
-        QString osName;
-        QString osVersion;
-        QString cpuName;
-        QString cpuCores;
-        QString ramTotal;
-        QString ramSpeed;
-        QString storageTotal;
-        QString storageFree;
-        QString gpuName;
-        QString gpuVRAM;
-    };
-
     MainWindow *m_mainWindow;
     QTimer *m_monitorTimer;
     QFutureWatcher<SystemSpecs> *m_specsWatcher;
+    SystemSpecsProbe *m_probe;
+    SystemSpecs m_specs;     // what the page shows, from the last scan or the snapshot
+    bool m_labelsScanning;   // the labels say "Scanning..." until the scan ends
     bool m_isMonitoring;
-    
-    // For CPU usage calculation
-    ULARGE_INTEGER m_lastIdleTime;
-    ULARGE_INTEGER m_lastKernelTime;
-    ULARGE_INTEGER m_lastUserTime;
-    
-    SystemSpecs getSystemSpecs();
+
+    // Samples are taken on the sampler's thread; the monitor timer only
+    // reads what arrived since the last display update
+    MetricsSampler *m_sampler;
+    quint64 m_sampleCursor;
+
+    void showCachedSpecs();
+    void startSpecsScan();
+    void emitSpecs(const SystemSpecs &specs);
     void updatePerformanceMetrics();
-    int getCPUUsage();
-    int getRAMUsage();
-    int getDiskUsage();
-    QString getGPUInfo();
-    QString getGPUVramInfo();
-    QString getRamSpeed();
-    QString getBootDriveInfo();
-    bool isWindows11();
-    
 
 private slots:
     void onSpecsScanFinished();
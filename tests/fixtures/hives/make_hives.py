@@ -0,0 +1,198 @@
+#!/usr/bin/env python3
+"""Writes the registry hive fixtures used by tst_registryhive.
+
+The hives are built cell by cell (regf base block, one hbin, nk/vk/lh/ri/db
+cells) so the tests do not depend on a Windows machine. Run it from this
+directory after changing it; the generated files are checked in.
+"""
+
+import struct
+
+# 2024-03-12 00:00:00 UTC as a FILETIME
+FILETIME = 133546752000000000
+
+REG_SZ = 1
+REG_EXPAND_SZ = 2
+REG_BINARY = 3
+REG_DWORD = 4
+REG_DWORD_BIG_ENDIAN = 5
+REG_MULTI_SZ = 7
+REG_QWORD = 11
+
+
+def utf16(text, terminated=True):
+    return (text + ("\0" if terminated else "")).encode("utf-16-le")
+
+
+def is_latin1(name):
+    return all(ord(c) < 256 for c in name)
+
+
+class Key:
+    def __init__(self, name, stamp=FILETIME):
+        self.name = name
+        self.stamp = stamp
+        self.subkeys = []
+        self.values = []  # (name, type, bytes)
+
+    def key(self, name, stamp=FILETIME):
+        child = Key(name, stamp)
+        self.subkeys.append(child)
+        return child
+
+    def path(self, path):
+        key = self
+        for name in path.split("\\"):
+            found = [k for k in key.subkeys if k.name.lower() == name.lower()]
+            key = found[0] if found else key.key(name)
+        return key
+
+    def value(self, name, kind, data):
+        self.values.append((name, kind, data))
+        return self
+
+
+class HiveWriter:
+    def __init__(self, index_chunk=0):
+        self.bin = bytearray(b"\0" * 32)  # hbin header, filled in last
+        self.index_chunk = index_chunk  # subkeys per hash list below an index root; 0 for one list
+
+    def alloc(self, payload):
+        # Cells are 8-byte aligned and store their size negated while allocated
+        size = (len(payload) + 4 + 7) & ~7
+        offset = len(self.bin)
+        self.bin += struct.pack("<i", -size) + payload + b"\0" * (size - 4 - len(payload))
+        return offset
+
+    def patch(self, offset, payload):
+        self.bin[offset + 4:offset + 4 + len(payload)] = payload
+
+    def name_bytes(self, name):
+        if is_latin1(name):
+            return name.encode("latin-1"), True
+        return utf16(name, False), False
+
+    def write_value(self, name, kind, data):
+        raw_name, compressed = self.name_bytes(name)
+        if len(data) <= 4:
+            length, offset = len(data) | 0x80000000, int.from_bytes(data.ljust(4, b"\0"), "little")
+        elif len(data) > 16344:
+            segments = []
+            for start in range(0, len(data), 16344):
+                segments.append(self.alloc(data[start:start + 16344]))
+            segment_list = self.alloc(b"".join(struct.pack("<I", s) for s in segments))
+            length, offset = len(data), self.alloc(b"db" + struct.pack("<HI", len(segments), segment_list))
+        else:
+            length, offset = len(data), self.alloc(data)
+        vk = b"vk" + struct.pack("<HIIIHH", len(raw_name), length, offset, kind, 1 if compressed else 0, 0)
+        return self.alloc(vk + raw_name)
+
+    def write_list(self, offsets, names):
+        entries = b"".join(struct.pack("<I", o) + struct.pack("<I", name_hash(n)) for o, n in zip(offsets, names))
+        return self.alloc(b"lh" + struct.pack("<H", len(offsets)) + entries)
+
+    def write_key(self, key, parent, root=False):
+        raw_name, compressed = self.name_bytes(key.name)
+        flags = (0x2C if root else 0) | (0x20 if compressed else 0)
+        placeholder = b"nk" + b"\0" * 74 + raw_name
+        offset = self.alloc(placeholder)
+
+        children = [self.write_key(child, offset) for child in key.subkeys]
+        subkey_list = 0xFFFFFFFF
+        if children:
+            names = [child.name for child in key.subkeys]
+            chunk = self.index_chunk
+            if chunk and len(children) > chunk:
+                # Many subkeys: an index root over several hash lists
+                lists = [self.write_list(children[i:i + chunk], names[i:i + chunk])
+                         for i in range(0, len(children), chunk)]
+                subkey_list = self.alloc(b"ri" + struct.pack("<H", len(lists)) +
+                                         b"".join(struct.pack("<I", l) for l in lists))
+            else:
+                subkey_list = self.write_list(children, names)
+
+        value_list = 0xFFFFFFFF
+        if key.values:
+            vks = [self.write_value(*value) for value in key.values]
+            value_list = self.alloc(b"".join(struct.pack("<I", v) for v in vks))
+
+        nk = b"nk" + struct.pack("<HQIIIIIIIIIIIIIIIHH",
+                                  flags, key.stamp, 0, parent if not root else 0xFFFFFFFF,
+                                  len(children), 0, subkey_list, 0xFFFFFFFF,
+                                  len(key.values), value_list, 0xFFFFFFFF, 0xFFFFFFFF,
+                                  0, 0, 0, 0, 0, len(raw_name), 0)
+        self.patch(offset, nk + raw_name)
+        return offset
+
+    def finish(self, root, hive_name):
+        root_offset = self.write_key(root, 0, True)
+        size = (len(self.bin) + 4095) & ~4095
+        # The rest of the bin is one free cell
+        free = size - len(self.bin)
+        if free:
+            self.bin += struct.pack("<i", free) + b"\0" * (free - 4)
+        self.bin[0:32] = b"hbin" + struct.pack("<IIQQI", 0, size, 0, FILETIME, 0)
+
+        base = bytearray(4096)
+        base[0:4] = b"regf"
+        struct.pack_into("<IIQIIIII", base, 4, 1, 1, FILETIME, 1, 5, 0, 1, root_offset)
+        struct.pack_into("<II", base, 0x28, size, 1)
+        name = utf16(hive_name, False)[:64]
+        base[0x30:0x30 + len(name)] = name
+        checksum = 0
+        for i in range(0, 0x1FC, 4):
+            checksum ^= struct.unpack_from("<I", base, i)[0]
+        struct.pack_into("<I", base, 0x1FC, checksum)
+        return bytes(base) + bytes(self.bin)
+
+
+def name_hash(name):
+    value = 0
+    for c in name.upper():
+        value = (value * 37 + ord(c)) & 0xFFFFFFFF
+    return value
+
+
+def ntuser_hive():
+    root = Key("CsiTool-CreateHive-{00000000-0000-0000-0000-000000000000}")
+    run = root.path("Software\\Microsoft\\Windows\\CurrentVersion\\Run")
+    run.value("OneDrive", REG_SZ,
+              utf16('"C:\\Users\\demo\\AppData\\Local\\Microsoft\\OneDrive\\OneDrive.exe" /background'))
+    run.value("Updater", REG_EXPAND_SZ, utf16("%LOCALAPPDATA%\\Updater\\updater.exe --silent"))
+    run.value("\u0417\u0430\u043f\u0443\u0441\u043a", REG_SZ, utf16("C:\\Tools\\zapusk.exe"))
+    # An empty command is not listed while enabled
+    run.value("Empty", REG_SZ, utf16(""))
+    disabled = root.path("Software\\Microsoft\\Windows\\CurrentVersion\\RunDisabled")
+    disabled.value("OldTool", REG_SZ, utf16("C:\\Tools\\old.exe"))
+    return HiveWriter().finish(root, "\\??\\C:\\Users\\demo\\ntuser.dat")
+
+
+def software_hive():
+    root = Key("ROOT")
+    run = root.path("Microsoft\\Windows\\CurrentVersion\\Run")
+    run.stamp = FILETIME + 10000000
+    run.value("SecurityHealth", REG_EXPAND_SZ, utf16("%windir%\\system32\\SecurityHealthSystray.exe"))
+
+    types = root.path("Raptor\\Types")
+    types.value("", REG_SZ, utf16("default"))
+    types.value("Dword", REG_DWORD, struct.pack("<I", 0xDEADBEEF))
+    types.value("BigEndian", REG_DWORD_BIG_ENDIAN, struct.pack(">I", 0x01020304))
+    types.value("Qword", REG_QWORD, struct.pack("<Q", 0x0123456789ABCDEF))
+    types.value("Multi", REG_MULTI_SZ, utf16("one\0two\0three\0"))
+    types.value("Unterminated", REG_SZ, utf16("no terminator", False))
+    types.value("Inline", REG_BINARY, b"\x01\x02\x03")
+    types.value("Binary", REG_BINARY, bytes(range(64)))
+    types.value("Big", REG_BINARY, bytes(i % 251 for i in range(40000)))
+
+    many = root.path("Raptor\\Many")
+    for i in range(600):
+        many.key("Entry%03d" % i)
+
+    return HiveWriter(index_chunk=256).finish(root, "\\REGISTRY\\MACHINE\\SOFTWARE")
+
+
+if __name__ == "__main__":
+    with open("NTUSER.DAT", "wb") as f:
+        f.write(ntuser_hive())
+    with open("SOFTWARE", "wb") as f:
+        f.write(software_hive())
@@ -0,0 +1,130 @@
+#!/usr/bin/env python3
+"""Writes the shortcut fixtures used by tst_shelllinkparser.
+
+Each .lnk is built field by field after [MS-SHLLINK]: the header, an
+optional ID list, an optional LinkInfo, the string data and the extra data
+blocks. Run it from this directory after changing it; the generated files
+are checked in.
+"""
+
+import struct
+
+CLSID = bytes([0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+               0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46])
+MY_COMPUTER = bytes.fromhex("e04fd020ea3a6910a2d808002b30309d")
+
+HAS_ID_LIST = 0x01
+HAS_LINK_INFO = 0x02
+HAS_NAME = 0x04
+HAS_RELATIVE_PATH = 0x08
+HAS_WORKING_DIR = 0x10
+HAS_ARGUMENTS = 0x20
+HAS_ICON_LOCATION = 0x40
+IS_UNICODE = 0x80
+HAS_EXP_STRING = 0x200
+
+# 2024-03-12 00:00:00 UTC as a FILETIME
+FILETIME = 133546752000000000
+
+
+def utf16(text):
+    return text.encode("utf-16-le") + b"\0\0"
+
+
+def header(flags):
+    return (struct.pack("<I", 0x4C) + CLSID + struct.pack("<II", flags, 0x20)
+            + struct.pack("<QQQ", FILETIME, FILETIME, FILETIME)
+            + struct.pack("<IiiHHII", 1234, 0, 1, 0, 0, 0, 0))
+
+
+def file_entry(short_name, long_name, directory):
+    # Short name padded to an even offset, then a version 9 0xBEEF0004 extension
+    name = short_name.encode("ascii") + b"\0"
+    if (14 + len(name)) % 2:
+        name += b"\0"
+    extension = struct.pack("<HHIIIH", 0, 9, 0xBEEF0004, 0, 0, 0x2E)
+    extension += b"\0" * 18 + struct.pack("<HII", 0, 0, 0) + utf16(long_name)
+    extension += struct.pack("<H", 14 + len(name))
+    extension = struct.pack("<H", len(extension)) + extension[2:]
+    body = bytes([0x31 if directory else 0x32, 0]) + struct.pack("<IIH", 0 if directory else 4096, 0, 0x10 if directory else 0x20)
+    body += name + extension
+    return struct.pack("<H", len(body) + 2) + body
+
+
+def id_list(volume, entries):
+    items = struct.pack("<H", 20) + bytes([0x1F, 0x50]) + MY_COMPUTER
+    volume_item = bytes([0x2F]) + volume.encode("ascii") + b"\0"
+    volume_item += b"\0" * (22 - len(volume_item))
+    items += struct.pack("<H", len(volume_item) + 2) + volume_item
+    for i, (short_name, long_name) in enumerate(entries):
+        items += file_entry(short_name, long_name, i + 1 < len(entries))
+    items += b"\0\0"
+    return struct.pack("<H", len(items)) + items
+
+
+def local_link_info(base_path):
+    volume_id = struct.pack("<IIII", 0x10 + 8, 3, 0x1A2B3C4D, 0x10) + b"SYSTEM\0\0"
+    base = base_path.encode("ascii") + b"\0"
+    header_size = 0x1C
+    volume_offset = header_size
+    base_offset = volume_offset + len(volume_id)
+    suffix_offset = base_offset + len(base)
+    body = volume_id + base + b"\0"
+    size = header_size + len(body)
+    return struct.pack("<IIIIIII", size, header_size, 1, volume_offset, base_offset, 0, suffix_offset) + body
+
+
+def network_link_info(share, suffix):
+    net_name = share.encode("ascii") + b"\0"
+    network = struct.pack("<IIIII", 0x14 + len(net_name), 0, 0x14, 0, 0x00020000) + net_name
+    header_size = 0x1C
+    suffix_offset = header_size + len(network)
+    body = network + suffix.encode("ascii") + b"\0"
+    size = header_size + len(body)
+    return struct.pack("<IIIIIII", size, header_size, 2, 0, 0, header_size, suffix_offset) + body
+
+
+def string_data(strings):
+    data = b""
+    for text in strings:
+        data += struct.pack("<H", len(text)) + text.encode("utf-16-le")
+    return data
+
+
+def environment_block(target):
+    ansi = target.encode("ascii")
+    return (struct.pack("<II", 0x314, 0xA0000001) + ansi + b"\0" * (260 - len(ansi))
+            + target.encode("utf-16-le") + b"\0" * (520 - 2 * len(target)))
+
+
+TERMINAL = b"\0\0\0\0"
+
+
+if __name__ == "__main__":
+    app = "C:\\Program Files\\Contoso\\app.exe"
+    entries = [("PROGRA~1", "Program Files"), ("Contoso", "Contoso"), ("app.exe", "app.exe")]
+
+    fixtures = {
+        # What Explorer writes: ID list, LinkInfo and strings
+        "local_path.lnk":
+            header(HAS_ID_LIST | HAS_LINK_INFO | HAS_NAME | HAS_WORKING_DIR | HAS_ARGUMENTS | HAS_ICON_LOCATION
+                   | IS_UNICODE)
+            + id_list("C:\\", entries) + local_link_info(app)
+            + string_data(["Contoso App", "C:\\Program Files\\Contoso", "--minimized",
+                           "C:\\Program Files\\Contoso\\app.exe"])
+            + TERMINAL,
+        "id_list_only.lnk":
+            header(HAS_ID_LIST | IS_UNICODE) + id_list("C:\\", entries) + TERMINAL,
+        "environment.lnk":
+            header(HAS_ARGUMENTS | IS_UNICODE | HAS_EXP_STRING)
+            + string_data(["/s"]) + environment_block("%windir%\\system32\\notepad.exe") + TERMINAL,
+        "relative.lnk":
+            header(HAS_RELATIVE_PATH | HAS_WORKING_DIR | HAS_ARGUMENTS | IS_UNICODE)
+            + string_data(["..\\tools\\run.cmd", "D:\\tools", "--quiet --log \"D:\\logs\\run, 1.txt\""])
+            + TERMINAL,
+        "network_share.lnk":
+            header(HAS_LINK_INFO) + network_link_info("\\\\fileserver\\public", "docs\\report.xlsx") + TERMINAL,
+    }
+    for name, data in fixtures.items():
+        with open(name, "wb") as f:
+            f.write(data)
@@ -0,0 +1,234 @@
+#!/usr/bin/env python3
+"""Writes the Prefetch fixtures used by tst_prefetchparser.
+
+One file per layout the parser knows: versions 17 (XP), 23 (Vista/7), 26
+(8.1) and 30/31 (10/11). The Windows 10+ files are wrapped in a "MAM"
+header and XPRESS-Huffman compressed by the small encoder below, once with
+Huffman tables built from symbol counts and once with fixed 9-bit codes.
+Run it from this directory after changing it; the generated files are
+checked in.
+"""
+
+import heapq
+import struct
+
+
+def filetime(unix):
+    return int((unix + 11644473600) * 10**7)
+
+
+def build_pf(version, exe, run_count, runs, files, traces, volumes, compact=False):
+    header_size = 0x128 if compact else {17: 0x98, 23: 0xF0, 26: 0x130, 30: 0x130, 31: 0x130}[version]
+    trace_entry = 8 if version >= 30 else 12
+    volume_entry = {17: 40, 23: 104, 26: 104, 30: 96, 31: 96}[version]
+
+    strings = b""
+    names = []
+    for f in files:
+        names.append((len(strings), len(f)))
+        strings += f.encode("utf-16-le") + b"\0\0"
+
+    metrics = b""
+    for offset, length in names:
+        if version == 17:
+            metrics += struct.pack("<IIIII", 0, 1, offset, length, 0)
+        else:
+            metrics += struct.pack("<IIIIIIQ", 0, 1, 0, offset, length, 0, 0)
+
+    trace = b""
+    for blocks in traces:
+        if trace_entry == 12:
+            trace += struct.pack("<IIBBH", 0xFFFFFFFF, blocks, 1, 2, 3)
+        else:
+            trace += struct.pack("<IBBH", blocks, 1, 2, 3)
+
+    # Volume paths are offsets from the start of the volumes section
+    entries = b""
+    paths = b""
+    base = volume_entry * len(volumes)
+    for v in volumes:
+        entry = struct.pack("<IIQI", base + len(paths), len(v), filetime(1.5e9), 0x1234)
+        entries += entry + b"\0" * (volume_entry - len(entry))
+        paths += v.encode("utf-16-le") + b"\0\0"
+    volume_section = entries + paths
+
+    metrics_offset = header_size
+    trace_offset = metrics_offset + len(metrics)
+    strings_offset = trace_offset + len(trace)
+    volumes_offset = strings_offset + len(strings)
+    total = volumes_offset + len(volume_section)
+
+    header = bytearray(header_size)
+    struct.pack_into("<I4sII", header, 0, version, b"SCCA", 0x11, total)
+    name = exe.encode("utf-16-le")[:58]
+    header[0x10:0x10 + len(name)] = name
+    struct.pack_into("<I", header, 0x4C, 0xDEADBEEF)
+    struct.pack_into("<9I", header, 0x54, metrics_offset, len(files), trace_offset, len(traces),
+                     strings_offset, len(strings), volumes_offset, len(volumes), len(volume_section))
+    if version == 17:
+        struct.pack_into("<Q", header, 0x78, filetime(runs[0]))
+        run_count_offset = 0x90
+    else:
+        slots = 1 if version == 23 else 8
+        for i, run in enumerate(runs[:slots]):
+            struct.pack_into("<Q", header, 0x80 + 8 * i, filetime(run))
+        run_count_offset = 0x98 if version == 23 else (0xC8 if compact else 0xD0)
+    struct.pack_into("<I", header, run_count_offset, run_count)
+    return bytes(header) + metrics + trace + strings + volume_section
+
+
+# ---- XPRESS Huffman ([MS-XCA] 2.1), written in the order the decoder reads ----
+
+def code_lengths(freq):
+    symbols = [s for s in range(512) if freq[s]]
+    if len(symbols) == 1:
+        lengths = [0] * 512
+        lengths[symbols[0]] = 1
+        lengths[0 if symbols[0] else 1] = 1
+        return lengths
+    heap = [(freq[s], i, [s]) for i, s in enumerate(symbols)]
+    heapq.heapify(heap)
+    depth = [0] * 512
+    counter = len(heap)
+    while len(heap) > 1:
+        a = heapq.heappop(heap)
+        b = heapq.heappop(heap)
+        for s in a[2] + b[2]:
+            depth[s] += 1
+        counter += 1
+        heapq.heappush(heap, (a[0] + b[0], counter, a[2] + b[2]))
+    # Codes are limited to 15 bits; fall back to a flat table
+    return [9] * 512 if max(depth) > 15 else depth
+
+
+def canonical_codes(lengths):
+    codes = {}
+    code = 0
+    for length in range(1, 16):
+        for s in range(512):
+            if lengths[s] == length:
+                codes[s] = (code >> (15 - length), length)
+                code += 1 << (15 - length)
+    return codes
+
+
+def tokenize(data, start, end):
+    tokens = []
+    i = start
+    while i < end:
+        best = (0, 0)
+        for distance in (1, 2, 3, 7, 64, 300, 4000, 65535):
+            if distance > i:
+                continue
+            length = 0
+            while i + length < end and data[i + length - distance] == data[i + length] and length < 70000:
+                length += 1
+            if length > best[0]:
+                best = (length, distance)
+        if best[0] >= 3:
+            tokens.append(("match", best[0], best[1]))
+            i += best[0]
+        else:
+            tokens.append(("literal", data[i]))
+            i += 1
+    return tokens
+
+
+def match_symbol(length, distance):
+    offset_bits = distance.bit_length() - 1
+    return 256 + (offset_bits << 4) + min(length - 3, 15), offset_bits
+
+
+def compress(data, fixed=False):
+    out = bytearray()
+    pos = 0
+    while pos < len(data):
+        tokens = tokenize(data, pos, min(pos + 65536, len(data)))
+        pos += sum(t[1] if t[0] == "match" else 1 for t in tokens)
+
+        freq = [0] * 512
+        for t in tokens:
+            freq[t[1] if t[0] == "literal" else match_symbol(t[1], t[2])[0]] += 1
+        lengths = [9] * 512 if fixed else code_lengths(freq)
+        table = bytearray(256)
+        for s in range(512):
+            table[s // 2] |= (lengths[s] & 15) << (4 * (s & 1))
+        codes = canonical_codes(lengths)
+        out += table
+
+        # Bits go into 16-bit words reserved ahead of the extra length bytes
+        bits = []
+        slots = [len(out), len(out) + 2]
+        out += b"\0" * 4
+        available = 32
+
+        def put(value, count):
+            nonlocal available
+            for k in range(count - 1, -1, -1):
+                bits.append((value >> k) & 1)
+            available -= count
+            if available < 16:
+                slots.append(len(out))
+                out.extend(b"\0\0")
+                available += 16
+
+        for t in tokens:
+            if t[0] == "literal":
+                put(*codes[t[1]])
+                continue
+            symbol, offset_bits = match_symbol(t[1], t[2])
+            put(*codes[symbol])
+            extra = t[1] - 3
+            if extra >= 15:
+                if extra - 15 < 255:
+                    out.append(extra - 15)
+                else:
+                    out.append(255)
+                    # Both wide forms: 16 bits, or a zero word followed by 32 bits
+                    if extra < 65536 and extra % 2 == 0:
+                        out += struct.pack("<H", extra)
+                    else:
+                        out += struct.pack("<HI", 0, extra)
+            put(t[2] - (1 << offset_bits), offset_bits)
+
+        while len(bits) % 16:
+            bits.append(0)
+        for k in range(len(bits) // 16):
+            word = 0
+            for bit in bits[16 * k:16 * k + 16]:
+                word = (word << 1) | bit
+            struct.pack_into("<H", out, slots[k], word)
+    return bytes(out)
+
+
+def mam(data, checksum=True, fixed=False):
+    compressed = compress(data, fixed)
+    if checksum:
+        # The parser skips the CRC, so it is left zero
+        return b"MAM\x84" + struct.pack("<II", len(data), 0) + compressed
+    return b"MAM\x04" + struct.pack("<I", len(data)) + compressed
+
+
+if __name__ == "__main__":
+    system = ["\\VOLUME{01d2-abcd}\\WINDOWS\\SYSTEM32\\NTDLL.DLL",
+              "\\VOLUME{01d2-abcd}\\WINDOWS\\SYSTEM32\\KERNEL32.DLL"]
+    many = system + ["\\VOLUME{01d2-abcd}\\PROGRAM FILES\\APP\\LIB%04d.DLL" % i for i in range(1200)]
+
+    fixtures = {
+        "NOTEPAD.EXE-1A2B3C4D.pf": build_pf(17, "NOTEPAD.EXE", 5, [1.6e9], system, [3, 4],
+                                            ["\\DEVICE\\HARDDISKVOLUME1"]),
+        "CALC.EXE-2B3C4D5E.pf": build_pf(23, "CALC.EXE", 12, [1.6e9], system, [10],
+                                         ["\\DEVICE\\HARDDISKVOLUME2"]),
+        "SKYPE.EXE-3C4D5E6F.pf": build_pf(26, "SKYPE.EXE", 40, [1.7e9, 1.69e9, 1.68e9], system, [100, 1],
+                                          ["\\DEVICE\\HARDDISKVOLUME3"]),
+        "ONEDRIVE.EXE-4D5E6F70.pf": mam(build_pf(30, "ONEDRIVE.EXE", 99, [1.75e9, 1.74e9], many,
+                                                 list(range(5000)), ["\\VOLUME{01d2-abcd}"])),
+        "ONEDRIVE.EXE-5E6F7081.pf": mam(build_pf(30, "ONEDRIVE.EXE", 3, [1.6e9], system, [7],
+                                                 ["\\VOLUME{01d2-abcd}"], compact=True),
+                                        checksum=False, fixed=True),
+        "A-VERY-LONG-EXECUTABLE-NAME-1-6F708192.pf": mam(build_pf(31, "A-VERY-LONG-EXECUTABLE-NAME-123.EXE", 1,
+                                                                  [1.76e9], system, [2], ["\\VOLUME{x}"])),
+    }
+    for name, data in fixtures.items():
+        with open(name, "wb") as f:
+            f.write(data)
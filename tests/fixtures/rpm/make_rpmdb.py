@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""Writes the rpm database fixture used by tst_sqlitetablereader and
+tst_rpminventorysource.
+
+The Packages table is laid out like rpm 4.16+ writes it, with one stored
+header blob per package. Small pages and a few hundred filler packages
+give the table interior pages; the file list of big-docs spills onto a
+chain of overflow pages. Run it from this directory after changing it; the
+generated file is checked in.
+"""
+
+import os
+import sqlite3
+import struct
+
+TAG_NAME = 1000
+TAG_VERSION = 1001
+TAG_RELEASE = 1002
+TAG_SUMMARY = 1004
+TAG_INSTALL_TIME = 1008
+TAG_SIZE = 1009
+TAG_VENDOR = 1011
+TAG_PACKAGER = 1015
+TAG_ARCH = 1022
+TAG_BASENAMES = 1117
+TAG_LONG_SIZE = 5009
+
+TYPE_INT32 = 4
+TYPE_INT64 = 5
+TYPE_STRING = 6
+TYPE_STRING_ARRAY = 8
+TYPE_I18N_STRING = 9
+
+# 2024-03-12 12:00:00 UTC, the same date in every time zone
+INSTALL_TIME = 1710244800
+FILLER_PACKAGES = 300
+
+
+def header_blob(tags):
+    """tags: (tag, type, value) with value an int, a str or a list of str"""
+    index = b""
+    store = b""
+    for tag, kind, value in tags:
+        if kind == TYPE_INT32:
+            store += b"\0" * (-len(store) % 4)
+            data, count = struct.pack(">I", value), 1
+        elif kind == TYPE_INT64:
+            store += b"\0" * (-len(store) % 8)
+            data, count = struct.pack(">Q", value), 1
+        elif kind == TYPE_STRING_ARRAY:
+            data, count = b"".join(v.encode() + b"\0" for v in value), len(value)
+        else:
+            data, count = value.encode() + b"\0", 1
+        index += struct.pack(">IIII", tag, kind, len(store), count)
+        store += data
+    return struct.pack(">II", len(tags), len(store)) + index + store
+
+
+def package(name, version, release, arch="x86_64", vendor="Fedora Project", size=None, long_size=None,
+            packager=None, files=()):
+    tags = [(TAG_NAME, TYPE_STRING, name), (TAG_VERSION, TYPE_STRING, version),
+            (TAG_RELEASE, TYPE_STRING, release),
+            (TAG_SUMMARY, TYPE_I18N_STRING, "The %s package" % name),
+            (TAG_INSTALL_TIME, TYPE_INT32, INSTALL_TIME)]
+    if size is not None:
+        tags.append((TAG_SIZE, TYPE_INT32, size))
+    if vendor:
+        tags.append((TAG_VENDOR, TYPE_STRING, vendor))
+    if packager:
+        tags.append((TAG_PACKAGER, TYPE_STRING, packager))
+    if arch:
+        tags.append((TAG_ARCH, TYPE_STRING, arch))
+    if files:
+        tags.append((TAG_BASENAMES, TYPE_STRING_ARRAY, list(files)))
+    if long_size is not None:
+        tags.append((TAG_LONG_SIZE, TYPE_INT64, long_size))
+    return name, header_blob(tags)
+
+
+if __name__ == "__main__":
+    packages = [
+        package("bash", "5.2.26", "3.fc40", size=8200000),
+        # Over 4 GB: only the 64-bit size tag is right
+        package("kernel-core", "6.8.5", "301.fc40", size=5000000000 % 2**32, long_size=5000000000),
+        package("gpg-pubkey", "a15b79cc", "63d04c2c", arch=None, vendor=None),
+        package("local-tool", "1.0", "1", arch="noarch", vendor=None, size=4096, packager="Jane Doe <jane@example.com>"),
+        package("big-docs", "2.1", "7.fc40", arch="noarch", size=70000,
+                files=["file-%05d.html" % i for i in range(600)]),
+    ]
+    packages += [package("filler-%03d" % i, "1.%d" % i, "1.fc40", size=1024 * i) for i in range(FILLER_PACKAGES)]
+
+    if os.path.exists("rpmdb.sqlite"):
+        os.remove("rpmdb.sqlite")
+    db = sqlite3.connect("rpmdb.sqlite")
+    db.execute("PRAGMA page_size = 1024")
+    db.execute("PRAGMA journal_mode = DELETE")
+    db.execute("CREATE TABLE 'Packages' (hnum INTEGER PRIMARY KEY AUTOINCREMENT, blob BLOB NOT NULL)")
+    db.execute("CREATE TABLE 'Name' (key TEXT NOT NULL, hnum INTEGER NOT NULL, idx INTEGER NOT NULL, "
+               "FOREIGN KEY (hnum) REFERENCES 'Packages'(hnum))")
+    db.execute("CREATE INDEX 'Name_key_idx' ON 'Name'(key ASC)")
+    for name, blob in packages:
+        cursor = db.execute("INSERT INTO Packages (blob) VALUES (?)", (blob,))
+        db.execute("INSERT INTO Name VALUES (?, ?, 0)", (name, cursor.lastrowid))
+    db.commit()
+    db.execute("VACUUM")
+    db.close()
@@ -0,0 +1,226 @@
+#include <QtTest>
+#include "bootcriticalpath.h"
+#include "memoryactivationsource.h"
+
+namespace
+{
+    QString activationsFixture()
+    {
+        return QString(FIXTURE_DIR) + "/boot/activations.ini";
+    }
+
+    bool writeUnit(const QDir &dir, const QString &relativePath, const QByteArray &contents)
+    {
+        QString path = dir.filePath(relativePath);
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        return file.open(QIODevice::WriteOnly) && file.write(contents) == contents.size();
+    }
+
+    // The boot described by fixtures/boot/activations.ini: the goal waits
+    // for app.service, which waits for db.service; other.service is done
+    // early and late.service is not part of the boot
+    bool writeSimpleBoot(const QDir &dir)
+    {
+        return writeUnit(dir, "default.target",
+                         "[Unit]\nDescription=Default\nWants=app.service other.service\nAfter=app.service other.service\n") &&
+               writeUnit(dir, "app.service",
+                         "[Unit]\nDefaultDependencies=no\nRequires=db.service\nAfter=db.service\n\n"
+                         "[Service]\nExecStart=/usr/bin/app\n") &&
+               writeUnit(dir, "db.service", "[Unit]\nDefaultDependencies=no\n") &&
+               writeUnit(dir, "other.service", "[Unit]\nDefaultDependencies=no\n") &&
+               writeUnit(dir, "late.service", "[Unit]\nDefaultDependencies=no\n");
+    }
+
+    QHash<QString, UnitActivation> readActivations(const BootActivationSource &source)
+    {
+        QHash<QString, UnitActivation> activations;
+        QString error;
+        if (!source.read(activations, error))
+            qWarning("%s", qPrintable(error));
+        return activations;
+    }
+}
+
+class TestBootCriticalPath : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void memorySourceLoadsIni();
+    void memorySourceWithoutActivations();
+
+    void followsLatestDependency();
+    void emptyAssignmentResetsOnlyItsSetting();
+    void instantiatesTemplates();
+    void followsLinksAndAliases();
+    void goalNotReached();
+    void noUnitFiles();
+};
+
+void TestBootCriticalPath::memorySourceLoadsIni()
+{
+    MemoryActivationSource source("fixture");
+    QVERIFY(source.loadIni(activationsFixture()));
+    QCOMPARE(source.id(), QString("fixture"));
+    QCOMPARE(source.count(), 5);
+
+    QHash<QString, UnitActivation> activations = readActivations(source);
+    QCOMPARE(activations.value("db.service").activatingUs, qint64(1000));
+    QCOMPARE(activations.value("db.service").activeUs, qint64(5000));
+
+    // Targets have no start job: they become active the moment they start
+    QCOMPARE(activations.value("default.target").activatingUs, qint64(9500));
+    QCOMPARE(activations.value("default.target").activeUs, qint64(9500));
+
+    QVERIFY(!source.loadIni(QString(FIXTURE_DIR) + "/boot/missing.ini"));
+    QCOMPARE(source.count(), 5);
+}
+
+void TestBootCriticalPath::memorySourceWithoutActivations()
+{
+    MemoryActivationSource source("empty");
+    QHash<QString, UnitActivation> activations;
+    QString error;
+    QVERIFY(!source.read(activations, error));
+    QVERIFY(!error.isEmpty());
+
+    source.setActivation("a.service", 10, 20);
+    QVERIFY(source.read(activations, error));
+    QCOMPARE(activations.value("a.service").activeUs, qint64(20));
+
+    source.clear();
+    QCOMPARE(source.count(), 0);
+}
+
+void TestBootCriticalPath::followsLatestDependency()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    QVERIFY(writeSimpleBoot(QDir(dir.path())));
+
+    MemoryActivationSource source("fixture");
+    QVERIFY(source.loadIni(activationsFixture()));
+
+    BootCriticalPath analysis({dir.path()});
+    QVERIFY(analysis.loadUnits());
+    QVERIFY2(analysis.analyze(readActivations(source)), qPrintable(analysis.errorString()));
+
+    QCOMPARE(analysis.criticalPath(), QStringList({"db.service", "app.service", "default.target"}));
+    QCOMPARE(analysis.bootTimeUs(), qint64(9500));
+    QCOMPARE(analysis.bootUnits(),
+             QSet<QString>({"default.target", "app.service", "db.service", "other.service"}));
+
+    QCOMPARE(analysis.role("app.service"), BootCriticalPath::CriticalPath);
+    QCOMPARE(analysis.role("other.service"), BootCriticalPath::Parallel);
+    QCOMPARE(analysis.role("late.service"), BootCriticalPath::AfterBoot);
+    QCOMPARE(analysis.role("unknown.service"), BootCriticalPath::NotStarted);
+    QCOMPARE(analysis.activation("app.service").activatingUs, qint64(5000));
+}
+
+void TestBootCriticalPath::emptyAssignmentResetsOnlyItsSetting()
+{
+    QTemporaryDir dir;
+    QDir units(dir.path());
+    QVERIFY(writeUnit(units, "default.target",
+                      "[Unit]\nWants=dropped.service\nRequires=kept.service\nBindsTo=bound.service\n"));
+    QVERIFY(writeUnit(units, "default.target.d/override.conf", "[Unit]\nWants=\nWants=added.service\n"));
+    for (const QString &name : {"dropped.service", "kept.service", "bound.service", "added.service"})
+        QVERIFY(writeUnit(units, name, "[Unit]\nDefaultDependencies=no\n"));
+
+    MemoryActivationSource source("memory");
+    source.setActivation("default.target", 100, 100);
+
+    BootCriticalPath analysis({dir.path()});
+    QVERIFY(analysis.loadUnits());
+    QVERIFY(analysis.analyze(readActivations(source)));
+
+    // "Wants=" in the drop-in clears the earlier Wants= and nothing else
+    QSet<QString> boot = analysis.bootUnits();
+    QVERIFY(!boot.contains("dropped.service"));
+    QVERIFY(boot.contains("kept.service"));
+    QVERIFY(boot.contains("bound.service"));
+    QVERIFY(boot.contains("added.service"));
+}
+
+void TestBootCriticalPath::instantiatesTemplates()
+{
+    QTemporaryDir dir;
+    QDir units(dir.path());
+    QVERIFY(writeUnit(units, "default.target", "[Unit]\nWants=getty@tty1.service\nAfter=getty@tty1.service\n"));
+    QVERIFY(writeUnit(units, "getty@.service",
+                      "[Unit]\nDefaultDependencies=no\nWants=setup-%i.service\nAfter=setup-%i.service\n"));
+    QVERIFY(writeUnit(units, "setup-tty1.service", "[Unit]\nDefaultDependencies=no\n"));
+
+    MemoryActivationSource source("memory");
+    source.setActivation("setup-tty1.service", 100, 400);
+    source.setActivation("getty@tty1.service", 400, 700);
+    source.setActivation("default.target", 800, 800);
+
+    BootCriticalPath analysis({dir.path()});
+    QVERIFY(analysis.loadUnits());
+    QVERIFY(analysis.analyze(readActivations(source)));
+    QCOMPARE(analysis.criticalPath(), QStringList({"setup-tty1.service", "getty@tty1.service", "default.target"}));
+}
+
+void TestBootCriticalPath::followsLinksAndAliases()
+{
+    QTemporaryDir dir;
+    QDir units(dir.path());
+    QVERIFY(writeUnit(units, "graphical.target", "[Unit]\nWants=display-manager.service\n"));
+    QVERIFY(writeUnit(units, "gdm.service", "[Unit]\nDescription=GNOME Display Manager\n"));
+    QVERIFY(writeUnit(units, "linked.service", "[Unit]\n"));
+    QVERIFY(writeUnit(units, "sysinit.target", "[Unit]\n"));
+    QVERIFY(writeUnit(units, "basic.target", "[Unit]\nAfter=sysinit.target\n"));
+    QVERIFY(units.mkpath("graphical.target.wants"));
+    if (!QFile::link(units.filePath("gdm.service"), units.filePath("display-manager.service")) ||
+        !QFile::link(units.filePath("linked.service"), units.filePath("graphical.target.wants/linked.service")))
+        QSKIP("Symbolic links are not available here");
+
+    // The journal names the unit the alias points to
+    MemoryActivationSource source("memory");
+    source.setActivation("sysinit.target", 50, 50);
+    source.setActivation("basic.target", 80, 80);
+    source.setActivation("linked.service", 100, 200);
+    source.setActivation("gdm.service", 100, 900);
+    source.setActivation("graphical.target", 1000, 1000);
+
+    BootCriticalPath analysis({dir.path()});
+    QVERIFY(analysis.loadUnits());
+    QVERIFY(analysis.analyze(readActivations(source), "graphical.target"));
+
+    QVERIFY(analysis.bootUnits().contains("gdm.service"));
+    QVERIFY(analysis.bootUnits().contains("linked.service"));
+    QVERIFY(!analysis.bootUnits().contains("display-manager.service"));
+
+    // Default dependencies order the target after what it pulls in, and services after basic.target
+    QCOMPARE(analysis.criticalPath(),
+             QStringList({"sysinit.target", "basic.target", "gdm.service", "graphical.target"}));
+    QCOMPARE(analysis.role("display-manager.service"), BootCriticalPath::CriticalPath);
+}
+
+void TestBootCriticalPath::goalNotReached()
+{
+    QTemporaryDir dir;
+    QVERIFY(writeSimpleBoot(QDir(dir.path())));
+
+    MemoryActivationSource source("memory");
+    source.setActivation("db.service", 1000, 5000);
+
+    BootCriticalPath analysis({dir.path()});
+    QVERIFY(analysis.loadUnits());
+    QVERIFY(!analysis.analyze(readActivations(source)));
+    QVERIFY(analysis.errorString().contains("default.target"));
+    QVERIFY(analysis.criticalPath().isEmpty());
+}
+
+void TestBootCriticalPath::noUnitFiles()
+{
+    QTemporaryDir dir;
+    BootCriticalPath analysis({dir.path(), dir.filePath("missing")});
+    QVERIFY(!analysis.loadUnits());
+    QVERIFY(!analysis.errorString().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestBootCriticalPath)
+#include "tst_bootcriticalpath.moc"
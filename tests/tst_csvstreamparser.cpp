@@ -0,0 +1,180 @@
+#include <QtTest>
+#include "csvstreamparser.h"
+
+namespace
+{
+    using Rows = QList<QStringList>;
+
+    // Output of "schtasks /query /fo csv /v" on a machine with three task folders
+    QByteArray readFixture()
+    {
+        QFile file(QString(FIXTURE_DIR) + "/schtasks/query_verbose.csv");
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QStringList rowFields(const CsvStreamParser::Row &row)
+    {
+        QStringList fields;
+        for (int i = 0; i < row.size(); ++i)
+            fields.append(row.text(i));
+        return fields;
+    }
+
+    // Feeds the input in pieces that end at the given offsets, then the rest
+    Rows parse(const QByteArray &input, const QList<int> &splits = QList<int>())
+    {
+        Rows rows;
+        CsvStreamParser parser([&rows](const CsvStreamParser::Row &row)
+                               {
+                                   rows.append(rowFields(row));
+                                   return true;
+                               });
+        int start = 0;
+        for (int split : splits)
+        {
+            parser.feed(input.mid(start, split - start));
+            start = split;
+        }
+        parser.feed(input.mid(start));
+        parser.finish();
+        return rows;
+    }
+
+    Rows parseInChunksOf(const QByteArray &input, int chunkSize)
+    {
+        QList<int> splits;
+        for (int offset = chunkSize; offset < input.size(); offset += chunkSize)
+            splits.append(offset);
+        return parse(input, splits);
+    }
+}
+
+class TestCsvStreamParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesFields_data();
+    void parsesFields();
+    void stopsWhenAsked();
+
+    void parsesVerboseSchtasks();
+    void chunkSizesAgree_data();
+    void chunkSizesAgree();
+    void everySplitPointAgrees();
+    void splitInsideQuotedField();
+};
+
+void TestCsvStreamParser::parsesFields_data()
+{
+    QTest::addColumn<QByteArray>("input");
+    QTest::addColumn<Rows>("expected");
+
+    QTest::newRow("plain") << QByteArray("a,b,c\n1,2,3\n") << Rows{{"a", "b", "c"}, {"1", "2", "3"}};
+    QTest::newRow("quoted comma") << QByteArray("\"a,b\",c\n") << Rows{{"a,b", "c"}};
+    QTest::newRow("doubled quotes") << QByteArray("\"say \"\"hi\"\"\",x\n") << Rows{{"say \"hi\"", "x"}};
+    QTest::newRow("only a quote") << QByteArray("\"\"\"\"\n") << Rows{{"\""}};
+    QTest::newRow("line break in quotes") << QByteArray("\"one\r\ntwo\",3\r\n") << Rows{{"one\r\ntwo", "3"}};
+    QTest::newRow("empty fields") << QByteArray(",,\n\"\",x\n") << Rows{{"", "", ""}, {"", "x"}};
+    QTest::newRow("CRLF") << QByteArray("a,b\r\nc,d\r\n") << Rows{{"a", "b"}, {"c", "d"}};
+    QTest::newRow("CR only") << QByteArray("a,b\rc,d\r") << Rows{{"a", "b"}, {"c", "d"}};
+    QTest::newRow("blank lines") << QByteArray("\r\n\r\na\r\n\n\nb\n") << Rows{{"a"}, {"b"}};
+    QTest::newRow("no final line break") << QByteArray("a,\"b\"") << Rows{{"a", "b"}};
+    QTest::newRow("text after closing quote") << QByteArray("\"a\"b,c\n") << Rows{{"ab", "c"}};
+}
+
+void TestCsvStreamParser::parsesFields()
+{
+    QFETCH(QByteArray, input);
+    QFETCH(Rows, expected);
+
+    QCOMPARE(parse(input), expected);
+}
+
+void TestCsvStreamParser::stopsWhenAsked()
+{
+    Rows rows;
+    CsvStreamParser parser([&rows](const CsvStreamParser::Row &row)
+                           {
+                               rows.append(rowFields(row));
+                               return rows.size() < 2;
+                           });
+    parser.feed(QByteArray("a\nb\nc\n"));
+    parser.feed(QByteArray("d\n"));
+    parser.finish();
+
+    QVERIFY(parser.isStopped());
+    QCOMPARE(parser.rowCount(), qint64(2));
+    QCOMPARE(rows, (Rows{{"a"}, {"b"}}));
+}
+
+void TestCsvStreamParser::parsesVerboseSchtasks()
+{
+    QByteArray input = readFixture();
+    QVERIFY(!input.isEmpty());
+
+    Rows rows = parse(input);
+    QCOMPARE(rows.size(), 8);
+
+    // The header comes again before the tasks of every folder
+    int headers = 0;
+    for (const QStringList &row : rows)
+    {
+        QCOMPARE(row.size(), 28);
+        if (row.at(1) == "TaskName")
+            ++headers;
+    }
+    QCOMPARE(headers, 3);
+    QCOMPARE(rows.at(0).at(8), QString("Task To Run"));
+    QCOMPARE(rows.at(4).at(1), QString("TaskName"));
+
+    const QStringList &sync = rows.at(1);
+    QCOMPARE(sync.at(1), QString("\\Contoso Logon Sync"));
+    QCOMPARE(sync.at(3), QString("Disabled"));
+    QCOMPARE(sync.at(8), QString("\"C:\\Program Files\\Contoso\\sync.exe\" --profile \"Work, Home\""));
+    QCOMPARE(sync.at(10), QString("Syncs the work folder at logon, then exits"));
+    QCOMPARE(sync.at(13), QString("Stop On Battery Mode, No Start On Batteries"));
+
+    QCOMPARE(rows.at(3).at(8), QString("powershell.exe -NoProfile -File \"C:\\Scripts\\backup.ps1\""));
+    QCOMPARE(rows.last().at(1), QString("\\Microsoft\\Windows\\WindowsUpdate\\Scheduled Start"));
+}
+
+void TestCsvStreamParser::chunkSizesAgree_data()
+{
+    QTest::addColumn<int>("chunkSize");
+    for (int size : {1, 2, 3, 7, 64, 1000})
+        QTest::newRow(qPrintable(QString("%1 bytes").arg(size))) << size;
+}
+
+void TestCsvStreamParser::chunkSizesAgree()
+{
+    QFETCH(int, chunkSize);
+
+    QByteArray input = readFixture();
+    QCOMPARE(parseInChunksOf(input, chunkSize), parse(input));
+}
+
+void TestCsvStreamParser::everySplitPointAgrees()
+{
+    // Covers splits inside quoted fields, between doubled quotes and between CR and LF
+    QByteArray input = readFixture();
+    Rows expected = parse(input);
+    for (int split = 1; split < input.size(); ++split)
+    {
+        if (parse(input, {split}) != expected)
+            QFAIL(qPrintable(QString("Splitting at byte %1 changes the rows").arg(split)));
+    }
+}
+
+void TestCsvStreamParser::splitInsideQuotedField()
+{
+    QByteArray input("\"\"\"C:\\Program Files\\x.exe\"\" \"\"a,b\"\"\",next\r\n");
+    Rows expected{{"\"C:\\Program Files\\x.exe\" \"a,b\"", "next"}};
+
+    QCOMPARE(parse(input, {5}), expected);
+    QCOMPARE(parse(input, {int(input.indexOf("\"\"a")) + 1}), expected);
+    QCOMPARE(parse(input, {int(input.indexOf('\r')) + 1}), expected);
+}
+
+QTEST_GUILESS_MAIN(TestCsvStreamParser)
+#include "tst_csvstreamparser.moc"
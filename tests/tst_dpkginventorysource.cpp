@@ -0,0 +1,193 @@
+#include <QtTest>
+#include "dpkginventorysource.h"
+
+namespace
+{
+    const int SyntheticPackages = 20000;
+    // Generous for a debug build on a busy machine; a release build takes a few milliseconds
+    const int SyntheticParseLimitMs = 1000;
+
+    QString fixture()
+    {
+        return QString(FIXTURE_DIR) + "/dpkg/status";
+    }
+
+    QByteArray readFixture()
+    {
+        QFile file(fixture());
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QString writeStatus(QTemporaryDir &dir, const QByteArray &contents)
+    {
+        QString path = dir.filePath("status");
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly))
+            file.write(contents);
+        return path;
+    }
+
+    QHash<QString, InventoryRecord> recordsByKey(const QList<InventoryRecord> &records)
+    {
+        QHash<QString, InventoryRecord> byKey;
+        for (const InventoryRecord &record : records)
+            byKey.insert(record.key, record);
+        return byKey;
+    }
+
+    // A status file the size of a full desktop install: every fourth package
+    // is removed but keeps its configuration
+    QByteArray syntheticStatus(int packages)
+    {
+        QByteArray status;
+        status.reserve(packages * 600);
+        for (int i = 0; i < packages; ++i)
+        {
+            status += "Package: synthetic-package-" + QByteArray::number(i) + "\n";
+            status += i % 4 == 3 ? "Status: deinstall ok config-files\n" : "Status: install ok installed\n";
+            status += "Priority: optional\nSection: misc\n";
+            status += "Installed-Size: " + QByteArray::number(100 + i) + "\n";
+            status += "Maintainer: Synthetic Maintainers <synthetic@example.com>\n";
+            status += "Architecture: amd64\n";
+            status += "Version: 1." + QByteArray::number(i % 100) + "-1\n";
+            status += "Depends: libc6 (>= 2.34), libsynthetic" + QByteArray::number(i % 50) + " (>= 1.0)\n";
+            status += "Description: Synthetic package number " + QByteArray::number(i) + "\n";
+            status += " A long description spread over continuation lines, as most\n";
+            status += " packages have one.\n .\n Version: 0.0 inside a description is not a field.\n\n";
+        }
+        return status;
+    }
+}
+
+class TestDpkgInventorySource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readsInstalledPackages();
+    void skipsContinuationLines();
+    void stampChangesWithTheStanza();
+    void readsSelectedEntries();
+    void missingStatusFile();
+    void parsesThousandsOfPackagesQuickly();
+
+    void benchmarkParse();
+};
+
+void TestDpkgInventorySource::readsInstalledPackages()
+{
+    DpkgInventorySource source(fixture());
+    QCOMPARE(source.id(), "dpkg:" + fixture());
+
+    QList<QPair<QString, qint64>> entries;
+    QVERIFY(source.listEntries(entries));
+    QCOMPARE(entries.size(), 6);
+
+    // "deinstall ok config-files" and "purge ok not-installed" stanzas are not installed;
+    // "deinstall ok installed" is, until apt gets to it
+    QHash<QString, InventoryRecord> records = recordsByKey(source.readEntries(QStringList()));
+    QCOMPARE(QSet<QString>(records.keyBegin(), records.keyEnd()),
+             QSet<QString>({"bash:amd64", "libc6:amd64", "libc6:i386", "gimp:amd64", "fonts-dejavu-core:all",
+                            "dpkg:amd64"}));
+
+    InventoryRecord bash = records.value("bash:amd64");
+    QCOMPARE(bash.value("DisplayName").toString(), QString("bash"));
+    QCOMPARE(bash.value("DisplayVersion").toString(), QString("5.2.21-2ubuntu4"));
+    QCOMPARE(bash.value("Publisher").toString(),
+             QString("Ubuntu Developers <ubuntu-devel-discuss@lists.ubuntu.com>"));
+    QCOMPARE(bash.value("EstimatedSize").toLongLong(), qint64(7124));
+    QCOMPARE(bash.value("SystemComponent").toInt(), 1);
+
+    QCOMPARE(records.value("libc6:i386").value("EstimatedSize").toLongLong(), qint64(12544));
+    QCOMPARE(records.value("gimp:amd64").value("SystemComponent").toInt(), 0);
+
+    // No Installed-Size field
+    QCOMPARE(records.value("fonts-dejavu-core:all").value("EstimatedSize").toLongLong(), qint64(0));
+
+    // The last stanza has no blank line after it
+    QCOMPARE(records.value("dpkg:amd64").value("DisplayVersion").toString(), QString("1.22.6ubuntu6"));
+}
+
+void TestDpkgInventorySource::skipsContinuationLines()
+{
+    // bash's description has indented "Version:" and "Installed-Size:" lines
+    DpkgInventorySource source(fixture());
+    InventoryRecord bash = recordsByKey(source.readEntries(QStringList())).value("bash:amd64");
+    QCOMPARE(bash.value("DisplayVersion").toString(), QString("5.2.21-2ubuntu4"));
+    QCOMPARE(bash.value("EstimatedSize").toLongLong(), qint64(7124));
+}
+
+void TestDpkgInventorySource::stampChangesWithTheStanza()
+{
+    QTemporaryDir dir;
+    QByteArray status = readFixture();
+    DpkgInventorySource source(writeStatus(dir, status));
+    QHash<QString, InventoryRecord> before = recordsByKey(source.readEntries(QStringList()));
+
+    // An upgrade of libc6:i386 rewrites only its stanza
+    int stanza = status.indexOf("Architecture: i386");
+    QVERIFY(stanza > 0);
+    status.replace(status.indexOf("Version: 2.39-0ubuntu8", stanza), 22, "Version: 2.39-0ubuntu9");
+    writeStatus(dir, status);
+    QHash<QString, InventoryRecord> after = recordsByKey(source.readEntries(QStringList()));
+
+    QCOMPARE(after.size(), before.size());
+    for (auto it = before.constBegin(); it != before.constEnd(); ++it)
+    {
+        bool changed = after.value(it.key()).lastWriteTime != it.value().lastWriteTime;
+        QCOMPARE(changed, it.key() == "libc6:i386");
+    }
+}
+
+void TestDpkgInventorySource::readsSelectedEntries()
+{
+    DpkgInventorySource source(fixture());
+    QList<InventoryRecord> records = source.readEntries({"libc6:amd64", "vlc:amd64"});
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.first().value("DisplayVersion").toString(), QString("2.39-0ubuntu8"));
+}
+
+void TestDpkgInventorySource::missingStatusFile()
+{
+    DpkgInventorySource source(QString(FIXTURE_DIR) + "/dpkg/missing");
+    QList<QPair<QString, qint64>> entries;
+    QVERIFY(!source.listEntries(entries));
+    QVERIFY(source.readEntries(QStringList()).isEmpty());
+
+    QTemporaryDir dir;
+    DpkgInventorySource empty(writeStatus(dir, QByteArray()));
+    QVERIFY(empty.listEntries(entries));
+    QVERIFY(entries.isEmpty());
+}
+
+void TestDpkgInventorySource::parsesThousandsOfPackagesQuickly()
+{
+    QTemporaryDir dir;
+    DpkgInventorySource source(writeStatus(dir, syntheticStatus(SyntheticPackages)));
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QPair<QString, qint64>> entries;
+    QVERIFY(source.listEntries(entries));
+    qint64 elapsed = timer.elapsed();
+
+    QCOMPARE(entries.size(), SyntheticPackages - SyntheticPackages / 4);
+    QVERIFY2(elapsed < SyntheticParseLimitMs,
+             qPrintable(QString("%1 packages took %2 ms").arg(SyntheticPackages).arg(elapsed)));
+}
+
+void TestDpkgInventorySource::benchmarkParse()
+{
+    QTemporaryDir dir;
+    DpkgInventorySource source(writeStatus(dir, syntheticStatus(SyntheticPackages)));
+
+    int count = 0;
+    QBENCHMARK
+    {
+        count = source.readEntries(QStringList()).size();
+    }
+    QCOMPARE(count, SyntheticPackages - SyntheticPackages / 4);
+}
+
+QTEST_GUILESS_MAIN(TestDpkgInventorySource)
+#include "tst_dpkginventorysource.moc"
@@ -0,0 +1,211 @@
+#include <QtTest>
+#include "globmatcher.h"
+
+namespace
+{
+    const int CorpusSize = 20000;
+
+    // The matching the cleaner did before GlobMatcher: one anchored
+    // expression per pattern, tried in turn
+    class RegexMatcher
+    {
+    public:
+        explicit RegexMatcher(const QStringList &patterns)
+        {
+            for (const QString &pattern : patterns)
+            {
+                m_patterns.append(QRegularExpression(
+                    QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(pattern)),
+                    QRegularExpression::CaseInsensitiveOption));
+            }
+        }
+
+        bool matches(const QString &fileName) const
+        {
+            for (const QRegularExpression &pattern : m_patterns)
+            {
+                if (pattern.match(fileName).hasMatch())
+                    return true;
+            }
+            return false;
+        }
+
+    private:
+        QVector<QRegularExpression> m_patterns;
+    };
+
+    // File names as found in temp, log and cache folders, built the same way on every run
+    QStringList fileNameCorpus()
+    {
+        const QStringList stems = {"setup", "Report", "thumbcache_", "iconcache_", "~DF", "MpCmdRun", "chrome_installer",
+                                   "CBS", "WindowsUpdate.20240312", "Temp", "temp", "msedge", "OneDrive", "data"};
+        const QStringList extensions = {".tmp", ".log", ".db", ".etl", ".dmp", ".hdmp", ".wer", ".dat", ".TMP", ".LOG",
+                                        ".pf", ".json", ".exe", ".dll", ""};
+
+        QStringList names;
+        names.reserve(CorpusSize);
+        quint32 state = 12345;
+        for (int i = 0; i < CorpusSize; ++i)
+        {
+            state = state * 1103515245u + 12345u;
+            QString stem = stems.at((state >> 8) % stems.size());
+            QString extension = extensions.at((state >> 16) % extensions.size());
+            QString middle = (state & 1) ? QString::number(i % 1000) : QString::number(i, 16).toUpper();
+            names.append(stem + middle + extension);
+        }
+        return names;
+    }
+
+    QStringList patternSet(const QString &name)
+    {
+        if (name == "dumps")
+            return {"*.dmp", "*.hdmp"};
+        if (name == "everything")
+            return {"*"};
+        return {"*.tmp", "*.log", "~*", "thumbcache_*.db", "iconcache_??.db", "*.etl", "Report.wer", "[Tt]emp*.dat",
+                "Windows*.20??????.*"};
+    }
+
+    void addPatternRows()
+    {
+        QTest::addColumn<QStringList>("patterns");
+        for (const QString &name : {"dumps", "cleaner mix", "everything"})
+            QTest::newRow(qPrintable(name)) << patternSet(name);
+    }
+}
+
+class TestGlobMatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void matchesSinglePatterns_data();
+    void matchesSinglePatterns();
+    void agreesWithRegex_data();
+    void agreesWithRegex();
+    void emptyMatcher();
+
+    void benchmarkRegex_data();
+    void benchmarkRegex();
+    void benchmarkGlobMatcher_data();
+    void benchmarkGlobMatcher();
+
+private:
+    QStringList m_corpus;
+};
+
+void TestGlobMatcher::initTestCase()
+{
+    m_corpus = fileNameCorpus();
+}
+
+void TestGlobMatcher::matchesSinglePatterns_data()
+{
+    QTest::addColumn<QString>("pattern");
+    QTest::addColumn<QString>("fileName");
+    QTest::addColumn<bool>("expected");
+
+    QTest::newRow("suffix") << "*.log" << "CBS.log" << true;
+    QTest::newRow("suffix, other case") << "*.log" << "CBS.LOG" << true;
+    QTest::newRow("suffix, no match") << "*.log" << "CBS.log.old" << false;
+    QTest::newRow("prefix") << "~*" << "~DF1234.TMP" << true;
+    QTest::newRow("exact") << "Report.wer" << "report.WER" << true;
+    QTest::newRow("exact, longer") << "Report.wer" << "Report.wer2" << false;
+    QTest::newRow("two stars") << "thumbcache_*.db" << "thumbcache_idx.db" << true;
+    QTest::newRow("two stars, empty middle") << "thumbcache_*.db" << "thumbcache_.db" << true;
+    QTest::newRow("two stars, wrong tail") << "thumbcache_*.db" << "thumbcache_idx.dbx" << false;
+    QTest::newRow("question marks") << "iconcache_??.db" << "iconcache_32.db" << true;
+    QTest::newRow("question marks, too long") << "iconcache_??.db" << "iconcache_256.db" << false;
+    QTest::newRow("backtracking") << "*a*b" << "xaxxbxb" << true;
+    QTest::newRow("character set") << "[Tt]emp*.dat" << "temp01.dat" << true;
+    QTest::newRow("character set, no match") << "[Tt]emp*.dat" << "xemp01.dat" << false;
+    QTest::newRow("star only") << "*" << "anything" << true;
+}
+
+void TestGlobMatcher::matchesSinglePatterns()
+{
+    QFETCH(QString, pattern);
+    QFETCH(QString, fileName);
+    QFETCH(bool, expected);
+
+    QCOMPARE(GlobMatcher({pattern}).matches(fileName), expected);
+    QCOMPARE(RegexMatcher({pattern}).matches(fileName), expected);
+}
+
+void TestGlobMatcher::agreesWithRegex_data()
+{
+    addPatternRows();
+}
+
+void TestGlobMatcher::agreesWithRegex()
+{
+    QFETCH(QStringList, patterns);
+
+    GlobMatcher matcher(patterns);
+    RegexMatcher reference(patterns);
+    int matched = 0;
+    for (const QString &name : m_corpus)
+    {
+        bool expected = reference.matches(name);
+        if (matcher.matches(name) != expected)
+            QFAIL(qPrintable(QString("%1 differs from the regular expressions").arg(name)));
+        matched += expected ? 1 : 0;
+    }
+
+    // The corpus exercises both outcomes unless everything matches
+    QVERIFY(matched > 0);
+    QVERIFY(matched < m_corpus.size() || matcher.matchesEverything());
+}
+
+void TestGlobMatcher::emptyMatcher()
+{
+    GlobMatcher matcher(QStringList{QString()});
+    QVERIFY(matcher.isEmpty());
+    QVERIFY(!matcher.matches("file.tmp"));
+    QVERIFY(!GlobMatcher().matchesEverything());
+}
+
+void TestGlobMatcher::benchmarkRegex_data()
+{
+    addPatternRows();
+}
+
+void TestGlobMatcher::benchmarkRegex()
+{
+    QFETCH(QStringList, patterns);
+
+    RegexMatcher matcher(patterns);
+    int matched = 0;
+    QBENCHMARK
+    {
+        matched = 0;
+        for (const QString &name : m_corpus)
+            matched += matcher.matches(name) ? 1 : 0;
+    }
+    QVERIFY(matched > 0);
+}
+
+void TestGlobMatcher::benchmarkGlobMatcher_data()
+{
+    addPatternRows();
+}
+
+void TestGlobMatcher::benchmarkGlobMatcher()
+{
+    QFETCH(QStringList, patterns);
+
+    GlobMatcher matcher(patterns);
+    int matched = 0;
+    QBENCHMARK
+    {
+        matched = 0;
+        for (const QString &name : m_corpus)
+            matched += matcher.matches(name) ? 1 : 0;
+    }
+    QVERIFY(matched > 0);
+}
+
+QTEST_GUILESS_MAIN(TestGlobMatcher)
+#include "tst_globmatcher.moc"
@@ -0,0 +1,207 @@
+#include <QtTest>
+#include "inventoryscanner.h"
+#include "memoryinventorysource.h"
+
+namespace
+{
+    const int SyntheticEntries = 10000;
+
+    // Counts the entries read, to check that rescans only read what changed
+    class CountingSource : public MemoryInventorySource
+    {
+    public:
+        explicit CountingSource(const QString &id) : MemoryInventorySource(id) {}
+
+        QList<InventoryRecord> readEntries(const QStringList &keys) const override
+        {
+            QList<InventoryRecord> records = MemoryInventorySource::readEntries(keys);
+            m_read.fetchAndAddRelaxed(records.size());
+            return records;
+        }
+
+        int takeReadCount() const { return m_read.fetchAndStoreRelaxed(0); }
+
+    private:
+        mutable QAtomicInt m_read;
+    };
+
+    InventoryRecord syntheticRecord(int index, qint64 lastWriteTime)
+    {
+        InventoryRecord record;
+        record.key = QString("{%1-0000-4000-8000-000000000000}").arg(index, 8, 16, QChar('0'));
+        record.lastWriteTime = lastWriteTime;
+        record.values.insert("DisplayName", QString("Synthetic Program %1").arg(index));
+        record.values.insert("DisplayVersion", "1.0." + QString::number(index % 100));
+        record.values.insert("Publisher", QString("Publisher %1").arg(index % 250));
+        record.values.insert("InstallDate", "20240101");
+        record.values.insert("EstimatedSize", 1024 + index);
+        record.values.insert("InstallLocation", QString("C:/Program Files/Synthetic %1").arg(index));
+
+        // Every tenth entry has no uninstaller and is not listed, like hotfix keys
+        if (index % 10 != 0)
+            record.values.insert("UninstallString", QString("C:/Program Files/Synthetic %1/uninstall.exe").arg(index));
+        return record;
+    }
+
+    int expectedCount(int entries)
+    {
+        return entries - (entries + 9) / 10;
+    }
+}
+
+class TestInventoryScanner : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+
+    void fullScan();
+    void unchangedRescanReadsNothing();
+    void changedEntryIsReadAlone();
+    void removedEntryIsDropped();
+    void cancelledScanIsEmpty();
+    void iniFixture();
+
+    void benchmarkFullScan();
+    void benchmarkRescanOneChange();
+
+private:
+    CountingSource *m_source = nullptr;
+    QList<InventorySource *> m_sources;
+    QAtomicInteger<bool> m_cancel;
+};
+
+void TestInventoryScanner::init()
+{
+    m_source = new CountingSource("memory");
+    for (int i = 0; i < SyntheticEntries; ++i)
+        m_source->setRecord(syntheticRecord(i, 1000 + i));
+    m_sources = {m_source};
+    m_cancel = false;
+}
+
+void TestInventoryScanner::cleanup()
+{
+    qDeleteAll(m_sources);
+    m_sources.clear();
+    m_source = nullptr;
+}
+
+void TestInventoryScanner::fullScan()
+{
+    SoftwareInventory inventory = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+
+    QCOMPARE(inventory.software().size(), expectedCount(SyntheticEntries));
+    QCOMPARE(m_source->takeReadCount(), SyntheticEntries);
+    QVERIFY(inventory.hasSource("memory"));
+    QVERIFY(inventory.createdAt().isValid());
+
+    QHash<QString, InstalledSoftware> entries = inventory.entriesForSource("memory");
+    InstalledSoftware software = entries.value(syntheticRecord(7, 0).key);
+    QCOMPARE(software.name, QString("Synthetic Program 7"));
+    QCOMPARE(software.installDate, QString("2024-01-01"));
+    QCOMPARE(software.size, qint64(1024 + 7) * 1024);
+    QCOMPARE(software.lastWriteTime, qint64(1007));
+}
+
+void TestInventoryScanner::unchangedRescanReadsNothing()
+{
+    SoftwareInventory first = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+    m_source->takeReadCount();
+
+    SoftwareInventory second = InventoryScanner::scan(m_sources, first, m_cancel);
+    QCOMPARE(m_source->takeReadCount(), 0);
+    QCOMPARE(second.software().size(), first.software().size());
+    QCOMPARE(second.sourceFingerprint("memory"), first.sourceFingerprint("memory"));
+}
+
+void TestInventoryScanner::changedEntryIsReadAlone()
+{
+    SoftwareInventory first = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+    m_source->takeReadCount();
+
+    InventoryRecord updated = syntheticRecord(42, 999999);
+    updated.values.insert("DisplayVersion", "2.0");
+    m_source->setRecord(updated);
+
+    SoftwareInventory second = InventoryScanner::scan(m_sources, first, m_cancel);
+    QCOMPARE(m_source->takeReadCount(), 1);
+    QCOMPARE(second.software().size(), first.software().size());
+    QVERIFY(second.sourceFingerprint("memory") != first.sourceFingerprint("memory"));
+    QCOMPARE(second.entriesForSource("memory").value(updated.key).version, QString("2.0"));
+}
+
+void TestInventoryScanner::removedEntryIsDropped()
+{
+    SoftwareInventory first = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+    m_source->takeReadCount();
+
+    QString removed = syntheticRecord(43, 0).key;
+    m_source->removeRecord(removed);
+
+    SoftwareInventory second = InventoryScanner::scan(m_sources, first, m_cancel);
+    QCOMPARE(m_source->takeReadCount(), 0);
+    QCOMPARE(second.software().size(), first.software().size() - 1);
+    QVERIFY(!second.entriesForSource("memory").contains(removed));
+}
+
+void TestInventoryScanner::cancelledScanIsEmpty()
+{
+    m_cancel = true;
+    SoftwareInventory inventory = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+    QVERIFY(inventory.isEmpty());
+    QCOMPARE(m_source->takeReadCount(), 0);
+}
+
+void TestInventoryScanner::iniFixture()
+{
+    MemoryInventorySource *fixture = new MemoryInventorySource("ini");
+    QVERIFY(fixture->loadIni(QString(FIXTURE_DIR) + "/inventory/uninstall.ini"));
+    QCOMPARE(fixture->count(), 4);
+
+    QList<InventorySource *> sources = {fixture};
+    SoftwareInventory inventory = InventoryScanner::scan(sources, SoftwareInventory(), m_cancel);
+    qDeleteAll(sources);
+
+    // The hotfix has no uninstaller and the last entry no display name
+    QHash<QString, InstalledSoftware> entries = inventory.entriesForSource("ini");
+    QCOMPARE(entries.size(), 2);
+
+    InstalledSoftware editor = entries.value("{6F1B3A2C-0000-4C1D-9E11-000000000001}");
+    QCOMPARE(editor.name, QString("Example Editor"));
+    QCOMPARE(editor.version, QString("2.4.1"));
+    QCOMPARE(editor.installDate, QString("2024-03-12"));
+    QCOMPARE(editor.size, qint64(20480) * 1024);
+    QCOMPARE(editor.lastWriteTime, qint64(1710201600000));
+
+    InstalledSoftware tool = entries.value("ExampleTool");
+    QVERIFY(tool.uninstallString.isEmpty());
+    QVERIFY(!tool.quietUninstallString.isEmpty());
+    QCOMPARE(tool.installDate, QString("Unknown"));
+}
+
+void TestInventoryScanner::benchmarkFullScan()
+{
+    QBENCHMARK
+    {
+        SoftwareInventory inventory = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+        QCOMPARE(inventory.software().size(), expectedCount(SyntheticEntries));
+    }
+}
+
+void TestInventoryScanner::benchmarkRescanOneChange()
+{
+    SoftwareInventory previous = InventoryScanner::scan(m_sources, SoftwareInventory(), m_cancel);
+    m_source->setRecord(syntheticRecord(42, 999999));
+
+    QBENCHMARK
+    {
+        SoftwareInventory inventory = InventoryScanner::scan(m_sources, previous, m_cancel);
+        QCOMPARE(inventory.software().size(), expectedCount(SyntheticEntries));
+    }
+}
+
+QTEST_GUILESS_MAIN(TestInventoryScanner)
+#include "tst_inventoryscanner.moc"
@@ -0,0 +1,167 @@
+#include <QtTest>
+#include "prefetchparser.h"
+
+// The fixtures are written by fixtures/prefetch/make_prefetch.py
+namespace
+{
+    QString fixtureDirectory()
+    {
+        return QString(FIXTURE_DIR) + "/prefetch";
+    }
+
+    QByteArray readFixture(const QString &name)
+    {
+        QFile file(fixtureDirectory() + "/" + name);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QDateTime unixTime(qint64 seconds)
+    {
+        return QDateTime::fromMSecsSinceEpoch(seconds * 1000);
+    }
+}
+
+class TestPrefetchParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesEveryVersion_data();
+    void parsesEveryVersion();
+    void readsLoadedFiles();
+    void countsRecentRuns();
+    void mergesCopiesOfOneProgram();
+    void keysExecutablesLikeWindows();
+    void rejectsDamagedFiles();
+};
+
+void TestPrefetchParser::parsesEveryVersion_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<int>("version");
+    QTest::addColumn<QString>("executable");
+    QTest::addColumn<int>("runCount");
+    QTest::addColumn<int>("lastRunCount");
+    QTest::addColumn<qint64>("lastRun");
+    QTest::addColumn<int>("fileCount");
+    QTest::addColumn<qint64>("traceBlocks");
+    QTest::addColumn<QString>("volume");
+
+    QTest::newRow("17") << "NOTEPAD.EXE-1A2B3C4D.pf" << 17 << "NOTEPAD.EXE" << 5 << 1 << qint64(1600000000)
+                        << 2 << qint64(7) << "\\DEVICE\\HARDDISKVOLUME1";
+    QTest::newRow("23") << "CALC.EXE-2B3C4D5E.pf" << 23 << "CALC.EXE" << 12 << 1 << qint64(1600000000)
+                        << 2 << qint64(10) << "\\DEVICE\\HARDDISKVOLUME2";
+    QTest::newRow("26") << "SKYPE.EXE-3C4D5E6F.pf" << 26 << "SKYPE.EXE" << 40 << 3 << qint64(1700000000)
+                        << 2 << qint64(101) << "\\DEVICE\\HARDDISKVOLUME3";
+    QTest::newRow("30 compressed") << "ONEDRIVE.EXE-4D5E6F70.pf" << 30 << "ONEDRIVE.EXE" << 99 << 2
+                                   << qint64(1750000000) << 1202 << qint64(12497500) << "\\VOLUME{01d2-abcd}";
+    QTest::newRow("30 compact, fixed codes") << "ONEDRIVE.EXE-5E6F7081.pf" << 30 << "ONEDRIVE.EXE" << 3 << 1
+                                             << qint64(1600000000) << 2 << qint64(7) << "\\VOLUME{01d2-abcd}";
+    // Names are cut to 29 characters
+    QTest::newRow("31") << "A-VERY-LONG-EXECUTABLE-NAME-1-6F708192.pf" << 31 << "A-VERY-LONG-EXECUTABLE-NAME-1"
+                        << 1 << 1 << qint64(1760000000) << 2 << qint64(2) << "\\VOLUME{x}";
+}
+
+void TestPrefetchParser::parsesEveryVersion()
+{
+    QFETCH(QString, file);
+    QFETCH(int, version);
+    QFETCH(QString, executable);
+    QFETCH(int, runCount);
+    QFETCH(int, lastRunCount);
+    QFETCH(qint64, lastRun);
+    QFETCH(int, fileCount);
+    QFETCH(qint64, traceBlocks);
+    QFETCH(QString, volume);
+
+    PrefetchInfo info;
+    QString error;
+    QVERIFY2(PrefetchParser::parseFile(fixtureDirectory() + "/" + file, info, error), qPrintable(error));
+
+    QCOMPARE(info.version, version);
+    QCOMPARE(info.executableName, executable);
+    QCOMPARE(info.hash, quint32(0xDEADBEEF));
+    QCOMPARE(info.runCount, runCount);
+    QCOMPARE(info.lastRuns.size(), lastRunCount);
+    QCOMPARE(info.lastRun(), unixTime(lastRun));
+    QCOMPARE(info.loadedFiles.size(), fileCount);
+    QCOMPARE(info.traceBlocks, traceBlocks);
+    QCOMPARE(info.estimatedReadBytes(), traceBlocks * 4096);
+    QCOMPARE(info.volumes, QStringList{volume});
+}
+
+void TestPrefetchParser::readsLoadedFiles()
+{
+    PrefetchInfo info;
+    QString error;
+    QVERIFY(PrefetchParser::parse(readFixture("ONEDRIVE.EXE-4D5E6F70.pf"), info, error));
+
+    // Spread over several 64 KB blocks of compressed output
+    QCOMPARE(info.loadedFiles.first(), QString("\\VOLUME{01d2-abcd}\\WINDOWS\\SYSTEM32\\NTDLL.DLL"));
+    QCOMPARE(info.loadedFiles.at(600), QString("\\VOLUME{01d2-abcd}\\PROGRAM FILES\\APP\\LIB0598.DLL"));
+    QCOMPARE(info.loadedFiles.last(), QString("\\VOLUME{01d2-abcd}\\PROGRAM FILES\\APP\\LIB1199.DLL"));
+}
+
+void TestPrefetchParser::countsRecentRuns()
+{
+    PrefetchInfo info;
+    QString error;
+    QVERIFY(PrefetchParser::parse(readFixture("SKYPE.EXE-3C4D5E6F.pf"), info, error));
+
+    // Launched at 1.68e9, 1.69e9 and 1.7e9; the lifetime run count does not matter
+    QCOMPARE(info.runsSince(unixTime(1670000000)), 3);
+    QCOMPARE(info.runsSince(unixTime(1685000000)), 2);
+    QCOMPARE(info.runsSince(unixTime(1700000000)), 1);
+    QCOMPARE(info.runsSince(unixTime(1710000000)), 0);
+    QVERIFY(info.runCount > info.runsSince(unixTime(0)));
+}
+
+void TestPrefetchParser::mergesCopiesOfOneProgram()
+{
+    QHash<QString, PrefetchInfo> programs = PrefetchParser::scanDirectory(fixtureDirectory());
+    QCOMPARE(programs.size(), 5);
+
+    // Two files for ONEDRIVE.EXE: counts add up, the newer copy describes the launch
+    PrefetchInfo oneDrive = programs.value("ONEDRIVE.EXE");
+    QCOMPARE(oneDrive.runCount, 102);
+    QCOMPARE(oneDrive.loadedFiles.size(), 1202);
+    QCOMPARE(oneDrive.lastRuns,
+             QList<QDateTime>({unixTime(1750000000), unixTime(1740000000), unixTime(1600000000)}));
+
+    QVERIFY(PrefetchParser::scanDirectory(QString()).isEmpty());
+}
+
+void TestPrefetchParser::keysExecutablesLikeWindows()
+{
+    QCOMPARE(PrefetchParser::executableKey("C:/Program Files/Microsoft OneDrive/OneDrive.exe"),
+             QString("ONEDRIVE.EXE"));
+    QCOMPARE(PrefetchParser::executableKey("D:/Tools/a-very-long-executable-name-123.exe"),
+             QString("A-VERY-LONG-EXECUTABLE-NAME-1"));
+}
+
+void TestPrefetchParser::rejectsDamagedFiles()
+{
+    PrefetchInfo info;
+    QString error;
+
+    QVERIFY(!PrefetchParser::parse(QByteArray(512, 'x'), info, error));
+    QCOMPARE(error, QString("Not a Prefetch file."));
+
+    QByteArray unsupported = readFixture("NOTEPAD.EXE-1A2B3C4D.pf");
+    unsupported[0] = char(99);
+    QVERIFY(!PrefetchParser::parse(unsupported, info, error));
+
+    // Sections that point past the end of a cut-off file
+    QByteArray truncated = readFixture("SKYPE.EXE-3C4D5E6F.pf");
+    truncated.truncate(0x140);
+    QVERIFY(!PrefetchParser::parse(truncated, info, error));
+
+    // Compressed data that ends early
+    QByteArray compressed = readFixture("ONEDRIVE.EXE-4D5E6F70.pf");
+    compressed.truncate(compressed.size() / 2);
+    QVERIFY(!PrefetchParser::parse(compressed, info, error));
+    QVERIFY(!error.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestPrefetchParser)
+#include "tst_prefetchparser.moc"
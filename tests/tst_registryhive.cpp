@@ -0,0 +1,219 @@
+#include <QtTest>
+#include "registryhive.h"
+#include "hivestartupsource.h"
+
+// The fixtures are written by fixtures/hives/make_hives.py
+namespace
+{
+    const qint64 FixtureFileTime = 133546752000000000LL; // 2024-03-12 00:00:00 UTC
+
+    QString fixture(const QString &name)
+    {
+        return QString(FIXTURE_DIR) + "/hives/" + name;
+    }
+
+    QString writeTemporary(QTemporaryDir &dir, const QByteArray &data)
+    {
+        QString path = dir.filePath("hive");
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly))
+            file.write(data);
+        return path;
+    }
+}
+
+class TestRegistryHive : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void rejectsOtherFiles();
+    void rejectsDamagedRoot();
+    void findsKeysCaseInsensitively();
+    void missingKeyHasNoValues();
+    void decodesValueTypes();
+    void readsBigData();
+    void followsIndexRoots();
+    void readsUtf16Names();
+    void readsLastWriteTime();
+
+    void startupSourceListsRunKeys();
+    void startupSourceIsReadOnly();
+    void startupSourceWithoutHive();
+};
+
+void TestRegistryHive::rejectsOtherFiles()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    RegistryHive hive;
+    QVERIFY(!hive.open(writeTemporary(dir, QByteArray(8192, '\0'))));
+    QVERIFY(!hive.isOpen());
+    QVERIFY(!hive.errorString().isEmpty());
+
+    // Shorter than the base block
+    QVERIFY(!hive.open(writeTemporary(dir, QByteArray("regf") + QByteArray(100, '\0'))));
+    QVERIFY(!hive.open(dir.filePath("missing")));
+}
+
+void TestRegistryHive::rejectsDamagedRoot()
+{
+    QFile source(fixture("SOFTWARE"));
+    QVERIFY(source.open(QIODevice::ReadOnly));
+    QByteArray data = source.readAll();
+
+    // Root cell offset past the end of the file
+    qToLittleEndian<quint32>(0x7FFFFFF0, reinterpret_cast<uchar *>(data.data()) + 0x24);
+
+    QTemporaryDir dir;
+    RegistryHive hive;
+    QVERIFY(!hive.open(writeTemporary(dir, data)));
+    QCOMPARE(hive.errorString(), QString("The hive's root key is damaged"));
+}
+
+void TestRegistryHive::findsKeysCaseInsensitively()
+{
+    RegistryHive hive;
+    QVERIFY2(hive.open(fixture("SOFTWARE")), qPrintable(hive.errorString()));
+    QCOMPARE(hive.keyName(hive.rootKey()), QString("ROOT"));
+
+    quint32 run = hive.findKey("Microsoft\\Windows\\CurrentVersion\\Run");
+    QVERIFY(run != 0);
+    QCOMPARE(hive.findKey("microsoft\\WINDOWS\\currentversion\\run"), run);
+    QCOMPARE(hive.findKey("\\Microsoft\\Windows\\CurrentVersion\\Run\\"), run);
+    QCOMPARE(hive.keyName(run), QString("Run"));
+
+    QStringList names;
+    for (quint32 key : hive.subkeys(hive.findKey("Raptor")))
+        names.append(hive.keyName(key));
+    QCOMPARE(names, QStringList({"Types", "Many"}));
+}
+
+void TestRegistryHive::missingKeyHasNoValues()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("SOFTWARE")));
+    QCOMPARE(hive.findKey("Microsoft\\Nothing\\Here"), 0u);
+    QVERIFY(hive.values(0).isEmpty());
+    QVERIFY(hive.subkeys(0).isEmpty());
+    QVERIFY(hive.keyName(0).isEmpty());
+}
+
+void TestRegistryHive::decodesValueTypes()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("SOFTWARE")));
+    QVariantMap values = hive.values(hive.findKey("Raptor\\Types"));
+
+    QCOMPARE(values.value("").toString(), QString("default"));
+    QCOMPARE(values.value("Dword").toLongLong(), qlonglong(0xDEADBEEF));
+    QCOMPARE(values.value("BigEndian").toLongLong(), qlonglong(0x01020304));
+    QCOMPARE(values.value("Qword").toLongLong(), qlonglong(0x0123456789ABCDEFLL));
+    QCOMPARE(values.value("Multi").toStringList(), QStringList({"one", "two", "three"}));
+    QCOMPARE(values.value("Unterminated").toString(), QString("no terminator"));
+    QCOMPARE(values.value("Inline").toByteArray(), QByteArray("\x01\x02\x03", 3));
+
+    QByteArray binary = values.value("Binary").toByteArray();
+    QCOMPARE(binary.size(), 64);
+    for (int i = 0; i < binary.size(); ++i)
+        QCOMPARE(uchar(binary[i]), uchar(i));
+
+    QVariantMap run = hive.values(hive.findKey("Microsoft\\Windows\\CurrentVersion\\Run"));
+    QCOMPARE(run.value("SecurityHealth").toString(), QString("%windir%\\system32\\SecurityHealthSystray.exe"));
+}
+
+void TestRegistryHive::readsBigData()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("SOFTWARE")));
+
+    // Stored as three segments behind a db cell
+    QByteArray big = hive.values(hive.findKey("Raptor\\Types")).value("Big").toByteArray();
+    QCOMPARE(big.size(), 40000);
+    for (int i = 0; i < big.size(); ++i)
+    {
+        if (uchar(big[i]) != uchar(i % 251))
+            QFAIL(qPrintable(QString("Byte %1 differs").arg(i)));
+    }
+}
+
+void TestRegistryHive::followsIndexRoots()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("SOFTWARE")));
+
+    // 600 subkeys in three hash lists below an ri cell
+    quint32 many = hive.findKey("Raptor\\Many");
+    QList<quint32> subkeys = hive.subkeys(many);
+    QCOMPARE(subkeys.size(), 600);
+    QCOMPARE(hive.keyName(subkeys.first()), QString("Entry000"));
+    QCOMPARE(hive.keyName(subkeys.last()), QString("Entry599"));
+    QCOMPARE(hive.findSubkey(many, "entry300"), subkeys.at(300));
+}
+
+void TestRegistryHive::readsUtf16Names()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("NTUSER.DAT")));
+
+    QVariantMap values = hive.values(hive.findKey("Software\\Microsoft\\Windows\\CurrentVersion\\Run"));
+    const QString cyrillic = QString::fromUtf8("\xD0\x97\xD0\xB0\xD0\xBF\xD1\x83\xD1\x81\xD0\xBA");
+    QCOMPARE(values.value(cyrillic).toString(), QString("C:\\Tools\\zapusk.exe"));
+}
+
+void TestRegistryHive::readsLastWriteTime()
+{
+    RegistryHive hive;
+    QVERIFY(hive.open(fixture("SOFTWARE")));
+    QCOMPARE(hive.lastWriteTime(hive.findKey("Raptor\\Types")), FixtureFileTime);
+    QCOMPARE(hive.lastWriteTime(hive.findKey("Microsoft\\Windows\\CurrentVersion\\Run")), FixtureFileTime + 10000000);
+}
+
+void TestRegistryHive::startupSourceListsRunKeys()
+{
+    HiveStartupSource source(fixture("NTUSER.DAT"), "Software\\Microsoft\\Windows\\CurrentVersion\\Run");
+    QList<StartupProgram> programs = source.scan();
+
+    // The empty Run value is left out
+    QHash<QString, StartupProgram> byName;
+    for (const StartupProgram &program : programs)
+        byName.insert(program.name, program);
+    QCOMPARE(byName.size(), 4);
+    QVERIFY(!byName.contains("Empty"));
+
+    StartupProgram oneDrive = byName.value("OneDrive");
+    QVERIFY(oneDrive.isEnabled);
+    QCOMPARE(oneDrive.status, QString("Enabled"));
+    QCOMPARE(oneDrive.startupType, QString("Registry"));
+    QCOMPARE(oneDrive.command,
+             QString("\"C:\\Users\\demo\\AppData\\Local\\Microsoft\\OneDrive\\OneDrive.exe\" /background"));
+    QCOMPARE(oneDrive.source, source.id());
+
+    QCOMPARE(byName.value("Updater").command, QString("%LOCALAPPDATA%\\Updater\\updater.exe --silent"));
+
+    StartupProgram oldTool = byName.value("OldTool");
+    QVERIFY(!oldTool.isEnabled);
+    QCOMPARE(oldTool.status, QString("Disabled"));
+    QVERIFY(oldTool.location.endsWith("(Disabled)"));
+}
+
+void TestRegistryHive::startupSourceIsReadOnly()
+{
+    HiveStartupSource source(fixture("NTUSER.DAT"), "Software\\Microsoft\\Windows\\CurrentVersion\\Run");
+    QList<StartupProgram> programs = source.scan();
+    QVERIFY(!programs.isEmpty());
+
+    QString error;
+    QVERIFY(!source.setEnabled(programs.first(), false, error));
+    QVERIFY(error.contains("read-only"));
+}
+
+void TestRegistryHive::startupSourceWithoutHive()
+{
+    HiveStartupSource source(fixture("MISSING"), "Microsoft\\Windows\\CurrentVersion\\Run");
+    QVERIFY(source.scan().isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestRegistryHive)
+#include "tst_registryhive.moc"
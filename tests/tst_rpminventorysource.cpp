@@ -0,0 +1,113 @@
+#include <QtTest>
+#include "rpminventorysource.h"
+
+// The fixture is written by fixtures/rpm/make_rpmdb.py
+namespace
+{
+    const int FillerPackages = 300;
+    const qint64 InstallTime = 1710244800; // 2024-03-12 12:00:00 UTC
+
+    QString fixture()
+    {
+        return QString(FIXTURE_DIR) + "/rpm/rpmdb.sqlite";
+    }
+
+    QHash<QString, InventoryRecord> recordsByKey(const QList<InventoryRecord> &records)
+    {
+        QHash<QString, InventoryRecord> byKey;
+        for (const InventoryRecord &record : records)
+            byKey.insert(record.key, record);
+        return byKey;
+    }
+}
+
+class TestRpmInventorySource : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void readsPackages();
+    void prefersTheLongSize();
+    void fallsBackToPackager();
+    void readsOverflowingHeaders();
+    void readsSelectedEntries();
+    void missingDatabase();
+};
+
+void TestRpmInventorySource::readsPackages()
+{
+    RpmInventorySource source(fixture());
+    QCOMPARE(source.id(), "rpm:" + fixture());
+
+    QList<QPair<QString, qint64>> entries;
+    QVERIFY(source.listEntries(entries));
+
+    // Every package but the imported signing key
+    QHash<QString, InventoryRecord> records = recordsByKey(source.readEntries(QStringList()));
+    QCOMPARE(records.size(), FillerPackages + 4);
+    QCOMPARE(entries.size(), records.size());
+    for (auto it = records.constBegin(); it != records.constEnd(); ++it)
+        QVERIFY(!it.key().startsWith("gpg-pubkey"));
+
+    InventoryRecord bash = records.value("bash-5.2.26-3.fc40.x86_64");
+    QCOMPARE(bash.lastWriteTime, InstallTime * 1000);
+    QCOMPARE(bash.value("DisplayName").toString(), QString("bash"));
+    QCOMPARE(bash.value("DisplayVersion").toString(), QString("5.2.26-3.fc40"));
+    QCOMPARE(bash.value("Publisher").toString(), QString("Fedora Project"));
+    QCOMPARE(bash.value("EstimatedSize").toLongLong(), qint64((8200000 + 1023) / 1024));
+    QCOMPARE(bash.value("InstallDate").toString(), QString("20240312"));
+    QCOMPARE(bash.value("SystemComponent").toInt(), 0);
+
+    QVERIFY(records.contains("filler-000-1.0-1.fc40.x86_64"));
+    QCOMPARE(records.value("filler-299-1.299-1.fc40.x86_64").value("EstimatedSize").toLongLong(), qint64(299));
+}
+
+void TestRpmInventorySource::prefersTheLongSize()
+{
+    // The 32-bit size tag wrapped around; the 64-bit one is right
+    RpmInventorySource source(fixture());
+    InventoryRecord kernel = recordsByKey(source.readEntries(QStringList())).value("kernel-core-6.8.5-301.fc40.x86_64");
+    QCOMPARE(kernel.value("EstimatedSize").toLongLong(), qint64((5000000000LL + 1023) / 1024));
+}
+
+void TestRpmInventorySource::fallsBackToPackager()
+{
+    RpmInventorySource source(fixture());
+    InventoryRecord tool = recordsByKey(source.readEntries(QStringList())).value("local-tool-1.0-1.noarch");
+    QCOMPARE(tool.value("DisplayName").toString(), QString("local-tool"));
+    QCOMPARE(tool.value("Publisher").toString(), QString("Jane Doe <jane@example.com>"));
+    QCOMPARE(tool.value("EstimatedSize").toLongLong(), qint64(4));
+}
+
+void TestRpmInventorySource::readsOverflowingHeaders()
+{
+    // The file list puts this header on a chain of overflow pages
+    RpmInventorySource source(fixture());
+    InventoryRecord docs = recordsByKey(source.readEntries(QStringList())).value("big-docs-2.1-7.fc40.noarch");
+    QCOMPARE(docs.value("DisplayVersion").toString(), QString("2.1-7.fc40"));
+    QCOMPARE(docs.value("EstimatedSize").toLongLong(), qint64((70000 + 1023) / 1024));
+}
+
+void TestRpmInventorySource::readsSelectedEntries()
+{
+    RpmInventorySource source(fixture());
+    QList<InventoryRecord> records = source.readEntries({"bash-5.2.26-3.fc40.x86_64", "missing-1-1.x86_64"});
+    QCOMPARE(records.size(), 1);
+    QCOMPARE(records.first().value("DisplayName").toString(), QString("bash"));
+}
+
+void TestRpmInventorySource::missingDatabase()
+{
+    RpmInventorySource missing(QString(FIXTURE_DIR) + "/rpm/missing.sqlite");
+    QList<QPair<QString, qint64>> entries;
+    QVERIFY(!missing.listEntries(entries));
+    QVERIFY(missing.readEntries(QStringList()).isEmpty());
+
+    // A file that is not a database lists nothing
+    RpmInventorySource notDatabase(QString(FIXTURE_DIR) + "/rpm/make_rpmdb.py");
+    QVERIFY(notDatabase.listEntries(entries));
+    QVERIFY(entries.isEmpty());
+}
+
+QTEST_GUILESS_MAIN(TestRpmInventorySource)
+#include "tst_rpminventorysource.moc"
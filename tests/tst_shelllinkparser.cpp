@@ -0,0 +1,229 @@
+#include <QtTest>
+#include "shelllinkparser.h"
+
+// The fixtures are written by fixtures/links/make_links.py
+namespace
+{
+    const int HeaderSize = 0x4C;
+    const int TerminalBlockSize = 4;
+    const int EnvironmentBlockSize = 0x314;
+
+    QString fixture(const QString &name)
+    {
+        return QString(FIXTURE_DIR) + "/links/" + name;
+    }
+
+    QByteArray readFixture(const QString &name)
+    {
+        QFile file(fixture(name));
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QStringList fixtureNames()
+    {
+        return {"local_path.lnk", "id_list_only.lnk", "environment.lnk", "relative.lnk", "network_share.lnk"};
+    }
+
+    void appendLittleEndian32(QByteArray &bytes, quint32 value)
+    {
+        for (int i = 0; i < 4; ++i)
+            bytes.append(char((value >> (8 * i)) & 0xFF));
+    }
+
+    // A valid header with the given LinkFlags, as the fixtures start
+    QByteArray linkHeader(quint32 flags)
+    {
+        QByteArray bytes = readFixture("local_path.lnk").left(HeaderSize);
+        QByteArray encoded;
+        appendLittleEndian32(encoded, flags);
+        bytes.replace(0x14, 4, encoded);
+        return bytes;
+    }
+}
+
+class TestShellLinkParser : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parsesFixtures_data();
+    void parsesFixtures();
+    void environmentTargetFallsBackToAnsi();
+
+    void rejectsTruncatedFiles_data();
+    void rejectsTruncatedFiles();
+    void rejectsOutOfRangeLinkInfo();
+    void survivesGarbage();
+    void rejectsOtherFiles();
+};
+
+void TestShellLinkParser::parsesFixtures_data()
+{
+    QTest::addColumn<QString>("file");
+    QTest::addColumn<QString>("targetPath");
+    QTest::addColumn<QString>("arguments");
+    QTest::addColumn<QString>("workingDirectory");
+    QTest::addColumn<QString>("relativePath");
+    QTest::addColumn<QString>("description");
+
+    QTest::newRow("LinkInfo local path") << "local_path.lnk" << "C:\\Program Files\\Contoso\\app.exe" << "--minimized"
+                                         << "C:\\Program Files\\Contoso" << "" << "Contoso App";
+    QTest::newRow("ID list only") << "id_list_only.lnk" << "C:\\Program Files\\Contoso\\app.exe" << "" << "" << ""
+                                  << "";
+    // Left unexpanded for the caller
+    QTest::newRow("environment block") << "environment.lnk" << "%windir%\\system32\\notepad.exe" << "/s" << "" << ""
+                                       << "";
+    QTest::newRow("relative path") << "relative.lnk" << "" << "--quiet --log \"D:\\logs\\run, 1.txt\"" << "D:\\tools"
+                                   << "..\\tools\\run.cmd" << "";
+    QTest::newRow("network share") << "network_share.lnk" << "\\\\fileserver\\public\\docs\\report.xlsx" << "" << ""
+                                   << "" << "";
+}
+
+void TestShellLinkParser::parsesFixtures()
+{
+    QFETCH(QString, file);
+    QFETCH(QString, targetPath);
+    QFETCH(QString, arguments);
+    QFETCH(QString, workingDirectory);
+    QFETCH(QString, relativePath);
+    QFETCH(QString, description);
+
+    ShellLink link;
+    QString error;
+    QVERIFY2(ShellLinkParser::parseFile(fixture(file), link, error), qPrintable(error));
+
+    QCOMPARE(link.targetPath, targetPath);
+    QCOMPARE(link.arguments, arguments);
+    QCOMPARE(link.workingDirectory, workingDirectory);
+    QCOMPARE(link.relativePath, relativePath);
+    QCOMPARE(link.description, description);
+}
+
+void TestShellLinkParser::environmentTargetFallsBackToAnsi()
+{
+    // Clear TargetUnicode; TargetAnsi still names the program
+    QByteArray bytes = readFixture("environment.lnk");
+    int block = bytes.size() - TerminalBlockSize - EnvironmentBlockSize;
+    QVERIFY(block > HeaderSize);
+    bytes.replace(block + 0x10C, 520, QByteArray(520, '\0'));
+
+    ShellLink link;
+    QString error;
+    QVERIFY2(ShellLinkParser::parse(bytes, link, error), qPrintable(error));
+    QCOMPARE(link.targetPath, QString("%windir%\\system32\\notepad.exe"));
+}
+
+void TestShellLinkParser::rejectsTruncatedFiles_data()
+{
+    QTest::addColumn<QString>("file");
+    for (const QString &name : fixtureNames())
+        QTest::newRow(qPrintable(name)) << name;
+}
+
+void TestShellLinkParser::rejectsTruncatedFiles()
+{
+    QFETCH(QString, file);
+
+    // Only the terminal block may go missing; every shorter cut loses part of the link
+    QByteArray bytes = readFixture(file);
+    QVERIFY(bytes.size() > HeaderSize);
+    for (int length = 0; length < bytes.size() - TerminalBlockSize; ++length)
+    {
+        ShellLink link;
+        QString error;
+        if (ShellLinkParser::parse(bytes.left(length), link, error))
+            QFAIL(qPrintable(QString("Cut to %1 bytes, the link still parsed").arg(length)));
+        QVERIFY(!error.isEmpty());
+    }
+
+    ShellLink link;
+    QString error;
+    QVERIFY(ShellLinkParser::parse(bytes.left(bytes.size() - TerminalBlockSize), link, error));
+}
+
+void TestShellLinkParser::rejectsOutOfRangeLinkInfo()
+{
+    ShellLink link;
+    QString error;
+
+    // LinkInfo that claims the larger header but ends after the smaller one
+    QByteArray shortInfo = linkHeader(0x2);
+    for (quint32 value : {0x1Cu, 0x24u, 0x1u, 0x1Cu, 0x1Cu, 0u, 0x1Cu})
+        appendLittleEndian32(shortInfo, value);
+    QVERIFY(!ShellLinkParser::parse(shortInfo, link, error));
+    QCOMPARE(error, QString("The shortcut does not name a target."));
+
+    // Offsets far outside the structure name nothing
+    QByteArray wildOffsets = linkHeader(0x3);
+    wildOffsets.append(char(0));
+    wildOffsets.append(char(0));
+    for (quint32 value : {0x24u, 0x24u, 0x3u, 0xFFFFFFF0u, 0x7FFFFFFFu, 0x80000000u, 0x10000u, 0xFFFFFFFFu, 0x23u})
+        appendLittleEndian32(wildOffsets, value);
+    QVERIFY(!ShellLinkParser::parse(wildOffsets, link, error));
+
+    // A LinkInfo larger than the file
+    QByteArray oversized = linkHeader(0x2);
+    for (quint32 value : {0x1000u, 0x1Cu, 0x1u, 0x1Cu, 0x1Cu, 0u, 0x1Cu})
+        appendLittleEndian32(oversized, value);
+    QVERIFY(!ShellLinkParser::parse(oversized, link, error));
+    QCOMPARE(error, QString("The link info is truncated."));
+}
+
+void TestShellLinkParser::survivesGarbage()
+{
+    // Every byte of every fixture overwritten in turn; the result does not
+    // matter as long as a failure says why
+    for (const QString &name : fixtureNames())
+    {
+        QByteArray original = readFixture(name);
+        for (int i = 0; i < original.size(); ++i)
+        {
+            for (char value : {char(0x00), char(0x7F), char(0xFF)})
+            {
+                QByteArray bytes = original;
+                bytes[i] = value;
+                ShellLink link;
+                QString error;
+                if (!ShellLinkParser::parse(bytes, link, error))
+                    QVERIFY(!error.isEmpty());
+            }
+        }
+    }
+
+    // Random bytes behind a header that announces every section
+    quint32 state = 12345;
+    for (int round = 0; round < 2000; ++round)
+    {
+        QByteArray bytes = linkHeader(0x1FF);
+        int length = int(state % 2048);
+        for (int i = 0; i < length; ++i)
+        {
+            state = state * 1103515245u + 12345u;
+            bytes.append(char(state >> 16));
+        }
+        ShellLink link;
+        QString error;
+        if (!ShellLinkParser::parse(bytes, link, error))
+            QVERIFY(!error.isEmpty());
+    }
+}
+
+void TestShellLinkParser::rejectsOtherFiles()
+{
+    ShellLink link;
+    QString error;
+
+    QVERIFY(!ShellLinkParser::parse(QByteArray(512, 'x'), link, error));
+    QCOMPARE(error, QString("Not a shell link file."));
+
+    QVERIFY(!ShellLinkParser::parse(QByteArray(), link, error));
+    QVERIFY(!ShellLinkParser::parseFile(fixture("missing.lnk"), link, error));
+    QVERIFY(!ShellLinkParser::parseFile(fixture("make_links.py"), link, error));
+
+    // A header with nothing after it points nowhere
+    QVERIFY(!ShellLinkParser::parse(linkHeader(0), link, error));
+    QCOMPARE(error, QString("The shortcut does not name a target."));
+}
+
+QTEST_GUILESS_MAIN(TestShellLinkParser)
+#include "tst_shelllinkparser.moc"
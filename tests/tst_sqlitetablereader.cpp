@@ -0,0 +1,168 @@
+#include <QtTest>
+#include "sqlitetablereader.h"
+
+// The fixture is written by fixtures/rpm/make_rpmdb.py
+namespace
+{
+    const int PackageCount = 305;
+    const int PageSize = 1024;
+    const int BigDocsRow = 5;
+
+    QString fixture()
+    {
+        return QString(FIXTURE_DIR) + "/rpm/rpmdb.sqlite";
+    }
+
+    QByteArray readFixture()
+    {
+        QFile file(fixture());
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    QString writeTemporary(QTemporaryDir &dir, const QByteArray &data)
+    {
+        QString path = dir.filePath("rpmdb.sqlite");
+        QFile file(path);
+        if (file.open(QIODevice::WriteOnly))
+            file.write(data);
+        return path;
+    }
+}
+
+class TestSqliteTableReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void findsTables();
+    void walksInteriorPages();
+    void followsOverflowPages();
+    void stopsWhenAsked();
+    void rejectsOtherFiles();
+    void survivesTruncation();
+};
+
+void TestSqliteTableReader::findsTables()
+{
+    SqliteTableReader reader;
+    QVERIFY2(reader.open(fixture()), qPrintable(reader.errorString()));
+    QVERIFY(reader.isOpen());
+
+    QCOMPARE(reader.tableRootPage("Packages"), quint32(2));
+    QCOMPARE(reader.tableRootPage("packages"), quint32(2));
+    QVERIFY(reader.tableRootPage("Name") > 2);
+
+    // Indexes are not tables
+    QCOMPARE(reader.tableRootPage("Name_key_idx"), quint32(0));
+    QCOMPARE(reader.tableRootPage("Missing"), quint32(0));
+
+    reader.close();
+    QVERIFY(!reader.isOpen());
+    QCOMPARE(reader.tableRootPage("Packages"), quint32(0));
+}
+
+void TestSqliteTableReader::walksInteriorPages()
+{
+    // The Packages root holds child pointers only
+    QByteArray bytes = readFixture();
+    QCOMPARE(uchar(bytes.at(PageSize)), uchar(0x05));
+
+    SqliteTableReader reader;
+    QVERIFY(reader.open(fixture()));
+
+    QList<qint64> rowIds;
+    bool blobsOnly = true;
+    QVERIFY(reader.readTable(reader.tableRootPage("Packages"), [&](qint64 rowId, const QVariantList &columns)
+                             {
+                                 rowIds.append(rowId);
+                                 // hnum is the rowid, so the record stores NULL in its place
+                                 blobsOnly = blobsOnly && columns.size() == 2 && columns[0].isNull() &&
+                                             columns[1].userType() == QMetaType::QByteArray;
+                                 return true; }));
+
+    QVERIFY(blobsOnly);
+    QCOMPARE(rowIds.size(), PackageCount);
+    for (int i = 0; i < rowIds.size(); ++i)
+        QCOMPARE(rowIds.at(i), qint64(i + 1));
+
+    // Text and integer columns of the Name table
+    QStringList names;
+    QVERIFY(reader.readTable(reader.tableRootPage("Name"), [&](qint64, const QVariantList &columns)
+                             {
+                                 if (columns.size() == 3 && columns[2].toLongLong() == 0)
+                                     names.append(columns[0].toString());
+                                 return true; }));
+    QCOMPARE(names.size(), PackageCount);
+    QCOMPARE(names.first(), QString("bash"));
+    QCOMPARE(names.last(), QString("filler-299"));
+}
+
+void TestSqliteTableReader::followsOverflowPages()
+{
+    SqliteTableReader reader;
+    QVERIFY(reader.open(fixture()));
+
+    QByteArray blob;
+    QVERIFY(reader.readTable(reader.tableRootPage("Packages"), [&](qint64 rowId, const QVariantList &columns)
+                             {
+                                 if (rowId != BigDocsRow)
+                                     return true;
+                                 blob = columns.value(1).toByteArray();
+                                 return false; }));
+
+    // Several pages long; the file names run to the very end
+    QVERIFY(blob.size() > 8 * PageSize);
+    QVERIFY(blob.contains("big-docs"));
+    QVERIFY(blob.contains("file-00000.html"));
+    QVERIFY(blob.endsWith(QByteArray("file-00599.html") + '\0'));
+}
+
+void TestSqliteTableReader::stopsWhenAsked()
+{
+    SqliteTableReader reader;
+    QVERIFY(reader.open(fixture()));
+
+    int rows = 0;
+    QVERIFY(reader.readTable(reader.tableRootPage("Packages"), [&](qint64, const QVariantList &)
+                             { return ++rows < 10; }));
+    QCOMPARE(rows, 10);
+}
+
+void TestSqliteTableReader::rejectsOtherFiles()
+{
+    SqliteTableReader reader;
+    QVERIFY(!reader.open(QString(FIXTURE_DIR) + "/rpm/missing.sqlite"));
+    QVERIFY(!reader.errorString().isEmpty());
+
+    QVERIFY(!reader.open(QString(FIXTURE_DIR) + "/rpm/make_rpmdb.py"));
+    QCOMPARE(reader.errorString(), QString("Not an SQLite 3 database"));
+    QVERIFY(!reader.isOpen());
+
+    QTemporaryDir dir;
+    QByteArray badPageSize = readFixture();
+    badPageSize[16] = char(0);
+    badPageSize[17] = char(100);
+    QVERIFY(!reader.open(writeTemporary(dir, badPageSize)));
+    QCOMPARE(reader.errorString(), QString("Unsupported SQLite page size"));
+}
+
+void TestSqliteTableReader::survivesTruncation()
+{
+    // Pages cut off the end are missing from the tree: the walk fails instead of reading past the file
+    QByteArray bytes = readFixture();
+    QTemporaryDir dir;
+    for (int pages = 1; pages * PageSize < bytes.size(); pages += 7)
+    {
+        SqliteTableReader reader;
+        QVERIFY(reader.open(writeTemporary(dir, bytes.left(pages * PageSize + 100))));
+
+        int rows = 0;
+        bool complete = reader.readTable(2, [&](qint64, const QVariantList &)
+                                         { ++rows; return true; });
+        QVERIFY(!complete || rows == PackageCount);
+        QVERIFY(rows <= PackageCount);
+    }
+}
+
+QTEST_GUILESS_MAIN(TestSqliteTableReader)
+#include "tst_sqlitetablereader.moc"
@@ -0,0 +1,5 @@
+#include "bootactivationsource.h"
+
+BootActivationSource::~BootActivationSource()
+{
+}
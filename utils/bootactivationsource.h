@@ -0,0 +1,29 @@
+#ifndef BOOTACTIVATIONSOURCE_H
+#define BOOTACTIVATIONSOURCE_H
+
+#include <QString>
+#include <QHash>
+
+// When a unit was started during boot, in microseconds of CLOCK_MONOTONIC
+// (since the kernel started); -1 when not recorded
+struct UnitActivation
+{
+    qint64 activatingUs = -1; // its start job began ("Starting ...")
+    qint64 activeUs = -1;     // it became active ("Started ...", "Reached target ...")
+};
+
+// A record of the units systemd started during one boot: the journal of the
+// running system, a recorded journal or fixtures. Implementations must allow
+// concurrent const calls.
+class BootActivationSource
+{
+public:
+    virtual ~BootActivationSource();
+
+    virtual QString id() const = 0;
+
+    // Unit name -> activation; false if nothing could be read
+    virtual bool read(QHash<QString, UnitActivation> &activations, QString &error) const = 0;
+};
+
+#endif // BOOTACTIVATIONSOURCE_H
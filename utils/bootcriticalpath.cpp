@@ -0,0 +1,444 @@
+#include "bootcriticalpath.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+namespace
+{
+    const QStringList UnitSuffixes = {".service", ".socket", ".target", ".mount", ".automount", ".swap",
+                                      ".path", ".timer", ".slice", ".scope", ".device"};
+
+    bool isUnitName(const QString &name)
+    {
+        for (const QString &suffix : UnitSuffixes)
+        {
+            if (name.endsWith(suffix) && name.size() > suffix.size())
+                return true;
+        }
+        return false;
+    }
+
+    // "getty@tty1.service" -> "getty@.service"; empty for names that are no instance
+    QString templateName(const QString &name)
+    {
+        int at = name.indexOf('@');
+        int dot = name.lastIndexOf('.');
+        if (at <= 0 || dot <= at + 1)
+            return QString();
+        return name.left(at + 1) + name.mid(dot);
+    }
+
+    // The specifiers dependencies use: %n, %N, %p, %i, %I and %%
+    QString expandSpecifiers(const QString &value, const QString &unitName)
+    {
+        if (!value.contains('%'))
+            return value;
+
+        int dot = unitName.lastIndexOf('.');
+        QString baseName = dot > 0 ? unitName.left(dot) : unitName;
+        int at = baseName.indexOf('@');
+        QString prefix = at >= 0 ? baseName.left(at) : baseName;
+        QString instance = at >= 0 ? baseName.mid(at + 1) : QString();
+
+        QString expanded;
+        for (int i = 0; i < value.size(); ++i)
+        {
+            if (value.at(i) != '%' || i + 1 == value.size())
+            {
+                expanded += value.at(i);
+                continue;
+            }
+
+            QChar specifier = value.at(++i);
+            if (specifier == 'n')
+                expanded += unitName;
+            else if (specifier == 'N')
+                expanded += baseName;
+            else if (specifier == 'p')
+                expanded += prefix;
+            else if (specifier == 'i' || specifier == 'I')
+                expanded += instance;
+            else if (specifier == '%')
+                expanded += '%';
+            else
+                expanded += QString('%') + specifier;
+        }
+        return expanded;
+    }
+}
+
+BootCriticalPath::BootCriticalPath(const QStringList &unitDirs)
+    : m_unitDirs(unitDirs)
+{
+}
+
+bool BootCriticalPath::loadUnits()
+{
+    m_units.clear();
+    m_aliases.clear();
+
+    QHash<QString, QString> files;        // unit -> its file in the most important directory
+    QHash<QString, QStringList> dropIns;  // unit -> .conf files from every directory
+    QHash<QString, QStringList> links;    // unit -> what its .wants/.requires directories name
+    QSet<QString> masked;
+
+    for (const QString &dirPath : m_unitDirs)
+    {
+        QFileInfoList entries = QDir(dirPath).entryInfoList(QDir::Files | QDir::Dirs | QDir::System | QDir::NoDotAndDotDot,
+                                                            QDir::Name);
+        for (const QFileInfo &entry : entries)
+        {
+            QString name = entry.fileName();
+            if (entry.isDir())
+            {
+                // Dependency and drop-in directories add up across the search path
+                if (name.endsWith(".wants") || name.endsWith(".requires"))
+                {
+                    QString unit = name.left(name.lastIndexOf('.'));
+                    links[unit] += QDir(entry.absoluteFilePath()).entryList(QDir::Files | QDir::System);
+                }
+                else if (name.endsWith(".d"))
+                {
+                    QDir dropInDir(entry.absoluteFilePath());
+                    for (const QString &conf : dropInDir.entryList(QStringList() << "*.conf", QDir::Files, QDir::Name))
+                        dropIns[name.left(name.size() - 2)].append(dropInDir.filePath(conf));
+                }
+                continue;
+            }
+
+            // The first directory that has a unit name wins
+            if (!isUnitName(name) || files.contains(name) || m_aliases.contains(name) || masked.contains(name))
+                continue;
+
+            if (entry.isSymLink())
+            {
+                QString target = entry.symLinkTarget();
+                if (target == "/dev/null")
+                {
+                    masked.insert(name);
+                    continue;
+                }
+                QString targetName = QFileInfo(target).fileName();
+                if (targetName != name && isUnitName(targetName))
+                {
+                    m_aliases.insert(name, targetName);
+                    continue;
+                }
+            }
+            files.insert(name, entry.absoluteFilePath());
+        }
+    }
+
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+    {
+        // Templates are read for each instance instead
+        if (it.key().contains("@."))
+            continue;
+
+        UnitInfo &unit = m_units[it.key()];
+        readUnitFile(it.value(), it.key(), unit);
+        for (const QString &dropIn : dropIns.value(it.key()))
+            readUnitFile(dropIn, it.key(), unit);
+        mergePullSettings(unit);
+        unit.loaded = true;
+    }
+
+    for (auto it = links.constBegin(); it != links.constEnd(); ++it)
+        m_units[it.key()].pulls += it.value();
+
+    instantiateTemplates(files, dropIns);
+
+    if (m_units.isEmpty())
+    {
+        m_error = "No systemd unit files were found.";
+        return false;
+    }
+
+    // Before= is the other unit's After=; from here on only resolved names are used
+    const QStringList names = m_units.keys();
+    for (const QString &name : names)
+    {
+        const QStringList before = m_units[name].before;
+        for (const QString &other : before)
+            m_units[resolve(other)].after.append(name);
+    }
+
+    for (auto it = m_units.begin(); it != m_units.end(); ++it)
+    {
+        UnitInfo &unit = it.value();
+        for (QString &name : unit.after)
+            name = resolve(name);
+        for (QString &name : unit.pulls)
+            name = resolve(name);
+        unit.before.clear();
+    }
+
+    addDefaultDependencies();
+
+    for (auto it = m_units.begin(); it != m_units.end(); ++it)
+    {
+        it->after.removeDuplicates();
+        it->pulls.removeDuplicates();
+    }
+    return true;
+}
+
+void BootCriticalPath::instantiateTemplates(const QHash<QString, QString> &files, const QHash<QString, QStringList> &dropIns)
+{
+    // Instances exist only where something names them; each may name further ones
+    QStringList pending;
+    for (auto it = m_units.constBegin(); it != m_units.constEnd(); ++it)
+        pending << it.key() << it->after << it->before << it->pulls;
+
+    QSet<QString> done;
+    while (!pending.isEmpty())
+    {
+        QString name = pending.takeLast();
+        QString templateFile = files.value(templateName(resolve(name)));
+        if (done.contains(name) || templateFile.isEmpty())
+            continue;
+        done.insert(name);
+
+        name = resolve(name);
+        UnitInfo &unit = m_units[name];
+        if (unit.loaded)
+            continue;
+
+        QString templateUnit = templateName(name);
+        readUnitFile(templateFile, name, unit);
+        for (const QString &dropIn : dropIns.value(templateUnit) + dropIns.value(name))
+            readUnitFile(dropIn, name, unit);
+        mergePullSettings(unit);
+        unit.loaded = true;
+        pending << unit.after << unit.before << unit.pulls;
+    }
+}
+
+void BootCriticalPath::addDefaultDependencies()
+{
+    // Services, sockets, timers and paths wait for early boot: services for
+    // basic.target, the others for sysinit.target
+    for (auto it = m_units.begin(); it != m_units.end(); ++it)
+    {
+        if (!it->loaded || !it->defaultDependencies)
+            continue;
+
+        const QString &name = it.key();
+        if (name.endsWith(".service"))
+        {
+            it->after << "sysinit.target" << "basic.target";
+            it->pulls << "sysinit.target";
+        }
+        else if (name.endsWith(".socket") || name.endsWith(".timer") || name.endsWith(".path"))
+        {
+            it->after << "sysinit.target";
+            it->pulls << "sysinit.target";
+        }
+    }
+
+    // A target is ordered after what it pulls in, unless either side opts
+    // out or the pulled unit is already ordered after the target
+    for (auto it = m_units.begin(); it != m_units.end(); ++it)
+    {
+        if (!it.key().endsWith(".target") || !it->loaded || !it->defaultDependencies)
+            continue;
+
+        for (const QString &pulled : it->pulls)
+        {
+            auto other = m_units.constFind(pulled);
+            if (other == m_units.constEnd() || !other->loaded || !other->defaultDependencies ||
+                other->after.contains(it.key()))
+                continue;
+            it->after.append(pulled);
+        }
+    }
+}
+
+void BootCriticalPath::readUnitFile(const QString &path, const QString &unitName, UnitInfo &unit)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+        return;
+
+    QString section;
+    QString pending; // a line continued with a trailing backslash
+    const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+    for (const QString &rawLine : lines)
+    {
+        QString line = rawLine.trimmed();
+        if (pending.isEmpty() && (line.startsWith('#') || line.startsWith(';')))
+            continue;
+        if (line.endsWith('\\'))
+        {
+            pending += line.left(line.size() - 1) + ' ';
+            continue;
+        }
+        line = pending + line;
+        pending.clear();
+
+        if (line.startsWith('['))
+        {
+            section = line;
+            continue;
+        }
+        if (section != "[Unit]")
+            continue;
+
+        int equals = line.indexOf('=');
+        if (equals <= 0)
+            continue;
+        QString key = line.left(equals).trimmed();
+        QString value = line.mid(equals + 1).trimmed();
+
+        QStringList *list = nullptr;
+        if (key == "After")
+            list = &unit.after;
+        else if (key == "Before")
+            list = &unit.before;
+        else if (key == "Requires" || key == "Wants" || key == "BindsTo" || key == "Requisite")
+            list = &unit.pullSettings[key];
+        else if (key == "DefaultDependencies")
+            unit.defaultDependencies = !QStringList({"no", "false", "off", "0"}).contains(value.toLower());
+
+        if (!list)
+            continue;
+
+        // An empty assignment resets what earlier lines and files set for
+        // that setting only; "Wants=" leaves Requires= alone
+        if (value.isEmpty())
+        {
+            list->clear();
+            continue;
+        }
+        for (const QString &dependency : value.split(' ', Qt::SkipEmptyParts))
+            list->append(expandSpecifiers(dependency, unitName));
+    }
+}
+
+void BootCriticalPath::mergePullSettings(UnitInfo &unit)
+{
+    for (auto it = unit.pullSettings.constBegin(); it != unit.pullSettings.constEnd(); ++it)
+        unit.pulls += it.value();
+    unit.pullSettings.clear();
+}
+
+QString BootCriticalPath::resolve(const QString &name) const
+{
+    // Aliases may chain; a loop stops after a few steps
+    QString resolved = name;
+    for (int depth = 0; depth < 8; ++depth)
+    {
+        auto alias = m_aliases.constFind(resolved);
+        if (alias == m_aliases.constEnd())
+            break;
+        resolved = alias.value();
+    }
+    return resolved;
+}
+
+bool BootCriticalPath::analyze(const QHash<QString, UnitActivation> &activations, const QString &goal)
+{
+    m_activations.clear();
+    m_bootUnits.clear();
+    m_criticalPath.clear();
+    m_critical.clear();
+    m_goal = resolve(goal);
+
+    for (auto it = activations.constBegin(); it != activations.constEnd(); ++it)
+        m_activations.insert(resolve(it.key()), it.value());
+
+    QStringList queue{m_goal};
+    while (!queue.isEmpty())
+    {
+        QString name = queue.takeLast();
+        if (m_bootUnits.contains(name))
+            continue;
+        m_bootUnits.insert(name);
+        queue += m_units.value(name).pulls;
+    }
+
+    if (m_activations.value(m_goal).activeUs < 0)
+    {
+        m_error = QString("'%1' was not reached in the recorded boot.").arg(m_goal);
+        return false;
+    }
+
+    // Back from the goal through whatever it was waiting for last
+    QString current = m_goal;
+    while (!current.isEmpty() && !m_critical.contains(current))
+    {
+        m_critical.insert(current);
+        m_criticalPath.prepend(current);
+
+        UnitActivation activation = m_activations.value(current);
+        qint64 startedAt = activation.activatingUs >= 0 ? activation.activatingUs : activation.activeUs;
+
+        QString next;
+        qint64 latest = -1;
+        for (const QString &dependency : m_units.value(current).after)
+        {
+            qint64 activeUs = m_activations.value(dependency).activeUs;
+            if (activeUs >= 0 && activeUs <= startedAt && activeUs > latest)
+            {
+                latest = activeUs;
+                next = dependency;
+            }
+        }
+        current = next;
+    }
+
+    m_error.clear();
+    return true;
+}
+
+QString BootCriticalPath::errorString() const
+{
+    return m_error;
+}
+
+QStringList BootCriticalPath::criticalPath() const
+{
+    return m_criticalPath;
+}
+
+BootCriticalPath::Role BootCriticalPath::role(const QString &unitName) const
+{
+    QString name = resolve(unitName);
+    if (m_critical.contains(name))
+        return CriticalPath;
+
+    qint64 activeUs = m_activations.value(name).activeUs;
+    if (activeUs < 0)
+        return NotStarted;
+    return activeUs <= bootTimeUs() ? Parallel : AfterBoot;
+}
+
+UnitActivation BootCriticalPath::activation(const QString &unitName) const
+{
+    return m_activations.value(resolve(unitName));
+}
+
+QSet<QString> BootCriticalPath::bootUnits() const
+{
+    return m_bootUnits;
+}
+
+qint64 BootCriticalPath::bootTimeUs() const
+{
+    return m_activations.value(m_goal).activeUs;
+}
+
+QString BootCriticalPath::roleName(Role role)
+{
+    switch (role)
+    {
+    case CriticalPath:
+        return "Critical path";
+    case Parallel:
+        return "Parallel";
+    case AfterBoot:
+        return "After boot";
+    default:
+        return "Not started";
+    }
+}
@@ -0,0 +1,78 @@
+#ifndef BOOTCRITICALPATH_H
+#define BOOTCRITICALPATH_H
+
+#include "bootactivationsource.h"
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QSet>
+
+// Works out which units held up boot, as "systemd-analyze critical-chain"
+// does, but from the unit files on disk and the activation times of any
+// BootActivationSource. The dependency graph comes from the [Unit] sections
+// of units and their drop-ins (After=, Before=, Requires=, Wants=,
+// BindsTo=, Requisite=), the .wants/.requires directories and the ordering
+// default dependencies add. The units the goal pulls in make up the boot.
+// The critical path is followed back from the goal, each time through the
+// unit it is ordered after that became active last before it started.
+// Every other unit that was active by the time the goal was reached ran in
+// parallel with the path and did not delay it.
+class BootCriticalPath
+{
+public:
+    enum Role
+    {
+        NotStarted,   // no activation recorded
+        CriticalPath, // the boot waited for it
+        Parallel,     // active before the goal, but nothing on the path waited for it
+        AfterBoot     // activated after the goal was reached
+    };
+
+    // Unit search path, highest precedence first
+    explicit BootCriticalPath(const QStringList &unitDirs);
+
+    // Reads every unit file, drop-in and .wants/.requires link; false if there were none
+    bool loadUnits();
+    bool analyze(const QHash<QString, UnitActivation> &activations, const QString &goal = "default.target");
+    QString errorString() const;
+
+    // From the first unit of the chain to the goal
+    QStringList criticalPath() const;
+    Role role(const QString &unitName) const;
+    UnitActivation activation(const QString &unitName) const;
+    // Units the goal pulls in, directly or through others
+    QSet<QString> bootUnits() const;
+    // When the goal was reached, in microseconds since the kernel started
+    qint64 bootTimeUs() const;
+
+    static QString roleName(Role role);
+
+private:
+    struct UnitInfo
+    {
+        QStringList after;  // After=, and Before= of other units once loading is done
+        QStringList before; // Before=, moved to the other side once loading is done
+        QStringList pulls;  // Requires=, Wants=, BindsTo=, Requisite= and links
+        QHash<QString, QStringList> pullSettings; // per setting while reading, as each resets on its own
+        bool defaultDependencies = true;
+        bool loaded = false; // a unit file was found
+    };
+
+    QStringList m_unitDirs;
+    QHash<QString, UnitInfo> m_units;
+    QHash<QString, QString> m_aliases; // alias -> the unit it names
+    QHash<QString, UnitActivation> m_activations;
+    QSet<QString> m_bootUnits;
+    QStringList m_criticalPath;
+    QSet<QString> m_critical;
+    QString m_goal;
+    QString m_error;
+
+    QString resolve(const QString &name) const;
+    void instantiateTemplates(const QHash<QString, QString> &files, const QHash<QString, QStringList> &dropIns);
+    void addDefaultDependencies();
+    static void readUnitFile(const QString &path, const QString &unitName, UnitInfo &unit);
+    static void mergePullSettings(UnitInfo &unit);
+};
+
+#endif // BOOTCRITICALPATH_H
@@ -0,0 +1,301 @@
+#include "cleancategorycache.h"
+#include "windowsutils.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QFileInfo>
+
+namespace
+{
+    // Each watched directory costs a handle, so deep trees are only
+    // partially watched; the rest is covered by the mtime check on refresh.
+    const int MaxWatchedDirectories = 256;
+    const int RefreshDebounceMs = 1500;
+}
+
+CleanCategoryCache::CleanCategoryCache(const QString &cacheName, const QList<CleanerItem> &items, QObject *parent)
+    : QObject(parent), m_filePath(CleanManifest::defaultFilePath(cacheName)), m_items(items), m_autoRefresh(false), m_cancelRefresh(false)
+{
+    m_fsWatcher = new QFileSystemWatcher(this);
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceTimer->setInterval(RefreshDebounceMs);
+    m_refreshWatcher = new QFutureWatcher<QVector<CleanCategoryPlan>>(this);
+
+    connect(m_fsWatcher, &QFileSystemWatcher::directoryChanged,
+            this, &CleanCategoryCache::onDirectoryChanged);
+    connect(m_debounceTimer, &QTimer::timeout,
+            this, &CleanCategoryCache::refresh);
+    connect(m_refreshWatcher, &QFutureWatcher<QVector<CleanCategoryPlan>>::finished,
+            this, &CleanCategoryCache::onRefreshFinished);
+}
+
+CleanCategoryCache::~CleanCategoryCache()
+{
+    m_cancelRefresh = true;
+    m_refreshWatcher->waitForFinished();
+}
+
+void CleanCategoryCache::load()
+{
+    m_manifest.load(m_filePath);
+    rebuildWatches();
+
+    // Whatever changed while the app was closed is found by the mtime check
+    for (const CleanerItem &item : m_items)
+    {
+        m_dirty.insert(item.name());
+    }
+}
+
+CleanManifest CleanCategoryCache::manifest() const
+{
+    return m_manifest;
+}
+
+bool CleanCategoryCache::isRefreshing() const
+{
+    return m_refreshWatcher->isRunning();
+}
+
+QStringList CleanCategoryCache::dirtyCategories() const
+{
+    QStringList names;
+    for (const CleanerItem &item : m_items)
+    {
+        if (m_dirty.contains(item.name()))
+            names.append(item.name());
+    }
+    return names;
+}
+
+void CleanCategoryCache::setAutoRefresh(bool enabled)
+{
+    m_autoRefresh = enabled;
+    if (!m_autoRefresh)
+    {
+        m_debounceTimer->stop();
+    }
+    else if (!m_dirty.isEmpty())
+    {
+        m_debounceTimer->start();
+    }
+}
+
+void CleanCategoryCache::refresh()
+{
+    m_debounceTimer->stop();
+
+    if (m_refreshWatcher->isRunning())
+    {
+        // Picked up again when the running refresh finishes
+        return;
+    }
+
+    QStringList names = dirtyCategories();
+    if (names.isEmpty())
+    {
+        emit refreshFinished();
+        return;
+    }
+
+    QSet<QString> forced = m_forced;
+    m_dirty.clear();
+    m_forced.clear();
+    m_cancelRefresh = false;
+    emit refreshStarted(names);
+
+    QList<CleanerItem> items = m_items;
+    CleanManifest manifest = m_manifest;
+    QFuture<QVector<CleanCategoryPlan>> future = QtConcurrent::run([this, items, manifest, names, forced]()
+                                                                   { return CleanCategoryCache::refreshCategories(items, manifest, names, forced, m_cancelRefresh); });
+    m_refreshWatcher->setFuture(future);
+}
+
+void CleanCategoryCache::invalidate(const QStringList &names)
+{
+    for (const QString &name : names)
+    {
+        m_dirty.insert(name);
+    }
+    scheduleRefresh();
+}
+
+void CleanCategoryCache::invalidateAll()
+{
+    for (const CleanerItem &item : m_items)
+    {
+        m_dirty.insert(item.name());
+        m_forced.insert(item.name());
+    }
+    scheduleRefresh();
+}
+
+void CleanCategoryCache::mergeCategories(const CleanManifest &source, const QStringList &names)
+{
+    for (const QString &name : names)
+    {
+        m_manifest.setCategory(source.category(name));
+    }
+    save();
+}
+
+void CleanCategoryCache::onDirectoryChanged(const QString &path)
+{
+    for (const QString &name : m_watchOwners.value(path))
+    {
+        m_dirty.insert(name);
+    }
+
+    scheduleRefresh();
+}
+
+void CleanCategoryCache::onRefreshFinished()
+{
+    QVector<CleanCategoryPlan> plans = m_refreshWatcher->result();
+    for (const CleanCategoryPlan &plan : plans)
+    {
+        m_manifest.setCategory(plan);
+    }
+    m_manifest.setCreatedAt(QDateTime::currentDateTime());
+
+    save();
+    if (!plans.isEmpty())
+    {
+        rebuildWatches();
+    }
+
+    emit refreshFinished();
+
+    if (!m_dirty.isEmpty())
+    {
+        scheduleRefresh();
+    }
+}
+
+void CleanCategoryCache::scheduleRefresh()
+{
+    // Bursts of changes (an installer unpacking into %TEMP%) collapse into one refresh
+    if (m_autoRefresh)
+    {
+        m_debounceTimer->start();
+    }
+}
+
+void CleanCategoryCache::rebuildWatches()
+{
+    if (!m_fsWatcher->directories().isEmpty())
+    {
+        m_fsWatcher->removePaths(m_fsWatcher->directories());
+    }
+    m_watchOwners.clear();
+
+    // Roots first so every category gets at least its top level watched
+    QStringList paths;
+    for (const CleanerItem &item : m_items)
+    {
+        for (const QString &root : item.allPaths())
+        {
+            QString path = QFileInfo(root).absoluteFilePath();
+            if (!m_watchOwners.contains(path))
+                paths.append(path);
+            m_watchOwners[path].append(item.name());
+        }
+    }
+
+    for (const CleanerItem &item : m_items)
+    {
+        CleanCategoryPlan plan = m_manifest.category(item.name());
+        for (const CleanDirectory &directory : plan.directories)
+        {
+            if (m_watchOwners.size() >= MaxWatchedDirectories)
+                break;
+            if (!m_watchOwners.contains(directory.path))
+                paths.append(directory.path);
+            if (!m_watchOwners[directory.path].contains(item.name()))
+                m_watchOwners[directory.path].append(item.name());
+        }
+    }
+
+    QStringList existing;
+    for (const QString &path : paths)
+    {
+        if (QFileInfo(path).isDir())
+            existing.append(path);
+    }
+
+    if (!existing.isEmpty())
+    {
+        m_fsWatcher->addPaths(existing);
+    }
+}
+
+void CleanCategoryCache::save() const
+{
+    m_manifest.save(m_filePath);
+}
+
+QVector<CleanCategoryPlan> CleanCategoryCache::refreshCategories(const QList<CleanerItem> &items, const CleanManifest &manifest,
+                                                                 const QStringList &names, const QSet<QString> &forced,
+                                                                 QAtomicInteger<bool> &cancelFlag)
+{
+    QVector<CleanCategoryPlan> plans;
+
+    for (const CleanerItem &item : items)
+    {
+        if (cancelFlag)
+            break;
+
+        if (!names.contains(item.name()))
+            continue;
+
+        // Only rescan categories whose directories really changed, unless a full rescan was asked for
+        if (!forced.contains(item.name()) && manifest.contains(item.name()) &&
+            !isPlanStale(item, manifest.category(item.name())))
+            continue;
+
+        plans.append(WindowsUtils::buildCategoryPlan(item, cancelFlag));
+    }
+
+    if (cancelFlag)
+    {
+        plans.clear();
+    }
+
+    return plans;
+}
+
+bool CleanCategoryCache::isPlanStale(const CleanerItem &item, const CleanCategoryPlan &plan)
+{
+    // Shell-managed categories cannot be watched and are always requeried
+    if (item.allPaths().isEmpty())
+        return true;
+
+    // A file skipped as too new has aged past the cutoff without any mtime changing
+    if (plan.nextEligibleAt > 0 && QDateTime::currentMSecsSinceEpoch() >= plan.nextEligibleAt)
+        return true;
+
+    // A root that appeared since the scan was never recorded
+    for (const QString &root : item.allPaths())
+    {
+        QFileInfo rootInfo(root);
+        bool recorded = false;
+        for (const CleanDirectory &directory : plan.directories)
+        {
+            if (directory.path == rootInfo.absoluteFilePath())
+            {
+                recorded = true;
+                break;
+            }
+        }
+        if (rootInfo.isDir() != recorded)
+            return true;
+    }
+
+    for (const CleanDirectory &directory : plan.directories)
+    {
+        QFileInfo info(directory.path);
+        if (!info.isDir() || info.lastModified().toMSecsSinceEpoch() != directory.lastModified)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,71 @@
+#ifndef CLEANCATEGORYCACHE_H
+#define CLEANCATEGORYCACHE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
+#include <QAtomicInteger>
+#include <QHash>
+#include <QSet>
+#include <QTimer>
+#include "cleaneritem.h"
+#include "cleanmanifest.h"
+
+// Keeps the scan manifest of a set of cleaner categories current. Totals
+// are restored from disk on start, and filesystem watches on the category
+// directories mark only the affected categories dirty. A refresh rescans
+// just the dirty categories whose directory mtimes actually changed, or
+// whose age cutoff has passed a file that was too new when scanned.
+// invalidateAll() rescans everything regardless.
+// With auto refresh on, dirty categories are refreshed after a short delay.
+class CleanCategoryCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    CleanCategoryCache(const QString &cacheName, const QList<CleanerItem> &items, QObject *parent = nullptr);
+    ~CleanCategoryCache();
+
+    void load();
+    CleanManifest manifest() const;
+    bool isRefreshing() const;
+    QStringList dirtyCategories() const;
+    void setAutoRefresh(bool enabled);
+
+    void refresh();
+    void invalidate(const QStringList &names);
+    void invalidateAll();
+    void mergeCategories(const CleanManifest &source, const QStringList &names);
+
+signals:
+    void refreshStarted(const QStringList &categories);
+    void refreshFinished();
+
+private slots:
+    void onDirectoryChanged(const QString &path);
+    void onRefreshFinished();
+
+private:
+    QString m_filePath;
+    QList<CleanerItem> m_items;
+    CleanManifest m_manifest;
+    QSet<QString> m_dirty;
+    QSet<QString> m_forced; // Dirty categories rescanned without the staleness check
+    bool m_autoRefresh;
+
+    QFileSystemWatcher *m_fsWatcher;
+    QHash<QString, QStringList> m_watchOwners; // watched directory -> categories
+    QTimer *m_debounceTimer;
+    QFutureWatcher<QVector<CleanCategoryPlan>> *m_refreshWatcher;
+    QAtomicInteger<bool> m_cancelRefresh;
+
+    void scheduleRefresh();
+    void rebuildWatches();
+    void save() const;
+    static QVector<CleanCategoryPlan> refreshCategories(const QList<CleanerItem> &items, const CleanManifest &manifest,
+                                                        const QStringList &names, const QSet<QString> &forced,
+                                                        QAtomicInteger<bool> &cancelFlag);
+    static bool isPlanStale(const CleanerItem &item, const CleanCategoryPlan &plan);
+};
+
+#endif // CLEANCATEGORYCACHE_H
@@ -1,14 +1,14 @@
 #include "cleaneritem.h"
 
 CleanerItem::CleanerItem()
-    : m_size(0), m_selected(false), m_safe(true)
+    : m_size(0), m_selected(false), m_safe(true), m_recursive(true), m_minAgeDays(0)
 {
 }
 
 CleanerItem::CleanerItem(const QString &name, const QString &description, const QString &path, 
                          const QStringList &filePatterns, qint64 size, bool isSelected, bool isSafe)
     : m_name(name), m_description(description), m_path(path), m_filePatterns(filePatterns),
-      m_size(size), m_selected(isSelected), m_safe(isSafe)
+      m_size(size), m_selected(isSelected), m_safe(isSafe), m_recursive(true), m_minAgeDays(0)
 {
 }
 
@@ -47,6 +47,30 @@ bool CleanerItem::isSafe() const
     return m_safe;
 }
 
+QStringList CleanerItem::extraPaths() const
+{
+    return m_extraPaths;
+}
+
+QStringList CleanerItem::allPaths() const
+{
+    QStringList paths;
+    if (!m_path.isEmpty())
+        paths << m_path;
+    paths << m_extraPaths;
+    return paths;
+}
+
+bool CleanerItem::isRecursive() const
+{
+    return m_recursive;
+}
+
+int CleanerItem::minAgeDays() const
+{
+    return m_minAgeDays;
+}
+
 void CleanerItem::setName(const QString &name)
 {
     m_name = name;
@@ -80,4 +104,19 @@ void CleanerItem::setSelected(bool selected)
 void CleanerItem::setSafe(bool safe)
 {
     m_safe = safe;
+}
+
+void CleanerItem::setExtraPaths(const QStringList &extraPaths)
+{
+    m_extraPaths = extraPaths;
+}
+
+void CleanerItem::setRecursive(bool recursive)
+{
+    m_recursive = recursive;
+}
+
+void CleanerItem::setMinAgeDays(int days)
+{
+    m_minAgeDays = days;
 }
\ No newline at end of file
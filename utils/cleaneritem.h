@@ -19,6 +19,10 @@ public:
     qint64 size() const;
     bool isSelected() const;
     bool isSafe() const;
+    QStringList extraPaths() const;
+    QStringList allPaths() const;
+    bool isRecursive() const;
+    int minAgeDays() const;
 
     // Setters
     void setName(const QString &name);
@@ -28,6 +32,9 @@ public:
     void setSize(qint64 size);
     void setSelected(bool selected);
     void setSafe(bool safe);
+    void setExtraPaths(const QStringList &extraPaths);
+    void setRecursive(bool recursive);
+    void setMinAgeDays(int days);
 
 private:
     QString m_name;
@@ -37,6 +44,9 @@ private:
     qint64 m_size;
     bool m_selected;
     bool m_safe;
+    QStringList m_extraPaths; // Additional roots scanned with the same patterns
+    bool m_recursive;
+    int m_minAgeDays;         // Only files older than this are candidates (0 = any age)
 };
 
 #endif // CLEANERITEM_H
\ No newline at end of file
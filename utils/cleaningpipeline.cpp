@@ -0,0 +1,164 @@
+#include "cleaningpipeline.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QElapsedTimer>
+#include <QProcess>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <shellapi.h>
+
+#pragma comment(lib, "shell32.lib")
+#endif
+
+namespace
+{
+    const int ProgressThrottleMs = 100;
+}
+
+CleaningPipeline::CleaningPipeline(QObject *parent)
+    : QObject(parent), m_cancel(false)
+{
+    m_watcher = new QFutureWatcher<CleaningOutcome>(this);
+    connect(m_watcher, &QFutureWatcher<CleaningOutcome>::finished,
+            this, &CleaningPipeline::onJobFinished);
+}
+
+CleaningPipeline::~CleaningPipeline()
+{
+    m_cancel = true;
+    m_watcher->waitForFinished();
+}
+
+bool CleaningPipeline::isRunning() const
+{
+    return m_watcher->isRunning();
+}
+
+bool CleaningPipeline::start(const CleanManifest &manifest, const QStringList &categories)
+{
+    if (m_watcher->isRunning())
+        return false;
+
+    m_cancel = false;
+    m_outcome = CleaningOutcome();
+
+    QFuture<CleaningOutcome> future = QtConcurrent::run([this, manifest, categories]()
+                                                        { return runJob(manifest, categories); });
+    m_watcher->setFuture(future);
+    return true;
+}
+
+void CleaningPipeline::cancel()
+{
+    m_cancel = true;
+}
+
+CleaningOutcome CleaningPipeline::outcome() const
+{
+    return m_outcome;
+}
+
+void CleaningPipeline::onJobFinished()
+{
+    m_outcome = m_watcher->result();
+    emit finished(m_outcome.canceled);
+}
+
+CleaningOutcome CleaningPipeline::runJob(CleanManifest manifest, const QStringList &categories)
+{
+    CleaningOutcome outcome;
+    QElapsedTimer throttle;
+    throttle.start();
+
+    for (int i = 0; i < categories.size(); ++i)
+    {
+        if (m_cancel)
+            break;
+
+        const QString &name = categories[i];
+        CleanCategoryPlan plan = manifest.category(name);
+        int filesTotal = plan.files.size();
+        qint64 bytesTotal = plan.totalSize;
+
+        // Signals emitted here are queued to the receivers in the GUI thread
+        emit categoryStarted(name, i, categories.size());
+
+        CleanApplyResult result = applyCategory(plan, m_cancel, [&](int filesDone, const CleanApplyResult &partial)
+                                                {
+            if (throttle.elapsed() < ProgressThrottleMs)
+                return;
+            throttle.restart();
+            emit progressUpdated(name, filesDone, filesTotal, partial.bytesFreed, bytesTotal); });
+
+        manifest.setCategory(plan);
+        outcome.cleanedCategories.append(name);
+        outcome.totals.filesDeleted += result.filesDeleted;
+        outcome.totals.filesSkipped += result.filesSkipped;
+        outcome.totals.filesFailed += result.filesFailed;
+        outcome.totals.bytesFreed += result.bytesFreed;
+
+        emit progressUpdated(name, filesTotal, filesTotal, result.bytesFreed, bytesTotal);
+        emit categoryFinished(name, result.filesDeleted, result.bytesFreed);
+    }
+
+    outcome.canceled = m_cancel;
+    outcome.manifest = manifest;
+    return outcome;
+}
+
+CleanApplyResult CleaningPipeline::applyCategory(CleanCategoryPlan &plan, QAtomicInteger<bool> &cancelFlag,
+                                                 const CleanManifest::ProgressCallback &progress)
+{
+    if (plan.name == "Recycle Bin")
+        return emptyRecycleBin(plan);
+
+    // Explorer keeps the thumbnail databases it is using open; those count as
+    // locked and stay, rather than closing the user's shell to free them
+    return CleanManifest::apply(plan, cancelFlag, progress);
+}
+
+CleanApplyResult CleaningPipeline::emptyRecycleBin(CleanCategoryPlan &plan)
+{
+    CleanApplyResult result;
+    qint64 items = 0;
+    qint64 bytes = plan.totalSize;
+    bool emptied = false;
+
+#ifdef Q_OS_WIN
+    // Measured again right before emptying, as the scan may be minutes old
+    SHQUERYRBINFO info = {};
+    info.cbSize = sizeof(info);
+    if (SUCCEEDED(SHQueryRecycleBinW(nullptr, &info)))
+    {
+        items = info.i64NumItems;
+        bytes = info.i64Size;
+        if (items == 0)
+        {
+            plan.totalSize = 0;
+            return result;
+        }
+    }
+
+    emptied = SUCCEEDED(SHEmptyRecycleBinW(nullptr, nullptr, SHERB_NOCONFIRMATION | SHERB_NOPROGRESSUI | SHERB_NOSOUND));
+#endif
+
+    if (!emptied)
+    {
+        QProcess process;
+        process.start("powershell", QStringList() << "-NoProfile" << "-Command" << "Clear-RecycleBin -Force -ErrorAction Stop");
+        emptied = process.waitForFinished() && process.exitStatus() == QProcess::NormalExit && process.exitCode() == 0;
+    }
+
+    // The plan keeps its size until the bin is known to be empty
+    if (!emptied)
+    {
+        result.filesFailed = int(qMax<qint64>(items, 1));
+        return result;
+    }
+
+    result.filesDeleted = int(items);
+    result.bytesFreed = bytes;
+    plan.files.clear();
+    plan.totalSize = 0;
+    return result;
+}
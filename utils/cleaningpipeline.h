@@ -0,0 +1,57 @@
+#ifndef CLEANINGPIPELINE_H
+#define CLEANINGPIPELINE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QAtomicInteger>
+#include <QStringList>
+#include "cleanmanifest.h"
+
+// Outcome of one cleaning job: the manifest with only the files still on
+// disk, plus the totals over all categories that were processed.
+struct CleaningOutcome
+{
+    CleanManifest manifest;
+    CleanApplyResult totals;
+    QStringList cleanedCategories;
+    bool canceled = false;
+};
+
+// Applies a CleanManifest on a worker thread. Progress is reported per
+// category in files and bytes; cancel() takes effect between files.
+class CleaningPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CleaningPipeline(QObject *parent = nullptr);
+    ~CleaningPipeline();
+
+    bool isRunning() const;
+    bool start(const CleanManifest &manifest, const QStringList &categories);
+    void cancel();
+    CleaningOutcome outcome() const;
+
+signals:
+    void categoryStarted(const QString &category, int index, int count);
+    void progressUpdated(const QString &category, int filesDone, int filesTotal,
+                         qint64 bytesFreed, qint64 bytesTotal);
+    void categoryFinished(const QString &category, int filesDeleted, qint64 bytesFreed);
+    void finished(bool canceled);
+
+private slots:
+    void onJobFinished();
+
+private:
+    QFutureWatcher<CleaningOutcome> *m_watcher;
+    QAtomicInteger<bool> m_cancel;
+    CleaningOutcome m_outcome;
+
+    CleaningOutcome runJob(CleanManifest manifest, const QStringList &categories);
+    static CleanApplyResult applyCategory(CleanCategoryPlan &plan, QAtomicInteger<bool> &cancelFlag,
+                                          const CleanManifest::ProgressCallback &progress);
+    // Through the shell, with Clear-RecycleBin as the fallback
+    static CleanApplyResult emptyRecycleBin(CleanCategoryPlan &plan);
+};
+
+#endif // CLEANINGPIPELINE_H
@@ -0,0 +1,340 @@
+#include "cleanmanifest.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace
+{
+    const quint32 ManifestMagic = 0x52434d46; // "RCMF"
+    const quint32 ManifestVersion = 4;
+    const int ProgressInterval = 64; // files between progress callbacks
+}
+
+CleanManifest::CleanManifest()
+{
+}
+
+void CleanManifest::clear()
+{
+    m_categories.clear();
+    m_createdAt = QDateTime();
+}
+
+bool CleanManifest::isEmpty() const
+{
+    return m_categories.isEmpty();
+}
+
+QDateTime CleanManifest::createdAt() const
+{
+    return m_createdAt;
+}
+
+void CleanManifest::setCreatedAt(const QDateTime &createdAt)
+{
+    m_createdAt = createdAt;
+}
+
+void CleanManifest::setCategory(const CleanCategoryPlan &plan)
+{
+    int index = indexOf(plan.name);
+    if (index >= 0)
+    {
+        m_categories[index] = plan;
+    }
+    else
+    {
+        m_categories.append(plan);
+    }
+}
+
+bool CleanManifest::contains(const QString &name) const
+{
+    return indexOf(name) >= 0;
+}
+
+CleanCategoryPlan CleanManifest::category(const QString &name) const
+{
+    int index = indexOf(name);
+    if (index < 0)
+    {
+        CleanCategoryPlan empty;
+        empty.name = name;
+        return empty;
+    }
+    return m_categories[index];
+}
+
+QStringList CleanManifest::categories() const
+{
+    QStringList names;
+    for (const CleanCategoryPlan &plan : m_categories)
+    {
+        names << plan.name;
+    }
+    return names;
+}
+
+qint64 CleanManifest::totalSize() const
+{
+    return totalSize(categories());
+}
+
+qint64 CleanManifest::totalSize(const QStringList &names) const
+{
+    qint64 total = 0;
+    for (const QString &name : names)
+    {
+        int index = indexOf(name);
+        if (index >= 0)
+            total += m_categories[index].totalSize;
+    }
+    return total;
+}
+
+int CleanManifest::fileCount(const QStringList &names) const
+{
+    int count = 0;
+    for (const QString &name : names)
+    {
+        int index = indexOf(name);
+        if (index >= 0)
+            count += m_categories[index].files.size();
+    }
+    return count;
+}
+
+QString CleanManifest::preview(const QStringList &names, int maxFilesPerCategory) const
+{
+    QString text;
+    for (const QString &name : names)
+    {
+        int index = indexOf(name);
+        if (index < 0)
+            continue;
+
+        const CleanCategoryPlan &plan = m_categories[index];
+        text += QString("• %1: %2 files (%3)\n")
+                    .arg(plan.name)
+                    .arg(plan.files.size())
+                    .arg(formatSize(plan.totalSize));
+
+        for (int i = 0; i < plan.files.size() && i < maxFilesPerCategory; ++i)
+        {
+            text += QString("    %1\n").arg(QDir::toNativeSeparators(plan.files[i].path));
+        }
+
+        if (plan.files.size() > maxFilesPerCategory)
+        {
+            text += QString("    ... and %1 more files\n").arg(plan.files.size() - maxFilesPerCategory);
+        }
+    }
+    return text;
+}
+
+bool CleanManifest::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << ManifestMagic << ManifestVersion << m_createdAt << qint32(m_categories.size());
+
+    for (const CleanCategoryPlan &plan : m_categories)
+    {
+        out << plan.name << plan.totalSize << plan.nextEligibleAt << qint32(plan.files.size());
+        for (const CleanCandidate &candidate : plan.files)
+        {
+            out << candidate.path << candidate.size << candidate.lastModified;
+        }
+
+        out << qint32(plan.directories.size());
+        for (const CleanDirectory &directory : plan.directories)
+        {
+            out << directory.path << directory.lastModified;
+        }
+        out << plan.removeEmptyDirectories;
+    }
+
+    return out.status() == QDataStream::Ok;
+}
+
+bool CleanManifest::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QDateTime createdAt;
+    qint32 categoryCount = 0;
+    in >> magic >> version >> createdAt >> categoryCount;
+
+    if (magic != ManifestMagic || version != ManifestVersion || categoryCount < 0)
+        return false;
+
+    QVector<CleanCategoryPlan> categories;
+    for (qint32 i = 0; i < categoryCount && in.status() == QDataStream::Ok; ++i)
+    {
+        CleanCategoryPlan plan;
+        qint32 fileCount = 0;
+        in >> plan.name >> plan.totalSize >> plan.nextEligibleAt >> fileCount;
+
+        for (qint32 j = 0; j < fileCount && in.status() == QDataStream::Ok; ++j)
+        {
+            CleanCandidate candidate;
+            in >> candidate.path >> candidate.size >> candidate.lastModified;
+            plan.files.append(candidate);
+        }
+
+        qint32 directoryCount = 0;
+        in >> directoryCount;
+        for (qint32 j = 0; j < directoryCount && in.status() == QDataStream::Ok; ++j)
+        {
+            CleanDirectory directory;
+            in >> directory.path >> directory.lastModified;
+            plan.directories.append(directory);
+        }
+        in >> plan.removeEmptyDirectories;
+        categories.append(plan);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_categories = categories;
+    m_createdAt = createdAt;
+    return true;
+}
+
+QString CleanManifest::defaultFilePath(const QString &baseName)
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/" + baseName + ".manifest";
+}
+
+QString CleanManifest::formatSize(qint64 bytes)
+{
+    double sizeMB = bytes / (1024.0 * 1024.0);
+
+    if (sizeMB < 1)
+    {
+        return QString("%1 KB").arg(int(bytes / 1024));
+    }
+    else if (sizeMB < 1024)
+    {
+        return QString("%1 MB").arg(sizeMB, 0, 'f', 1);
+    }
+    return QString("%1 GB").arg(sizeMB / 1024, 0, 'f', 1);
+}
+
+CleanApplyResult CleanManifest::apply(CleanCategoryPlan &plan, QAtomicInteger<bool> &cancelFlag,
+                                     const ProgressCallback &progress)
+{
+    CleanApplyResult result;
+    QVector<CleanCandidate> remaining;
+    int processed = 0;
+
+    for (const CleanCandidate &candidate : plan.files)
+    {
+        if (cancelFlag)
+        {
+            remaining.append(candidate);
+            continue;
+        }
+
+        if (progress && processed % ProgressInterval == 0)
+        {
+            progress(processed, result);
+        }
+        processed++;
+
+        // Cheap stat check: only delete what the scan actually saw
+        QFileInfo info(candidate.path);
+        if (!info.exists())
+        {
+            result.filesSkipped++;
+            continue;
+        }
+
+        if (info.size() != candidate.size ||
+            info.lastModified().toMSecsSinceEpoch() != candidate.lastModified)
+        {
+            // Still on disk, so it stays listed; the next scan picks up its new size
+            result.filesSkipped++;
+            remaining.append(candidate);
+            continue;
+        }
+
+        bool removed = QFile::remove(candidate.path);
+        if (!removed)
+        {
+            // Read-only files need their write bit back before they can go
+            QFile::setPermissions(candidate.path, info.permissions() | QFileDevice::WriteUser);
+            removed = QFile::remove(candidate.path);
+        }
+
+        if (removed)
+        {
+            result.filesDeleted++;
+            result.bytesFreed += candidate.size;
+        }
+        else
+        {
+            result.filesFailed++;
+            remaining.append(candidate);
+        }
+    }
+
+    if (progress)
+    {
+        progress(processed, result);
+    }
+
+    if (plan.removeEmptyDirectories && !cancelFlag)
+    {
+        // Deepest first so parents are empty by the time they are reached;
+        // rmdir refuses directories that still hold anything
+        QVector<CleanDirectory> directories = plan.directories;
+        std::sort(directories.begin(), directories.end(), [](const CleanDirectory &a, const CleanDirectory &b)
+                  { return a.path.size() > b.path.size(); });
+
+        QVector<CleanDirectory> kept;
+        for (const CleanDirectory &directory : directories)
+        {
+            if (!QDir().rmdir(directory.path) && QFileInfo::exists(directory.path))
+                kept.append(directory);
+        }
+        plan.directories = kept;
+    }
+
+    plan.files = remaining;
+    plan.totalSize = 0;
+    for (const CleanCandidate &candidate : remaining)
+    {
+        plan.totalSize += candidate.size;
+    }
+
+    return result;
+}
+
+int CleanManifest::indexOf(const QString &name) const
+{
+    for (int i = 0; i < m_categories.size(); ++i)
+    {
+        if (m_categories[i].name == name)
+            return i;
+    }
+    return -1;
+}
@@ -0,0 +1,97 @@
+#ifndef CLEANMANIFEST_H
+#define CLEANMANIFEST_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <QAtomicInteger>
+#include <functional>
+
+// A single file found by a scan. Size and mtime are recorded so the clean
+// step can cheaply detect files that changed after the scan.
+struct CleanCandidate
+{
+    QString path;
+    qint64 size = 0;
+    qint64 lastModified = 0; // msecs since epoch
+};
+
+// A directory visited by a scan. Its mtime changes whenever an entry is
+// added, removed or renamed, which makes it a cheap staleness check.
+struct CleanDirectory
+{
+    QString path;
+    qint64 lastModified = 0; // msecs since epoch
+};
+
+// Everything a scan found for one cleaner category.
+struct CleanCategoryPlan
+{
+    QString name;
+    QVector<CleanCandidate> files;
+    QVector<CleanDirectory> directories;
+    qint64 totalSize = 0;
+
+    // When the oldest file skipped for being newer than the age cutoff
+    // becomes a candidate (msecs since epoch, 0 = none skipped)
+    qint64 nextEligibleAt = 0;
+
+    // Remove the listed directories once emptied (leftover folders); cleaner
+    // categories keep theirs since they include roots such as %TEMP%
+    bool removeEmptyDirectories = false;
+};
+
+struct CleanApplyResult
+{
+    int filesDeleted = 0;
+    int filesSkipped = 0; // Gone or changed since the scan
+    int filesFailed = 0;  // Locked or access denied
+    qint64 bytesFreed = 0;
+};
+
+// In-memory result of a cleaner scan. The clean step applies it directly
+// instead of re-enumerating the category roots.
+class CleanManifest
+{
+public:
+    CleanManifest();
+
+    void clear();
+    bool isEmpty() const;
+    QDateTime createdAt() const;
+    void setCreatedAt(const QDateTime &createdAt);
+
+    void setCategory(const CleanCategoryPlan &plan);
+    bool contains(const QString &name) const;
+    CleanCategoryPlan category(const QString &name) const;
+    QStringList categories() const;
+
+    qint64 totalSize() const;
+    qint64 totalSize(const QStringList &names) const;
+    int fileCount(const QStringList &names) const;
+
+    // Dry-run preview of what applying the given categories would delete
+    QString preview(const QStringList &names, int maxFilesPerCategory = 5) const;
+
+    bool save(const QString &filePath) const;
+    bool load(const QString &filePath);
+    static QString defaultFilePath(const QString &baseName);
+    static QString formatSize(qint64 bytes);
+
+    // Called every few files with the running totals of the current category
+    using ProgressCallback = std::function<void(int filesProcessed, const CleanApplyResult &result)>;
+
+    // Deletes the planned files, skipping any whose size or mtime no longer
+    // match the scan. Files that are left on disk stay in the plan.
+    static CleanApplyResult apply(CleanCategoryPlan &plan, QAtomicInteger<bool> &cancelFlag,
+                                  const ProgressCallback &progress = ProgressCallback());
+
+private:
+    QVector<CleanCategoryPlan> m_categories;
+    QDateTime m_createdAt;
+
+    int indexOf(const QString &name) const;
+};
+
+#endif // CLEANMANIFEST_H
@@ -0,0 +1,72 @@
+#include "cputicks.h"
+#include <QFile>
+#include <QList>
+#include <QtGlobal>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace
+{
+#ifdef Q_OS_WIN
+    qint64 fileTimeTicks(const FILETIME &time)
+    {
+        return qint64((quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime);
+    }
+#endif
+}
+
+bool CpuTicks::isValid() const
+{
+    return total > 0;
+}
+
+int CpuTicks::busyPercentSince(const CpuTicks &earlier) const
+{
+    // Over 50 ms a 100 Hz tick counter may not have moved at all
+    qint64 totalDiff = total - earlier.total;
+    if (!isValid() || !earlier.isValid() || totalDiff <= 0)
+        return 0;
+    return qBound(0, int((busy - earlier.busy) * 100 / totalDiff), 100);
+}
+
+CpuTicks CpuTicks::current()
+{
+#ifdef Q_OS_WIN
+    // Kernel time includes idle time
+    CpuTicks ticks;
+    FILETIME idle, kernel, user;
+    if (GetSystemTimes(&idle, &kernel, &user))
+    {
+        ticks.total = fileTimeTicks(kernel) + fileTimeTicks(user);
+        ticks.busy = ticks.total - fileTimeTicks(idle);
+    }
+    return ticks;
+#else
+    QFile stat("/proc/stat");
+    if (!stat.open(QIODevice::ReadOnly))
+        return CpuTicks();
+    return fromProcStat(stat.readLine());
+#endif
+}
+
+CpuTicks CpuTicks::fromProcStat(const QByteArray &text)
+{
+    CpuTicks ticks;
+    int end = text.indexOf('\n');
+    QByteArray line = end >= 0 ? text.left(end) : text;
+    if (!line.startsWith("cpu "))
+        return ticks;
+
+    // cpu  user nice system idle iowait irq softirq steal
+    QList<QByteArray> fields = line.simplified().split(' ');
+    for (int i = 1; i < fields.size() && i <= 8; ++i)
+    {
+        qint64 value = fields[i].toLongLong();
+        ticks.total += value;
+        if (i != 4 && i != 5)
+            ticks.busy += value;
+    }
+    return ticks;
+}
@@ -0,0 +1,22 @@
+#ifndef CPUTICKS_H
+#define CPUTICKS_H
+
+#include <QByteArray>
+
+// CPU time of all processors since boot, split into busy and total; two
+// readings give the usage in between. Idle and I/O wait count as not busy.
+struct CpuTicks
+{
+    qint64 busy = 0;
+    qint64 total = 0;
+
+    bool isValid() const;
+    // Busy share of the time between the two readings, 0 if no tick passed
+    int busyPercentSince(const CpuTicks &earlier) const;
+
+    static CpuTicks current();
+    // The "cpu" line that starts /proc/stat
+    static CpuTicks fromProcStat(const QByteArray &text);
+};
+
+#endif // CPUTICKS_H
@@ -0,0 +1,194 @@
+#include "cronrebootsource.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QRegularExpression>
+#include <QSaveFile>
+
+namespace
+{
+    const char *const UserCrontab = "crontab";
+
+    // Splits "@reboot [user] command" into its command; a leading '#' marks a disabled job
+    bool parseRebootLine(const QString &line, bool hasUserField, bool &enabled, QString &command)
+    {
+        QString text = line.trimmed();
+        enabled = !text.startsWith('#');
+        while (text.startsWith('#'))
+            text = text.mid(1).trimmed();
+
+        if (!text.startsWith("@reboot") || text.length() <= 7 || !text.at(7).isSpace())
+            return false;
+
+        text = text.mid(7).trimmed();
+        if (hasUserField)
+            text = text.section(QRegularExpression("\\s+"), 1).trimmed();
+        command = text;
+        return !command.isEmpty();
+    }
+
+    bool readCrontab(const QString &location, QStringList &lines)
+    {
+        QByteArray content;
+        if (location == UserCrontab)
+        {
+            QProcess process;
+            process.start("crontab", QStringList() << "-l");
+            if (!process.waitForFinished(3000))
+            {
+                process.kill();
+                return false;
+            }
+            // "no crontab for user" exits with 1 and means an empty crontab
+            content = process.exitCode() == 0 ? process.readAllStandardOutput() : QByteArray();
+        }
+        else
+        {
+            QFile file(location);
+            if (!file.open(QIODevice::ReadOnly))
+                return false;
+            content = file.readAll();
+        }
+
+        lines = QString::fromLocal8Bit(content).split('\n');
+        while (!lines.isEmpty() && lines.last().isEmpty())
+            lines.removeLast();
+        return true;
+    }
+}
+
+QString CronRebootSource::id() const
+{
+    return "cron";
+}
+
+QStringList CronRebootSource::systemCrontabs()
+{
+    QStringList files;
+    if (QFileInfo::exists("/etc/crontab"))
+        files << "/etc/crontab";
+
+    // run-parts style names only; editors' backups and package leftovers are ignored by cron too
+    QFileInfoList entries = QDir("/etc/cron.d").entryInfoList(QDir::Files, QDir::Name);
+    for (const QFileInfo &entry : entries)
+    {
+        QString name = entry.fileName();
+        if (!name.startsWith('.') && !name.endsWith('~') && !name.contains(".dpkg-") && !name.contains(".rpm"))
+            files << entry.absoluteFilePath();
+    }
+    return files;
+}
+
+void CronRebootSource::scanLines(QList<StartupProgram> &programs, const QStringList &lines,
+                                 const QString &location, bool hasUserField) const
+{
+    for (const QString &line : lines)
+    {
+        bool isEnabled = false;
+        QString command;
+        if (!parseRebootLine(line, hasUserField, isEnabled, command))
+            continue;
+
+        StartupProgram program;
+        program.name = QFileInfo(command.section(QRegularExpression("\\s+"), 0, 0)).fileName();
+        program.status = isEnabled ? "Enabled" : "Disabled";
+        program.startupType = "Cron";
+        program.command = command;
+        program.location = location;
+        program.isEnabled = isEnabled;
+        program.source = id();
+        programs.append(program);
+    }
+}
+
+QList<StartupProgram> CronRebootSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+    for (const QString &path : systemCrontabs())
+    {
+        QStringList lines;
+        if (readCrontab(path, lines))
+            scanLines(programs, lines, path, true);
+    }
+
+    QStringList lines;
+    if (readCrontab(UserCrontab, lines))
+        scanLines(programs, lines, UserCrontab, false);
+
+    return programs;
+}
+
+bool CronRebootSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    bool userCrontab = program.location == UserCrontab;
+    QStringList lines;
+    if (!readCrontab(program.location, lines))
+    {
+        error = QString("Could not read %1.").arg(program.location);
+        return false;
+    }
+
+    // Toggle the first job with the same command that is in the other state
+    bool changed = false;
+    for (QString &line : lines)
+    {
+        bool isEnabled = false;
+        QString command;
+        if (!parseRebootLine(line, !userCrontab, isEnabled, command) ||
+            command != program.command || isEnabled == enable)
+            continue;
+
+        if (enable)
+        {
+            line = line.trimmed();
+            while (line.startsWith('#'))
+                line = line.mid(1).trimmed();
+        }
+        else
+        {
+            line = "#" + line;
+        }
+        changed = true;
+        break;
+    }
+
+    if (!changed)
+    {
+        error = QString("The @reboot job for '%1' was not found in %2.").arg(program.name, program.location);
+        return false;
+    }
+
+    QByteArray content = (lines.join('\n') + '\n').toLocal8Bit();
+    if (userCrontab)
+    {
+        QProcess process;
+        process.setProcessChannelMode(QProcess::MergedChannels);
+        process.start("crontab", QStringList() << "-");
+        if (!process.waitForStarted(3000))
+        {
+            error = "crontab could not be started.";
+            return false;
+        }
+        process.write(content);
+        process.closeWriteChannel();
+        if (!process.waitForFinished(10000) || process.exitCode() != 0)
+        {
+            process.kill();
+            error = QString::fromLocal8Bit(process.readAll()).trimmed();
+            if (error.isEmpty())
+                error = "crontab did not accept the change.";
+            return false;
+        }
+        return true;
+    }
+
+    QSaveFile file(program.location);
+    if (!file.open(QIODevice::WriteOnly) || file.write(content) != content.size() || !file.commit())
+    {
+        error = QString("Could not write %1. System crontabs need administrator rights.").arg(program.location);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,23 @@
+#ifndef CRONREBOOTSOURCE_H
+#define CRONREBOOTSOURCE_H
+
+#include "startupsource.h"
+#include <QStringList>
+
+// "@reboot" jobs of cron: the system crontab and /etc/cron.d, whose lines
+// carry a user field, and the current user's crontab read through
+// "crontab -l". Disabling comments the line out, enabling uncomments it.
+class CronRebootSource : public StartupSource
+{
+public:
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+
+private:
+    static QStringList systemCrontabs();
+    void scanLines(QList<StartupProgram> &programs, const QStringList &lines,
+                   const QString &location, bool hasUserField) const;
+};
+
+#endif // CRONREBOOTSOURCE_H
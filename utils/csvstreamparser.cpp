@@ -0,0 +1,191 @@
+#include "csvstreamparser.h"
+#include <cstring>
+
+CsvStreamParser::Row::Row(const QByteArray &buffer, const QVector<int> &ends)
+    : m_buffer(buffer), m_ends(ends)
+{
+}
+
+int CsvStreamParser::Row::size() const
+{
+    return m_ends.size();
+}
+
+int CsvStreamParser::Row::start(int field) const
+{
+    return field == 0 ? 0 : m_ends[field - 1];
+}
+
+const char *CsvStreamParser::Row::data(int field) const
+{
+    return m_buffer.constData() + start(field);
+}
+
+int CsvStreamParser::Row::length(int field) const
+{
+    return m_ends[field] - start(field);
+}
+
+QByteArray CsvStreamParser::Row::toByteArray(int field) const
+{
+    return QByteArray(data(field), length(field));
+}
+
+QString CsvStreamParser::Row::text(int field) const
+{
+    return QString::fromLocal8Bit(data(field), length(field));
+}
+
+CsvStreamParser::CsvStreamParser(const RowCallback &callback, char delimiter)
+    : m_callback(callback), m_delimiter(delimiter), m_state(FieldStart), m_rowStarted(false),
+      m_skipLineFeed(false), m_stopped(false), m_rowCount(0)
+{
+    // Reserved capacity survives resize(0), so the row buffer is allocated once
+    m_row.reserve(1024);
+    m_ends.reserve(16);
+}
+
+void CsvStreamParser::feed(const QByteArray &chunk)
+{
+    feed(chunk.constData(), chunk.size());
+}
+
+void CsvStreamParser::feed(const char *data, qint64 size)
+{
+    const char *const end = data + size;
+    const char *p = data;
+
+    while (p < end && !m_stopped)
+    {
+        char c = *p;
+        if (m_skipLineFeed)
+        {
+            m_skipLineFeed = false;
+            if (c == '\n')
+            {
+                ++p;
+                continue;
+            }
+        }
+
+        switch (m_state)
+        {
+        case FieldStart:
+            if (c == '"')
+            {
+                m_rowStarted = true;
+                m_state = Quoted;
+                ++p;
+                break;
+            }
+            m_state = Unquoted;
+            Q_FALLTHROUGH();
+
+        case Unquoted:
+        {
+            // Copy the run up to the next delimiter or line break in one go
+            const char *run = p;
+            while (p < end && *p != m_delimiter && *p != '\n' && *p != '\r')
+                ++p;
+            if (p > run)
+            {
+                m_row.append(run, int(p - run));
+                m_rowStarted = true;
+            }
+            if (p == end)
+                break;
+
+            if (*p == m_delimiter)
+            {
+                m_rowStarted = true;
+                endField();
+            }
+            else
+            {
+                m_skipLineFeed = *p == '\r';
+                endRow();
+            }
+            ++p;
+            break;
+        }
+
+        case Quoted:
+        {
+            const char *quote = static_cast<const char *>(std::memchr(p, '"', size_t(end - p)));
+            const char *runEnd = quote ? quote : end;
+            m_row.append(p, int(runEnd - p));
+            p = runEnd;
+            if (quote)
+            {
+                m_state = QuoteInQuoted;
+                ++p;
+            }
+            break;
+        }
+
+        case QuoteInQuoted:
+            if (c == '"')
+            {
+                // A doubled quote stands for one quote character
+                m_row.append('"');
+                m_state = Quoted;
+            }
+            else if (c == m_delimiter)
+            {
+                endField();
+            }
+            else if (c == '\n' || c == '\r')
+            {
+                m_skipLineFeed = c == '\r';
+                endRow();
+            }
+            else
+            {
+                // Not RFC 4180, but keep text after a closing quote rather than lose it
+                m_row.append(c);
+                m_state = Unquoted;
+            }
+            ++p;
+            break;
+        }
+    }
+}
+
+void CsvStreamParser::finish()
+{
+    if (!m_stopped && (m_rowStarted || !m_ends.isEmpty()))
+        endRow();
+    m_skipLineFeed = false;
+}
+
+qint64 CsvStreamParser::rowCount() const
+{
+    return m_rowCount;
+}
+
+bool CsvStreamParser::isStopped() const
+{
+    return m_stopped;
+}
+
+void CsvStreamParser::endField()
+{
+    m_ends.append(m_row.size());
+    m_state = FieldStart;
+}
+
+void CsvStreamParser::endRow()
+{
+    if (m_rowStarted || !m_ends.isEmpty())
+    {
+        endField();
+        ++m_rowCount;
+        if (!m_callback(Row(m_row, m_ends)))
+            m_stopped = true;
+    }
+
+    m_row.resize(0);
+    m_ends.resize(0);
+    m_state = FieldStart;
+    m_rowStarted = false;
+}
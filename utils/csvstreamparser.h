@@ -0,0 +1,74 @@
+#ifndef CSVSTREAMPARSER_H
+#define CSVSTREAMPARSER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include <functional>
+
+// Incremental RFC 4180 reader: bytes are fed in whatever chunks a pipe
+// delivers them and every row is handed to the callback as soon as its line
+// ends. Quoted fields may contain delimiters, doubled quotes and line
+// breaks. Fields are views into one row buffer that is reused for every
+// row, so no per-field strings are allocated; copy what must outlive the
+// callback. Blank lines are skipped and CRLF, LF and CR all end a row.
+class CsvStreamParser
+{
+public:
+    class Row
+    {
+    public:
+        int size() const;
+        const char *data(int field) const;
+        int length(int field) const;
+        QByteArray toByteArray(int field) const;
+        // Decoded with the local 8-bit codec, as console programs write
+        QString text(int field) const;
+
+    private:
+        friend class CsvStreamParser;
+        Row(const QByteArray &buffer, const QVector<int> &ends);
+
+        const QByteArray &m_buffer;
+        const QVector<int> &m_ends;
+        int start(int field) const;
+    };
+
+    // Return false to stop parsing; later input is then ignored
+    using RowCallback = std::function<bool(const Row &row)>;
+
+    explicit CsvStreamParser(const RowCallback &callback, char delimiter = ',');
+
+    void feed(const char *data, qint64 size);
+    void feed(const QByteArray &chunk);
+    // Completes a last row that has no line break after it
+    void finish();
+
+    qint64 rowCount() const;
+    bool isStopped() const;
+
+private:
+    enum State
+    {
+        FieldStart,
+        Unquoted,
+        Quoted,
+        QuoteInQuoted
+    };
+
+    RowCallback m_callback;
+    char m_delimiter;
+    State m_state;
+    bool m_rowStarted;
+    bool m_skipLineFeed; // a CR ended the row, so an LF right after it is part of the break
+    bool m_stopped;
+    qint64 m_rowCount;
+
+    QByteArray m_row;   // unescaped field bytes of the current row, back to back
+    QVector<int> m_ends; // end offset of every completed field in m_row
+
+    void endField();
+    void endRow();
+};
+
+#endif // CSVSTREAMPARSER_H
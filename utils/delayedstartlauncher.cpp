@@ -0,0 +1,184 @@
+#include "delayedstartlauncher.h"
+#include "startupimpactsampler.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <shellapi.h>
+#pragma comment(lib, "shell32.lib")
+#endif
+
+namespace
+{
+    const int TickIntervalMs = 1000;
+
+#ifdef Q_OS_LINUX
+    // Sectors moved by whole disks; partitions would count the same I/O twice
+    qint64 diskBytesFromSysfs()
+    {
+        qint64 total = 0;
+        const QStringList devices = QDir("/sys/block").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &device : devices)
+        {
+            if (device.startsWith("loop") || device.startsWith("ram") || device.startsWith("zram"))
+                continue;
+
+            QFile stat("/sys/block/" + device + "/stat");
+            if (!stat.open(QIODevice::ReadOnly))
+                continue;
+
+            // Fields 3 and 7 are sectors read and written, always in 512-byte units
+            QList<QByteArray> fields = stat.readAll().simplified().split(' ');
+            if (fields.size() >= 7)
+                total += (fields[2].toLongLong() + fields[6].toLongLong()) * 512;
+        }
+        return total;
+    }
+#endif
+}
+
+DelayedStartLauncher::DelayedStartLauncher(QObject *parent)
+    : QObject(parent), m_timer(new QTimer(this))
+{
+    m_timer->setInterval(TickIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &DelayedStartLauncher::tick);
+}
+
+void DelayedStartLauncher::start()
+{
+    DelayedStartList list;
+    list.load();
+    m_queue = list.entries();
+    m_settings = list.settings();
+
+    if (m_queue.isEmpty())
+    {
+        QTimer::singleShot(0, this, &DelayedStartLauncher::finished);
+        return;
+    }
+
+    // The first entry also waits one gap, while the desktop itself settles
+    m_lastSample = sampleSystemLoad();
+    m_sinceLaunch.start();
+    m_waiting.start();
+    m_timer->start();
+}
+
+void DelayedStartLauncher::tick()
+{
+    SystemLoadSample sample = sampleSystemLoad();
+    bool quiet = isQuiet(sample);
+    m_lastSample = sample;
+
+    if (m_sinceLaunch.elapsed() < qint64(m_settings.gapSeconds) * 1000)
+        return;
+
+    bool waitedEnough = m_waiting.elapsed() >= qint64(m_settings.gapSeconds + m_settings.maxWaitSeconds) * 1000;
+    if (!quiet && !waitedEnough)
+        return;
+
+    DelayedStartEntry entry = m_queue.takeFirst();
+    if (!launch(entry))
+        qDebug() << "Delayed start could not launch" << entry.name << ":" << entry.command;
+
+    if (m_queue.isEmpty())
+    {
+        m_timer->stop();
+        emit finished();
+        return;
+    }
+
+    m_sinceLaunch.restart();
+    m_waiting.restart();
+}
+
+bool DelayedStartLauncher::isQuiet(const SystemLoadSample &sample) const
+{
+    qint64 elapsedMs = sample.takenAtMs - m_lastSample.takenAtMs;
+    if (elapsedMs <= 0 || sample.cpu.total <= m_lastSample.cpu.total)
+        return false;
+
+    int cpuPercent = sample.cpu.busyPercentSince(m_lastSample.cpu);
+    double diskKBps = qMax<qint64>(0, sample.diskBytes - m_lastSample.diskBytes) / 1024.0 * 1000.0 / double(elapsedMs);
+    return cpuPercent < m_settings.cpuThresholdPercent && diskKBps < m_settings.diskThresholdKBps;
+}
+
+SystemLoadSample DelayedStartLauncher::sampleSystemLoad()
+{
+    SystemLoadSample sample;
+    sample.takenAtMs = QDateTime::currentMSecsSinceEpoch();
+    sample.cpu = CpuTicks::current();
+
+#ifdef Q_OS_WIN
+    // Without a disk counter API that works unelevated, bytes read by all processes stand in
+    for (const ProcessUsage &process : StartupImpactSampler::sampleProcesses())
+        sample.diskBytes += process.diskReadBytes;
+#elif defined(Q_OS_LINUX)
+    sample.diskBytes = diskBytesFromSysfs();
+#endif
+
+    return sample;
+}
+
+bool DelayedStartLauncher::launch(const DelayedStartEntry &entry)
+{
+#ifdef Q_OS_WIN
+    // Startup folder entries are files (mostly shortcuts) that the shell opens
+    if (entry.startupType == "Startup Folder")
+    {
+        QString path = QDir::toNativeSeparators(entry.command);
+        QString directory = QDir::toNativeSeparators(QFileInfo(entry.command).absolutePath());
+        HINSTANCE result = ShellExecuteW(nullptr, L"open", reinterpret_cast<const wchar_t *>(path.utf16()), nullptr,
+                                         reinterpret_cast<const wchar_t *>(directory.utf16()), SW_SHOWNORMAL);
+        return reinterpret_cast<INT_PTR>(result) > 32;
+    }
+
+    // Run values are whole command lines, possibly with %VARIABLES%
+    QString command = entry.command;
+    wchar_t expanded[4096];
+    if (ExpandEnvironmentStringsW(reinterpret_cast<const wchar_t *>(command.utf16()), expanded, ARRAYSIZE(expanded)) > 0)
+        command = QString::fromWCharArray(expanded);
+
+    std::wstring commandLine = command.toStdWString();
+    std::wstring directory = QDir::toNativeSeparators(
+                                 QFileInfo(StartupImpactSampler::executableFromCommand(command)).absolutePath())
+                                 .toStdWString();
+
+    STARTUPINFOW startupInfo = {};
+    startupInfo.cb = sizeof(startupInfo);
+    PROCESS_INFORMATION processInfo = {};
+    if (!CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, FALSE, 0, nullptr,
+                        directory.c_str(), &startupInfo, &processInfo))
+        return false;
+
+    CloseHandle(processInfo.hThread);
+    CloseHandle(processInfo.hProcess);
+    return true;
+#else
+    // Desktop entry Exec lines may carry field codes; none apply at logon
+    static const QString fieldCodes = "fFuUdDnNickvm";
+    QString command;
+    for (int i = 0; i < entry.command.size(); ++i)
+    {
+        QChar c = entry.command.at(i);
+        if (c == '%' && i + 1 < entry.command.size())
+        {
+            QChar code = entry.command.at(++i);
+            if (code == '%')
+                command += '%';
+            else if (!fieldCodes.contains(code))
+                command += QString(c) + code;
+            continue;
+        }
+        command += c;
+    }
+
+    return QProcess::startDetached("/bin/sh", QStringList() << "-c" << command);
+#endif
+}
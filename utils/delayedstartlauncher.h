@@ -0,0 +1,53 @@
+#ifndef DELAYEDSTARTLAUNCHER_H
+#define DELAYEDSTARTLAUNCHER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include "delayedstartlist.h"
+#include "cputicks.h"
+
+class QTimer;
+
+// Totals since boot; two samples give the load in between
+struct SystemLoadSample
+{
+    CpuTicks cpu;
+    qint64 diskBytes = 0;
+    qint64 takenAtMs = 0;
+};
+
+// Runs at logon in place of the delayed entries: starts them one by one in
+// priority order, keeps a gap between launches and holds each launch until
+// CPU use and disk traffic drop below the configured thresholds (or the
+// entry waited the maximum time, so nothing is left out).
+class DelayedStartLauncher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DelayedStartLauncher(QObject *parent = nullptr);
+
+    void start();
+
+    static SystemLoadSample sampleSystemLoad();
+    static bool launch(const DelayedStartEntry &entry);
+
+signals:
+    void finished();
+
+private slots:
+    void tick();
+
+private:
+    QTimer *m_timer;
+    QList<DelayedStartEntry> m_queue;
+    DelayedStartSettings m_settings;
+    SystemLoadSample m_lastSample;
+    QElapsedTimer m_sinceLaunch; // gap before the next entry
+    QElapsedTimer m_waiting;     // how long the next entry has waited for the gate
+
+    bool isQuiet(const SystemLoadSample &sample) const;
+};
+
+#endif // DELAYEDSTARTLAUNCHER_H
@@ -0,0 +1,162 @@
+#include "delayedstartlist.h"
+#include "logoncommand.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <algorithm>
+
+namespace
+{
+    const quint32 DelayedStartMagic = 0x5244534C; // "RDSL"
+    const quint32 DelayedStartVersion = 1;
+}
+
+DelayedStartList::DelayedStartList()
+{
+}
+
+QList<DelayedStartEntry> DelayedStartList::entries() const
+{
+    QList<DelayedStartEntry> sorted = m_entries;
+    std::stable_sort(sorted.begin(), sorted.end(),
+                     [](const DelayedStartEntry &a, const DelayedStartEntry &b)
+                     {
+                         return a.priority < b.priority;
+                     });
+    return sorted;
+}
+
+bool DelayedStartList::isEmpty() const
+{
+    return m_entries.isEmpty();
+}
+
+int DelayedStartList::indexOf(const QString &source, const QString &name) const
+{
+    for (int i = 0; i < m_entries.size(); ++i)
+    {
+        if (m_entries[i].source == source && m_entries[i].name.compare(name, Qt::CaseInsensitive) == 0)
+            return i;
+    }
+    return -1;
+}
+
+const DelayedStartEntry *DelayedStartList::find(const QString &source, const QString &name) const
+{
+    int index = indexOf(source, name);
+    return index >= 0 ? &m_entries[index] : nullptr;
+}
+
+void DelayedStartList::add(const DelayedStartEntry &entry)
+{
+    int index = indexOf(entry.source, entry.name);
+    if (index >= 0)
+        m_entries[index] = entry;
+    else
+        m_entries.append(entry);
+}
+
+bool DelayedStartList::remove(const QString &source, const QString &name)
+{
+    int index = indexOf(source, name);
+    if (index < 0)
+        return false;
+    m_entries.removeAt(index);
+    return true;
+}
+
+DelayedStartSettings DelayedStartList::settings() const
+{
+    return m_settings;
+}
+
+void DelayedStartList::setSettings(const DelayedStartSettings &settings)
+{
+    m_settings = settings;
+}
+
+bool DelayedStartList::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    DelayedStartSettings settings;
+    qint32 gap = 0, cpu = 0, disk = 0, maxWait = 0, count = 0;
+    in >> magic >> version >> gap >> cpu >> disk >> maxWait >> count;
+
+    if (magic != DelayedStartMagic || version != DelayedStartVersion || count < 0)
+        return false;
+
+    settings.gapSeconds = gap;
+    settings.cpuThresholdPercent = cpu;
+    settings.diskThresholdKBps = disk;
+    settings.maxWaitSeconds = maxWait;
+
+    QList<DelayedStartEntry> entries;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        DelayedStartEntry entry;
+        qint32 priority = 0;
+        in >> entry.name >> entry.command >> entry.startupType >> entry.source >> priority;
+        entry.priority = priority;
+        entries.append(entry);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_settings = settings;
+    m_entries = entries;
+    return true;
+}
+
+bool DelayedStartList::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    // Written atomically; the launcher may read it at the next logon at any moment
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << DelayedStartMagic << DelayedStartVersion
+        << qint32(m_settings.gapSeconds) << qint32(m_settings.cpuThresholdPercent)
+        << qint32(m_settings.diskThresholdKBps) << qint32(m_settings.maxWaitSeconds)
+        << qint32(m_entries.size());
+
+    for (const DelayedStartEntry &entry : m_entries)
+    {
+        out << entry.name << entry.command << entry.startupType << entry.source << qint32(entry.priority);
+    }
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+QString DelayedStartList::defaultFilePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/delayed_start.dat";
+}
+
+QString DelayedStartList::launcherArgument()
+{
+    return "--delayed-start";
+}
+
+bool DelayedStartList::setLauncherRegistered(bool registered, QString &error)
+{
+    static const LogonCommand launcher{"Raptor Delayed Start", "raptor-delayed-start.desktop",
+                                       "Starts delayed startup programs one after another", launcherArgument()};
+    return launcher.setRegistered(registered, error);
+}
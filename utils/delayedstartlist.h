@@ -0,0 +1,59 @@
+#ifndef DELAYEDSTARTLIST_H
+#define DELAYEDSTARTLIST_H
+
+#include <QString>
+#include <QList>
+
+// A startup entry taken out of its own location and started later by the
+// delayed start launcher instead
+struct DelayedStartEntry
+{
+    QString name;
+    QString command;     // as listed while disabled in its source
+    QString startupType; // "Registry", "Startup Folder" or "Autostart"
+    QString source;      // StartupSource::id() it was disabled in
+    int priority = 0;    // lower starts earlier
+};
+
+struct DelayedStartSettings
+{
+    int gapSeconds = 5;           // between two launches, and before the first
+    int cpuThresholdPercent = 30; // launch only while total CPU use is below this
+    int diskThresholdKBps = 4096; // and disk traffic below this
+    int maxWaitSeconds = 60;      // start anyway once an entry waited this long
+};
+
+// The entries the launcher starts, kept in a small file next to the other
+// caches. The launcher itself is registered as an ordinary startup entry
+// (a Run value on Windows, an autostart file on Linux) that runs the logon
+// helper with launcherArgument() while the list is not empty.
+class DelayedStartList
+{
+public:
+    DelayedStartList();
+
+    // Sorted by priority; entries of equal priority keep the order they were added in
+    QList<DelayedStartEntry> entries() const;
+    bool isEmpty() const;
+    const DelayedStartEntry *find(const QString &source, const QString &name) const;
+    void add(const DelayedStartEntry &entry);
+    bool remove(const QString &source, const QString &name);
+
+    DelayedStartSettings settings() const;
+    void setSettings(const DelayedStartSettings &settings);
+
+    bool load(const QString &filePath = defaultFilePath());
+    bool save(const QString &filePath = defaultFilePath()) const;
+
+    static QString defaultFilePath();
+    static QString launcherArgument();
+    static bool setLauncherRegistered(bool registered, QString &error);
+
+private:
+    QList<DelayedStartEntry> m_entries;
+    DelayedStartSettings m_settings;
+
+    int indexOf(const QString &source, const QString &name) const;
+};
+
+#endif // DELAYEDSTARTLIST_H
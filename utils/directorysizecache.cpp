@@ -0,0 +1,164 @@
+#include "directorysizecache.h"
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+namespace
+{
+    const quint32 SizeCacheMagic = 0x52445343; // "RDSC"
+    const quint32 SizeCacheVersion = 1;
+}
+
+DirectorySizeCache::DirectorySizeCache()
+{
+}
+
+qint64 DirectorySizeCache::directorySize(const QString &path, const QAtomicInteger<bool> &cancelFlag)
+{
+    QFileInfo info(path);
+    if (!info.isDir())
+        return 0;
+
+    return measure(QDir::cleanPath(info.absoluteFilePath()), info.lastModified().toMSecsSinceEpoch(), cancelFlag);
+}
+
+qint64 DirectorySizeCache::measure(const QString &path, qint64 lastModified, const QAtomicInteger<bool> &cancelFlag)
+{
+    Entry entry;
+    if (!lookup(path, lastModified, entry))
+    {
+        // Adding, removing or renaming an entry bumps the directory mtime,
+        // so only directories that changed are listed again
+        entry.lastModified = lastModified;
+
+        QDirIterator it(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
+        while (it.hasNext())
+        {
+            if (cancelFlag)
+                return 0;
+
+            it.next();
+            QFileInfo info = it.fileInfo();
+            if (info.isDir())
+            {
+                // Junctions and symlinks point back into other trees
+                if (!info.isSymLink())
+                    entry.subdirectories.append(info.fileName());
+            }
+            else
+            {
+                entry.fileBytes += info.size();
+            }
+        }
+
+        store(path, entry);
+    }
+
+    qint64 total = entry.fileBytes;
+    for (const QString &name : entry.subdirectories)
+    {
+        if (cancelFlag)
+            break;
+
+        QString childPath = path + "/" + name;
+        QFileInfo childInfo(childPath);
+        if (childInfo.isDir())
+            total += measure(childPath, childInfo.lastModified().toMSecsSinceEpoch(), cancelFlag);
+    }
+
+    return total;
+}
+
+bool DirectorySizeCache::lookup(const QString &path, qint64 lastModified, Entry &entry)
+{
+    QWriteLocker locker(&m_lock);
+    auto it = m_entries.find(path);
+    if (it == m_entries.end() || it->lastModified != lastModified)
+        return false;
+
+    it->used = true;
+    entry = *it;
+    return true;
+}
+
+void DirectorySizeCache::store(const QString &path, const Entry &entry)
+{
+    QWriteLocker locker(&m_lock);
+    Entry &stored = m_entries[path];
+    stored = entry;
+    stored.used = true;
+}
+
+bool DirectorySizeCache::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 count = 0;
+    in >> magic >> version >> count;
+
+    if (magic != SizeCacheMagic || version != SizeCacheVersion || count < 0)
+        return false;
+
+    QHash<QString, Entry> entries;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString path;
+        Entry entry;
+        in >> path >> entry.lastModified >> entry.fileBytes >> entry.subdirectories;
+        entries.insert(path, entry);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    QWriteLocker locker(&m_lock);
+    m_entries = entries;
+    return true;
+}
+
+bool DirectorySizeCache::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QReadLocker locker(&m_lock);
+
+    // Directories not visited since loading belong to uninstalled software
+    qint32 count = 0;
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    {
+        if (it->used)
+            count++;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << SizeCacheMagic << SizeCacheVersion << count;
+
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it)
+    {
+        if (it->used)
+            out << it.key() << it->lastModified << it->fileBytes << it->subdirectories;
+    }
+
+    return out.status() == QDataStream::Ok;
+}
+
+QString DirectorySizeCache::defaultFilePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/install_sizes.cache";
+}
@@ -0,0 +1,42 @@
+#ifndef DIRECTORYSIZECACHE_H
+#define DIRECTORYSIZECACHE_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QReadWriteLock>
+#include <QAtomicInteger>
+
+// Exact recursive directory sizes with a per-directory cache. Each entry
+// holds the bytes of the directory's own files and its subdirectory names,
+// keyed by the directory mtime. A repeat walk only stats directories and
+// re-lists the ones that changed. Safe to use from several threads.
+class DirectorySizeCache
+{
+public:
+    DirectorySizeCache();
+
+    qint64 directorySize(const QString &path, const QAtomicInteger<bool> &cancelFlag);
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    static QString defaultFilePath();
+
+private:
+    struct Entry
+    {
+        qint64 lastModified = 0;
+        qint64 fileBytes = 0;
+        QStringList subdirectories;
+        bool used = false;
+    };
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, Entry> m_entries;
+
+    qint64 measure(const QString &path, qint64 lastModified, const QAtomicInteger<bool> &cancelFlag);
+    bool lookup(const QString &path, qint64 lastModified, Entry &entry);
+    void store(const QString &path, const Entry &entry);
+};
+
+#endif // DIRECTORYSIZECACHE_H
@@ -0,0 +1,204 @@
+#include "dpkginventorysource.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
+#include <cstring>
+
+namespace
+{
+    // The few fields the inventory uses; everything else is skipped unread
+    struct Stanza
+    {
+        QByteArray package;
+        QByteArray status;
+        QByteArray architecture;
+        QByteArray version;
+        QByteArray maintainer;
+        QByteArray installedSize;
+        QByteArray essential;
+        QByteArray priority;
+    };
+
+    QByteArray *fieldFor(Stanza &stanza, const char *name, int length)
+    {
+        struct Field
+        {
+            const char *name;
+            int length;
+            QByteArray Stanza::*member;
+        };
+        static const Field fields[] = {
+            {"Package", 7, &Stanza::package},
+            {"Status", 6, &Stanza::status},
+            {"Architecture", 12, &Stanza::architecture},
+            {"Version", 7, &Stanza::version},
+            {"Maintainer", 10, &Stanza::maintainer},
+            {"Installed-Size", 14, &Stanza::installedSize},
+            {"Essential", 9, &Stanza::essential},
+            {"Priority", 8, &Stanza::priority}};
+
+        for (const Field &field : fields)
+        {
+            if (field.length == length && std::memcmp(field.name, name, size_t(length)) == 0)
+                return &(stanza.*field.member);
+        }
+        return nullptr;
+    }
+
+    // FNV-1a over the raw stanza: changes whenever anything dpkg records for the package does
+    qint64 stanzaStamp(const char *begin, const char *end)
+    {
+        quint64 hash = 14695981039346656037ULL;
+        for (const char *p = begin; p < end; ++p)
+        {
+            hash ^= uchar(*p);
+            hash *= 1099511628211ULL;
+        }
+        return qint64(hash);
+    }
+
+    void addPackage(const Stanza &stanza, qint64 stamp, const QString &removeCommand, QList<InventoryRecord> &records)
+    {
+        // Removed packages keep a stanza ("deinstall ok config-files") until purged
+        if (!stanza.status.endsWith(" installed") || stanza.package.isEmpty())
+            return;
+
+        QString package = QString::fromUtf8(stanza.package);
+
+        InventoryRecord record;
+        record.key = stanza.architecture.isEmpty() ? package : package + ":" + QString::fromLatin1(stanza.architecture);
+        record.lastWriteTime = stamp;
+
+        record.values.insert("DisplayName", package);
+        record.values.insert("DisplayVersion", QString::fromUtf8(stanza.version));
+        record.values.insert("Publisher", QString::fromUtf8(stanza.maintainer));
+        // Installed-Size is in KiB, the unit of EstimatedSize
+        record.values.insert("EstimatedSize", stanza.installedSize.toLongLong());
+        // Left out without a way to get root; the entry then cannot be uninstalled from here
+        if (!removeCommand.isEmpty())
+            record.values.insert("UninstallString", removeCommand + record.key);
+
+        // Packages the system cannot boot or upgrade without
+        bool essential = stanza.essential == "yes" || stanza.priority == "required" || stanza.priority == "important";
+        record.values.insert("SystemComponent", essential ? 1 : 0);
+
+        records.append(record);
+    }
+}
+
+DpkgInventorySource::DpkgInventorySource(const QString &statusPath)
+    : m_statusPath(statusPath)
+{
+}
+
+QString DpkgInventorySource::id() const
+{
+    return "dpkg:" + m_statusPath;
+}
+
+bool DpkgInventorySource::listEntries(QList<QPair<QString, qint64>> &entries) const
+{
+    if (!QFileInfo(m_statusPath).isFile())
+        return false;
+
+    for (const InventoryRecord &record : parseStatus())
+    {
+        entries.append(qMakePair(record.key, record.lastWriteTime));
+    }
+    return true;
+}
+
+QList<InventoryRecord> DpkgInventorySource::readEntries(const QStringList &keys) const
+{
+    QList<InventoryRecord> records = parseStatus();
+    if (keys.isEmpty())
+        return records;
+
+    QSet<QString> wanted(keys.begin(), keys.end());
+    QList<InventoryRecord> selected;
+    for (const InventoryRecord &record : records)
+    {
+        if (wanted.contains(record.key))
+            selected.append(record);
+    }
+    return selected;
+}
+
+QString DpkgInventorySource::defaultStatusPath()
+{
+    return "/var/lib/dpkg/status";
+}
+
+bool DpkgInventorySource::isAvailable()
+{
+    return QFileInfo(defaultStatusPath()).isFile();
+}
+
+QList<InventoryRecord> DpkgInventorySource::parseStatus() const
+{
+    QList<InventoryRecord> records;
+
+    QFile file(m_statusPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return records;
+
+    // pkexec asks for authorization itself; -y because there is no terminal to answer on
+    QString removeCommand;
+    if (!QStandardPaths::findExecutable("pkexec").isEmpty())
+        removeCommand = "pkexec /usr/bin/apt-get remove -y ";
+
+    // The file is scanned in place; only the wanted field values are copied
+    QByteArray buffer;
+    qint64 size = file.size();
+    const char *data = reinterpret_cast<const char *>(file.map(0, size));
+    if (!data)
+    {
+        buffer = file.readAll();
+        data = buffer.constData();
+        size = buffer.size();
+    }
+
+    Stanza stanza;
+    const char *stanzaStart = data;
+    const char *position = data;
+    const char *end = data + size;
+    while (position < end)
+    {
+        const char *lineEnd = static_cast<const char *>(std::memchr(position, '\n', size_t(end - position)));
+        if (!lineEnd)
+            lineEnd = end;
+        const char *next = lineEnd < end ? lineEnd + 1 : end;
+        if (lineEnd > position && lineEnd[-1] == '\r')
+            --lineEnd;
+
+        // A blank line ends the package stanza
+        if (lineEnd == position)
+        {
+            addPackage(stanza, stanzaStamp(stanzaStart, position), removeCommand, records);
+            stanza = Stanza();
+            position = next;
+            stanzaStart = next;
+            continue;
+        }
+
+        // Continuation lines belong to multi-line fields such as Description
+        if (*position == ' ' || *position == '\t')
+        {
+            position = next;
+            continue;
+        }
+
+        const char *colon = static_cast<const char *>(std::memchr(position, ':', size_t(lineEnd - position)));
+        if (colon && colon > position)
+        {
+            QByteArray *field = fieldFor(stanza, position, int(colon - position));
+            if (field)
+                *field = QByteArray(colon + 1, int(lineEnd - colon - 1)).trimmed();
+        }
+        position = next;
+    }
+
+    addPackage(stanza, stanzaStamp(stanzaStart, end), removeCommand, records);
+    return records;
+}
@@ -0,0 +1,27 @@
+#ifndef DPKGINVENTORYSOURCE_H
+#define DPKGINVENTORYSOURCE_H
+
+#include "inventorysource.h"
+
+// Installed Debian packages, read from the dpkg status database. Package
+// fields are mapped onto the registry value names the scan understands
+// (Package -> DisplayName, Installed-Size -> EstimatedSize in KB, ...).
+class DpkgInventorySource : public InventorySource
+{
+public:
+    explicit DpkgInventorySource(const QString &statusPath = defaultStatusPath());
+
+    QString id() const override;
+    bool listEntries(QList<QPair<QString, qint64>> &entries) const override;
+    QList<InventoryRecord> readEntries(const QStringList &keys) const override;
+
+    static QString defaultStatusPath();
+    static bool isAvailable();
+
+private:
+    QString m_statusPath;
+
+    QList<InventoryRecord> parseStatus() const;
+};
+
+#endif // DPKGINVENTORYSOURCE_H
@@ -0,0 +1,170 @@
+#include "fileindex.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+FileIndex::FileIndex()
+{
+}
+
+void FileIndex::build(const QStringList &roots, int maxDepth, const QAtomicInteger<bool> &cancelFlag)
+{
+    clear();
+
+    for (const QString &root : roots)
+    {
+        QFileInfo rootInfo(root);
+        if (!rootInfo.isDir())
+            continue;
+
+        IndexedDirectory entry;
+        entry.path = QDir::cleanPath(rootInfo.absoluteFilePath());
+        entry.name = rootInfo.fileName();
+        m_directories.append(entry);
+    }
+
+    // Breadth first: the list itself is the work queue
+    for (int id = 0; id < m_directories.size(); ++id)
+    {
+        if (cancelFlag)
+        {
+            clear();
+            return;
+        }
+
+        if (m_directories[id].depth >= maxDepth)
+            continue;
+
+        // Junctions such as "Application Data" loop back into their parent
+        QDirIterator it(m_directories[id].path, QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::NoSymLinks);
+        while (it.hasNext())
+        {
+            it.next();
+
+            IndexedDirectory child;
+            child.path = it.filePath();
+            child.name = it.fileName();
+            child.parent = id;
+            child.depth = m_directories[id].depth + 1;
+
+            int childId = m_directories.size();
+            m_directories.append(child);
+            m_children[id].append(childId);
+
+            m_byCompactName[compact(child.name)].append(childId);
+            for (const QString &token : tokens(child.name))
+            {
+                m_byToken[token].append(childId);
+            }
+        }
+    }
+
+    m_builtAt = QDateTime::currentDateTime();
+}
+
+void FileIndex::clear()
+{
+    m_directories.clear();
+    m_children.clear();
+    m_byCompactName.clear();
+    m_byToken.clear();
+    m_builtAt = QDateTime();
+}
+
+bool FileIndex::isEmpty() const
+{
+    return m_directories.isEmpty();
+}
+
+QDateTime FileIndex::builtAt() const
+{
+    return m_builtAt;
+}
+
+int FileIndex::count() const
+{
+    return m_directories.size();
+}
+
+const IndexedDirectory &FileIndex::directory(int id) const
+{
+    return m_directories[id];
+}
+
+QVector<int> FileIndex::children(int id) const
+{
+    return m_children.value(id);
+}
+
+QVector<int> FileIndex::findByCompactName(const QString &compactName) const
+{
+    return m_byCompactName.value(compactName);
+}
+
+QVector<int> FileIndex::findByToken(const QString &token) const
+{
+    return m_byToken.value(token);
+}
+
+QStringList FileIndex::defaultRoots()
+{
+    QStringList roots;
+
+#ifdef Q_OS_WIN
+    const char *variables[] = {"ProgramFiles", "ProgramFiles(x86)", "ProgramW6432", "ProgramData", "APPDATA", "LOCALAPPDATA"};
+    for (const char *variable : variables)
+    {
+        QString path = QDir::fromNativeSeparators(qEnvironmentVariable(variable));
+        if (!path.isEmpty())
+            roots.append(path);
+    }
+
+    QString localAppData = QDir::fromNativeSeparators(qEnvironmentVariable("LOCALAPPDATA"));
+    if (!localAppData.isEmpty())
+        roots.append(QDir::cleanPath(localAppData + "/../LocalLow"));
+#else
+    // /etc and /var/lib are left out: what is there belongs to packages, and
+    // the package manager removes or keeps it on purge
+    QString home = QDir::homePath();
+    roots << home + "/.config" << home + "/.local/share" << home + "/.cache" << "/opt";
+#endif
+
+    roots.removeDuplicates();
+    return roots;
+}
+
+QString FileIndex::compact(const QString &text)
+{
+    QString result;
+    result.reserve(text.size());
+    for (QChar c : text)
+    {
+        if (c.isLetterOrNumber())
+            result.append(c.toCaseFolded());
+    }
+    return result;
+}
+
+QStringList FileIndex::tokens(const QString &text)
+{
+    QStringList result;
+    QString current;
+    for (QChar c : text)
+    {
+        if (c.isLetterOrNumber())
+        {
+            current.append(c.toCaseFolded());
+        }
+        else if (!current.isEmpty())
+        {
+            result.append(current);
+            current.clear();
+        }
+    }
+    if (!current.isEmpty())
+        result.append(current);
+
+    result.removeDuplicates();
+    return result;
+}
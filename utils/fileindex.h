@@ -0,0 +1,56 @@
+#ifndef FILEINDEX_H
+#define FILEINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+#include <QAtomicInteger>
+
+struct IndexedDirectory
+{
+    QString path;
+    QString name;
+    int parent = -1; // -1 for roots
+    int depth = 0;   // 0 for roots
+};
+
+// Directory names under the places applications keep their files (Program
+// Files, ProgramData, AppData; /opt and the XDG directories on Linux), a
+// few levels deep. Lookups by folded name or name token answer "which
+// folders could belong to X" without walking the volume. Build on a worker
+// thread; lookups are read-only.
+class FileIndex
+{
+public:
+    FileIndex();
+
+    void build(const QStringList &roots, int maxDepth, const QAtomicInteger<bool> &cancelFlag);
+    void clear();
+    bool isEmpty() const;
+    QDateTime builtAt() const;
+
+    int count() const;
+    const IndexedDirectory &directory(int id) const;
+    QVector<int> children(int id) const;
+
+    // Directories whose compacted name ("Notepad++" -> "notepad") equals the key
+    QVector<int> findByCompactName(const QString &compactName) const;
+    // Directories whose name contains the token as a separate word
+    QVector<int> findByToken(const QString &token) const;
+
+    static QStringList defaultRoots();
+    // Case-folded letters and digits only
+    static QString compact(const QString &text);
+    static QStringList tokens(const QString &text);
+
+private:
+    QVector<IndexedDirectory> m_directories;
+    QHash<int, QVector<int>> m_children;
+    QHash<QString, QVector<int>> m_byCompactName;
+    QHash<QString, QVector<int>> m_byToken;
+    QDateTime m_builtAt;
+};
+
+#endif // FILEINDEX_H
@@ -0,0 +1,200 @@
+#include "fuzzysearchindex.h"
+#include <algorithm>
+
+namespace
+{
+    // Misses allowed between the query's trigrams and a document's. A single
+    // typo in the middle of a word costs up to three trigrams.
+    const int MaxMisses = 3;
+
+    int allowedMisses(int queryTrigrams)
+    {
+        return qMin(MaxMisses, queryTrigrams / 2);
+    }
+
+    quint64 trigramCode(QChar a, QChar b, QChar c)
+    {
+        return (quint64(a.unicode()) << 32) | (quint64(b.unicode()) << 16) | quint64(c.unicode());
+    }
+}
+
+FuzzySearchIndex::FuzzySearchIndex()
+    : m_lastPoolAll(true)
+{
+}
+
+void FuzzySearchIndex::clear()
+{
+    m_documents.clear();
+    m_postings.clear();
+    m_hitCounts.clear();
+    m_lastQuery.clear();
+    m_lastPool.clear();
+    m_lastPoolAll = true;
+}
+
+int FuzzySearchIndex::addDocument(const QStringList &fields)
+{
+    Document document;
+    for (const QString &field : fields)
+    {
+        QString folded = normalize(field);
+        document.fields.append(folded);
+
+        // Padding marks word boundaries so prefixes score higher
+        collectTrigrams(" " + folded + " ", document.trigrams);
+    }
+
+    std::sort(document.trigrams.begin(), document.trigrams.end());
+    document.trigrams.erase(std::unique(document.trigrams.begin(), document.trigrams.end()), document.trigrams.end());
+
+    int id = m_documents.size();
+    for (quint64 trigram : document.trigrams)
+    {
+        m_postings[trigram].append(id);
+    }
+    m_documents.append(document);
+
+    // The candidate pool no longer covers every document
+    m_lastQuery.clear();
+    m_lastPool.clear();
+    m_lastPoolAll = true;
+
+    return id;
+}
+
+int FuzzySearchIndex::documentCount() const
+{
+    return m_documents.size();
+}
+
+QVector<int> FuzzySearchIndex::search(const QString &query)
+{
+    QString text = normalize(query);
+    if (text.isEmpty())
+    {
+        m_lastQuery.clear();
+        m_lastPool.clear();
+        m_lastPoolAll = true;
+
+        QVector<int> all(m_documents.size());
+        for (int i = 0; i < all.size(); ++i)
+        {
+            all[i] = i;
+        }
+        return all;
+    }
+
+    // Typing more characters only adds query trigrams, so anything outside
+    // the previous pool is already missing more than MaxMisses of them
+    bool narrow = !m_lastQuery.isEmpty() && text.startsWith(m_lastQuery) && !m_lastPoolAll;
+
+    // No trailing pad: the last word of the query may still be incomplete
+    QVector<quint64> queryTrigrams;
+    collectTrigrams(" " + text, queryTrigrams);
+    std::sort(queryTrigrams.begin(), queryTrigrams.end());
+    queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+    int trigramCount = queryTrigrams.size();
+    int matchHits = trigramCount - allowedMisses(trigramCount);
+    int poolHits = trigramCount - MaxMisses;
+
+    if (!narrow)
+    {
+        // Count hits through the postings once for the whole collection
+        m_hitCounts.fill(0, m_documents.size());
+        for (quint64 trigram : queryTrigrams)
+        {
+            auto postings = m_postings.constFind(trigram);
+            if (postings == m_postings.constEnd())
+                continue;
+            for (int id : postings.value())
+            {
+                if (m_hitCounts[id] < 255)
+                    m_hitCounts[id]++;
+            }
+        }
+    }
+
+    struct Match
+    {
+        int id;
+        double score;
+    };
+    QVector<Match> matches;
+    QVector<int> pool;
+    bool poolAll = poolHits <= 0;
+
+    int candidateCount = narrow ? m_lastPool.size() : m_documents.size();
+    for (int i = 0; i < candidateCount; ++i)
+    {
+        int id = narrow ? m_lastPool[i] : i;
+        const Document &document = m_documents[id];
+
+        int hits = narrow ? countHits(document.trigrams, queryTrigrams) : m_hitCounts[id];
+        double bonus = substringBonus(document, text);
+
+        if (!poolAll && (hits >= poolHits || bonus > 0))
+            pool.append(id);
+
+        if ((trigramCount > 0 && hits >= matchHits) || bonus > 0)
+        {
+            double overlap = trigramCount > 0 ? double(hits) / trigramCount : 0.0;
+            matches.append(Match{id, overlap + bonus});
+        }
+    }
+
+    m_lastQuery = text;
+    m_lastPool = pool;
+    m_lastPoolAll = poolAll;
+
+    std::stable_sort(matches.begin(), matches.end(), [](const Match &a, const Match &b)
+                     { return a.score > b.score; });
+
+    QVector<int> ids;
+    ids.reserve(matches.size());
+    for (const Match &match : matches)
+    {
+        ids.append(match.id);
+    }
+    return ids;
+}
+
+QString FuzzySearchIndex::normalize(const QString &text)
+{
+    return text.toCaseFolded().simplified();
+}
+
+void FuzzySearchIndex::collectTrigrams(const QString &text, QVector<quint64> &trigrams)
+{
+    for (int i = 0; i + 2 < text.size(); ++i)
+    {
+        trigrams.append(trigramCode(text[i], text[i + 1], text[i + 2]));
+    }
+}
+
+int FuzzySearchIndex::countHits(const QVector<quint64> &documentTrigrams, const QVector<quint64> &queryTrigrams)
+{
+    int hits = 0;
+    for (quint64 trigram : queryTrigrams)
+    {
+        if (std::binary_search(documentTrigrams.begin(), documentTrigrams.end(), trigram))
+            hits++;
+    }
+    return hits;
+}
+
+double FuzzySearchIndex::substringBonus(const Document &document, const QString &query)
+{
+    // Earlier fields weigh more: name over publisher over version
+    double weight = 1.0;
+    for (const QString &field : document.fields)
+    {
+        if (field.startsWith(query))
+            return 2.0 * weight;
+        if (field.contains(query))
+            return 1.0 * weight;
+        weight /= 2;
+    }
+    return 0.0;
+}
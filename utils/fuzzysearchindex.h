@@ -0,0 +1,51 @@
+#ifndef FUZZYSEARCHINDEX_H
+#define FUZZYSEARCHINDEX_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+// Trigram index over a few text fields per document (name, publisher,
+// version, ...) for search-as-you-type. A document matches when it contains
+// the query or shares all but a few of its trigrams, which tolerates one
+// typo. Results are ranked by trigram overlap plus a bonus for prefix and
+// substring hits, weighted by field order. When the query extends the
+// previous one, only the previous candidate pool is examined again.
+class FuzzySearchIndex
+{
+public:
+    FuzzySearchIndex();
+
+    void clear();
+
+    // Fields in decreasing weight; returns the document id
+    int addDocument(const QStringList &fields);
+    int documentCount() const;
+
+    // Ranked document ids; every id in insertion order for an empty query
+    QVector<int> search(const QString &query);
+
+private:
+    struct Document
+    {
+        QStringList fields;         // case-folded
+        QVector<quint64> trigrams;  // sorted, unique
+    };
+
+    QVector<Document> m_documents;
+    QHash<quint64, QVector<int>> m_postings;
+
+    QString m_lastQuery;
+    QVector<int> m_lastPool; // documents that can still match an extension of m_lastQuery
+    bool m_lastPoolAll;
+
+    QVector<quint8> m_hitCounts; // scratch, one per document
+
+    static QString normalize(const QString &text);
+    static void collectTrigrams(const QString &text, QVector<quint64> &trigrams);
+    static int countHits(const QVector<quint64> &documentTrigrams, const QVector<quint64> &queryTrigrams);
+    static double substringBonus(const Document &document, const QString &query);
+};
+
+#endif // FUZZYSEARCHINDEX_H
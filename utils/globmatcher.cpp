@@ -0,0 +1,158 @@
+#include "globmatcher.h"
+
+GlobMatcher::GlobMatcher(const QStringList &patterns, Qt::CaseSensitivity sensitivity)
+    : m_sensitivity(sensitivity), m_empty(true), m_matchAll(false)
+{
+    for (const QString &rawPattern : patterns)
+    {
+        if (rawPattern.isEmpty())
+            continue;
+
+        m_empty = false;
+        QString pattern = fold(rawPattern);
+
+        // Character sets are rare enough to leave to QRegularExpression
+        if (pattern.contains('['))
+        {
+            QRegularExpression::PatternOptions options = QRegularExpression::NoPatternOption;
+            if (m_sensitivity == Qt::CaseInsensitive)
+                options |= QRegularExpression::CaseInsensitiveOption;
+            m_classPatterns.append(QRegularExpression(
+                QRegularExpression::anchoredPattern(QRegularExpression::wildcardToRegularExpression(rawPattern)), options));
+            continue;
+        }
+
+        int stars = pattern.count('*');
+        bool hasQuestion = pattern.contains('?');
+
+        if (stars == pattern.size())
+        {
+            m_matchAll = true;
+        }
+        else if (stars == 0 && !hasQuestion)
+        {
+            m_exact.insert(pattern);
+        }
+        else if (stars == 1 && !hasQuestion && pattern.startsWith('*'))
+        {
+            QString suffix = pattern.mid(1);
+            m_suffixes.insert(suffix);
+            addLength(m_suffixLengths, suffix.size());
+        }
+        else if (stars == 1 && !hasQuestion && pattern.endsWith('*'))
+        {
+            QString prefix = pattern.left(pattern.size() - 1);
+            m_prefixes.insert(prefix);
+            addLength(m_prefixLengths, prefix.size());
+        }
+        else
+        {
+            Glob glob;
+            glob.pattern = pattern;
+            glob.minLength = pattern.size() - stars;
+
+            int lastWildcard = qMax(pattern.lastIndexOf('*'), pattern.lastIndexOf('?'));
+            glob.literalTail = pattern.mid(lastWildcard + 1);
+            m_globs.append(glob);
+        }
+    }
+}
+
+bool GlobMatcher::isEmpty() const
+{
+    return m_empty;
+}
+
+bool GlobMatcher::matchesEverything() const
+{
+    return m_matchAll;
+}
+
+bool GlobMatcher::matches(const QString &fileName) const
+{
+    if (m_matchAll)
+        return true;
+
+    QString name = fold(fileName);
+
+    if (m_exact.contains(name))
+        return true;
+
+    for (int length : m_suffixLengths)
+    {
+        if (length <= name.size() && m_suffixes.contains(name.right(length)))
+            return true;
+    }
+
+    for (int length : m_prefixLengths)
+    {
+        if (length <= name.size() && m_prefixes.contains(name.left(length)))
+            return true;
+    }
+
+    for (const Glob &glob : m_globs)
+    {
+        if (name.size() < glob.minLength || !name.endsWith(glob.literalTail))
+            continue;
+        if (matchGlob(glob.pattern, name))
+            return true;
+    }
+
+    for (const QRegularExpression &expression : m_classPatterns)
+    {
+        if (expression.match(fileName).hasMatch())
+            return true;
+    }
+
+    return false;
+}
+
+QString GlobMatcher::fold(const QString &text) const
+{
+    return m_sensitivity == Qt::CaseInsensitive ? text.toCaseFolded() : text;
+}
+
+void GlobMatcher::addLength(QVector<int> &lengths, int length)
+{
+    if (!lengths.contains(length))
+        lengths.append(length);
+}
+
+bool GlobMatcher::matchGlob(const QString &pattern, const QString &text)
+{
+    // Greedy match that only backtracks to the most recent '*', which keeps
+    // it linear for the patterns used by the cleaner categories
+    int p = 0;
+    int t = 0;
+    int starPattern = -1;
+    int starText = 0;
+
+    while (t < text.size())
+    {
+        if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == text[t]))
+        {
+            ++p;
+            ++t;
+        }
+        else if (p < pattern.size() && pattern[p] == '*')
+        {
+            starPattern = p++;
+            starText = t;
+        }
+        else if (starPattern >= 0)
+        {
+            p = starPattern + 1;
+            t = ++starText;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (p < pattern.size() && pattern[p] == '*')
+    {
+        ++p;
+    }
+    return p == pattern.size();
+}
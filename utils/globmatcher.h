@@ -0,0 +1,50 @@
+#ifndef GLOBMATCHER_H
+#define GLOBMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QSet>
+#include <QVector>
+#include <QRegularExpression>
+
+// Matches file names against a set of wildcard patterns ("*.log",
+// "thumbcache_*.db") compiled once up front. Plain extension and prefix
+// patterns become hash lookups; the rest are matched with a small
+// backtracking '*'/'?' matcher, so a name is tested against every
+// pattern in a single call instead of one directory listing per pattern.
+class GlobMatcher
+{
+public:
+    explicit GlobMatcher(const QStringList &patterns = QStringList(),
+                         Qt::CaseSensitivity sensitivity = Qt::CaseInsensitive);
+
+    bool isEmpty() const;
+    bool matchesEverything() const;
+    bool matches(const QString &fileName) const;
+
+private:
+    struct Glob
+    {
+        QString pattern;
+        QString literalTail; // text after the last wildcard, for a cheap reject
+        int minLength = 0;   // characters a name needs at the very least
+    };
+
+    Qt::CaseSensitivity m_sensitivity;
+    bool m_empty;
+    bool m_matchAll;
+
+    QSet<QString> m_exact;
+    QSet<QString> m_suffixes;
+    QVector<int> m_suffixLengths;
+    QSet<QString> m_prefixes;
+    QVector<int> m_prefixLengths;
+    QVector<Glob> m_globs;
+    QVector<QRegularExpression> m_classPatterns; // patterns with [...] sets
+
+    QString fold(const QString &text) const;
+    static void addLength(QVector<int> &lengths, int length);
+    static bool matchGlob(const QString &pattern, const QString &text);
+};
+
+#endif // GLOBMATCHER_H
@@ -0,0 +1,59 @@
+#include "hivestartupsource.h"
+#include "registryhive.h"
+#include <QVariantMap>
+#include <QDebug>
+
+HiveStartupSource::HiveStartupSource(const QString &hivePath, const QString &keyPath)
+    : m_hivePath(hivePath), m_keyPath(keyPath)
+{
+}
+
+QString HiveStartupSource::id() const
+{
+    return "hive:" + m_hivePath + "|" + m_keyPath;
+}
+
+QList<StartupProgram> HiveStartupSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+    RegistryHive hive;
+    if (!hive.open(m_hivePath))
+    {
+        qDebug() << "Cannot read hive" << m_hivePath << ":" << hive.errorString();
+        return programs;
+    }
+
+    // Both keys are read straight from their value lists in the mapped file
+    const QString paths[] = {m_keyPath, m_keyPath + "Disabled"};
+    for (const QString &path : paths)
+    {
+        bool enabled = path == m_keyPath;
+        QVariantMap values = hive.values(hive.findKey(path));
+        for (auto it = values.constBegin(); it != values.constEnd(); ++it)
+        {
+            QString command = it.value().toString();
+            if (it.key().isEmpty() || (enabled && command.isEmpty()))
+                continue;
+
+            StartupProgram program;
+            program.name = it.key();
+            program.status = enabled ? "Enabled" : "Disabled";
+            program.startupType = "Registry";
+            program.command = command;
+            program.location = m_hivePath + "\\" + m_keyPath + (enabled ? "" : " (Disabled)");
+            program.isEnabled = enabled;
+            program.source = id();
+            programs.append(program);
+        }
+    }
+
+    return programs;
+}
+
+bool HiveStartupSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    Q_UNUSED(enable);
+    error = QString("'%1' comes from an offline registry hive, which is opened read-only.").arg(program.name);
+    return false;
+}
@@ -0,0 +1,23 @@
+#ifndef HIVESTARTUPSOURCE_H
+#define HIVESTARTUPSOURCE_H
+
+#include "startupsource.h"
+
+// A Run key inside an offline registry hive file (the SOFTWARE or
+// NTUSER.DAT of a mounted image), read through RegistryHive. Read-only.
+class HiveStartupSource : public StartupSource
+{
+public:
+    // keyPath is relative to the hive root, e.g. "Microsoft\Windows\CurrentVersion\Run"
+    HiveStartupSource(const QString &hivePath, const QString &keyPath);
+
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+
+private:
+    QString m_hivePath;
+    QString m_keyPath;
+};
+
+#endif // HIVESTARTUPSOURCE_H
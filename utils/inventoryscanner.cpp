@@ -0,0 +1,143 @@
+#include "inventoryscanner.h"
+#include <QVector>
+#include <QtConcurrent/QtConcurrent>
+
+SoftwareInventory InventoryScanner::scan(const QList<InventorySource *> &sources, const SoftwareInventory &previous,
+                                         const QAtomicInteger<bool> &cancel)
+{
+    SoftwareInventory inventory;
+    if (cancel)
+        return inventory;
+
+    QVector<QList<InstalledSoftware>> results(sources.size());
+    QVector<quint64> fingerprints(sources.size(), 0);
+    QVector<QFuture<void>> futures;
+
+    for (int i = 0; i < sources.size(); ++i)
+    {
+        if (cancel)
+            break;
+
+        futures.append(QtConcurrent::run([&sources, i, &previous, &cancel, &results, &fingerprints]()
+                                         { scanSource(sources[i], previous, cancel, results[i], fingerprints[i]); }));
+    }
+
+    // Scans stop early once cancelled and still write into the local result lists until then
+    for (auto &future : futures)
+    {
+        future.waitForFinished();
+    }
+
+    QList<InstalledSoftware> softwareList;
+    for (const auto &result : results)
+    {
+        softwareList.append(result);
+    }
+
+    inventory.setSoftware(softwareList);
+    for (int i = 0; i < sources.size(); ++i)
+    {
+        inventory.setSourceFingerprint(sources[i]->id(), fingerprints[i]);
+    }
+    inventory.setCreatedAt(QDateTime::currentDateTime());
+
+    return inventory;
+}
+
+void InventoryScanner::scanSource(const InventorySource *source, const SoftwareInventory &previous,
+                                  const QAtomicInteger<bool> &cancel, QList<InstalledSoftware> &softwareList,
+                                  quint64 &fingerprint)
+{
+    QString sourceId = source->id();
+    QList<QPair<QString, qint64>> entries;
+    QList<InventoryRecord> records;
+
+    if (source->listEntries(entries))
+    {
+        fingerprint = SoftwareInventory::computeFingerprint(entries);
+
+        // Nothing in this source changed since the last scan
+        if (previous.hasSource(sourceId) && previous.sourceFingerprint(sourceId) == fingerprint)
+        {
+            softwareList = previous.entriesForSource(sourceId).values();
+            return;
+        }
+
+        // Only entries written since the last scan are read again, in one batch
+        QHash<QString, InstalledSoftware> cached = previous.entriesForSource(sourceId);
+        QStringList changedKeys;
+        for (const QPair<QString, qint64> &entry : entries)
+        {
+            auto cachedEntry = cached.constFind(entry.first);
+            if (cachedEntry != cached.constEnd() && cachedEntry->lastWriteTime == entry.second)
+                softwareList.append(*cachedEntry);
+            else
+                changedKeys.append(entry.first);
+        }
+
+        if (changedKeys.isEmpty() || cancel)
+            return;
+        records = source->readEntries(changedKeys);
+    }
+    else
+    {
+        // Sources that cannot list cheaply are read in full every time
+        fingerprint = 0;
+        records = source->readEntries(QStringList());
+    }
+
+    for (const InventoryRecord &record : records)
+    {
+        if (cancel)
+            break;
+
+        InstalledSoftware software;
+        if (softwareFromRecord(record, software))
+        {
+            software.source = sourceId;
+            softwareList.append(software);
+        }
+    }
+}
+
+bool InventoryScanner::softwareFromRecord(const InventoryRecord &record, InstalledSoftware &software)
+{
+    software.guid = record.key;
+    software.lastWriteTime = record.lastWriteTime;
+    software.name = record.value("DisplayName").toString();
+
+    // Skip if no display name
+    if (software.name.isEmpty())
+        return false;
+
+    software.version = record.value("DisplayVersion").toString();
+    software.publisher = record.value("Publisher").toString();
+    software.uninstallString = record.value("UninstallString").toString();
+    software.quietUninstallString = record.value("QuietUninstallString").toString();
+
+    QString installDate = record.value("InstallDate").toString();
+    if (!installDate.isEmpty() && installDate.length() == 8)
+    {
+        software.installDate = QString("%1-%2-%3")
+                                   .arg(installDate.left(4))
+                                   .arg(installDate.mid(4, 2))
+                                   .arg(installDate.mid(6, 2));
+    }
+    else
+    {
+        software.installDate = "Unknown";
+    }
+
+    // Registry estimate; the software manager replaces it with the exact
+    // size of the install directory for non-system software
+    QVariant sizeVar = record.value("EstimatedSize");
+    software.size = sizeVar.isValid() ? sizeVar.toLongLong() * 1024 : 0;
+    software.installLocation = record.value("InstallLocation").toString();
+
+    software.isSystemComponent = record.value("SystemComponent").toBool() ||
+                                 software.publisher.contains("Microsoft", Qt::CaseInsensitive) ||
+                                 software.name.contains("Update", Qt::CaseInsensitive);
+
+    // Only add if it has uninstall capability
+    return !software.uninstallString.isEmpty() || !software.quietUninstallString.isEmpty();
+}
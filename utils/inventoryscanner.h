@@ -0,0 +1,28 @@
+#ifndef INVENTORYSCANNER_H
+#define INVENTORYSCANNER_H
+
+#include <QList>
+#include <QAtomicInteger>
+#include "softwareinventory.h"
+#include "inventorysource.h"
+
+// Turns the entries of inventory sources into the installed software list.
+// Sources are scanned in parallel; a source whose listing is unchanged since
+// the previous inventory is taken over as is, otherwise only its changed
+// entries are read again. Install sizes are left as the sources report them.
+class InventoryScanner
+{
+public:
+    static SoftwareInventory scan(const QList<InventorySource *> &sources, const SoftwareInventory &previous,
+                                  const QAtomicInteger<bool> &cancel);
+
+    // False for entries without a display name or any uninstall command
+    static bool softwareFromRecord(const InventoryRecord &record, InstalledSoftware &software);
+
+private:
+    static void scanSource(const InventorySource *source, const SoftwareInventory &previous,
+                           const QAtomicInteger<bool> &cancel, QList<InstalledSoftware> &softwareList,
+                           quint64 &fingerprint);
+};
+
+#endif // INVENTORYSCANNER_H
@@ -0,0 +1,19 @@
+#include "inventorysource.h"
+
+QVariant InventoryRecord::value(const QString &name) const
+{
+    auto it = values.constFind(name);
+    if (it != values.constEnd())
+        return it.value();
+
+    for (auto entry = values.constBegin(); entry != values.constEnd(); ++entry)
+    {
+        if (entry.key().compare(name, Qt::CaseInsensitive) == 0)
+            return entry.value();
+    }
+    return QVariant();
+}
+
+InventorySource::~InventorySource()
+{
+}
@@ -0,0 +1,39 @@
+#ifndef INVENTORYSOURCE_H
+#define INVENTORYSOURCE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QPair>
+#include <QVariantMap>
+
+// All values of one uninstall entry, named like the registry values of an
+// Uninstall subkey (DisplayName, DisplayVersion, EstimatedSize, ...)
+struct InventoryRecord
+{
+    QString key;              // subkey name, unique within its source
+    qint64 lastWriteTime = 0; // changes whenever the entry changes
+    QVariantMap values;
+
+    // Value names are case-insensitive, as in the registry
+    QVariant value(const QString &name) const;
+};
+
+// A place installed software is listed in. Listing is meant to be cheap
+// (names and change stamps only); values are read in bulk for the entries
+// that changed. Implementations must allow concurrent const calls.
+class InventorySource
+{
+public:
+    virtual ~InventorySource();
+
+    // Stable name; also the key of the source's fingerprint in the saved inventory
+    virtual QString id() const = 0;
+
+    virtual bool listEntries(QList<QPair<QString, qint64>> &entries) const = 0;
+
+    // Reads every value of the given entries in one pass; all entries if keys is empty
+    virtual QList<InventoryRecord> readEntries(const QStringList &keys) const = 0;
+};
+
+#endif // INVENTORYSOURCE_H
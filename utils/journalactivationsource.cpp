@@ -0,0 +1,126 @@
+#include "journalactivationsource.h"
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QProcess>
+#include <QStringList>
+
+namespace
+{
+    // SD_MESSAGE_UNIT_STARTING and SD_MESSAGE_UNIT_STARTED from sd-messages.h
+    const char UnitStartingId[] = "7d4958e842da4a758f6c1cdc7b36dcc5";
+    const char UnitStartedId[] = "39f53479d3a045ac8e11786248231fbf";
+
+    // Only silence this long means journalctl is stuck
+    const int IdleTimeoutMs = 10000;
+}
+
+JournalActivationSource::JournalActivationSource(const QString &recordedPath)
+    : m_recordedPath(recordedPath)
+{
+}
+
+QString JournalActivationSource::id() const
+{
+    return m_recordedPath.isEmpty() ? "journal" : "journal:" + m_recordedPath;
+}
+
+bool JournalActivationSource::read(QHash<QString, UnitActivation> &activations, QString &error) const
+{
+    QString bootId;
+    activations.clear();
+
+    if (!m_recordedPath.isEmpty())
+    {
+        QFile file(m_recordedPath);
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            error = QString("'%1' could not be opened: %2").arg(m_recordedPath, file.errorString());
+            return false;
+        }
+        while (!file.atEnd())
+            parseLine(file.readLine(), bootId, activations);
+    }
+    else
+    {
+#ifdef Q_OS_LINUX
+        // journalctl filters by itself: messages of PID 1 with either catalog id
+        QProcess process;
+        process.start("journalctl", QStringList() << "-b" << "-o" << "json" << "--no-pager" << "_PID=1"
+                                                  << QString("MESSAGE_ID=%1").arg(UnitStartingId)
+                                                  << QString("MESSAGE_ID=%1").arg(UnitStartedId));
+        if (!process.waitForStarted(3000))
+        {
+            error = "journalctl could not be started.";
+            return false;
+        }
+
+        while (process.waitForReadyRead(IdleTimeoutMs))
+        {
+            while (process.canReadLine())
+                parseLine(process.readLine(), bootId, activations);
+        }
+
+        if (process.state() != QProcess::NotRunning)
+        {
+            process.kill();
+            process.waitForFinished(1000);
+        }
+        while (process.canReadLine())
+            parseLine(process.readLine(), bootId, activations);
+        parseLine(process.readAll(), bootId, activations);
+#else
+        error = "The systemd journal is only available on Linux.";
+        return false;
+#endif
+    }
+
+    if (activations.isEmpty())
+    {
+        error = "The journal holds no unit start messages for this boot.";
+        return false;
+    }
+    return true;
+}
+
+void JournalActivationSource::parseLine(const QByteArray &line, QString &bootId, QHash<QString, UnitActivation> &activations)
+{
+    if (!line.contains(UnitStartingId) && !line.contains(UnitStartedId))
+        return;
+
+    QJsonParseError parseError;
+    QJsonObject entry = QJsonDocument::fromJson(line, &parseError).object();
+    if (parseError.error != QJsonParseError::NoError)
+        return;
+
+    // User managers log with USER_UNIT; only the system manager's UNIT is wanted
+    QString unit = entry.value("UNIT").toString();
+    QString messageId = entry.value("MESSAGE_ID").toString();
+    bool ok = false;
+    qint64 timestamp = entry.value("__MONOTONIC_TIMESTAMP").toString().toLongLong(&ok);
+    if (unit.isEmpty() || !ok || (messageId != UnitStartingId && messageId != UnitStartedId))
+        return;
+
+    // Monotonic time starts over with every boot, so only one boot can be kept
+    QString boot = entry.value("_BOOT_ID").toString();
+    if (boot != bootId)
+    {
+        activations.clear();
+        bootId = boot;
+    }
+
+    // A unit restarted later keeps the times of its start during boot
+    UnitActivation &activation = activations[unit];
+    if (messageId == UnitStartingId)
+    {
+        if (activation.activatingUs < 0)
+            activation.activatingUs = timestamp;
+    }
+    else if (activation.activeUs < 0)
+    {
+        activation.activeUs = timestamp;
+        // Targets and most mounts log no "Starting" message
+        if (activation.activatingUs < 0)
+            activation.activatingUs = timestamp;
+    }
+}
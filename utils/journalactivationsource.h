@@ -0,0 +1,29 @@
+#ifndef JOURNALACTIVATIONSOURCE_H
+#define JOURNALACTIVATIONSOURCE_H
+
+#include "bootactivationsource.h"
+#include <QByteArray>
+
+// Unit start times taken from the messages systemd itself logs when a start
+// job begins and when it is done (the "Starting"/"Started" catalog entries),
+// in journalctl's JSON output. Reads the current boot through journalctl, or
+// a file recorded with "journalctl -b -o json"; when a file holds several
+// boots, the last one counts. Reading the system journal may need membership
+// of the systemd-journal group.
+class JournalActivationSource : public BootActivationSource
+{
+public:
+    explicit JournalActivationSource(const QString &recordedPath = QString());
+
+    QString id() const override;
+    bool read(QHash<QString, UnitActivation> &activations, QString &error) const override;
+
+    // One line of JSON output; lines that are not start messages are skipped
+    // before any JSON is parsed
+    static void parseLine(const QByteArray &line, QString &bootId, QHash<QString, UnitActivation> &activations);
+
+private:
+    QString m_recordedPath;
+};
+
+#endif // JOURNALACTIVATIONSOURCE_H
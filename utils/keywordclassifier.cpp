@@ -0,0 +1,144 @@
+#include "keywordclassifier.h"
+#include <QQueue>
+
+namespace
+{
+    const quint32 InName = 1u << KeywordClassifier::Name;
+    const quint32 InCommand = 1u << KeywordClassifier::Command;
+    const quint32 InPublisher = 1u << KeywordClassifier::Publisher;
+
+    // Non-ASCII characters cannot be part of a keyword; some fold into ASCII
+    int foldedCode(QChar c)
+    {
+        ushort code = c.unicode();
+        if (code >= 'A' && code <= 'Z')
+            return code + ('a' - 'A');
+        if (code < 128)
+            return code;
+        code = c.toCaseFolded().unicode();
+        return code < 128 ? code : -1;
+    }
+}
+
+KeywordClassifier::KeywordClassifier(const QVector<Rule> &rules)
+{
+    addState();
+
+    // Trie of the keywords
+    for (const Rule &rule : rules)
+    {
+        int state = 0;
+        for (QChar c : rule.keyword)
+        {
+            int code = foldedCode(c);
+            Q_ASSERT(code >= 0);
+            if (code < 0)
+            {
+                state = -1;
+                break;
+            }
+
+            // Index, not reference: adding a state reallocates the table
+            int index = state * AlphabetSize + code;
+            if (m_next[index] == 0)
+            {
+                int created = addState();
+                m_next[index] = created;
+            }
+            state = m_next[index];
+        }
+        if (state < 0)
+            continue;
+
+        for (int field = 0; field < FieldCount; ++field)
+        {
+            if (rule.fields & (1u << field))
+                m_outputs[state * FieldCount + field] |= rule.categories;
+        }
+    }
+
+    // Breadth first, each state inherits the outputs of its failure state and
+    // missing transitions are taken from it, so matching never backtracks
+    QQueue<QPair<int, int>> queue; // state, failure state
+    for (int code = 0; code < AlphabetSize; ++code)
+    {
+        if (m_next[code] > 0)
+            queue.enqueue(qMakePair(m_next[code], 0));
+    }
+
+    while (!queue.isEmpty())
+    {
+        QPair<int, int> item = queue.dequeue();
+        int state = item.first;
+        int failure = item.second;
+
+        for (int field = 0; field < FieldCount; ++field)
+            m_outputs[state * FieldCount + field] |= m_outputs[failure * FieldCount + field];
+
+        for (int code = 0; code < AlphabetSize; ++code)
+        {
+            int &child = m_next[state * AlphabetSize + code];
+            int fallback = m_next[failure * AlphabetSize + code];
+            if (child > 0)
+                queue.enqueue(qMakePair(child, fallback));
+            else
+                child = fallback;
+        }
+    }
+}
+
+quint32 KeywordClassifier::classify(const QString &text, Field field) const
+{
+    quint32 categories = 0;
+    int state = 0;
+    for (QChar c : text)
+    {
+        int code = foldedCode(c);
+        state = code < 0 ? 0 : m_next[state * AlphabetSize + code];
+        categories |= m_outputs[state * FieldCount + field];
+    }
+    return categories;
+}
+
+const KeywordClassifier &KeywordClassifier::standard()
+{
+    using namespace KeywordCategory;
+    static const KeywordClassifier classifier({
+        // Startup entries of the OS's own security components
+        {"securityhealth", ProtectedStartup, InName},
+        {"windowsdefender", ProtectedStartup, InName},
+        {"system32\\securityhealth", ProtectedStartup, InCommand},
+
+        // Services, by display name
+        {"windows", SystemService, InName},
+        {"microsoft", SystemService, InName},
+        {"system32", SystemService, InName},
+        {"svchost", SystemService, InName},
+        {"runtime", SystemService, InName},
+        {"kernel", SystemService, InName},
+        {"driver", SystemService, InName},
+        {"network", SystemService, InName},
+        {"security", SystemService, InName},
+        {"update", SystemService, InName},
+        {"defender", SystemService, InName},
+        {"firewall", SystemService, InName},
+
+        // System software, not worth measuring on disk
+        {"microsoft", SystemSoftware, InPublisher},
+        {"windows", SystemSoftware, InName},
+        {"update", SystemSoftware, InName},
+        {"security", SystemSoftware, InName},
+        {"runtime", SystemSoftware, InName},
+        {"visual c++", SystemSoftware, InName},
+        {".net", SystemSoftware, InName},
+    });
+    return classifier;
+}
+
+int KeywordClassifier::addState()
+{
+    int state = m_outputs.size() / FieldCount;
+    m_next.resize(m_next.size() + AlphabetSize);
+    m_outputs.resize(m_outputs.size() + FieldCount);
+    return state;
+}
@@ -0,0 +1,60 @@
+#ifndef KEYWORDCLASSIFIER_H
+#define KEYWORDCLASSIFIER_H
+
+#include <QString>
+#include <QVector>
+
+// Categories of the standard rule table; a text can fall into several
+namespace KeywordCategory
+{
+    enum : quint32
+    {
+        ProtectedStartup = 0x01, // startup entries never listed
+        SystemService = 0x02,    // services hidden from the startup list
+        SystemSoftware = 0x04    // software whose install folder is not measured
+    };
+}
+
+// Finds every keyword of a rule table in a text in one pass, with an
+// Aho-Corasick automaton over case-folded characters. Each rule maps a
+// keyword to category bits and says which fields (name, command,
+// publisher) it applies to; classify() returns the OR of the categories
+// of all matching rules. Keywords must be ASCII. Build once, then share:
+// classify() is const and thread-safe.
+class KeywordClassifier
+{
+public:
+    enum Field
+    {
+        Name,
+        Command,
+        Publisher,
+        FieldCount
+    };
+
+    struct Rule
+    {
+        QString keyword;
+        quint32 categories;
+        quint32 fields; // bits of (1 << Field)
+    };
+
+    explicit KeywordClassifier(const QVector<Rule> &rules);
+
+    quint32 classify(const QString &text, Field field) const;
+
+    // The rules the startup, service and software filters share
+    static const KeywordClassifier &standard();
+
+private:
+    static const int AlphabetSize = 128;
+
+    // Transitions of the completed automaton, AlphabetSize per state
+    QVector<int> m_next;
+    // Categories ending at each state, FieldCount per state
+    QVector<quint32> m_outputs;
+
+    int addState();
+};
+
+#endif // KEYWORDCLASSIFIER_H
@@ -0,0 +1,233 @@
+#include "leftoverfinder.h"
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QHash>
+#include <QRegularExpression>
+#include <QSet>
+#include <algorithm>
+
+namespace
+{
+    // Words that say nothing about which product a folder belongs to
+    const QSet<QString> &stopWords()
+    {
+        static const QSet<QString> words = {
+            "the", "for", "and", "of", "edition", "version", "setup", "update", "app", "application",
+            "x64", "x86", "bit", "win", "windows", "64bit", "32bit", "en", "us", "free", "tools"};
+        return words;
+    }
+
+    // Shared folders that hold many vendors' files
+    const QSet<QString> &protectedNames()
+    {
+        static const QSet<QString> names = {
+            "microsoft", "windows", "commonfiles", "windowsapps", "packages", "temp", "installer",
+            "microsoftnet", "windowsdefender", "windowspowershell", "internetexplorer", "windowsnt",
+            "system32", "syswow64", "programs", "crashdumps", "d3dscache", "systemd", "dpkg", "apt"};
+        return names;
+    }
+
+    bool isVersionLike(const QString &word)
+    {
+        static const QRegularExpression pattern("^v?\\d+([.\\-_]\\d+)*[a-z]?$", QRegularExpression::CaseInsensitiveOption);
+        return pattern.match(word).hasMatch();
+    }
+
+    QString stripDecorations(const InstalledSoftware &software)
+    {
+        // Parenthesised parts are architecture or language tags
+        static const QRegularExpression parentheses("\\([^)]*\\)|\\[[^\\]]*\\]");
+        QString name = software.name;
+        name.remove(parentheses);
+
+        QStringList kept;
+        for (const QString &word : name.split(' ', Qt::SkipEmptyParts))
+        {
+            if (word == software.version || isVersionLike(word) || stopWords().contains(FileIndex::compact(word)))
+                continue;
+            kept.append(word);
+        }
+        return kept.join(' ');
+    }
+}
+
+LeftoverFinder::LeftoverFinder(const FileIndex &index, const PathPrefixTrie &installedLocations)
+    : m_index(index), m_installedLocations(installedLocations)
+{
+}
+
+QList<LeftoverCandidate> LeftoverFinder::find(const InstalledSoftware &software, const QAtomicInteger<bool> &cancelFlag) const
+{
+    QHash<QString, LeftoverCandidate> found;
+    auto consider = [&](const QString &path, int confidence, const QString &reason)
+    {
+        if (isOwnedByInstalledSoftware(path))
+            return;
+
+        auto existing = found.find(path);
+        if (existing != found.end() && existing->confidence >= confidence)
+            return;
+
+        LeftoverCandidate candidate;
+        candidate.path = path;
+        candidate.confidence = confidence;
+        candidate.reason = reason;
+        found.insert(path, candidate);
+    };
+
+    // The recorded install folder is the strongest hint
+    if (!software.installLocation.isEmpty())
+    {
+        QFileInfo location(software.installLocation);
+        QString path = QDir::cleanPath(location.absoluteFilePath());
+        if (location.isDir() && PathPrefixTrie::pathComponents(path).size() >= 3 && !isProtected(location.fileName()))
+            consider(path, 100, "Install location");
+    }
+
+    QString product = productKey(software);
+    if (product.size() >= 3)
+    {
+        for (int id : m_index.findByCompactName(product))
+        {
+            const IndexedDirectory &directory = m_index.directory(id);
+            if (directory.depth >= 1 && !isProtected(directory.name))
+                consider(directory.path, 80, "Folder named after the product");
+        }
+    }
+
+    // Vendor folders: "Mozilla/Firefox" for "Mozilla Firefox" by "Mozilla"
+    QString publisher = publisherKey(software.publisher);
+    if (publisher.size() >= 3 && !protectedNames().contains(publisher))
+    {
+        QString productWithoutPublisher = product.startsWith(publisher) ? product.mid(publisher.size()) : product;
+        for (int id : m_index.findByCompactName(publisher))
+        {
+            for (int childId : m_index.children(id))
+            {
+                const IndexedDirectory &child = m_index.directory(childId);
+                QString childKey = FileIndex::compact(child.name);
+                if (childKey.size() >= 3 && (childKey == product || childKey == productWithoutPublisher) && !isProtected(child.name))
+                    consider(child.path, 70, "Product folder in the publisher's folder");
+            }
+        }
+    }
+
+    // Every significant word of the name appears in the folder name
+    QStringList words = significantTokens(stripDecorations(software));
+    if (words.size() >= 2 || (words.size() == 1 && words.first().size() >= 5))
+    {
+        QVector<int> matches = m_index.findByToken(words.first());
+        for (int i = 1; i < words.size() && !matches.isEmpty(); ++i)
+        {
+            QVector<int> next = m_index.findByToken(words[i]);
+            QSet<int> allowed(next.begin(), next.end());
+            matches.erase(std::remove_if(matches.begin(), matches.end(), [&allowed](int id)
+                                         { return !allowed.contains(id); }),
+                          matches.end());
+        }
+
+        for (int id : matches)
+        {
+            const IndexedDirectory &directory = m_index.directory(id);
+            if (directory.depth >= 1 && !isProtected(directory.name))
+                consider(directory.path, 50, "Folder name contains the product name");
+        }
+    }
+
+    // A folder inside another candidate is deleted with it
+    QStringList paths = found.keys();
+    std::sort(paths.begin(), paths.end());
+    QList<LeftoverCandidate> candidates;
+    QString lastKept;
+    for (const QString &path : paths)
+    {
+        if (cancelFlag)
+            return QList<LeftoverCandidate>();
+        if (!lastKept.isEmpty() && path.startsWith(lastKept + "/", Qt::CaseInsensitive))
+            continue;
+        lastKept = path;
+
+        LeftoverCandidate candidate = found.value(path);
+        candidate.plan = planFor(path, cancelFlag);
+        candidates.append(candidate);
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const LeftoverCandidate &a, const LeftoverCandidate &b)
+                     { return a.plan.totalSize > b.plan.totalSize; });
+    return candidates;
+}
+
+QString LeftoverFinder::productKey(const InstalledSoftware &software)
+{
+    return FileIndex::compact(stripDecorations(software));
+}
+
+QString LeftoverFinder::publisherKey(const QString &publisher)
+{
+    // Legal suffixes are rarely part of the vendor's folder name
+    static const QRegularExpression suffix(",?\\s+(inc|ltd|llc|gmbh|corp|corporation|co|company|limited|ag|bv|srl|pty|sa|s\\.a)\\.?$",
+                                           QRegularExpression::CaseInsensitiveOption);
+    QString name = publisher.trimmed();
+    QString previous;
+    while (name != previous)
+    {
+        previous = name;
+        name.remove(suffix);
+        name = name.trimmed();
+    }
+    return FileIndex::compact(name);
+}
+
+bool LeftoverFinder::isOwnedByInstalledSoftware(const QString &path) const
+{
+    return !m_installedLocations.longestPrefixValues(path).isEmpty() || m_installedLocations.hasEntriesUnder(path);
+}
+
+bool LeftoverFinder::isProtected(const QString &name)
+{
+    return protectedNames().contains(FileIndex::compact(name));
+}
+
+QStringList LeftoverFinder::significantTokens(const QString &productName)
+{
+    QStringList result;
+    for (const QString &token : FileIndex::tokens(productName))
+    {
+        if (token.size() >= 3 && !stopWords().contains(token) && !isVersionLike(token))
+            result.append(token);
+    }
+    return result;
+}
+
+CleanCategoryPlan LeftoverFinder::planFor(const QString &path, const QAtomicInteger<bool> &cancelFlag)
+{
+    CleanCategoryPlan plan;
+    plan.name = path;
+    plan.removeEmptyDirectories = true;
+
+    QFileInfo rootInfo(path);
+    plan.directories.append(CleanDirectory{path, rootInfo.lastModified().toMSecsSinceEpoch()});
+
+    QDirIterator it(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        if (cancelFlag)
+            break;
+
+        it.next();
+        QFileInfo info = it.fileInfo();
+        if (info.isDir() && !info.isSymLink())
+        {
+            plan.directories.append(CleanDirectory{info.absoluteFilePath(), info.lastModified().toMSecsSinceEpoch()});
+        }
+        else
+        {
+            plan.files.append(CleanCandidate{info.absoluteFilePath(), info.size(), info.lastModified().toMSecsSinceEpoch()});
+            plan.totalSize += info.size();
+        }
+    }
+
+    return plan;
+}
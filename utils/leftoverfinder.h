@@ -0,0 +1,50 @@
+#ifndef LEFTOVERFINDER_H
+#define LEFTOVERFINDER_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QAtomicInteger>
+#include "fileindex.h"
+#include "pathprefixtrie.h"
+#include "cleanmanifest.h"
+#include "softwareinventory.h"
+
+struct LeftoverCandidate
+{
+    QString path;
+    QString reason;
+    int confidence = 0;     // 0-100
+    CleanCategoryPlan plan; // every file and folder below path, named after it
+};
+
+// Folders an uninstalled application left behind. Candidates come from the
+// entry's InstallLocation and from FileIndex lookups by product name,
+// publisher/product folder pairs and name tokens. Folders inside or
+// containing another installed application's location are never offered.
+// Each candidate carries a CleanCategoryPlan so it can go straight to
+// CleaningPipeline.
+class LeftoverFinder
+{
+public:
+    LeftoverFinder(const FileIndex &index, const PathPrefixTrie &installedLocations);
+
+    // Largest first
+    QList<LeftoverCandidate> find(const InstalledSoftware &software, const QAtomicInteger<bool> &cancelFlag) const;
+
+    // "Python 3.11.4 (64-bit)" -> "python"
+    static QString productKey(const InstalledSoftware &software);
+    // "Mozilla Corporation" -> "mozilla"
+    static QString publisherKey(const QString &publisher);
+
+private:
+    const FileIndex &m_index;
+    const PathPrefixTrie &m_installedLocations;
+
+    bool isOwnedByInstalledSoftware(const QString &path) const;
+    static bool isProtected(const QString &name);
+    static QStringList significantTokens(const QString &productName);
+    static CleanCategoryPlan planFor(const QString &path, const QAtomicInteger<bool> &cancelFlag);
+};
+
+#endif // LEFTOVERFINDER_H
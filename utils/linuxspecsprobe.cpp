@@ -0,0 +1,250 @@
+#include "linuxspecsprobe.h"
+#include <QFile>
+#include <QDir>
+#include <QSysInfo>
+#include <QRegularExpression>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+namespace
+{
+    // pci.ids spells vendors out in full ("Advanced Micro Devices, Inc. [AMD/ATI]")
+    QString shortVendorName(const QString &vendorId, const QString &fullName)
+    {
+        if (vendorId == "10de")
+            return "NVIDIA";
+        if (vendorId == "1002" || vendorId == "1022")
+            return "AMD";
+        if (vendorId == "8086")
+            return "Intel";
+        return fullName.section(' ', 0, 0);
+    }
+
+    // "AD102 [GeForce RTX 4090]" -> "GeForce RTX 4090"
+    QString marketingName(const QString &deviceName)
+    {
+        int open = deviceName.indexOf('[');
+        int close = deviceName.lastIndexOf(']');
+        if (open >= 0 && close > open + 1)
+            return deviceName.mid(open + 1, close - open - 1).trimmed();
+        return deviceName;
+    }
+
+    QString hexId(const QByteArray &sysfsValue)
+    {
+        QString value = QString::fromLatin1(sysfsValue).trimmed().toLower();
+        if (value.startsWith("0x"))
+            value = value.mid(2);
+        return value;
+    }
+}
+
+LinuxSpecsProbe::LinuxSpecsProbe(const QString &rootPath)
+    : m_rootPath(rootPath)
+{
+}
+
+QString LinuxSpecsProbe::id() const
+{
+    return "linux";
+}
+
+QByteArray LinuxSpecsProbe::readFile(const QString &path) const
+{
+    QFile file(m_rootPath + path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return file.readAll();
+}
+
+void LinuxSpecsProbe::probeOs(SystemSpecs &specs) const
+{
+    // /usr/lib/os-release is the fallback the os-release spec names
+    QByteArray osRelease = readFile("/etc/os-release");
+    if (osRelease.isEmpty())
+        osRelease = readFile("/usr/lib/os-release");
+
+    QString osName = osReleaseValue(osRelease, "PRETTY_NAME");
+    if (osName.isEmpty())
+        osName = (osReleaseValue(osRelease, "NAME") + " " + osReleaseValue(osRelease, "VERSION")).trimmed();
+    if (osName.isEmpty())
+        osName = "Linux";
+
+    QString kernel = QString::fromLatin1(readFile("/proc/sys/kernel/osrelease")).trimmed();
+    if (kernel.isEmpty())
+        kernel = QSysInfo::kernelVersion();
+
+    // Format: "Debian GNU/Linux 12 (bookworm) | kernel 6.1.0-18-amd64"
+    specs.osName = QString("%1 | kernel %2").arg(osName, kernel);
+}
+
+void LinuxSpecsProbe::probeCpu(SystemSpecs &specs) const
+{
+    // x86 has "model name"; ARM kernels use one of the others, if any
+    const QList<QByteArray> nameKeys = {"model name", "Hardware", "cpu model", "Model"};
+
+    const QList<QByteArray> lines = readFile("/proc/cpuinfo").split('\n');
+    for (const QByteArray &key : nameKeys)
+    {
+        for (const QByteArray &line : lines)
+        {
+            int colon = line.indexOf(':');
+            if (colon > 0 && line.left(colon).trimmed() == key)
+            {
+                specs.cpuName = QString::fromUtf8(line.mid(colon + 1)).simplified();
+                break;
+            }
+        }
+        if (!specs.cpuName.isEmpty())
+            break;
+    }
+    if (specs.cpuName.isEmpty())
+        specs.cpuName = QSysInfo::currentCpuArchitecture();
+
+#ifdef Q_OS_UNIX
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cores > 0)
+        specs.cpuCores = QString("%1 cores").arg(cores);
+#endif
+}
+
+void LinuxSpecsProbe::probeMemory(SystemSpecs &specs) const
+{
+#ifdef Q_OS_UNIX
+    long pages = sysconf(_SC_PHYS_PAGES);
+    long pageSize = sysconf(_SC_PAGE_SIZE);
+    if (pages > 0 && pageSize > 0)
+        specs.ramTotal = formatBytes(qint64(pages) * pageSize);
+#else
+    Q_UNUSED(specs);
+#endif
+}
+
+void LinuxSpecsProbe::probeGpu(SystemSpecs &specs) const
+{
+    specs.gpuName = "Unknown GPU";
+
+    // card0, card1, ...; names with a dash are connectors of those cards
+    QDir drm(m_rootPath + "/sys/class/drm");
+    const QStringList cards = drm.entryList(QStringList() << "card*", QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+
+    QString device;
+    for (const QString &card : cards)
+    {
+        if (card.contains('-') || !QFile::exists(drm.filePath(card + "/device/vendor")))
+            continue;
+
+        QString candidate = "/sys/class/drm/" + card + "/device";
+        if (device.isEmpty())
+            device = candidate;
+
+        // The adapter the firmware showed the boot screen on
+        if (readFile(candidate + "/boot_vga").trimmed() == "1")
+        {
+            device = candidate;
+            break;
+        }
+    }
+    if (device.isEmpty())
+        return;
+
+    QString vendorId = hexId(readFile(device + "/vendor"));
+    QString deviceId = hexId(readFile(device + "/device"));
+
+    QByteArray pciIds = readFile("/usr/share/hwdata/pci.ids");
+    if (pciIds.isEmpty())
+        pciIds = readFile("/usr/share/misc/pci.ids");
+
+    QString name = pciName(pciIds, vendorId, deviceId);
+    if (name.isEmpty())
+    {
+        // Without pci.ids, the kernel driver still tells the vendor apart
+        QString driver;
+        const QList<QByteArray> uevent = readFile(device + "/uevent").split('\n');
+        for (const QByteArray &line : uevent)
+        {
+            if (line.startsWith("DRIVER="))
+                driver = QString::fromLatin1(line.mid(7)).trimmed();
+        }
+        name = QString("%1 GPU").arg(shortVendorName(vendorId, vendorId));
+        if (!driver.isEmpty())
+            name += " (" + driver + ")";
+    }
+    specs.gpuName = name;
+
+    // Only amdgpu exports the VRAM size; other drivers keep it to themselves
+    qint64 vram = QString::fromLatin1(readFile(device + "/mem_info_vram_total")).trimmed().toLongLong();
+    if (vram > 0)
+        specs.gpuVRAM = formatBytes(vram) + " VRAM";
+}
+
+QString LinuxSpecsProbe::osReleaseValue(const QByteArray &contents, const QByteArray &key)
+{
+    const QList<QByteArray> lines = contents.split('\n');
+    for (const QByteArray &line : lines)
+    {
+        if (!line.startsWith(key + "="))
+            continue;
+
+        QByteArray value = line.mid(key.size() + 1).trimmed();
+        if (value.size() >= 2 && (value.startsWith('"') || value.startsWith('\'')) && value.endsWith(value.at(0)))
+            value = value.mid(1, value.size() - 2);
+
+        // Shell-style escapes of $, ", \ and `
+        QByteArray unescaped;
+        for (int i = 0; i < value.size(); ++i)
+        {
+            if (value.at(i) == '\\' && i + 1 < value.size())
+                ++i;
+            unescaped += value.at(i);
+        }
+        return QString::fromUtf8(unescaped);
+    }
+    return QString();
+}
+
+QString LinuxSpecsProbe::pciName(const QByteArray &pciIds, const QString &vendorId, const QString &deviceId)
+{
+    if (vendorId.isEmpty())
+        return QString();
+
+    // Vendors start at column 0, their devices are indented by one tab and
+    // subsystems by two; the device list ends at the next vendor
+    QString vendorName;
+    int pos = 0;
+    while (pos < pciIds.size())
+    {
+        int end = pciIds.indexOf('\n', pos);
+        if (end < 0)
+            end = pciIds.size();
+        const QByteArray line = pciIds.mid(pos, end - pos);
+        pos = end + 1;
+
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        if (line.at(0) != '\t')
+        {
+            if (!vendorName.isEmpty())
+                break;
+            if (line.startsWith(vendorId.toLatin1() + "  "))
+                vendorName = QString::fromUtf8(line.mid(vendorId.size() + 2)).trimmed();
+            continue;
+        }
+
+        if (vendorName.isEmpty() || line.startsWith("\t\t"))
+            continue;
+
+        if (line.mid(1).startsWith(deviceId.toLatin1() + "  "))
+        {
+            QString deviceName = QString::fromUtf8(line.mid(deviceId.size() + 3)).trimmed();
+            return shortVendorName(vendorId, vendorName) + " " + marketingName(deviceName);
+        }
+    }
+
+    if (!vendorName.isEmpty())
+        return shortVendorName(vendorId, vendorName) + " GPU";
+    return QString();
+}
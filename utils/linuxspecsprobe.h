@@ -0,0 +1,33 @@
+#ifndef LINUXSPECSPROBE_H
+#define LINUXSPECSPROBE_H
+
+#include "systemspecsprobe.h"
+
+// /etc/os-release, /proc/cpuinfo, sysconf() and the DRM devices under
+// /sys/class/drm, named through the pci.ids database when it is installed.
+// RAM speed is left empty: only SMBIOS has it, and that needs root.
+// The directories can be pointed elsewhere to probe a captured tree.
+class LinuxSpecsProbe : public SystemSpecsProbe
+{
+public:
+    explicit LinuxSpecsProbe(const QString &rootPath = QString());
+
+    QString id() const override;
+
+    void probeOs(SystemSpecs &specs) const override;
+    void probeCpu(SystemSpecs &specs) const override;
+    void probeMemory(SystemSpecs &specs) const override;
+    void probeGpu(SystemSpecs &specs) const override;
+
+    // Value of a KEY=value line of an os-release file, unquoted
+    static QString osReleaseValue(const QByteArray &contents, const QByteArray &key);
+    // "Vendor device" from pci.ids text for hex ids such as "10de"; empty if unknown
+    static QString pciName(const QByteArray &pciIds, const QString &vendorId, const QString &deviceId);
+
+private:
+    QString m_rootPath; // prefix for every file read; empty for the running system
+
+    QByteArray readFile(const QString &path) const;
+};
+
+#endif // LINUXSPECSPROBE_H
@@ -0,0 +1,106 @@
+#include "logoncommand.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSettings>
+
+namespace
+{
+#ifdef Q_OS_WIN
+    const char *const RunKey = "HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run";
+#else
+    QString autostartDirectory()
+    {
+        QString configHome = QString::fromLocal8Bit(qgetenv("XDG_CONFIG_HOME"));
+        if (configHome.isEmpty())
+            configHome = QDir::homePath() + "/.config";
+        return configHome + "/autostart";
+    }
+#endif
+}
+
+QString LogonCommand::command() const
+{
+    return QString("\"%1\" %2").arg(QDir::toNativeSeparators(helperPath()), argument);
+}
+
+QString LogonCommand::helperPath()
+{
+#ifdef Q_OS_WIN
+    return QCoreApplication::applicationDirPath() + "/Ratpro_Logon.exe";
+#else
+    return QCoreApplication::applicationDirPath() + "/Ratpro_Logon";
+#endif
+}
+
+bool LogonCommand::isRegistered() const
+{
+#ifdef Q_OS_WIN
+    return QSettings(RunKey, QSettings::NativeFormat).contains(name);
+#else
+    return QFile::exists(autostartDirectory() + "/" + desktopFile);
+#endif
+}
+
+bool LogonCommand::setRegistered(bool registered, QString &error) const
+{
+    // Without the helper the entry would start nothing, and what it replaces would be lost
+    if (registered && !QFileInfo(helperPath()).isFile())
+    {
+        error = QString("%1 cannot be registered: %2 is missing.").arg(name, QDir::toNativeSeparators(helperPath()));
+        return false;
+    }
+
+#ifdef Q_OS_WIN
+    QSettings registry(RunKey, QSettings::NativeFormat);
+    if (registered)
+        registry.setValue(name, command());
+    else
+        registry.remove(name);
+    registry.sync();
+
+    if (registry.status() != QSettings::NoError)
+    {
+        error = QString("%1 could not be registered in the Run key.").arg(name);
+        return false;
+    }
+    return true;
+#else
+    QString path = autostartDirectory() + "/" + desktopFile;
+    if (!registered)
+    {
+        if (QFile::exists(path) && !QFile::remove(path))
+        {
+            error = QString("Could not remove %1.").arg(path);
+            return false;
+        }
+        return true;
+    }
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = QString("Could not write %1.").arg(path);
+        return false;
+    }
+
+    file.write(QString("[Desktop Entry]\n"
+                       "Type=Application\n"
+                       "Name=%1\n"
+                       "Comment=%2\n"
+                       "Exec=%3\n"
+                       "NoDisplay=true\n"
+                       "X-GNOME-Autostart-enabled=true\n")
+                   .arg(name, comment, command())
+                   .toUtf8());
+    if (!file.commit())
+    {
+        error = QString("Could not write %1.").arg(path);
+        return false;
+    }
+    return true;
+#endif
+}
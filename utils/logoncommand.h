@@ -0,0 +1,23 @@
+#ifndef LOGONCOMMAND_H
+#define LOGONCOMMAND_H
+
+#include <QString>
+
+// The logon helper (Ratpro_Logon, installed next to the main executable)
+// started with one argument at every logon, registered as an ordinary
+// startup entry: a Run value on Windows, an autostart file on Linux. The
+// helper's manifest asks for no elevation, so Windows does start it.
+struct LogonCommand
+{
+    QString name;        // Run value name and the autostart entry's Name
+    QString desktopFile; // autostart file name, e.g. "raptor-delayed-start.desktop"
+    QString comment;
+    QString argument;
+
+    QString command() const;
+    static QString helperPath();
+    bool isRegistered() const;
+    bool setRegistered(bool registered, QString &error) const;
+};
+
+#endif // LOGONCOMMAND_H
@@ -0,0 +1,62 @@
+#include "memoryactivationsource.h"
+#include <QFileInfo>
+#include <QSettings>
+
+MemoryActivationSource::MemoryActivationSource(const QString &id)
+    : m_id(id)
+{
+}
+
+QString MemoryActivationSource::id() const
+{
+    return m_id;
+}
+
+bool MemoryActivationSource::read(QHash<QString, UnitActivation> &activations, QString &error) const
+{
+    if (m_activations.isEmpty())
+    {
+        error = "No unit activations were recorded.";
+        return false;
+    }
+    activations = m_activations;
+    return true;
+}
+
+void MemoryActivationSource::setActivation(const QString &unit, qint64 activatingUs, qint64 activeUs)
+{
+    UnitActivation activation;
+    activation.activatingUs = activatingUs;
+    activation.activeUs = activeUs;
+    m_activations.insert(unit, activation);
+}
+
+void MemoryActivationSource::clear()
+{
+    m_activations.clear();
+}
+
+int MemoryActivationSource::count() const
+{
+    return m_activations.size();
+}
+
+bool MemoryActivationSource::loadIni(const QString &filePath)
+{
+    if (!QFileInfo(filePath).isFile())
+        return false;
+
+    QSettings ini(filePath, QSettings::IniFormat);
+    for (const QString &group : ini.childGroups())
+    {
+        ini.beginGroup(group);
+
+        // A unit without an "Activating" time went straight to active, as targets do
+        qint64 active = ini.value("Active", -1).toLongLong();
+        setActivation(group, ini.value("Activating", active).toLongLong(), active);
+
+        ini.endGroup();
+    }
+
+    return ini.status() == QSettings::NoError;
+}
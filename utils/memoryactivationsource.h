@@ -0,0 +1,28 @@
+#ifndef MEMORYACTIVATIONSOURCE_H
+#define MEMORYACTIVATIONSOURCE_H
+
+#include "bootactivationsource.h"
+
+// Activations held in memory, optionally loaded from an INI file with one
+// [group] per unit and "Activating"/"Active" keys in microseconds. Lets the
+// boot analysis run without a journal, against fixtures or generated boots.
+// Must not be modified while an analysis is reading it.
+class MemoryActivationSource : public BootActivationSource
+{
+public:
+    explicit MemoryActivationSource(const QString &id);
+
+    QString id() const override;
+    bool read(QHash<QString, UnitActivation> &activations, QString &error) const override;
+
+    void setActivation(const QString &unit, qint64 activatingUs, qint64 activeUs);
+    void clear();
+    int count() const;
+    bool loadIni(const QString &filePath);
+
+private:
+    QString m_id;
+    QHash<QString, UnitActivation> m_activations;
+};
+
+#endif // MEMORYACTIVATIONSOURCE_H
@@ -0,0 +1,87 @@
+#include "memoryinventorysource.h"
+#include <QFileInfo>
+#include <QSettings>
+
+MemoryInventorySource::MemoryInventorySource(const QString &id)
+    : m_id(id)
+{
+}
+
+QString MemoryInventorySource::id() const
+{
+    return m_id;
+}
+
+bool MemoryInventorySource::listEntries(QList<QPair<QString, qint64>> &entries) const
+{
+    for (const InventoryRecord &record : m_records)
+    {
+        entries.append(qMakePair(record.key, record.lastWriteTime));
+    }
+    return true;
+}
+
+QList<InventoryRecord> MemoryInventorySource::readEntries(const QStringList &keys) const
+{
+    if (keys.isEmpty())
+        return m_records.values();
+
+    QList<InventoryRecord> records;
+    for (const QString &key : keys)
+    {
+        auto it = m_records.constFind(key);
+        if (it != m_records.constEnd())
+            records.append(it.value());
+    }
+    return records;
+}
+
+void MemoryInventorySource::setRecord(const InventoryRecord &record)
+{
+    m_records.insert(record.key, record);
+}
+
+void MemoryInventorySource::removeRecord(const QString &key)
+{
+    m_records.remove(key);
+}
+
+void MemoryInventorySource::clear()
+{
+    m_records.clear();
+}
+
+int MemoryInventorySource::count() const
+{
+    return m_records.size();
+}
+
+bool MemoryInventorySource::loadIni(const QString &filePath)
+{
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile())
+        return false;
+
+    QSettings ini(filePath, QSettings::IniFormat);
+    qint64 fileStamp = fileInfo.lastModified().toMSecsSinceEpoch();
+
+    for (const QString &group : ini.childGroups())
+    {
+        ini.beginGroup(group);
+
+        InventoryRecord record;
+        record.key = group;
+        for (const QString &name : ini.childKeys())
+        {
+            record.values.insert(name, ini.value(name));
+        }
+
+        QVariant stamp = record.values.take("LastWriteTime");
+        record.lastWriteTime = stamp.isValid() ? stamp.toLongLong() : fileStamp;
+        setRecord(record);
+
+        ini.endGroup();
+    }
+
+    return ini.status() == QSettings::NoError;
+}
@@ -0,0 +1,32 @@
+#ifndef MEMORYINVENTORYSOURCE_H
+#define MEMORYINVENTORYSOURCE_H
+
+#include "inventorysource.h"
+#include <QMap>
+
+// Inventory entries held in memory, optionally loaded from an INI file with
+// one [group] per entry and registry value names as keys. A "LastWriteTime"
+// key sets the change stamp; otherwise the file's mtime is used. Lets the
+// scan run off Windows against fixtures or generated entries. Must not be
+// modified while a scan is reading it.
+class MemoryInventorySource : public InventorySource
+{
+public:
+    explicit MemoryInventorySource(const QString &id);
+
+    QString id() const override;
+    bool listEntries(QList<QPair<QString, qint64>> &entries) const override;
+    QList<InventoryRecord> readEntries(const QStringList &keys) const override;
+
+    void setRecord(const InventoryRecord &record);
+    void removeRecord(const QString &key);
+    void clear();
+    int count() const;
+    bool loadIni(const QString &filePath);
+
+private:
+    QString m_id;
+    QMap<QString, InventoryRecord> m_records;
+};
+
+#endif // MEMORYINVENTORYSOURCE_H
@@ -0,0 +1,99 @@
+#include "metricsringbuffer.h"
+
+MetricsRingBuffer::MetricsRingBuffer(int capacity)
+{
+    quint64 size = 2;
+    while (size < quint64(qMax(capacity, 2)))
+        size <<= 1;
+
+    m_slots.reset(new Slot[size]);
+    m_mask = size - 1;
+}
+
+int MetricsRingBuffer::capacity() const
+{
+    return int(m_mask + 1);
+}
+
+void MetricsRingBuffer::push(const MetricsSample &sample)
+{
+    const quint64 index = m_head.load(std::memory_order_relaxed);
+    Slot &slot = m_slots[index & m_mask];
+
+    const quint64 sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    // Readers must not see the new fields before the odd sequence
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.timestampNs.store(sample.timestampNs, std::memory_order_relaxed);
+    slot.cpuUsage.store(sample.cpuUsage, std::memory_order_relaxed);
+    slot.ramUsage.store(sample.ramUsage, std::memory_order_relaxed);
+    slot.diskUsage.store(sample.diskUsage, std::memory_order_relaxed);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    m_head.store(index + 1, std::memory_order_release);
+}
+
+quint64 MetricsRingBuffer::written() const
+{
+    return m_head.load(std::memory_order_acquire);
+}
+
+bool MetricsRingBuffer::readSlot(quint64 index, MetricsSample &sample) const
+{
+    const Slot &slot = m_slots[index & m_mask];
+
+    // Write number n into a slot leaves its sequence at 2 * (n + 1); any
+    // other value means the slot is being written or already holds a newer lap
+    const quint64 expected = 2 * (index / (m_mask + 1) + 1);
+
+    if (slot.sequence.load(std::memory_order_acquire) != expected)
+        return false;
+
+    sample.timestampNs = slot.timestampNs.load(std::memory_order_relaxed);
+    sample.cpuUsage = slot.cpuUsage.load(std::memory_order_relaxed);
+    sample.ramUsage = slot.ramUsage.load(std::memory_order_relaxed);
+    sample.diskUsage = slot.diskUsage.load(std::memory_order_relaxed);
+
+    // Keeps the field loads above from moving below the second check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.sequence.load(std::memory_order_relaxed) == expected;
+}
+
+bool MetricsRingBuffer::latest(MetricsSample &sample) const
+{
+    // Lost only if the writer laps the whole ring during the copy
+    for (;;)
+    {
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        if (head == 0)
+            return false;
+        if (readSlot(head - 1, sample))
+            return true;
+    }
+}
+
+quint64 MetricsRingBuffer::readSince(quint64 &cursor, QVector<MetricsSample> &samples) const
+{
+    quint64 skipped = 0;
+    const quint64 head = m_head.load(std::memory_order_acquire);
+    const quint64 size = m_mask + 1;
+
+    if (cursor > head)
+        cursor = head;
+    if (head - cursor > size)
+    {
+        skipped = head - size - cursor;
+        cursor = head - size;
+    }
+
+    for (; cursor < head; ++cursor)
+    {
+        MetricsSample sample;
+        if (readSlot(cursor, sample))
+            samples.append(sample);
+        else
+            ++skipped; // overwritten while we were catching up
+    }
+    return skipped;
+}
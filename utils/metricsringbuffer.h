@@ -0,0 +1,63 @@
+#ifndef METRICSRINGBUFFER_H
+#define METRICSRINGBUFFER_H
+
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+#include <memory>
+
+// One reading of the performance counters
+struct MetricsSample
+{
+    qint64 timestampNs = 0; // steady clock, taken right after the counters were read
+    int cpuUsage = 0;       // percent, over the interval since the previous sample
+    int ramUsage = 0;       // percent
+    int diskUsage = 0;      // percent of the system drive in use
+};
+
+// Fixed-size ring one thread writes and any number of threads read without
+// locks. Every slot is a seqlock: the writer makes its sequence odd, stores
+// the fields and makes it even again, and a reader keeps a copy only if the
+// sequence was the same even value before and after. The writer never
+// waits; a reader that falls more than a ring behind skips what was
+// overwritten. Fields are relaxed atomics, so torn reads are detected
+// rather than undefined.
+class MetricsRingBuffer
+{
+public:
+    // Rounded up to a power of two
+    explicit MetricsRingBuffer(int capacity = 256);
+
+    int capacity() const;
+
+    // Writer thread only
+    void push(const MetricsSample &sample);
+
+    // Number of samples pushed so far; also the cursor of the next one
+    quint64 written() const;
+
+    // Any thread: the newest sample, false if there is none yet
+    bool latest(MetricsSample &sample) const;
+    // Any thread: appends the samples from cursor on and moves the cursor
+    // past them; returns how many were overwritten before they could be read
+    quint64 readSince(quint64 &cursor, QVector<MetricsSample> &samples) const;
+
+private:
+    // A cache line each, so the slot being written does not evict the one being read
+    struct alignas(64) Slot
+    {
+        std::atomic<quint64> sequence{0}; // 2 * writes into this slot, odd while writing
+        std::atomic<qint64> timestampNs{0};
+        std::atomic<int> cpuUsage{0};
+        std::atomic<int> ramUsage{0};
+        std::atomic<int> diskUsage{0};
+    };
+
+    std::atomic<quint64> m_head{0};
+    std::unique_ptr<Slot[]> m_slots;
+    quint64 m_mask;
+
+    bool readSlot(quint64 index, MetricsSample &sample) const;
+};
+
+#endif // METRICSRINGBUFFER_H
@@ -0,0 +1,181 @@
+#include "metricssampler.h"
+#include <QDeadlineTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+namespace
+{
+#ifndef Q_OS_WIN
+    // procfs files are regenerated on every read from the start, so the
+    // handles stay open and are rewound instead of reopened
+    QByteArray rereadHead(QFile &file)
+    {
+        if (!file.isOpen() || !file.seek(0))
+            return QByteArray();
+        return file.read(512);
+    }
+#endif
+}
+
+MetricsSampler::MetricsSampler(QObject *parent)
+    : QThread(parent), m_intervalMs(500), m_stopRequested(false),
+      m_diskUsage(0)
+{
+}
+
+MetricsSampler::~MetricsSampler()
+{
+    stop();
+}
+
+void MetricsSampler::setInterval(int intervalMs)
+{
+    m_intervalMs = qMax(intervalMs, MinimumIntervalMs);
+}
+
+int MetricsSampler::interval() const
+{
+    return m_intervalMs;
+}
+
+void MetricsSampler::stop()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_stopRequested = true;
+        m_wake.wakeAll();
+    }
+    wait();
+    m_stopRequested = false;
+}
+
+const MetricsRingBuffer &MetricsSampler::samples() const
+{
+    return m_buffer;
+}
+
+void MetricsSampler::run()
+{
+    using std::chrono::steady_clock;
+
+    openCounters();
+    sampleCpu(); // baseline for the first interval
+    m_diskRefreshedAt = steady_clock::time_point();
+
+    // Ticks are counted from the start, not from the last wake-up, so late
+    // wake-ups do not add up; the timestamp says when a sample was really taken
+    steady_clock::time_point next = steady_clock::now();
+    while (!m_stopRequested)
+    {
+        next += std::chrono::milliseconds(int(m_intervalMs));
+
+        // Behind by more than a tick (suspend, debugger): resume from now rather than burst
+        steady_clock::time_point now = steady_clock::now();
+        if (next < now)
+            next = now;
+
+        {
+            QMutexLocker locker(&m_mutex);
+            QDeadlineTimer deadline(next, Qt::PreciseTimer);
+            while (!m_stopRequested && !deadline.hasExpired())
+                m_wake.wait(&m_mutex, deadline);
+        }
+        if (m_stopRequested)
+            break;
+
+        MetricsSample sample;
+        sample.cpuUsage = sampleCpu();
+        sample.ramUsage = sampleRam();
+        now = steady_clock::now();
+        sample.diskUsage = sampleDisk(now);
+        sample.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+        m_buffer.push(sample);
+    }
+
+    closeCounters();
+}
+
+void MetricsSampler::openCounters()
+{
+#ifndef Q_OS_WIN
+    m_procStat.setFileName("/proc/stat");
+    m_procStat.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    m_procMeminfo.setFileName("/proc/meminfo");
+    m_procMeminfo.open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+#endif
+    m_lastCpu = CpuTicks();
+}
+
+void MetricsSampler::closeCounters()
+{
+#ifndef Q_OS_WIN
+    m_procStat.close();
+    m_procMeminfo.close();
+#endif
+}
+
+int MetricsSampler::sampleCpu()
+{
+#ifdef Q_OS_WIN
+    CpuTicks ticks = CpuTicks::current();
+#else
+    // Rewinding the open handle saves reopening /proc/stat at every sample
+    CpuTicks ticks = CpuTicks::fromProcStat(rereadHead(m_procStat));
+#endif
+
+    int usage = ticks.busyPercentSince(m_lastCpu);
+    m_lastCpu = ticks;
+    return usage;
+}
+
+int MetricsSampler::sampleRam()
+{
+#ifdef Q_OS_WIN
+    MEMORYSTATUSEX memoryStatus;
+    memoryStatus.dwLength = sizeof(memoryStatus);
+    if (GlobalMemoryStatusEx(&memoryStatus))
+        return int(memoryStatus.dwMemoryLoad);
+#else
+    // MemTotal and MemAvailable are among the first lines. In use means not
+    // available: page cache the kernel can drop counts as free
+    qint64 totalKB = 0;
+    qint64 availableKB = -1;
+    const QList<QByteArray> lines = rereadHead(m_procMeminfo).split('\n');
+    for (const QByteArray &line : lines)
+    {
+        QList<QByteArray> fields = line.simplified().split(' ');
+        if (fields.size() < 2)
+            continue;
+        if (fields[0] == "MemTotal:")
+            totalKB = fields[1].toLongLong();
+        else if (fields[0] == "MemAvailable:")
+            availableKB = fields[1].toLongLong();
+    }
+
+    if (totalKB > 0 && availableKB >= 0)
+        return qBound(0, int((totalKB - availableKB) * 100 / totalKB), 100);
+#endif
+    return 0;
+}
+
+int MetricsSampler::sampleDisk(std::chrono::steady_clock::time_point now)
+{
+    if (m_diskRefreshedAt != std::chrono::steady_clock::time_point() &&
+        now - m_diskRefreshedAt < std::chrono::milliseconds(DiskRefreshMs))
+        return m_diskUsage;
+
+    if (m_diskRefreshedAt == std::chrono::steady_clock::time_point())
+        m_bootDrive = QStorageInfo::root();
+    else
+        m_bootDrive.refresh();
+    m_diskRefreshedAt = now;
+
+    if (m_bootDrive.isValid() && m_bootDrive.bytesTotal() > 0)
+    {
+        double usedBytes = m_bootDrive.bytesTotal() - m_bootDrive.bytesFree();
+        m_diskUsage = int(usedBytes * 100 / m_bootDrive.bytesTotal());
+    }
+    return m_diskUsage;
+}
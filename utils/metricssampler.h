@@ -0,0 +1,68 @@
+#ifndef METRICSSAMPLER_H
+#define METRICSSAMPLER_H
+
+#include "metricsringbuffer.h"
+#include "cputicks.h"
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInteger>
+#include <QStorageInfo>
+#include <QFile>
+#include <chrono>
+
+// Reads CPU, memory and system drive usage on a thread of its own, on a
+// fixed schedule that does not drift with the load of the GUI thread, and
+// publishes each timestamped sample to a lock-free ring. Consumers read the
+// ring at their own pace: latest() for the current value, readSince() for
+// everything since their last look. A sample costs a few syscalls on open
+// handles, so intervals down to 50 ms are cheap; the drive, which changes
+// slowly and costs a statfs, is refreshed every DiskRefreshMs only.
+class MetricsSampler : public QThread
+{
+    Q_OBJECT
+
+public:
+    static constexpr int MinimumIntervalMs = 50;
+    static constexpr int DiskRefreshMs = 2000;
+
+    explicit MetricsSampler(QObject *parent = nullptr);
+    ~MetricsSampler();
+
+    // Takes effect from the next sample; clamped to MinimumIntervalMs
+    void setInterval(int intervalMs);
+    int interval() const;
+
+    // Wakes the thread at once and waits for it to exit
+    void stop();
+
+    const MetricsRingBuffer &samples() const;
+
+protected:
+    void run() override;
+
+private:
+    MetricsRingBuffer m_buffer;
+    QAtomicInteger<int> m_intervalMs;
+    QAtomicInteger<bool> m_stopRequested;
+    QMutex m_mutex;
+    QWaitCondition m_wake;
+
+    // Only touched by the sampler thread
+    CpuTicks m_lastCpu;
+    QStorageInfo m_bootDrive;
+    std::chrono::steady_clock::time_point m_diskRefreshedAt;
+    int m_diskUsage;
+#ifndef Q_OS_WIN
+    QFile m_procStat;
+    QFile m_procMeminfo;
+#endif
+
+    void openCounters();
+    void closeCounters();
+    int sampleCpu();
+    int sampleRam();
+    int sampleDisk(std::chrono::steady_clock::time_point now);
+};
+
+#endif // METRICSSAMPLER_H
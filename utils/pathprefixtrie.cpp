@@ -0,0 +1,104 @@
+#include "pathprefixtrie.h"
+#include <QDir>
+
+PathPrefixTrie::PathPrefixTrie()
+{
+    clear();
+}
+
+void PathPrefixTrie::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+}
+
+bool PathPrefixTrie::isEmpty() const
+{
+    return m_nodes.size() == 1 && m_nodes[0].values.isEmpty();
+}
+
+void PathPrefixTrie::insert(const QString &directory, int value)
+{
+    QStringList components = pathComponents(directory);
+    if (components.isEmpty())
+        return;
+
+    int node = 0;
+    for (const QString &component : components)
+    {
+        int child = m_nodes[node].children.value(component, -1);
+        if (child < 0)
+        {
+            child = m_nodes.size();
+            m_nodes.append(Node());
+            m_nodes[node].children.insert(component, child);
+        }
+        node = child;
+    }
+
+    if (!m_nodes[node].values.contains(value))
+        m_nodes[node].values.append(value);
+}
+
+QVector<int> PathPrefixTrie::longestPrefixValues(const QString &path) const
+{
+    int deepest = -1;
+    int node = 0;
+    for (const QString &component : pathComponents(path))
+    {
+        auto child = m_nodes[node].children.constFind(component);
+        if (child == m_nodes[node].children.constEnd())
+            break;
+        node = child.value();
+        if (!m_nodes[node].values.isEmpty())
+            deepest = node;
+    }
+
+    return deepest >= 0 ? m_nodes[deepest].values : QVector<int>();
+}
+
+bool PathPrefixTrie::hasEntriesUnder(const QString &directory) const
+{
+    QStringList components = pathComponents(directory);
+    if (components.isEmpty())
+        return false;
+
+    int node = 0;
+    for (const QString &component : components)
+    {
+        auto child = m_nodes[node].children.constFind(component);
+        if (child == m_nodes[node].children.constEnd())
+            return false;
+        node = child.value();
+    }
+
+    QVector<int> stack{node};
+    while (!stack.isEmpty())
+    {
+        const Node &current = m_nodes[stack.takeLast()];
+        if (!current.values.isEmpty())
+            return true;
+        for (int child : current.children)
+        {
+            stack.append(child);
+        }
+    }
+    return false;
+}
+
+QStringList PathPrefixTrie::pathComponents(const QString &path)
+{
+    QString cleaned = QDir::cleanPath(QDir::fromNativeSeparators(path.trimmed()));
+    if (cleaned.isEmpty() || QDir::isRelativePath(cleaned))
+        return QStringList();
+
+#ifdef Q_OS_WIN
+    cleaned = cleaned.toCaseFolded();
+#endif
+
+    // A leading "/" becomes an empty first component so "/opt" and "opt" differ
+    QStringList components = cleaned.split('/');
+    if (cleaned.endsWith('/'))
+        components.removeLast(); // roots such as "/" or "C:/"
+    return components;
+}
@@ -0,0 +1,43 @@
+#ifndef PATHPREFIXTRIE_H
+#define PATHPREFIXTRIE_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+// Directory paths mapped to integer values, one trie node per path
+// component. A lookup walks the components of a file path once and returns
+// the values of the deepest inserted directory containing it, so nested
+// install locations ("App" and "App/Plugins") resolve to the inner one.
+// Paths compare case-insensitively on Windows.
+class PathPrefixTrie
+{
+public:
+    PathPrefixTrie();
+
+    void clear();
+    bool isEmpty() const;
+
+    void insert(const QString &directory, int value);
+
+    // Values of the deepest inserted directory that is path or one of its ancestors
+    QVector<int> longestPrefixValues(const QString &path) const;
+
+    // Whether directory itself or anything below it was inserted
+    bool hasEntriesUnder(const QString &directory) const;
+
+    // Cleaned, '/'-separated components; empty for relative paths
+    static QStringList pathComponents(const QString &path);
+
+private:
+    struct Node
+    {
+        QHash<QString, int> children;
+        QVector<int> values;
+    };
+
+    QVector<Node> m_nodes; // m_nodes[0] is the root
+};
+
+#endif // PATHPREFIXTRIE_H
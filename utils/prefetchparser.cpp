@@ -0,0 +1,337 @@
+#include "prefetchparser.h"
+#include "xpresshuffman.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QtEndian>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace
+{
+    // Windows 8+ wrapper: "MAM", the compression format in the low nibble of
+    // the fourth byte (4 = XPRESS Huffman) and, with its high bit set, a CRC
+    const char CompressedSignature[3] = {'M', 'A', 'M'};
+    const uchar CompressionXpressHuffman = 0x04;
+    const uchar CompressionHasChecksum = 0x80;
+    const char Signature[4] = {'S', 'C', 'C', 'A'};
+
+    const int ExecutableNameOffset = 0x10;
+    const int ExecutableNameBytes = 60;
+    const int HashOffset = 0x4C;
+    const int FileInformationOffset = 0x54;
+
+    // Windows 10's second layout of version 30 moves the run count up by 8
+    const quint32 Version30CompactMetricsOffset = 0x128;
+
+    const qint64 TracePageSize = 4096;
+    // Real files are well under this even decompressed
+    const qint64 MaxPrefetchSize = 64 * 1024 * 1024;
+
+    quint32 read32(const uchar *p)
+    {
+        return qFromLittleEndian<quint32>(p);
+    }
+
+    quint64 read64(const uchar *p)
+    {
+        return qFromLittleEndian<quint64>(p);
+    }
+
+    // A FILETIME; 0 means the slot was never used
+    QDateTime fileTime(quint64 value)
+    {
+        if (value == 0)
+            return QDateTime();
+        return QDateTime::fromMSecsSinceEpoch(qint64(value / 10000) - 11644473600000LL);
+    }
+
+    // count UTF-16 characters at offset, cut at the first NUL
+    QString utf16String(const uchar *data, qint64 offset, qint64 count)
+    {
+        QString text;
+        for (qint64 i = 0; i < count; ++i)
+        {
+            ushort unit = qFromLittleEndian<quint16>(data + offset + 2 * i);
+            if (unit == 0)
+                break;
+            text.append(QChar(unit));
+        }
+        return text;
+    }
+
+    // Whether [offset, offset + length) lies within a buffer of size bytes
+    bool inBounds(qint64 offset, qint64 length, qint64 size)
+    {
+        return offset >= 0 && length >= 0 && offset <= size && length <= size - offset;
+    }
+}
+
+QDateTime PrefetchInfo::lastRun() const
+{
+    return lastRuns.isEmpty() ? QDateTime() : lastRuns.first();
+}
+
+int PrefetchInfo::runsSince(const QDateTime &time) const
+{
+    int count = 0;
+    for (const QDateTime &run : lastRuns)
+    {
+        if (run >= time)
+            ++count;
+    }
+    return count;
+}
+
+qint64 PrefetchInfo::estimatedReadBytes() const
+{
+    return qMin<qint64>(traceBlocks, LLONG_MAX / TracePageSize) * TracePageSize;
+}
+
+bool PrefetchParser::parse(const QByteArray &bytes, PrefetchInfo &info, QString &error)
+{
+    info = PrefetchInfo();
+
+    if (bytes.size() >= 8 && std::memcmp(bytes.constData(), CompressedSignature, 3) == 0)
+    {
+        QByteArray decompressed;
+        if (!decompress(bytes, decompressed, error))
+            return false;
+        return parse(decompressed, info, error);
+    }
+
+    const uchar *data = reinterpret_cast<const uchar *>(bytes.constData());
+    const qint64 size = bytes.size();
+
+    if (size < 0x98 || std::memcmp(data + 4, Signature, 4) != 0)
+    {
+        error = "Not a Prefetch file.";
+        return false;
+    }
+
+    info.version = int(read32(data));
+    int metricsEntrySize = 0;
+    int traceEntrySize = 0;
+    int traceCountOffset = 0;
+    int volumeEntrySize = 0;
+    int lastRunOffset = 0;
+    int lastRunCount = 1;
+    int runCountOffset = 0;
+
+    switch (info.version)
+    {
+    case 17:
+        metricsEntrySize = 20;
+        traceEntrySize = 12;
+        traceCountOffset = 4;
+        volumeEntrySize = 40;
+        lastRunOffset = 0x78;
+        runCountOffset = 0x90;
+        break;
+    case 23:
+        metricsEntrySize = 32;
+        traceEntrySize = 12;
+        traceCountOffset = 4;
+        volumeEntrySize = 104;
+        lastRunOffset = 0x80;
+        runCountOffset = 0x98;
+        break;
+    case 26:
+        metricsEntrySize = 32;
+        traceEntrySize = 12;
+        traceCountOffset = 4;
+        volumeEntrySize = 104;
+        lastRunOffset = 0x80;
+        lastRunCount = 8;
+        runCountOffset = 0xD0;
+        break;
+    case 30:
+    case 31:
+        metricsEntrySize = 32;
+        traceEntrySize = 8;
+        traceCountOffset = 0;
+        volumeEntrySize = 96;
+        lastRunOffset = 0x80;
+        lastRunCount = 8;
+        runCountOffset = read32(data + FileInformationOffset) == Version30CompactMetricsOffset ? 0xC8 : 0xD0;
+        break;
+    default:
+        error = QString("Unsupported Prefetch version %1.").arg(info.version);
+        return false;
+    }
+
+    if (!inBounds(runCountOffset, 4, size))
+    {
+        error = "The Prefetch header is truncated.";
+        return false;
+    }
+
+    info.executableName = utf16String(data, ExecutableNameOffset, ExecutableNameBytes / 2);
+    info.hash = read32(data + HashOffset);
+    info.runCount = int(qMin<quint32>(read32(data + runCountOffset), INT_MAX));
+
+    for (int i = 0; i < lastRunCount; ++i)
+    {
+        QDateTime time = fileTime(read64(data + lastRunOffset + 8 * i));
+        if (time.isValid())
+            info.lastRuns.append(time);
+    }
+
+    const uchar *fileInformation = data + FileInformationOffset;
+    const quint32 metricsOffset = read32(fileInformation);
+    const quint32 metricsCount = read32(fileInformation + 4);
+    const quint32 traceOffset = read32(fileInformation + 8);
+    const quint32 traceCount = read32(fileInformation + 12);
+    const quint32 stringsOffset = read32(fileInformation + 16);
+    const quint32 stringsSize = read32(fileInformation + 20);
+    const quint32 volumesOffset = read32(fileInformation + 24);
+    const quint32 volumeCount = read32(fileInformation + 28);
+    const quint32 volumesSize = read32(fileInformation + 32);
+
+    if (!inBounds(metricsOffset, qint64(metricsCount) * metricsEntrySize, size) ||
+        !inBounds(traceOffset, qint64(traceCount) * traceEntrySize, size) ||
+        !inBounds(stringsOffset, stringsSize, size) ||
+        !inBounds(volumesOffset, volumesSize, size) ||
+        qint64(volumeCount) * volumeEntrySize > volumesSize)
+    {
+        error = "A Prefetch section lies outside the file.";
+        return false;
+    }
+
+    // Names are byte offsets into the filename strings section, lengths in characters
+    const int nameOffsetField = info.version == 17 ? 8 : 12;
+    for (quint32 i = 0; i < metricsCount; ++i)
+    {
+        const uchar *entry = data + metricsOffset + qint64(i) * metricsEntrySize;
+        quint32 nameOffset = read32(entry + nameOffsetField);
+        quint32 nameLength = read32(entry + nameOffsetField + 4);
+        if (!inBounds(nameOffset, qint64(nameLength) * 2, stringsSize))
+        {
+            error = QString("File name %1 lies outside the strings section.").arg(i);
+            return false;
+        }
+        info.loadedFiles.append(utf16String(data, stringsOffset + qint64(nameOffset), nameLength));
+    }
+
+    for (quint32 i = 0; i < traceCount; ++i)
+        info.traceBlocks += read32(data + traceOffset + qint64(i) * traceEntrySize + traceCountOffset);
+
+    // Device paths are offsets from the start of the volumes section
+    for (quint32 i = 0; i < volumeCount; ++i)
+    {
+        const uchar *entry = data + volumesOffset + qint64(i) * volumeEntrySize;
+        quint32 pathOffset = read32(entry);
+        quint32 pathLength = read32(entry + 4);
+        if (!inBounds(pathOffset, qint64(pathLength) * 2, volumesSize))
+        {
+            error = QString("Volume %1 lies outside the volumes section.").arg(i);
+            return false;
+        }
+        info.volumes.append(utf16String(data, volumesOffset + qint64(pathOffset), pathLength));
+    }
+
+    return true;
+}
+
+bool PrefetchParser::decompress(const QByteArray &bytes, QByteArray &output, QString &error)
+{
+    const uchar *data = reinterpret_cast<const uchar *>(bytes.constData());
+    uchar format = data[3];
+    if ((format & 0x0F) != CompressionXpressHuffman)
+    {
+        error = QString("Unsupported Prefetch compression format %1.").arg(format & 0x0F);
+        return false;
+    }
+
+    // The checksum is skipped rather than verified; the decoder and the
+    // parser bounds-check everything they read instead
+    int headerSize = (format & CompressionHasChecksum) ? 12 : 8;
+    if (bytes.size() < headerSize)
+    {
+        error = "The compressed Prefetch header is truncated.";
+        return false;
+    }
+
+    quint32 outputSize = read32(data + 4);
+    if (outputSize > MaxPrefetchSize)
+    {
+        error = QString("Implausible Prefetch size %1.").arg(outputSize);
+        return false;
+    }
+
+    if (!XpressHuffman::decompress(bytes.mid(headerSize), outputSize, output, error))
+        return false;
+
+    // A compressed file wrapping another compressed file is not a Prefetch file
+    if (output.startsWith(QByteArray(CompressedSignature, 3)))
+    {
+        error = "Not a Prefetch file.";
+        return false;
+    }
+    return true;
+}
+
+bool PrefetchParser::parseFile(const QString &filePath, PrefetchInfo &info, QString &error)
+{
+    QFile file(filePath);
+    if (file.size() > MaxPrefetchSize)
+    {
+        error = QString("'%1' is too large to be a Prefetch file.").arg(filePath);
+        return false;
+    }
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = QString("'%1' could not be opened: %2").arg(filePath, file.errorString());
+        return false;
+    }
+    return parse(file.readAll(), info, error);
+}
+
+QHash<QString, PrefetchInfo> PrefetchParser::scanDirectory(const QString &directory)
+{
+    QHash<QString, PrefetchInfo> programs;
+    if (directory.isEmpty())
+        return programs;
+
+    QDir dir(directory);
+    for (const QString &fileName : dir.entryList(QStringList{"*.pf"}, QDir::Files))
+    {
+        PrefetchInfo info;
+        QString error;
+        if (!parseFile(dir.filePath(fileName), info, error) || info.executableName.isEmpty())
+            continue;
+
+        auto existing = programs.find(info.executableName);
+        if (existing == programs.end())
+        {
+            programs.insert(info.executableName, info);
+            continue;
+        }
+
+        // The most recently run copy describes the launch; counts and times add up
+        PrefetchInfo merged = info.lastRun() > existing->lastRun() ? info : *existing;
+        const PrefetchInfo &other = info.lastRun() > existing->lastRun() ? *existing : info;
+        merged.runCount = int(qMin<qint64>(qint64(merged.runCount) + other.runCount, INT_MAX));
+        merged.lastRuns.append(other.lastRuns);
+        std::sort(merged.lastRuns.begin(), merged.lastRuns.end(), [](const QDateTime &a, const QDateTime &b)
+                  { return a > b; });
+        *existing = merged;
+    }
+    return programs;
+}
+
+QString PrefetchParser::executableKey(const QString &executablePath)
+{
+    // Prefetch names are the upper-cased file name, cut to fit 30 UTF-16 units with the NUL
+    return QFileInfo(executablePath).fileName().toUpper().left(ExecutableNameBytes / 2 - 1);
+}
+
+QString PrefetchParser::defaultDirectory()
+{
+#ifdef Q_OS_WIN
+    return QDir::fromNativeSeparators(qEnvironmentVariable("SystemRoot", "C:\\Windows")) + "/Prefetch";
+#else
+    return QString();
+#endif
+}
@@ -0,0 +1,54 @@
+#ifndef PREFETCHPARSER_H
+#define PREFETCHPARSER_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QHash>
+
+// What a Prefetch (.pf) file records about one program's launches
+struct PrefetchInfo
+{
+    int version = 0;           // 17 (XP), 23 (Vista/7), 26 (8.1), 30/31 (10/11)
+    QString executableName;    // upper case, at most 29 characters
+    quint32 hash = 0;          // of the executable's path (and, for hosts, command line)
+    int runCount = 0;
+    QList<QDateTime> lastRuns; // newest first; up to eight from version 26 on
+    QStringList loadedFiles;   // device paths of the files read during launch
+    QStringList volumes;       // device paths of the volumes they are on
+    qint64 traceBlocks = 0;    // blocks the trace chains record as loaded
+
+    QDateTime lastRun() const;
+    // Recorded launches at or after time; at most as many as lastRuns holds
+    int runsSince(const QDateTime &time) const;
+    // Rough I/O footprint of one launch: the traced blocks taken as 4 KB pages
+    qint64 estimatedReadBytes() const;
+};
+
+// Reads the Prefetch files Windows keeps under %SystemRoot%\Prefetch, so
+// launch counts and times are known without auditing. Versions 17 to 31
+// are understood; Windows 8 and later store them XPRESS-Huffman compressed
+// behind a "MAM" header, which is undone here rather than through ntdll, so
+// the parser runs (and can be checked against sample files) on any OS.
+class PrefetchParser
+{
+public:
+    static bool parse(const QByteArray &bytes, PrefetchInfo &info, QString &error);
+    static bool parseFile(const QString &filePath, PrefetchInfo &info, QString &error);
+
+    // Every readable .pf file in a directory, keyed by executable name; a
+    // program started from several paths has one file per path, and those are
+    // merged into one record
+    static QHash<QString, PrefetchInfo> scanDirectory(const QString &directory);
+    // The key scanDirectory() uses for an executable path
+    static QString executableKey(const QString &executablePath);
+    // %SystemRoot%\Prefetch on Windows, empty elsewhere
+    static QString defaultDirectory();
+
+private:
+    static bool decompress(const QByteArray &bytes, QByteArray &output, QString &error);
+};
+
+#endif // PREFETCHPARSER_H
@@ -0,0 +1,153 @@
+#include "processsnapshot.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <tlhelp32.h>
+#elif defined(Q_OS_LINUX)
+#include <signal.h>
+#endif
+
+namespace
+{
+#ifdef Q_OS_WIN
+    QString imagePath(DWORD pid)
+    {
+        // Limited rights are enough for the image name and succeed for most processes
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!process)
+            return QString();
+
+        wchar_t buffer[MAX_PATH * 4];
+        DWORD length = DWORD(sizeof(buffer) / sizeof(buffer[0]));
+        QString path;
+        if (QueryFullProcessImageNameW(process, 0, buffer, &length))
+            path = QDir::fromNativeSeparators(QString::fromWCharArray(buffer, int(length)));
+
+        CloseHandle(process);
+        return path;
+    }
+
+    void captureProcesses(QList<ProcessInfo> &processes)
+    {
+        HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+        if (snapshot == INVALID_HANDLE_VALUE)
+            return;
+
+        PROCESSENTRY32W entry;
+        entry.dwSize = sizeof(entry);
+        if (Process32FirstW(snapshot, &entry))
+        {
+            do
+            {
+                ProcessInfo info;
+                info.pid = entry.th32ProcessID;
+                info.parentPid = entry.th32ParentProcessID;
+                info.name = QString::fromWCharArray(entry.szExeFile);
+                if (info.pid != 0)
+                    info.executablePath = imagePath(entry.th32ProcessID);
+                processes.append(info);
+            } while (Process32NextW(snapshot, &entry));
+        }
+
+        CloseHandle(snapshot);
+    }
+#elif defined(Q_OS_LINUX)
+    quint32 parentPid(const QString &procDir)
+    {
+        QFile stat(procDir + "/stat");
+        if (!stat.open(QIODevice::ReadOnly))
+            return 0;
+
+        // "pid (comm) state ppid ..."; comm may itself contain spaces or parentheses
+        QByteArray line = stat.readAll();
+        int end = line.lastIndexOf(')');
+        if (end < 0)
+            return 0;
+        QList<QByteArray> fields = line.mid(end + 2).split(' ');
+        return fields.size() > 1 ? fields[1].toUInt() : 0;
+    }
+
+    void captureProcesses(QList<ProcessInfo> &processes)
+    {
+        const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+        for (const QString &entry : entries)
+        {
+            bool isPid = false;
+            quint32 pid = entry.toUInt(&isPid);
+            if (!isPid)
+                continue;
+
+            QString procDir = "/proc/" + entry;
+
+            ProcessInfo info;
+            info.pid = pid;
+            info.parentPid = parentPid(procDir);
+
+            // Unreadable for other users' processes; kernel threads have no exe
+            QString executable = QFile::symLinkTarget(procDir + "/exe");
+            if (executable.endsWith(" (deleted)"))
+                executable.chop(10);
+            info.executablePath = executable;
+
+            if (!executable.isEmpty())
+            {
+                info.name = QFileInfo(executable).fileName();
+            }
+            else
+            {
+                QFile comm(procDir + "/comm");
+                if (comm.open(QIODevice::ReadOnly))
+                    info.name = QString::fromLocal8Bit(comm.readAll()).trimmed();
+            }
+
+            // The process may have exited between listing and reading
+            if (!info.name.isEmpty())
+                processes.append(info);
+        }
+    }
+#else
+    void captureProcesses(QList<ProcessInfo> &processes)
+    {
+        Q_UNUSED(processes);
+    }
+#endif
+}
+
+ProcessSnapshot ProcessSnapshot::capture()
+{
+    ProcessSnapshot snapshot;
+    snapshot.m_capturedAt = QDateTime::currentDateTime();
+    captureProcesses(snapshot.m_processes);
+    return snapshot;
+}
+
+const QList<ProcessInfo> &ProcessSnapshot::processes() const
+{
+    return m_processes;
+}
+
+QDateTime ProcessSnapshot::capturedAt() const
+{
+    return m_capturedAt;
+}
+
+bool ProcessSnapshot::terminate(quint32 pid)
+{
+#ifdef Q_OS_WIN
+    HANDLE process = OpenProcess(PROCESS_TERMINATE, FALSE, pid);
+    if (!process)
+        return false;
+
+    bool terminated = TerminateProcess(process, 0);
+    CloseHandle(process);
+    return terminated;
+#elif defined(Q_OS_LINUX)
+    return ::kill(pid_t(pid), SIGTERM) == 0;
+#else
+    Q_UNUSED(pid);
+    return false;
+#endif
+}
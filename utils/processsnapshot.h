@@ -0,0 +1,34 @@
+#ifndef PROCESSSNAPSHOT_H
+#define PROCESSSNAPSHOT_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+
+struct ProcessInfo
+{
+    quint32 pid = 0;
+    quint32 parentPid = 0;
+    QString name;           // executable file name
+    QString executablePath; // empty when the process could not be queried
+};
+
+// The running processes with their executable paths, taken in one pass:
+// a Toolhelp snapshot plus QueryFullProcessImageName on Windows, /proc on
+// Linux. Processes of other users or protected processes keep an empty path.
+class ProcessSnapshot
+{
+public:
+    static ProcessSnapshot capture();
+
+    const QList<ProcessInfo> &processes() const;
+    QDateTime capturedAt() const;
+
+    static bool terminate(quint32 pid);
+
+private:
+    QList<ProcessInfo> m_processes;
+    QDateTime m_capturedAt;
+};
+
+#endif // PROCESSSNAPSHOT_H
@@ -0,0 +1,350 @@
+#include "registryhive.h"
+#include <QtEndian>
+
+namespace
+{
+    // Cell offsets are relative to the first hive bin, which follows the base block
+    const qint64 BaseBlockSize = 4096;
+    const quint32 RootCellOffsetPosition = 0x24;
+    const quint32 InlineDataFlag = 0x80000000;
+    const quint32 BigDataSegmentSize = 16344;
+    const int MaxIndexDepth = 8;
+
+    const quint16 KeyNameCompressed = 0x0020;
+    const quint16 ValueNameCompressed = 0x0001;
+
+    const quint32 TypeString = 1;
+    const quint32 TypeExpandString = 2;
+    const quint32 TypeDword = 4;
+    const quint32 TypeDwordBigEndian = 5;
+    const quint32 TypeMultiString = 7;
+    const quint32 TypeQword = 11;
+
+    quint16 read16(const uchar *p)
+    {
+        return qFromLittleEndian<quint16>(p);
+    }
+
+    quint32 read32(const uchar *p)
+    {
+        return qFromLittleEndian<quint32>(p);
+    }
+
+    bool hasSignature(const uchar *p, quint32 size, const char *signature)
+    {
+        return size >= 2 && p[0] == uchar(signature[0]) && p[1] == uchar(signature[1]);
+    }
+
+    QString fromUtf16LE(const uchar *p, int byteCount)
+    {
+        QString text;
+        text.resize(byteCount / 2);
+        for (int i = 0; i < text.size(); ++i)
+            text[i] = QChar(read16(p + 2 * i));
+        return text;
+    }
+}
+
+RegistryHive::RegistryHive()
+    : m_data(nullptr), m_size(0), m_rootKey(0)
+{
+}
+
+RegistryHive::~RegistryHive()
+{
+    close();
+}
+
+bool RegistryHive::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+    {
+        m_buffer = m_file.readAll();
+        m_data = reinterpret_cast<const uchar *>(m_buffer.constData());
+        m_size = m_buffer.size();
+    }
+
+    if (m_size < BaseBlockSize || qstrncmp(reinterpret_cast<const char *>(m_data), "regf", 4) != 0)
+    {
+        m_error = "Not a registry hive file";
+        close();
+        return false;
+    }
+
+    m_rootKey = read32(m_data + RootCellOffsetPosition);
+    quint32 rootSize = 0;
+    if (!keyCell(m_rootKey, &rootSize))
+    {
+        m_error = "The hive's root key is damaged";
+        close();
+        return false;
+    }
+
+    m_error.clear();
+    return true;
+}
+
+void RegistryHive::close()
+{
+    if (m_file.isOpen())
+    {
+        if (m_buffer.isEmpty() && m_data)
+            m_file.unmap(const_cast<uchar *>(m_data));
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_rootKey = 0;
+}
+
+bool RegistryHive::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString RegistryHive::errorString() const
+{
+    return m_error;
+}
+
+quint32 RegistryHive::rootKey() const
+{
+    return m_rootKey;
+}
+
+quint32 RegistryHive::findKey(const QString &path) const
+{
+    quint32 key = m_rootKey;
+    for (const QString &name : path.split('\\', Qt::SkipEmptyParts))
+    {
+        key = findSubkey(key, name);
+        if (!key)
+            break;
+    }
+    return key;
+}
+
+quint32 RegistryHive::findSubkey(quint32 key, const QString &name) const
+{
+    for (quint32 subkey : subkeys(key))
+    {
+        if (keyName(subkey).compare(name, Qt::CaseInsensitive) == 0)
+            return subkey;
+    }
+    return 0;
+}
+
+QString RegistryHive::keyName(quint32 key) const
+{
+    quint32 size = 0;
+    const uchar *nk = keyCell(key, &size);
+    if (!nk)
+        return QString();
+
+    quint16 length = read16(nk + 72);
+    if (76 + quint32(length) > size)
+        return QString();
+    return cellName(nk + 76, length, read16(nk + 2) & KeyNameCompressed);
+}
+
+qint64 RegistryHive::lastWriteTime(quint32 key) const
+{
+    quint32 size = 0;
+    const uchar *nk = keyCell(key, &size);
+    return nk ? qint64(qFromLittleEndian<quint64>(nk + 4)) : 0;
+}
+
+QList<quint32> RegistryHive::subkeys(quint32 key) const
+{
+    QList<quint32> keys;
+    quint32 size = 0;
+    const uchar *nk = keyCell(key, &size);
+    if (nk && read32(nk + 20) > 0)
+        collectSubkeys(read32(nk + 28), keys, 0);
+    return keys;
+}
+
+QVariantMap RegistryHive::values(quint32 key) const
+{
+    QVariantMap result;
+    quint32 size = 0;
+    const uchar *nk = keyCell(key, &size);
+    if (!nk)
+        return result;
+
+    quint32 count = read32(nk + 36);
+    quint32 listSize = 0;
+    const uchar *list = count > 0 ? cell(read32(nk + 40), &listSize) : nullptr;
+    if (!list)
+        return result;
+
+    count = qMin(count, listSize / 4);
+    for (quint32 i = 0; i < count; ++i)
+    {
+        quint32 vkSize = 0;
+        const uchar *vk = cell(read32(list + 4 * i), &vkSize);
+        if (!vk || vkSize < 20 || !hasSignature(vk, vkSize, "vk"))
+            continue;
+
+        quint16 nameLength = read16(vk + 2);
+        if (20 + quint32(nameLength) > vkSize)
+            continue;
+
+        QString name = cellName(vk + 20, nameLength, read16(vk + 16) & ValueNameCompressed);
+        result.insert(name, decodeValue(read32(vk + 12), valueBytes(vk)));
+    }
+    return result;
+}
+
+const uchar *RegistryHive::cell(quint32 offset, quint32 *size) const
+{
+    qint64 position = BaseBlockSize + qint64(offset);
+    if (!m_data || offset == 0xFFFFFFFF || position + 4 > m_size)
+        return nullptr;
+
+    // Allocated cells store their size negated
+    qint32 rawSize = qint32(read32(m_data + position));
+    if (rawSize >= -4 || position - qint64(rawSize) > m_size)
+        return nullptr;
+
+    *size = quint32(-rawSize) - 4;
+    return m_data + position + 4;
+}
+
+const uchar *RegistryHive::keyCell(quint32 key, quint32 *size) const
+{
+    const uchar *nk = cell(key, size);
+    if (!nk || *size < 76 || !hasSignature(nk, *size, "nk"))
+        return nullptr;
+    return nk;
+}
+
+void RegistryHive::collectSubkeys(quint32 listOffset, QList<quint32> &keys, int depth) const
+{
+    quint32 size = 0;
+    const uchar *list = cell(listOffset, &size);
+    if (!list || size < 4 || depth > MaxIndexDepth)
+        return;
+
+    quint32 count = read16(list + 2);
+    if (hasSignature(list, size, "lf") || hasSignature(list, size, "lh"))
+    {
+        // Offset and name hash pairs
+        count = qMin(count, (size - 4) / 8);
+        for (quint32 i = 0; i < count; ++i)
+            keys.append(read32(list + 4 + 8 * i));
+    }
+    else if (hasSignature(list, size, "li"))
+    {
+        count = qMin(count, (size - 4) / 4);
+        for (quint32 i = 0; i < count; ++i)
+            keys.append(read32(list + 4 + 4 * i));
+    }
+    else if (hasSignature(list, size, "ri"))
+    {
+        // Index root: a list of lists, used by keys with many subkeys
+        count = qMin(count, (size - 4) / 4);
+        for (quint32 i = 0; i < count; ++i)
+            collectSubkeys(read32(list + 4 + 4 * i), keys, depth + 1);
+    }
+}
+
+QByteArray RegistryHive::valueBytes(const uchar *vk) const
+{
+    quint32 length = read32(vk + 4);
+    quint32 offset = read32(vk + 8);
+
+    // Up to four bytes live in the offset field itself
+    if (length & InlineDataFlag)
+    {
+        length &= ~InlineDataFlag;
+        return QByteArray(reinterpret_cast<const char *>(vk + 8), int(qMin<quint32>(length, 4)));
+    }
+
+    quint32 dataSize = 0;
+    const uchar *data = cell(offset, &dataSize);
+    if (!data)
+        return QByteArray();
+
+    if (length <= BigDataSegmentSize || !hasSignature(data, dataSize, "db"))
+        return QByteArray(reinterpret_cast<const char *>(data), int(qMin(length, dataSize)));
+
+    // Big data: a list of segments of at most 16344 bytes each
+    quint32 segmentCount = dataSize >= 8 ? read16(data + 2) : 0;
+    quint32 listSize = 0;
+    const uchar *segments = segmentCount ? cell(read32(data + 4), &listSize) : nullptr;
+    if (!segments)
+        return QByteArray();
+
+    QByteArray result;
+    result.reserve(int(length));
+    segmentCount = qMin(segmentCount, listSize / 4);
+    for (quint32 i = 0; i < segmentCount && quint32(result.size()) < length; ++i)
+    {
+        quint32 segmentSize = 0;
+        const uchar *segment = cell(read32(segments + 4 * i), &segmentSize);
+        if (!segment)
+            return QByteArray();
+
+        quint32 take = qMin(qMin(segmentSize, BigDataSegmentSize), length - quint32(result.size()));
+        result.append(reinterpret_cast<const char *>(segment), int(take));
+    }
+    return result;
+}
+
+QString RegistryHive::cellName(const uchar *name, int length, bool compressed)
+{
+    // "Compressed" names are stored one byte per character
+    if (compressed)
+        return QString::fromLatin1(reinterpret_cast<const char *>(name), length);
+    return fromUtf16LE(name, length);
+}
+
+QVariant RegistryHive::decodeValue(quint32 type, const QByteArray &data)
+{
+    const uchar *bytes = reinterpret_cast<const uchar *>(data.constData());
+
+    switch (type)
+    {
+    case TypeString:
+    case TypeExpandString:
+    {
+        // Stored strings usually, but not always, include the terminator
+        QString value = fromUtf16LE(bytes, data.size());
+        int end = value.indexOf(QChar(0));
+        return end >= 0 ? value.left(end) : value;
+    }
+    case TypeMultiString:
+    {
+        QStringList parts = fromUtf16LE(bytes, data.size()).split(QChar(0));
+        parts.removeAll(QString());
+        return parts;
+    }
+    case TypeDword:
+        if (data.size() >= 4)
+            return qlonglong(read32(bytes));
+        return QVariant();
+    case TypeDwordBigEndian:
+        if (data.size() >= 4)
+            return qlonglong(qFromBigEndian<quint32>(bytes));
+        return QVariant();
+    case TypeQword:
+        if (data.size() >= 8)
+            return qlonglong(qFromLittleEndian<quint64>(bytes));
+        return QVariant();
+    default:
+        return data;
+    }
+}
@@ -0,0 +1,61 @@
+#ifndef REGISTRYHIVE_H
+#define REGISTRYHIVE_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QVariantMap>
+#include <QFile>
+#include <QByteArray>
+
+// Read-only parser for registry hive files (regf), such as an offline copy
+// of SOFTWARE or NTUSER.DAT or the hives of a mounted disk image. The file
+// is memory-mapped and keys and values are decoded straight from their nk
+// and vk cells, so whole keys can be read in one pass without the Windows
+// registry API. Every cell offset is bounds-checked; damaged cells are
+// skipped. Transaction logs (.LOG1/.LOG2) of a dirty hive are not replayed.
+//
+// Keys are identified by their cell offset; 0 means "no key".
+class RegistryHive
+{
+public:
+    RegistryHive();
+    ~RegistryHive();
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    quint32 rootKey() const;
+    // Backslash-separated path below the root, matched case-insensitively
+    quint32 findKey(const QString &path) const;
+    quint32 findSubkey(quint32 key, const QString &name) const;
+
+    QString keyName(quint32 key) const;
+    qint64 lastWriteTime(quint32 key) const; // FILETIME, as RegEnumKeyEx reports it
+    QList<quint32> subkeys(quint32 key) const;
+
+    // REG_SZ/EXPAND_SZ as QString, MULTI_SZ as QStringList, DWORD/QWORD as
+    // qlonglong, anything else as QByteArray; the default value is ""
+    QVariantMap values(quint32 key) const;
+
+private:
+    Q_DISABLE_COPY(RegistryHive)
+
+    QFile m_file;
+    QByteArray m_buffer; // used when the file cannot be mapped
+    const uchar *m_data;
+    qint64 m_size;
+    quint32 m_rootKey;
+    QString m_error;
+
+    const uchar *cell(quint32 offset, quint32 *size) const;
+    const uchar *keyCell(quint32 key, quint32 *size) const;
+    void collectSubkeys(quint32 listOffset, QList<quint32> &keys, int depth) const;
+    QByteArray valueBytes(const uchar *vk) const;
+    static QString cellName(const uchar *name, int length, bool compressed);
+    static QVariant decodeValue(quint32 type, const QByteArray &data);
+};
+
+#endif // REGISTRYHIVE_H
@@ -0,0 +1,194 @@
+#include "registryinventorysource.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <QVector>
+
+namespace
+{
+    HKEY openUninstallKey(const QString &registryPath)
+    {
+        int separator = registryPath.indexOf('\\');
+        QString rootName = registryPath.left(separator);
+        QString subPath = registryPath.mid(separator + 1);
+
+        HKEY root = nullptr;
+        if (rootName == "HKEY_LOCAL_MACHINE")
+            root = HKEY_LOCAL_MACHINE;
+        else if (rootName == "HKEY_CURRENT_USER")
+            root = HKEY_CURRENT_USER;
+        else
+            return nullptr;
+
+        HKEY key = nullptr;
+        if (RegOpenKeyExW(root, reinterpret_cast<const wchar_t *>(subPath.utf16()), 0, KEY_READ, &key) != ERROR_SUCCESS)
+            return nullptr;
+        return key;
+    }
+
+    qint64 fileTimeToStamp(const FILETIME &time)
+    {
+        return (qint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
+
+    QVariant registryValue(DWORD type, const QByteArray &data)
+    {
+        const wchar_t *text = reinterpret_cast<const wchar_t *>(data.constData());
+        int textLength = data.size() / int(sizeof(wchar_t));
+
+        switch (type)
+        {
+        case REG_SZ:
+        case REG_EXPAND_SZ:
+        {
+            // Stored strings usually, but not always, include the terminator
+            QString value = QString::fromWCharArray(text, textLength);
+            int end = value.indexOf(QChar(0));
+            return end >= 0 ? value.left(end) : value;
+        }
+        case REG_MULTI_SZ:
+        {
+            QStringList parts = QString::fromWCharArray(text, textLength).split(QChar(0));
+            parts.removeAll(QString());
+            return parts;
+        }
+        case REG_DWORD:
+            if (data.size() >= int(sizeof(quint32)))
+                return qlonglong(*reinterpret_cast<const quint32 *>(data.constData()));
+            return QVariant();
+        case REG_QWORD:
+            if (data.size() >= int(sizeof(quint64)))
+                return qlonglong(*reinterpret_cast<const quint64 *>(data.constData()));
+            return QVariant();
+        default:
+            return data;
+        }
+    }
+
+    bool readSubkey(HKEY parent, const QString &name, InventoryRecord &record)
+    {
+        HKEY key = nullptr;
+        if (RegOpenKeyExW(parent, reinterpret_cast<const wchar_t *>(name.utf16()), 0, KEY_READ, &key) != ERROR_SUCCESS)
+            return false;
+
+        DWORD valueCount = 0;
+        DWORD maxNameLength = 0;
+        DWORD maxDataLength = 0;
+        FILETIME writeTime;
+        if (RegQueryInfoKeyW(key, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
+                             &valueCount, &maxNameLength, &maxDataLength, nullptr, &writeTime) != ERROR_SUCCESS)
+        {
+            RegCloseKey(key);
+            return false;
+        }
+
+        record.key = name;
+        record.lastWriteTime = fileTimeToStamp(writeTime);
+
+        QVector<wchar_t> valueName(int(maxNameLength) + 1);
+        QByteArray data(int(maxDataLength) + sizeof(wchar_t), '\0');
+        for (DWORD i = 0; i < valueCount; ++i)
+        {
+            DWORD nameLength = maxNameLength + 1;
+            DWORD dataLength = DWORD(data.size());
+            DWORD type = 0;
+            LONG status = RegEnumValueW(key, i, valueName.data(), &nameLength, nullptr, &type,
+                                        reinterpret_cast<BYTE *>(data.data()), &dataLength);
+            if (status == ERROR_NO_MORE_ITEMS)
+                break;
+            if (status != ERROR_SUCCESS)
+                continue;
+
+            record.values.insert(QString::fromWCharArray(valueName.data(), int(nameLength)),
+                                 registryValue(type, data.left(int(dataLength))));
+        }
+
+        RegCloseKey(key);
+        return true;
+    }
+}
+#endif
+
+RegistryInventorySource::RegistryInventorySource(const QString &registryPath)
+    : m_registryPath(registryPath)
+{
+}
+
+QString RegistryInventorySource::id() const
+{
+    return m_registryPath;
+}
+
+bool RegistryInventorySource::listEntries(QList<QPair<QString, qint64>> &entries) const
+{
+#ifdef Q_OS_WIN
+    HKEY key = openUninstallKey(m_registryPath);
+    if (!key)
+        return false;
+
+    DWORD subkeyCount = 0;
+    DWORD maxNameLength = 0;
+    if (RegQueryInfoKeyW(key, nullptr, nullptr, nullptr, &subkeyCount, &maxNameLength,
+                         nullptr, nullptr, nullptr, nullptr, nullptr, nullptr) != ERROR_SUCCESS)
+    {
+        RegCloseKey(key);
+        return false;
+    }
+
+    // Enumerating subkeys returns their last write times without reading any values
+    QVector<wchar_t> name(int(maxNameLength) + 1);
+    for (DWORD i = 0; i < subkeyCount; ++i)
+    {
+        DWORD nameLength = maxNameLength + 1;
+        FILETIME writeTime;
+        LONG status = RegEnumKeyExW(key, i, name.data(), &nameLength, nullptr, nullptr, nullptr, &writeTime);
+        if (status == ERROR_NO_MORE_ITEMS)
+            break;
+        if (status != ERROR_SUCCESS)
+            continue;
+
+        entries.append(qMakePair(QString::fromWCharArray(name.data(), int(nameLength)), fileTimeToStamp(writeTime)));
+    }
+
+    RegCloseKey(key);
+    return true;
+#else
+    Q_UNUSED(entries);
+    return false;
+#endif
+}
+
+QList<InventoryRecord> RegistryInventorySource::readEntries(const QStringList &keys) const
+{
+    QList<InventoryRecord> records;
+
+#ifdef Q_OS_WIN
+    QStringList names = keys;
+    if (names.isEmpty())
+    {
+        QList<QPair<QString, qint64>> entries;
+        listEntries(entries);
+        for (const QPair<QString, qint64> &entry : entries)
+        {
+            names.append(entry.first);
+        }
+    }
+
+    HKEY parent = openUninstallKey(m_registryPath);
+    if (!parent)
+        return records;
+
+    for (const QString &name : names)
+    {
+        InventoryRecord record;
+        if (readSubkey(parent, name, record))
+            records.append(record);
+    }
+
+    RegCloseKey(parent);
+#else
+    Q_UNUSED(keys);
+#endif
+
+    return records;
+}
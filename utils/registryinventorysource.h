@@ -0,0 +1,23 @@
+#ifndef REGISTRYINVENTORYSOURCE_H
+#define REGISTRYINVENTORYSOURCE_H
+
+#include "inventorysource.h"
+
+// An Uninstall key of the Windows registry, e.g.
+// "HKEY_LOCAL_MACHINE\SOFTWARE\Microsoft\Windows\CurrentVersion\Uninstall".
+// Subkeys are listed with their last write times; each subkey's values are
+// read with one RegEnumValue pass instead of one lookup per value.
+class RegistryInventorySource : public InventorySource
+{
+public:
+    explicit RegistryInventorySource(const QString &registryPath);
+
+    QString id() const override;
+    bool listEntries(QList<QPair<QString, qint64>> &entries) const override;
+    QList<InventoryRecord> readEntries(const QStringList &keys) const override;
+
+private:
+    QString m_registryPath;
+};
+
+#endif // REGISTRYINVENTORYSOURCE_H
@@ -0,0 +1,79 @@
+#include "registrystartupsource.h"
+#include <QSettings>
+
+RegistryStartupSource::RegistryStartupSource(const QString &registryPath)
+    : m_registryPath(registryPath)
+{
+}
+
+QString RegistryStartupSource::id() const
+{
+    return "registry:" + m_registryPath;
+}
+
+QList<StartupProgram> RegistryStartupSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+#ifdef Q_OS_WIN
+    // Entries in the Run key are enabled, entries in RunDisabled are not
+    const QString paths[] = {m_registryPath, m_registryPath + "Disabled"};
+    for (const QString &path : paths)
+    {
+        bool enabled = path == m_registryPath;
+        QSettings registry(path, QSettings::NativeFormat);
+        for (const QString &key : registry.childKeys())
+        {
+            QString value = registry.value(key).toString();
+            if (enabled && value.isEmpty())
+                continue;
+
+            StartupProgram program;
+            program.name = key;
+            program.status = enabled ? "Enabled" : "Disabled";
+            program.startupType = "Registry";
+            program.command = value;
+            program.location = enabled ? m_registryPath : m_registryPath + " (Disabled)";
+            program.isEnabled = enabled;
+            program.source = id();
+            programs.append(program);
+        }
+    }
+#endif
+
+    return programs;
+}
+
+bool RegistryStartupSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+#ifdef Q_OS_WIN
+    QSettings registry(m_registryPath, QSettings::NativeFormat);
+    QSettings disabledReg(m_registryPath + "Disabled", QSettings::NativeFormat);
+
+    // Task Manager moves entries between the Run key and its "Disabled" sibling
+    QSettings &from = enable ? disabledReg : registry;
+    QSettings &to = enable ? registry : disabledReg;
+    if (!from.contains(program.name))
+    {
+        error = QString("'%1' was not found in %2.").arg(program.name, enable ? "the disabled registry" : "the registry");
+        return false;
+    }
+
+    to.setValue(program.name, from.value(program.name));
+    to.sync();
+    if (to.status() != QSettings::NoError)
+    {
+        error = "The registry could not be written. Please ensure you're running as Administrator.";
+        return false;
+    }
+
+    from.remove(program.name);
+    from.sync();
+    return true;
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(enable);
+    error = "The registry is only available on Windows.";
+    return false;
+#endif
+}
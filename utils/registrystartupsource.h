@@ -0,0 +1,23 @@
+#ifndef REGISTRYSTARTUPSOURCE_H
+#define REGISTRYSTARTUPSOURCE_H
+
+#include "startupsource.h"
+
+// A Run key of the live registry, e.g.
+// "HKEY_CURRENT_USER\Software\Microsoft\Windows\CurrentVersion\Run".
+// Disabled entries live in the sibling "RunDisabled" key, where Task
+// Manager style disabling moves them.
+class RegistryStartupSource : public StartupSource
+{
+public:
+    explicit RegistryStartupSource(const QString &registryPath);
+
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+
+private:
+    QString m_registryPath;
+};
+
+#endif // REGISTRYSTARTUPSOURCE_H
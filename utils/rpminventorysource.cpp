@@ -0,0 +1,218 @@
+#include "rpminventorysource.h"
+#include "sqlitetablereader.h"
+#include <QDateTime>
+#include <QFileInfo>
+#include <QSet>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    // Header tags, from rpmtag.h
+    const quint32 TagName = 1000;
+    const quint32 TagVersion = 1001;
+    const quint32 TagRelease = 1002;
+    const quint32 TagInstallTime = 1008;
+    const quint32 TagSize = 1009;
+    const quint32 TagVendor = 1011;
+    const quint32 TagPackager = 1015;
+    const quint32 TagArch = 1022;
+    const quint32 TagLongSize = 5009;
+
+    const quint32 TypeInt32 = 4;
+    const quint32 TypeInt64 = 5;
+    const quint32 TypeString = 6;
+    const quint32 TypeStringArray = 8;
+    const quint32 TypeI18nString = 9;
+
+    struct RpmHeader
+    {
+        QString name;
+        QString version;
+        QString release;
+        QString arch;
+        QString vendor;
+        QString packager;
+        qint64 installTime = 0;
+        qint64 size = 0;
+    };
+
+    // A stored header: index entry count, data size, 16-byte index entries
+    // (tag, type, offset, count; all big-endian) and the data they point into
+    bool parseHeader(const QByteArray &blob, RpmHeader &header)
+    {
+        const uchar *data = reinterpret_cast<const uchar *>(blob.constData());
+        if (blob.size() < 8)
+            return false;
+
+        quint32 entryCount = qFromBigEndian<quint32>(data);
+        quint32 storeSize = qFromBigEndian<quint32>(data + 4);
+        quint64 storeStart = 8 + quint64(entryCount) * 16;
+        if (storeStart + storeSize > quint64(blob.size()))
+            return false;
+
+        const uchar *store = data + storeStart;
+        for (quint32 i = 0; i < entryCount; ++i)
+        {
+            const uchar *entry = data + 8 + 16 * i;
+            quint32 tag = qFromBigEndian<quint32>(entry);
+            quint32 type = qFromBigEndian<quint32>(entry + 4);
+            quint32 offset = qFromBigEndian<quint32>(entry + 8);
+            if (offset >= storeSize)
+                continue;
+
+            const uchar *value = store + offset;
+            quint32 available = storeSize - offset;
+
+            if (type == TypeString || type == TypeStringArray || type == TypeI18nString)
+            {
+                // The first string; translations and array items follow it
+                const void *terminator = std::memchr(value, 0, available);
+                int length = terminator ? int(static_cast<const uchar *>(terminator) - value) : int(available);
+                QString text = QString::fromUtf8(reinterpret_cast<const char *>(value), length);
+
+                switch (tag)
+                {
+                case TagName: header.name = text; break;
+                case TagVersion: header.version = text; break;
+                case TagRelease: header.release = text; break;
+                case TagArch: header.arch = text; break;
+                case TagVendor: header.vendor = text; break;
+                case TagPackager: header.packager = text; break;
+                default: break;
+                }
+            }
+            else if (type == TypeInt32 && available >= 4)
+            {
+                if (tag == TagInstallTime)
+                    header.installTime = qFromBigEndian<quint32>(value);
+                else if (tag == TagSize && header.size == 0)
+                    header.size = qFromBigEndian<quint32>(value);
+            }
+            else if (type == TypeInt64 && available >= 8 && tag == TagLongSize)
+            {
+                header.size = qint64(qFromBigEndian<quint64>(value));
+            }
+        }
+        return !header.name.isEmpty();
+    }
+
+    // Run through pkexec, which asks for authorization itself, and without
+    // prompts because there is no terminal to answer them on. Empty without
+    // pkexec: such entries cannot be uninstalled from here.
+    QString removeCommand()
+    {
+        if (QStandardPaths::findExecutable("pkexec").isEmpty())
+            return QString();
+        if (QFileInfo::exists("/usr/bin/dnf"))
+            return "pkexec /usr/bin/dnf remove -y ";
+        if (QFileInfo::exists("/usr/bin/zypper"))
+            return "pkexec /usr/bin/zypper --non-interactive remove ";
+        return "pkexec /usr/bin/rpm -e ";
+    }
+}
+
+RpmInventorySource::RpmInventorySource(const QString &databasePath)
+    : m_databasePath(databasePath)
+{
+}
+
+QString RpmInventorySource::id() const
+{
+    return "rpm:" + m_databasePath;
+}
+
+bool RpmInventorySource::listEntries(QList<QPair<QString, qint64>> &entries) const
+{
+    if (!QFileInfo(m_databasePath).isFile())
+        return false;
+
+    for (const InventoryRecord &record : parseDatabase())
+    {
+        entries.append(qMakePair(record.key, record.lastWriteTime));
+    }
+    return true;
+}
+
+QList<InventoryRecord> RpmInventorySource::readEntries(const QStringList &keys) const
+{
+    QList<InventoryRecord> records = parseDatabase();
+    if (keys.isEmpty())
+        return records;
+
+    QSet<QString> wanted(keys.begin(), keys.end());
+    QList<InventoryRecord> selected;
+    for (const InventoryRecord &record : records)
+    {
+        if (wanted.contains(record.key))
+            selected.append(record);
+    }
+    return selected;
+}
+
+QString RpmInventorySource::defaultDatabasePath()
+{
+    // /var/lib/rpm is a compatibility symlink on newer systems
+    const char *paths[] = {"/usr/lib/sysimage/rpm/rpmdb.sqlite", "/var/lib/rpm/rpmdb.sqlite"};
+    for (const char *path : paths)
+    {
+        if (QFileInfo(path).isFile())
+            return path;
+    }
+    return paths[1];
+}
+
+bool RpmInventorySource::isAvailable()
+{
+    return QFileInfo(defaultDatabasePath()).isFile();
+}
+
+QList<InventoryRecord> RpmInventorySource::parseDatabase() const
+{
+    QList<InventoryRecord> records;
+
+    SqliteTableReader database;
+    if (!database.open(m_databasePath))
+        return records;
+
+    quint32 rootPage = database.tableRootPage("Packages");
+    if (!rootPage)
+        return records;
+
+    QString uninstallPrefix = removeCommand();
+
+    // Packages (hnum INTEGER PRIMARY KEY, blob BLOB): the header is column 1
+    database.readTable(rootPage, [&](qint64, const QVariantList &columns)
+                       {
+                           RpmHeader header;
+                           if (columns.size() < 2 || !parseHeader(columns[1].toByteArray(), header))
+                               return true;
+
+                           // Imported signing keys are listed as packages
+                           if (header.name == "gpg-pubkey")
+                               return true;
+
+                           InventoryRecord record;
+                           record.key = header.name + "-" + header.version + "-" + header.release +
+                                        (header.arch.isEmpty() ? QString() : "." + header.arch);
+                           // Upgrades reinstall the package, so the install time changes with it
+                           record.lastWriteTime = header.installTime * 1000;
+
+                           record.values.insert("DisplayName", header.name);
+                           record.values.insert("DisplayVersion", header.version + "-" + header.release);
+                           record.values.insert("Publisher", header.vendor.isEmpty() ? header.packager : header.vendor);
+                           // Bytes in the header, KB in EstimatedSize
+                           record.values.insert("EstimatedSize", (header.size + 1023) / 1024);
+                           // The full name-version-release.arch, so one of several installed versions can be removed
+                           if (!uninstallPrefix.isEmpty())
+                               record.values.insert("UninstallString", uninstallPrefix + record.key);
+                           if (header.installTime > 0)
+                               record.values.insert("InstallDate", QDateTime::fromSecsSinceEpoch(header.installTime).toString("yyyyMMdd"));
+                           record.values.insert("SystemComponent", 0);
+
+                           records.append(record);
+                           return true; });
+
+    return records;
+}
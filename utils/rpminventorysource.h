@@ -0,0 +1,29 @@
+#ifndef RPMINVENTORYSOURCE_H
+#define RPMINVENTORYSOURCE_H
+
+#include "inventorysource.h"
+
+// Installed RPM packages, read from the SQLite rpm database (Fedora 33+,
+// RHEL 9+) through SqliteTableReader, without running rpm. Each package
+// header blob is decoded for its name, version, vendor, size and install
+// time, mapped onto the registry value names like DpkgInventorySource does.
+// The older Berkeley DB and ndb database formats are not read.
+class RpmInventorySource : public InventorySource
+{
+public:
+    explicit RpmInventorySource(const QString &databasePath = defaultDatabasePath());
+
+    QString id() const override;
+    bool listEntries(QList<QPair<QString, qint64>> &entries) const override;
+    QList<InventoryRecord> readEntries(const QStringList &keys) const override;
+
+    static QString defaultDatabasePath();
+    static bool isAvailable();
+
+private:
+    QString m_databasePath;
+
+    QList<InventoryRecord> parseDatabase() const;
+};
+
+#endif // RPMINVENTORYSOURCE_H
@@ -0,0 +1,111 @@
+#include "scheduledtaskstartupsource.h"
+#include "csvstreamparser.h"
+#include <QDebug>
+#include <QProcess>
+#include <QStringList>
+
+namespace
+{
+    // schtasks can go quiet for a while on large task libraries; only silence this long counts as hung
+    const int IdleTimeoutMs = 10000;
+
+    // Rows of "schtasks /query /fo csv /nh": TaskName, Next Run Time, Status
+    void addTask(QList<StartupProgram> &programs, const CsvStreamParser::Row &row, const QString &sourceId)
+    {
+        if (row.size() < 3)
+            return;
+
+        QString taskName = row.text(0);
+
+        // Tasks that run at startup or logon, leaving Windows' own alone
+        if ((taskName.contains("Startup", Qt::CaseInsensitive) ||
+             taskName.contains("Logon", Qt::CaseInsensitive)) &&
+            !taskName.contains("Microsoft", Qt::CaseInsensitive))
+        {
+            bool isEnabled = row.text(2) != "Disabled";
+
+            StartupProgram program;
+            program.name = taskName;
+            program.status = isEnabled ? "Enabled" : "Disabled";
+            program.startupType = "Scheduled Task";
+            program.location = "Task Scheduler";
+            program.isEnabled = isEnabled;
+            program.source = sourceId;
+            programs.append(program);
+        }
+    }
+}
+
+QString ScheduledTaskStartupSource::id() const
+{
+    return "tasks";
+}
+
+QList<StartupProgram> ScheduledTaskStartupSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+#ifdef Q_OS_WIN
+    QProcess process;
+    process.start("schtasks", QStringList() << "/query" << "/fo" << "csv" << "/nh");
+    if (!process.waitForStarted(3000))
+        return programs;
+
+    // Rows are parsed as the output arrives instead of after the whole listing
+    const QString sourceId = id();
+    CsvStreamParser parser([&programs, &sourceId](const CsvStreamParser::Row &row)
+                           {
+                               addTask(programs, row, sourceId);
+                               return true;
+                           });
+    while (process.waitForReadyRead(IdleTimeoutMs))
+        parser.feed(process.readAllStandardOutput());
+
+    if (process.state() != QProcess::NotRunning)
+    {
+        // Keep the tasks listed so far
+        qDebug() << "schtasks stopped answering after" << parser.rowCount() << "tasks";
+        process.kill();
+        process.waitForFinished(1000);
+    }
+    parser.feed(process.readAllStandardOutput());
+    parser.finish();
+#endif
+
+    return programs;
+}
+
+bool ScheduledTaskStartupSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+#ifdef Q_OS_WIN
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start("schtasks", QStringList() << "/change" << "/tn" << program.name
+                                            << (enable ? "/enable" : "/disable"));
+
+    if (!process.waitForStarted(3000))
+    {
+        error = "schtasks could not be started.";
+        return false;
+    }
+
+    if (!process.waitForFinished(10000))
+    {
+        process.kill();
+        error = "schtasks did not finish in time.";
+        return false;
+    }
+
+    if (process.exitCode() != 0)
+    {
+        error = QString::fromLocal8Bit(process.readAll()).trimmed();
+        return false;
+    }
+    return true;
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(enable);
+    error = "Scheduled tasks are only available on Windows.";
+    return false;
+#endif
+}
@@ -0,0 +1,16 @@
+#ifndef SCHEDULEDTASKSTARTUPSOURCE_H
+#define SCHEDULEDTASKSTARTUPSOURCE_H
+
+#include "startupsource.h"
+
+// Non-Microsoft scheduled tasks that run at startup or logon, listed and
+// changed through schtasks.exe
+class ScheduledTaskStartupSource : public StartupSource
+{
+public:
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+};
+
+#endif // SCHEDULEDTASKSTARTUPSOURCE_H
@@ -0,0 +1,226 @@
+#include "servicestartupsource.h"
+#include "keywordclassifier.h"
+#include <QByteArray>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+
+#pragma comment(lib, "advapi32.lib")
+#endif
+
+QString ServiceStartupSource::id() const
+{
+    return "services";
+}
+
+QList<StartupProgram> ServiceStartupSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+#ifdef Q_OS_WIN
+    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_ENUMERATE_SERVICE);
+    if (!scManager)
+        return programs;
+
+    // First call to get the required buffer size
+    DWORD bytesNeeded = 0;
+    DWORD serviceCount = 0;
+    DWORD resumeHandle = 0;
+    EnumServicesStatusEx(scManager, SC_ENUM_PROCESS_INFO, SERVICE_WIN32, SERVICE_STATE_ALL,
+                         nullptr, 0, &bytesNeeded, &serviceCount, &resumeHandle, nullptr);
+    if (GetLastError() != ERROR_MORE_DATA)
+    {
+        CloseServiceHandle(scManager);
+        return programs;
+    }
+
+    QByteArray buffer(int(bytesNeeded), Qt::Uninitialized);
+    ENUM_SERVICE_STATUS_PROCESS *services = reinterpret_cast<ENUM_SERVICE_STATUS_PROCESS *>(buffer.data());
+    if (EnumServicesStatusEx(scManager, SC_ENUM_PROCESS_INFO, SERVICE_WIN32, SERVICE_STATE_ALL,
+                             reinterpret_cast<BYTE *>(buffer.data()), bytesNeeded, &bytesNeeded,
+                             &serviceCount, &resumeHandle, nullptr))
+    {
+        const KeywordClassifier &classifier = KeywordClassifier::standard();
+        for (DWORD i = 0; i < serviceCount; i++)
+        {
+            const ENUM_SERVICE_STATUS_PROCESS &service = services[i];
+
+            // Filter out critical system services
+            QString displayName = QString::fromWCharArray(service.lpDisplayName);
+            if (classifier.classify(displayName, KeywordClassifier::Name) & KeywordCategory::SystemService)
+                continue;
+
+            SC_HANDLE hService = OpenService(scManager, service.lpServiceName, SERVICE_QUERY_CONFIG);
+            if (!hService)
+                continue;
+
+            DWORD configSize = 0;
+            QueryServiceConfig(hService, nullptr, 0, &configSize);
+            if (configSize > 0)
+            {
+                QByteArray configBuffer(int(configSize), Qt::Uninitialized);
+                QUERY_SERVICE_CONFIG *config = reinterpret_cast<QUERY_SERVICE_CONFIG *>(configBuffer.data());
+                if (QueryServiceConfig(hService, config, configSize, &configSize))
+                {
+                    bool isEnabled = config->dwStartType == SERVICE_AUTO_START;
+
+                    StartupProgram program;
+                    program.name = displayName;
+                    program.status = isEnabled ? "Enabled" : "Disabled";
+                    program.startupType = "Service";
+                    program.command = QString::fromWCharArray(service.lpServiceName);
+                    program.location = "Services";
+                    program.isEnabled = isEnabled;
+                    program.source = id();
+                    programs.append(program);
+                }
+            }
+            CloseServiceHandle(hService);
+        }
+    }
+
+    CloseServiceHandle(scManager);
+#endif
+
+    return programs;
+}
+
+bool ServiceStartupSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+#ifdef Q_OS_WIN
+    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT);
+    if (!scManager)
+    {
+        error = "Could not open the Service Control Manager.";
+        return false;
+    }
+
+    // The key name is listed in command, so no guessing from the display name
+    SC_HANDLE service = OpenService(scManager, reinterpret_cast<const wchar_t *>(program.command.utf16()),
+                                    SERVICE_CHANGE_CONFIG);
+    if (!service)
+    {
+        error = QString("Could not open the service '%1'. You may need to run as Administrator.").arg(program.name);
+        CloseServiceHandle(scManager);
+        return false;
+    }
+
+    DWORD startType = enable ? SERVICE_AUTO_START : SERVICE_DISABLED;
+    BOOL success = ChangeServiceConfig(service, SERVICE_NO_CHANGE, startType, SERVICE_NO_CHANGE,
+                                       nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    if (!success)
+        error = QString("Changing '%1' failed with error %2.").arg(program.name).arg(GetLastError());
+
+    CloseServiceHandle(service);
+    CloseServiceHandle(scManager);
+    return success;
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(enable);
+    error = "Windows services are only available on Windows.";
+    return false;
+#endif
+}
+
+bool ServiceStartupSource::saveState(const StartupProgram &program, QByteArray &state, QString &error) const
+{
+#ifdef Q_OS_WIN
+    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT);
+    if (!scManager)
+    {
+        error = "Could not open the Service Control Manager.";
+        return false;
+    }
+
+    SC_HANDLE service = OpenService(scManager, reinterpret_cast<const wchar_t *>(program.command.utf16()),
+                                    SERVICE_QUERY_CONFIG);
+    if (!service)
+    {
+        error = QString("Could not open the service '%1'.").arg(program.name);
+        CloseServiceHandle(scManager);
+        return false;
+    }
+
+    bool success = false;
+    DWORD configSize = 0;
+    QueryServiceConfig(service, nullptr, 0, &configSize);
+    QByteArray configBuffer(int(qMax<DWORD>(configSize, sizeof(QUERY_SERVICE_CONFIG))), Qt::Uninitialized);
+    QUERY_SERVICE_CONFIG *config = reinterpret_cast<QUERY_SERVICE_CONFIG *>(configBuffer.data());
+    if (QueryServiceConfig(service, config, DWORD(configBuffer.size()), &configSize))
+    {
+        // Only automatic services have a delayed flag; it reads as off elsewhere
+        SERVICE_DELAYED_AUTO_START_INFO delayed = {};
+        DWORD delayedSize = 0;
+        QueryServiceConfig2(service, SERVICE_CONFIG_DELAYED_AUTO_START_INFO, reinterpret_cast<BYTE *>(&delayed),
+                            sizeof(delayed), &delayedSize);
+
+        state = QByteArray::number(quint32(config->dwStartType)) + ";" +
+                QByteArray::number(delayed.fDelayedAutostart ? 1 : 0);
+        success = true;
+    }
+    else
+    {
+        error = QString("Reading the configuration of '%1' failed with error %2.").arg(program.name).arg(GetLastError());
+    }
+
+    CloseServiceHandle(service);
+    CloseServiceHandle(scManager);
+    return success;
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(state);
+    error = "Windows services are only available on Windows.";
+    return false;
+#endif
+}
+
+bool ServiceStartupSource::restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const
+{
+#ifdef Q_OS_WIN
+    // "<start type>;<delayed>", as saveState() wrote it
+    QList<QByteArray> fields = state.split(';');
+    bool ok = false;
+    DWORD startType = fields.value(0).toUInt(&ok);
+    if (!ok || fields.size() != 2 || startType > SERVICE_DISABLED)
+    {
+        error = QString("The saved state of '%1' is not valid.").arg(program.name);
+        return false;
+    }
+
+    SC_HANDLE scManager = OpenSCManager(nullptr, nullptr, SC_MANAGER_CONNECT);
+    if (!scManager)
+    {
+        error = "Could not open the Service Control Manager.";
+        return false;
+    }
+
+    SC_HANDLE service = OpenService(scManager, reinterpret_cast<const wchar_t *>(program.command.utf16()),
+                                    SERVICE_CHANGE_CONFIG);
+    if (!service)
+    {
+        error = QString("Could not open the service '%1'. You may need to run as Administrator.").arg(program.name);
+        CloseServiceHandle(scManager);
+        return false;
+    }
+
+    BOOL success = ChangeServiceConfig(service, SERVICE_NO_CHANGE, startType, SERVICE_NO_CHANGE,
+                                       nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr);
+    if (success && startType == SERVICE_AUTO_START)
+    {
+        SERVICE_DELAYED_AUTO_START_INFO delayed = {};
+        delayed.fDelayedAutostart = fields.value(1) == "1";
+        success = ChangeServiceConfig2(service, SERVICE_CONFIG_DELAYED_AUTO_START_INFO, &delayed);
+    }
+    if (!success)
+        error = QString("Restoring '%1' failed with error %2.").arg(program.name).arg(GetLastError());
+
+    CloseServiceHandle(service);
+    CloseServiceHandle(scManager);
+    return success;
+#else
+    Q_UNUSED(program);
+    Q_UNUSED(state);
+    error = "Windows services are only available on Windows.";
+    return false;
+#endif
+}
@@ -0,0 +1,21 @@
+#ifndef SERVICESTARTUPSOURCE_H
+#define SERVICESTARTUPSOURCE_H
+
+#include "startupsource.h"
+
+// Win32 services from the Service Control Manager. Automatic services are
+// enabled, everything else is disabled; critical system services are left
+// out. StartupProgram::command holds the service key name. Saved states are
+// the exact start type and delayed-start flag, so a manual service that was
+// enabled goes back to manual, not to disabled.
+class ServiceStartupSource : public StartupSource
+{
+public:
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+    bool saveState(const StartupProgram &program, QByteArray &state, QString &error) const override;
+    bool restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const override;
+};
+
+#endif // SERVICESTARTUPSOURCE_H
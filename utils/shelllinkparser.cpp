@@ -0,0 +1,304 @@
+#include "shelllinkparser.h"
+#include <QFile>
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    const quint32 HeaderSize = 0x4C;
+    const uchar LinkClsid[16] = {0x01, 0x14, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                 0xC0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x46};
+
+    // LinkFlags
+    const quint32 HasLinkTargetIdList = 0x00000001;
+    const quint32 HasLinkInfo = 0x00000002;
+    const quint32 HasName = 0x00000004;
+    const quint32 HasRelativePath = 0x00000008;
+    const quint32 HasWorkingDir = 0x00000010;
+    const quint32 HasArguments = 0x00000020;
+    const quint32 HasIconLocation = 0x00000040;
+    const quint32 IsUnicode = 0x00000080;
+    const quint32 ForceNoLinkInfo = 0x00000100;
+
+    // LinkInfoFlags
+    const quint32 VolumeIdAndLocalBasePath = 0x1;
+    const quint32 CommonNetworkRelativeLinkAndPathSuffix = 0x2;
+
+    const quint32 EnvironmentVariableBlock = 0xA0000001;
+    const quint32 FileEntryExtension = 0xBEEF0004;
+
+    // Shortcuts are a few KB; anything far larger is not one
+    const qint64 MaxLinkSize = 1024 * 1024;
+
+    quint16 read16(const uchar *p)
+    {
+        return qFromLittleEndian<quint16>(p);
+    }
+
+    quint32 read32(const uchar *p)
+    {
+        return qFromLittleEndian<quint32>(p);
+    }
+
+    // NUL-terminated ANSI string starting at offset, never running past end
+    QString ansiString(const uchar *data, int offset, int end)
+    {
+        if (offset < 0 || offset >= end)
+            return QString();
+        int length = 0;
+        while (offset + length < end && data[offset + length] != 0)
+            ++length;
+        return QString::fromLocal8Bit(reinterpret_cast<const char *>(data + offset), length);
+    }
+
+    // NUL-terminated UTF-16LE string starting at offset
+    QString unicodeString(const uchar *data, int offset, int end)
+    {
+        QString text;
+        if (offset < 0)
+            return text;
+        for (int i = offset; i + 1 < end; i += 2)
+        {
+            quint16 unit = read16(data + i);
+            if (unit == 0)
+                break;
+            text.append(QChar(unit));
+        }
+        return text;
+    }
+}
+
+bool ShellLinkParser::parseFile(const QString &filePath, ShellLink &link, QString &error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        error = file.errorString();
+        return false;
+    }
+    if (file.size() > MaxLinkSize)
+    {
+        error = "The file is too large to be a shortcut.";
+        return false;
+    }
+    return parse(file.readAll(), link, error);
+}
+
+bool ShellLinkParser::parse(const QByteArray &bytes, ShellLink &link, QString &error)
+{
+    link = ShellLink();
+    const uchar *data = reinterpret_cast<const uchar *>(bytes.constData());
+    const int size = bytes.size();
+
+    if (size < int(HeaderSize) || read32(data) != HeaderSize || std::memcmp(data + 4, LinkClsid, 16) != 0)
+    {
+        error = "Not a shell link file.";
+        return false;
+    }
+
+    const quint32 flags = read32(data + 0x14);
+    int pos = int(HeaderSize);
+
+    QString idListPath;
+    if (flags & HasLinkTargetIdList)
+    {
+        if (pos + 2 > size)
+        {
+            error = "The ID list is truncated.";
+            return false;
+        }
+        int idListSize = read16(data + pos);
+        pos += 2;
+        if (pos + idListSize > size)
+        {
+            error = "The ID list is truncated.";
+            return false;
+        }
+        idListPath = pathFromIdList(bytes, pos, idListSize);
+        pos += idListSize;
+    }
+
+    if ((flags & HasLinkInfo) && !(flags & ForceNoLinkInfo))
+    {
+        if (pos + 0x1C > size)
+        {
+            error = "The link info is truncated.";
+            return false;
+        }
+
+        const uchar *info = data + pos;
+        int infoSize = int(read32(info));
+        int infoHeaderSize = int(read32(info + 4));
+        quint32 infoFlags = read32(info + 8);
+        if (infoSize < 0x1C || infoSize > size - pos)
+        {
+            error = "The link info is truncated.";
+            return false;
+        }
+
+        // Offsets are relative to the LinkInfo structure and must stay inside it
+        int localBaseOffset = int(read32(info + 0x10));
+        int networkOffset = int(read32(info + 0x14));
+        int suffixOffset = int(read32(info + 0x18));
+        int localBaseOffsetUnicode = 0;
+        int suffixOffsetUnicode = 0;
+        if (infoHeaderSize >= 0x24 && infoSize >= 0x24)
+        {
+            localBaseOffsetUnicode = int(read32(info + 0x1C));
+            suffixOffsetUnicode = int(read32(info + 0x20));
+        }
+
+        QString suffix = suffixOffsetUnicode > 0 ? unicodeString(info, suffixOffsetUnicode, infoSize)
+                                                 : ansiString(info, suffixOffset, infoSize);
+
+        if (infoFlags & VolumeIdAndLocalBasePath)
+        {
+            QString base = localBaseOffsetUnicode > 0 ? unicodeString(info, localBaseOffsetUnicode, infoSize)
+                                                      : ansiString(info, localBaseOffset, infoSize);
+            link.targetPath = base + suffix;
+        }
+        else if ((infoFlags & CommonNetworkRelativeLinkAndPathSuffix) && networkOffset > 0 &&
+                 networkOffset <= infoSize - 0x14)
+        {
+            const uchar *network = info + networkOffset;
+            int networkEnd = infoSize - networkOffset;
+            int netNameOffset = int(read32(network + 8));
+            QString share;
+            if (netNameOffset > 0x14 && networkEnd >= 0x1C)
+                share = unicodeString(network, int(read32(network + 0x14)), networkEnd);
+            if (share.isEmpty())
+                share = ansiString(network, netNameOffset, networkEnd);
+            if (!share.isEmpty())
+                link.targetPath = suffix.isEmpty() ? share : share + "\\" + suffix;
+        }
+
+        pos += infoSize;
+    }
+
+    // StringData: each present string is a character count followed by the characters
+    const bool unicode = flags & IsUnicode;
+    const quint32 stringFlags[] = {HasName, HasRelativePath, HasWorkingDir, HasArguments, HasIconLocation};
+    QString *strings[] = {&link.description, &link.relativePath, &link.workingDirectory, &link.arguments,
+                          &link.iconLocation};
+    for (int i = 0; i < 5; ++i)
+    {
+        if (!(flags & stringFlags[i]))
+            continue;
+        if (pos + 2 > size)
+        {
+            error = "The string data is truncated.";
+            return false;
+        }
+
+        int count = read16(data + pos);
+        pos += 2;
+        int byteCount = unicode ? count * 2 : count;
+        if (pos + byteCount > size)
+        {
+            error = "The string data is truncated.";
+            return false;
+        }
+
+        if (unicode)
+        {
+            QString text;
+            text.reserve(count);
+            for (int c = 0; c < count; ++c)
+                text.append(QChar(read16(data + pos + c * 2)));
+            *strings[i] = text;
+        }
+        else
+        {
+            *strings[i] = QString::fromLocal8Bit(reinterpret_cast<const char *>(data + pos), count);
+        }
+        pos += byteCount;
+    }
+
+    // ExtraData blocks until a terminal block smaller than 4 bytes
+    QString environmentTarget;
+    while (pos + 8 <= size)
+    {
+        int blockSize = int(read32(data + pos));
+        if (blockSize < 8 || blockSize > size - pos)
+            break;
+
+        if (read32(data + pos + 4) == EnvironmentVariableBlock && blockSize >= 0x314)
+        {
+            // TargetAnsi (260 bytes) is followed by TargetUnicode (520 bytes)
+            environmentTarget = unicodeString(data + pos, 0x10C, 0x314);
+            if (environmentTarget.isEmpty())
+                environmentTarget = ansiString(data + pos, 8, 0x10C);
+        }
+        pos += blockSize;
+    }
+
+    if (link.targetPath.isEmpty())
+        link.targetPath = !environmentTarget.isEmpty() ? environmentTarget : idListPath;
+
+    if (link.targetPath.isEmpty() && link.relativePath.isEmpty())
+    {
+        error = "The shortcut does not name a target.";
+        return false;
+    }
+    return true;
+}
+
+QString ShellLinkParser::pathFromIdList(const QByteArray &bytes, int offset, int size)
+{
+    // Only file system items are followed: a volume ("C:\") and then one
+    // file entry per folder, whose long name sits in its 0xBEEF0004 extension
+    const uchar *data = reinterpret_cast<const uchar *>(bytes.constData()) + offset;
+    QString path;
+    int pos = 0;
+    while (pos + 2 <= size)
+    {
+        int itemSize = read16(data + pos);
+        if (itemSize == 0)
+            break;
+        if (itemSize < 3 || pos + itemSize > size)
+            return QString();
+
+        const uchar *item = data + pos;
+        uchar type = item[2];
+        if ((type & 0x70) == 0x20)
+        {
+            // Volume item: "C:\" in ANSI
+            path = ansiString(item, 3, itemSize);
+        }
+        else if ((type & 0x70) == 0x30 && itemSize >= 14 && !path.isEmpty())
+        {
+            // Short name, padded to an even offset, then the extension blocks
+            bool unicodeName = type & 0x04;
+            int nameStart = 14;
+            QString name = unicodeName ? unicodeString(item, nameStart, itemSize) : ansiString(item, nameStart, itemSize);
+            int nameEnd = nameStart + (unicodeName ? (name.size() + 1) * 2 : name.toLocal8Bit().size() + 1);
+            nameEnd += nameEnd % 2;
+
+            // The extension's long name follows a version-dependent set of fields
+            if (nameEnd + 8 <= itemSize && read32(item + nameEnd + 4) == FileEntryExtension)
+            {
+                const uchar *extension = item + nameEnd;
+                int extensionSize = qMin<int>(read16(extension), itemSize - nameEnd);
+                int version = read16(extension + 2);
+                int longNameOffset = 18;
+                if (version >= 7)
+                    longNameOffset += 18;
+                if (version >= 3)
+                    longNameOffset += 2;
+                if (version >= 9)
+                    longNameOffset += 4;
+                if (version >= 8)
+                    longNameOffset += 4;
+                QString longName = unicodeString(extension, longNameOffset, extensionSize);
+                if (!longName.isEmpty())
+                    name = longName;
+            }
+
+            if (!path.endsWith('\\'))
+                path += '\\';
+            path += name;
+        }
+        pos += itemSize;
+    }
+    return path;
+}
@@ -0,0 +1,34 @@
+#ifndef SHELLLINKPARSER_H
+#define SHELLLINKPARSER_H
+
+#include <QString>
+#include <QByteArray>
+
+// What a .lnk shortcut points at
+struct ShellLink
+{
+    QString targetPath;       // may still contain %VARIABLES% from an environment block
+    QString arguments;
+    QString workingDirectory;
+    QString relativePath;
+    QString iconLocation;
+    QString description;
+};
+
+// Reads the Shell Link binary format ([MS-SHLLINK]) straight from the file
+// bytes, without COM or the shell: the header, the LinkInfo local or
+// network path, the string data and the environment variable block. When a
+// link carries no LinkInfo, the path is rebuilt from the file system items
+// of its ID list. Every offset is bounds-checked, so damaged files fail
+// instead of reading past the buffer.
+class ShellLinkParser
+{
+public:
+    static bool parse(const QByteArray &bytes, ShellLink &link, QString &error);
+    static bool parseFile(const QString &filePath, ShellLink &link, QString &error);
+
+private:
+    static QString pathFromIdList(const QByteArray &bytes, int offset, int size);
+};
+
+#endif // SHELLLINKPARSER_H
@@ -0,0 +1,35 @@
+#include "softwarefilterproxymodel.h"
+
+SoftwareFilterProxyModel::SoftwareFilterProxyModel(SoftwareTableModel *source, QObject *parent)
+    : QSortFilterProxyModel(parent), m_software(source), m_filtering(false)
+{
+    setSourceModel(source);
+}
+
+void SoftwareFilterProxyModel::setMatches(const QVector<int> &ids, int idCount)
+{
+    QVector<bool> visible(idCount, false);
+    for (int id : ids)
+    {
+        if (id >= 0 && id < idCount)
+            visible[id] = true;
+    }
+
+    m_visible.swap(visible);
+    m_filtering = true;
+    invalidateFilter();
+}
+
+void SoftwareFilterProxyModel::sort(int column, Qt::SortOrder order)
+{
+    m_software->sort(column, order);
+}
+
+bool SoftwareFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
+{
+    if (!m_filtering || sourceParent.isValid())
+        return true;
+
+    int id = m_software->sourceIndex(sourceRow);
+    return id >= 0 && id < m_visible.size() && m_visible[id];
+}
@@ -0,0 +1,32 @@
+#ifndef SOFTWAREFILTERPROXYMODEL_H
+#define SOFTWAREFILTERPROXYMODEL_H
+
+#include <QSortFilterProxyModel>
+#include <QVector>
+#include "softwaretablemodel.h"
+
+// Shows the rows of a SoftwareTableModel that are in a search result. The
+// result is a set of FuzzySearchIndex ids, which are the model's source
+// indexes, so filtering is one lookup per row. Sorting is passed on to the
+// source model and its precomputed keys; the proxy keeps the source order.
+class SoftwareFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit SoftwareFilterProxyModel(SoftwareTableModel *source, QObject *parent = nullptr);
+
+    // Ids of the entries to show; every row is shown until this is first called
+    void setMatches(const QVector<int> &ids, int idCount);
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    SoftwareTableModel *m_software;
+    QVector<bool> m_visible; // indexed by id
+    bool m_filtering;
+};
+
+#endif // SOFTWAREFILTERPROXYMODEL_H
@@ -0,0 +1,176 @@
+#include "softwareinventory.h"
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+namespace
+{
+    const quint32 InventoryMagic = 0x52534956; // "RSIV"
+    const quint32 InventoryVersion = 1;
+}
+
+SoftwareInventory::SoftwareInventory()
+{
+}
+
+bool SoftwareInventory::isEmpty() const
+{
+    return m_software.isEmpty();
+}
+
+QDateTime SoftwareInventory::createdAt() const
+{
+    return m_createdAt;
+}
+
+void SoftwareInventory::setCreatedAt(const QDateTime &createdAt)
+{
+    m_createdAt = createdAt;
+}
+
+QList<InstalledSoftware> SoftwareInventory::software() const
+{
+    return m_software;
+}
+
+void SoftwareInventory::setSoftware(const QList<InstalledSoftware> &software)
+{
+    m_software = software;
+}
+
+QHash<QString, InstalledSoftware> SoftwareInventory::entriesForSource(const QString &source) const
+{
+    QHash<QString, InstalledSoftware> entries;
+    for (const InstalledSoftware &software : m_software)
+    {
+        if (software.source == source)
+            entries.insert(software.guid, software);
+    }
+    return entries;
+}
+
+bool SoftwareInventory::hasSource(const QString &source) const
+{
+    return m_fingerprints.contains(source);
+}
+
+quint64 SoftwareInventory::sourceFingerprint(const QString &source) const
+{
+    return m_fingerprints.value(source);
+}
+
+void SoftwareInventory::setSourceFingerprint(const QString &source, quint64 fingerprint)
+{
+    m_fingerprints.insert(source, fingerprint);
+}
+
+bool SoftwareInventory::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << InventoryMagic << InventoryVersion << m_createdAt;
+
+    out << qint32(m_fingerprints.size());
+    for (auto it = m_fingerprints.constBegin(); it != m_fingerprints.constEnd(); ++it)
+    {
+        out << it.key() << it.value();
+    }
+
+    out << qint32(m_software.size());
+    for (const InstalledSoftware &software : m_software)
+    {
+        out << software.name << software.version << software.publisher << software.size
+            << software.installDate << software.uninstallString << software.quietUninstallString
+            << software.installLocation << software.guid << software.isSystemComponent
+            << software.source << software.lastWriteTime;
+    }
+
+    return out.status() == QDataStream::Ok;
+}
+
+bool SoftwareInventory::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QDateTime createdAt;
+    in >> magic >> version >> createdAt;
+
+    if (magic != InventoryMagic || version != InventoryVersion)
+        return false;
+
+    qint32 sourceCount = 0;
+    in >> sourceCount;
+    QHash<QString, quint64> fingerprints;
+    for (qint32 i = 0; i < sourceCount && in.status() == QDataStream::Ok; ++i)
+    {
+        QString source;
+        quint64 fingerprint = 0;
+        in >> source >> fingerprint;
+        fingerprints.insert(source, fingerprint);
+    }
+
+    qint32 softwareCount = 0;
+    in >> softwareCount;
+    QList<InstalledSoftware> softwareList;
+    for (qint32 i = 0; i < softwareCount && in.status() == QDataStream::Ok; ++i)
+    {
+        InstalledSoftware software;
+        in >> software.name >> software.version >> software.publisher >> software.size
+           >> software.installDate >> software.uninstallString >> software.quietUninstallString
+           >> software.installLocation >> software.guid >> software.isSystemComponent
+           >> software.source >> software.lastWriteTime;
+        softwareList.append(software);
+    }
+
+    if (in.status() != QDataStream::Ok || sourceCount < 0 || softwareCount < 0)
+        return false;
+
+    m_createdAt = createdAt;
+    m_fingerprints = fingerprints;
+    m_software = softwareList;
+    return true;
+}
+
+QString SoftwareInventory::defaultFilePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/software_inventory.cache";
+}
+
+quint64 SoftwareInventory::computeFingerprint(const QList<QPair<QString, qint64>> &subkeys)
+{
+    // FNV-1a over the names and timestamps
+    quint64 hash = 14695981039346656037ULL;
+    auto mix = [&hash](quint64 value)
+    {
+        hash ^= value;
+        hash *= 1099511628211ULL;
+    };
+
+    for (const QPair<QString, qint64> &subkey : subkeys)
+    {
+        for (QChar c : subkey.first)
+        {
+            mix(c.unicode());
+        }
+        mix(quint64(subkey.second));
+    }
+    mix(quint64(subkeys.size()));
+
+    return hash;
+}
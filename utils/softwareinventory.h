@@ -0,0 +1,60 @@
+#ifndef SOFTWAREINVENTORY_H
+#define SOFTWAREINVENTORY_H
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QDateTime>
+
+struct InstalledSoftware
+{
+    QString name;
+    QString version;
+    QString publisher;
+    qint64 size = 0;
+    QString installDate;
+    QString uninstallString;
+    QString quietUninstallString;
+    QString installLocation;
+    QString guid;
+    bool isSystemComponent = false;
+
+    // Where the entry was read from, for incremental rescans
+    QString source;           // uninstall key path
+    qint64 lastWriteTime = 0; // last write time of the entry's subkey
+};
+
+// Installed software list plus a change fingerprint per uninstall source,
+// persisted between launches so the list can be shown before rescanning.
+class SoftwareInventory
+{
+public:
+    SoftwareInventory();
+
+    bool isEmpty() const;
+    QDateTime createdAt() const;
+    void setCreatedAt(const QDateTime &createdAt);
+
+    QList<InstalledSoftware> software() const;
+    void setSoftware(const QList<InstalledSoftware> &software);
+    QHash<QString, InstalledSoftware> entriesForSource(const QString &source) const;
+
+    bool hasSource(const QString &source) const;
+    quint64 sourceFingerprint(const QString &source) const;
+    void setSourceFingerprint(const QString &source, quint64 fingerprint);
+
+    bool save(const QString &filePath) const;
+    bool load(const QString &filePath);
+    static QString defaultFilePath();
+
+    // Order-sensitive hash over (subkey name, last write time) pairs
+    static quint64 computeFingerprint(const QList<QPair<QString, qint64>> &subkeys);
+
+private:
+    QList<InstalledSoftware> m_software;
+    QHash<QString, quint64> m_fingerprints;
+    QDateTime m_createdAt;
+};
+
+#endif // SOFTWAREINVENTORY_H
@@ -0,0 +1,299 @@
+#include "softwaretablemodel.h"
+#include <QBrush>
+#include <QColor>
+#include <QDate>
+#include <QHash>
+#include <algorithm>
+#include <numeric>
+
+SoftwareTableModel::SoftwareTableModel(QObject *parent)
+    : QAbstractTableModel(parent), m_sortColumn(NameColumn), m_sortOrder(Qt::AscendingOrder)
+{
+    // "App 10" after "App 9", "1.10" after "1.9"
+    m_collator.setCaseSensitivity(Qt::CaseInsensitive);
+    m_collator.setNumericMode(true);
+}
+
+int SoftwareTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+int SoftwareTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant SoftwareTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= int(m_rows.size()))
+        return QVariant();
+
+    const InstalledSoftware &software = m_rows[index.row()].software;
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        switch (index.column())
+        {
+        case NameColumn:
+            return software.name;
+        case VersionColumn:
+            return software.version;
+        case SizeColumn:
+            return formatSize(software.size);
+        case InstallDateColumn:
+            return software.installDate;
+        }
+        break;
+    case Qt::TextAlignmentRole:
+        if (index.column() == SizeColumn)
+            return int(Qt::AlignRight | Qt::AlignVCenter);
+        break;
+    case Qt::BackgroundRole:
+        if (index.column() == NameColumn && software.isSystemComponent)
+            return QBrush(QColor(255, 243, 205)); // Light yellow for system components
+        break;
+    case Qt::ToolTipRole:
+        if (index.column() == NameColumn && software.isSystemComponent)
+            return QString("System Component - Use Force Uninstall with caution");
+        break;
+    }
+
+    return QVariant();
+}
+
+QVariant SoftwareTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QAbstractTableModel::headerData(section, orientation, role);
+
+    switch (section)
+    {
+    case NameColumn:
+        return QString("Software Name");
+    case VersionColumn:
+        return QString("Version");
+    case SizeColumn:
+        return QString("Size");
+    case InstallDateColumn:
+        return QString("Install Date");
+    }
+    return QVariant();
+}
+
+void SoftwareTableModel::sort(int column, Qt::SortOrder order)
+{
+    if (column < 0 || column >= ColumnCount)
+        return;
+
+    m_sortColumn = column;
+    m_sortOrder = order;
+
+    emit layoutAboutToBeChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+
+    // Sort a permutation so persistent indexes (selection, current row) can follow their rows
+    std::vector<int> permutation(m_rows.size());
+    std::iota(permutation.begin(), permutation.end(), 0);
+    std::stable_sort(permutation.begin(), permutation.end(), [this](int a, int b)
+                     { return lessThan(m_rows[a], m_rows[b]); });
+
+    std::vector<Row> sorted;
+    sorted.reserve(m_rows.size());
+    std::vector<int> newRow(m_rows.size());
+    for (size_t i = 0; i < permutation.size(); ++i)
+    {
+        newRow[permutation[i]] = int(i);
+        sorted.push_back(std::move(m_rows[permutation[i]]));
+    }
+    m_rows.swap(sorted);
+
+    QModelIndexList from = persistentIndexList();
+    QModelIndexList to;
+    to.reserve(from.size());
+    for (const QModelIndex &index : from)
+    {
+        to.append(this->index(newRow[index.row()], index.column()));
+    }
+    changePersistentIndexList(from, to);
+
+    emit layoutChanged(QList<QPersistentModelIndex>(), QAbstractItemModel::VerticalSortHint);
+}
+
+void SoftwareTableModel::setSoftware(const QList<InstalledSoftware> &softwareList)
+{
+    QHash<QString, int> incoming;
+    incoming.reserve(softwareList.size());
+    for (int i = 0; i < softwareList.size(); ++i)
+    {
+        incoming.insert(rowKey(softwareList[i]), i);
+    }
+
+    // Remove vanished entries, one signal per contiguous run
+    int row = int(m_rows.size()) - 1;
+    while (row >= 0)
+    {
+        if (incoming.contains(rowKey(m_rows[row].software)))
+        {
+            --row;
+            continue;
+        }
+
+        int last = row;
+        while (row > 0 && !incoming.contains(rowKey(m_rows[row - 1].software)))
+            --row;
+
+        beginRemoveRows(QModelIndex(), row, last);
+        m_rows.erase(m_rows.begin() + row, m_rows.begin() + last + 1);
+        endRemoveRows();
+        --row;
+    }
+
+    // Update entries whose content changed
+    QVector<bool> present(softwareList.size(), false);
+    for (int i = 0; i < int(m_rows.size()); ++i)
+    {
+        int source = incoming.value(rowKey(m_rows[i].software));
+        present[source] = true;
+        m_rows[i].sourceIndex = source;
+
+        if (!sameContent(m_rows[i].software, softwareList[source]))
+        {
+            m_rows[i] = makeRow(softwareList[source], source);
+            emit dataChanged(index(i, 0), index(i, ColumnCount - 1));
+        }
+    }
+
+    if (!isSorted())
+        sort(m_sortColumn, m_sortOrder);
+
+    // Insert new entries at their sorted position
+    std::vector<Row> added;
+    for (int i = 0; i < softwareList.size(); ++i)
+    {
+        if (!present[i])
+            added.push_back(makeRow(softwareList[i], i));
+    }
+    if (added.empty())
+        return;
+
+    auto less = [this](const Row &a, const Row &b)
+    { return lessThan(a, b); };
+    std::stable_sort(added.begin(), added.end(), less);
+
+    if (m_rows.empty())
+    {
+        // First population: one insert signal for everything
+        beginInsertRows(QModelIndex(), 0, int(added.size()) - 1);
+        m_rows.swap(added);
+        endInsertRows();
+        return;
+    }
+
+    for (Row &entry : added)
+    {
+        int position = int(std::upper_bound(m_rows.begin(), m_rows.end(), entry, less) - m_rows.begin());
+        beginInsertRows(QModelIndex(), position, position);
+        m_rows.insert(m_rows.begin() + position, std::move(entry));
+        endInsertRows();
+    }
+}
+
+void SoftwareTableModel::clear()
+{
+    if (m_rows.empty())
+        return;
+
+    beginResetModel();
+    m_rows.clear();
+    endResetModel();
+}
+
+const InstalledSoftware &SoftwareTableModel::software(int row) const
+{
+    return m_rows[row].software;
+}
+
+int SoftwareTableModel::sourceIndex(int row) const
+{
+    return m_rows[row].sourceIndex;
+}
+
+QString SoftwareTableModel::formatSize(qint64 bytes)
+{
+    if (bytes == 0)
+        return "0 B";
+
+    const QString sizes[] = {"B", "KB", "MB", "GB"};
+    int i = 0;
+    double size = bytes;
+
+    while (size >= 1024 && i < 3)
+    {
+        size /= 1024;
+        i++;
+    }
+
+    return QString("%1 %2").arg(size, 0, 'f', 1).arg(sizes[i]);
+}
+
+SoftwareTableModel::Row SoftwareTableModel::makeRow(const InstalledSoftware &software, int sourceIndex) const
+{
+    // Install dates are stored as yyyy-MM-dd; unknown dates sort first
+    QDate installDate = QDate::fromString(software.installDate, Qt::ISODate);
+
+    return Row{software,
+               sourceIndex,
+               m_collator.sortKey(software.name),
+               m_collator.sortKey(software.version),
+               installDate.isValid() ? installDate.toJulianDay() : 0};
+}
+
+bool SoftwareTableModel::lessThan(const Row &a, const Row &b) const
+{
+    int result = 0;
+    switch (m_sortColumn)
+    {
+    case VersionColumn:
+        result = a.versionKey.compare(b.versionKey);
+        break;
+    case SizeColumn:
+        result = a.software.size < b.software.size ? -1 : (a.software.size > b.software.size ? 1 : 0);
+        break;
+    case InstallDateColumn:
+        result = a.installDay < b.installDay ? -1 : (a.installDay > b.installDay ? 1 : 0);
+        break;
+    }
+
+    // Ties, and the name column itself, fall back to the name
+    if (result == 0)
+        result = a.nameKey.compare(b.nameKey);
+
+    return m_sortOrder == Qt::AscendingOrder ? result < 0 : result > 0;
+}
+
+bool SoftwareTableModel::isSorted() const
+{
+    for (size_t i = 1; i < m_rows.size(); ++i)
+    {
+        if (lessThan(m_rows[i], m_rows[i - 1]))
+            return false;
+    }
+    return true;
+}
+
+QString SoftwareTableModel::rowKey(const InstalledSoftware &software)
+{
+    // Uninstall subkeys identify an entry within its source
+    if (!software.guid.isEmpty())
+        return software.source + '\n' + software.guid;
+    return software.source + '\n' + software.name + '\n' + software.version;
+}
+
+bool SoftwareTableModel::sameContent(const InstalledSoftware &a, const InstalledSoftware &b)
+{
+    return a.lastWriteTime == b.lastWriteTime && a.size == b.size && a.name == b.name &&
+           a.version == b.version && a.publisher == b.publisher && a.installDate == b.installDate &&
+           a.isSystemComponent == b.isSystemComponent && a.uninstallString == b.uninstallString &&
+           a.quietUninstallString == b.quietUninstallString && a.installLocation == b.installLocation;
+}
@@ -0,0 +1,67 @@
+#ifndef SOFTWARETABLEMODEL_H
+#define SOFTWARETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QCollator>
+#include <vector>
+#include "softwareinventory.h"
+
+// Installed software for the software table. Collation keys for name and
+// version and numeric keys for size and install date are computed once per
+// entry, so column sorts only compare plain keys. setSoftware() diffs the new
+// list against the current rows by source and registry key and emits row
+// inserts, removals and data changes instead of resetting the model.
+class SoftwareTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column
+    {
+        NameColumn,
+        VersionColumn,
+        SizeColumn,
+        InstallDateColumn,
+        ColumnCount
+    };
+
+    explicit SoftwareTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
+
+    void setSoftware(const QList<InstalledSoftware> &softwareList);
+    void clear();
+
+    const InstalledSoftware &software(int row) const;
+    // Position of the row's entry in the list last passed to setSoftware()
+    int sourceIndex(int row) const;
+
+    static QString formatSize(qint64 bytes);
+
+private:
+    struct Row
+    {
+        InstalledSoftware software;
+        int sourceIndex;
+        QCollatorSortKey nameKey;
+        QCollatorSortKey versionKey;
+        qint64 installDay;
+    };
+
+    std::vector<Row> m_rows;
+    QCollator m_collator;
+    int m_sortColumn;
+    Qt::SortOrder m_sortOrder;
+
+    Row makeRow(const InstalledSoftware &software, int sourceIndex) const;
+    bool lessThan(const Row &a, const Row &b) const;
+    bool isSorted() const;
+    static QString rowKey(const InstalledSoftware &software);
+    static bool sameContent(const InstalledSoftware &a, const InstalledSoftware &b);
+};
+
+#endif // SOFTWARETABLEMODEL_H
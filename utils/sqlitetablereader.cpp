@@ -0,0 +1,298 @@
+#include "sqlitetablereader.h"
+#include <QtEndian>
+#include <cstring>
+
+namespace
+{
+    const int HeaderSize = 100;
+    const uchar InteriorTablePage = 0x05;
+    const uchar LeafTablePage = 0x0D;
+    const int MaxTreeDepth = 32;
+
+    // Big-endian variable-length integer of one to nine bytes
+    bool readVarint(const uchar *&p, const uchar *end, quint64 &value)
+    {
+        value = 0;
+        for (int i = 0; i < 9; ++i)
+        {
+            if (p >= end)
+                return false;
+            uchar byte = *p++;
+            if (i == 8)
+            {
+                value = (value << 8) | byte;
+                return true;
+            }
+            value = (value << 7) | (byte & 0x7F);
+            if (!(byte & 0x80))
+                return true;
+        }
+        return true;
+    }
+
+    qint64 readSignedBigEndian(const uchar *p, int length)
+    {
+        qint64 value = (p[0] & 0x80) ? -1 : 0;
+        for (int i = 0; i < length; ++i)
+            value = (value << 8) | p[i];
+        return value;
+    }
+}
+
+SqliteTableReader::SqliteTableReader()
+    : m_data(nullptr), m_size(0), m_pageSize(0), m_usableSize(0), m_pageCount(0)
+{
+}
+
+SqliteTableReader::~SqliteTableReader()
+{
+    close();
+}
+
+bool SqliteTableReader::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        m_error = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    m_data = m_file.map(0, m_size);
+    if (!m_data)
+    {
+        m_buffer = m_file.readAll();
+        m_data = reinterpret_cast<const uchar *>(m_buffer.constData());
+        m_size = m_buffer.size();
+    }
+
+    if (m_size < HeaderSize || std::memcmp(m_data, "SQLite format 3", 16) != 0)
+    {
+        m_error = "Not an SQLite 3 database";
+        close();
+        return false;
+    }
+
+    // A stored page size of 1 means 65536
+    m_pageSize = qFromBigEndian<quint16>(m_data + 16);
+    if (m_pageSize == 1)
+        m_pageSize = 65536;
+    m_usableSize = m_pageSize - m_data[20];
+    if (m_pageSize < 512 || (m_pageSize & (m_pageSize - 1)) || m_usableSize < 480)
+    {
+        m_error = "Unsupported SQLite page size";
+        close();
+        return false;
+    }
+
+    m_pageCount = quint32(m_size / m_pageSize);
+    m_error.clear();
+    return true;
+}
+
+void SqliteTableReader::close()
+{
+    if (m_file.isOpen())
+    {
+        if (m_buffer.isEmpty() && m_data)
+            m_file.unmap(const_cast<uchar *>(m_data));
+        m_file.close();
+    }
+    m_buffer.clear();
+    m_data = nullptr;
+    m_size = 0;
+    m_pageSize = 0;
+    m_usableSize = 0;
+    m_pageCount = 0;
+}
+
+bool SqliteTableReader::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+QString SqliteTableReader::errorString() const
+{
+    return m_error;
+}
+
+quint32 SqliteTableReader::tableRootPage(const QString &tableName) const
+{
+    // sqlite_master (type, name, tbl_name, rootpage, sql) is rooted at page 1
+    quint32 rootPage = 0;
+    readTable(1, [&](qint64, const QVariantList &columns)
+              {
+                  if (columns.size() >= 4 && columns[0].toString() == "table" &&
+                      columns[1].toString().compare(tableName, Qt::CaseInsensitive) == 0)
+                  {
+                      rootPage = quint32(columns[3].toLongLong());
+                      return false;
+                  }
+                  return true; });
+    return rootPage;
+}
+
+bool SqliteTableReader::readTable(quint32 rootPage, const RowCallback &callback) const
+{
+    bool stopped = false;
+    return isOpen() && walk(rootPage, 0, callback, stopped);
+}
+
+const uchar *SqliteTableReader::page(quint32 number) const
+{
+    if (number == 0 || number > m_pageCount)
+        return nullptr;
+    return m_data + qint64(number - 1) * m_pageSize;
+}
+
+bool SqliteTableReader::walk(quint32 pageNumber, int depth, const RowCallback &callback, bool &stopped) const
+{
+    const uchar *start = page(pageNumber);
+    if (!start || depth > MaxTreeDepth)
+        return false;
+
+    // Page 1 begins with the database header
+    const uchar *header = pageNumber == 1 ? start + HeaderSize : start;
+    const uchar *end = start + m_usableSize;
+    uchar type = header[0];
+    quint16 cellCount = qFromBigEndian<quint16>(header + 3);
+    const uchar *pointers = header + (type == InteriorTablePage ? 12 : 8);
+    if (pointers + 2 * cellCount > end)
+        return false;
+
+    for (quint16 i = 0; i < cellCount && !stopped; ++i)
+    {
+        quint16 offset = qFromBigEndian<quint16>(pointers + 2 * i);
+        const uchar *cell = start + offset;
+        if (cell >= end)
+            return false;
+
+        if (type == InteriorTablePage)
+        {
+            // Left child page number, then the child's largest rowid
+            if (cell + 4 > end || !walk(qFromBigEndian<quint32>(cell), depth + 1, callback, stopped))
+                return false;
+        }
+        else if (type == LeafTablePage)
+        {
+            quint64 payloadSize = 0;
+            quint64 rowId = 0;
+            if (!readVarint(cell, end, payloadSize) || !readVarint(cell, end, rowId))
+                return false;
+
+            QByteArray record = payload(cell, end, payloadSize);
+            if (quint64(record.size()) != payloadSize)
+                return false;
+            if (!callback(qint64(rowId), decodeRecord(record)))
+                stopped = true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if (type == InteriorTablePage && !stopped)
+        return walk(qFromBigEndian<quint32>(header + 8), depth + 1, callback, stopped);
+    return true;
+}
+
+QByteArray SqliteTableReader::payload(const uchar *cell, const uchar *pageEnd, quint64 size) const
+{
+    // How much of the payload is stored in the cell is fixed by the file format
+    quint64 usable = m_usableSize;
+    quint64 maxLocal = usable - 35;
+    quint64 local = size;
+    if (size > maxLocal)
+    {
+        quint64 minLocal = (usable - 12) * 32 / 255 - 23;
+        local = minLocal + (size - minLocal) % (usable - 4);
+        if (local > maxLocal)
+            local = minLocal;
+    }
+
+    if (cell + local > pageEnd || size > quint64(m_size))
+        return QByteArray();
+
+    QByteArray result;
+    result.reserve(int(size));
+    result.append(reinterpret_cast<const char *>(cell), int(local));
+    if (local == size)
+        return result;
+
+    // The rest lives on a chain of overflow pages
+    if (cell + local + 4 > pageEnd)
+        return QByteArray();
+    quint32 next = qFromBigEndian<quint32>(cell + local);
+    for (quint32 hops = 0; next && quint64(result.size()) < size && hops < m_pageCount; ++hops)
+    {
+        const uchar *overflow = page(next);
+        if (!overflow)
+            return QByteArray();
+
+        quint64 take = qMin<quint64>(usable - 4, size - quint64(result.size()));
+        result.append(reinterpret_cast<const char *>(overflow + 4), int(take));
+        next = qFromBigEndian<quint32>(overflow);
+    }
+    return result;
+}
+
+QVariantList SqliteTableReader::decodeRecord(const QByteArray &record)
+{
+    QVariantList columns;
+    const uchar *start = reinterpret_cast<const uchar *>(record.constData());
+    const uchar *end = start + record.size();
+
+    const uchar *p = start;
+    quint64 headerSize = 0;
+    if (!readVarint(p, end, headerSize) || headerSize > quint64(record.size()))
+        return columns;
+
+    const uchar *headerEnd = start + headerSize;
+    const uchar *body = headerEnd;
+    while (p < headerEnd)
+    {
+        quint64 serialType = 0;
+        if (!readVarint(p, headerEnd, serialType))
+            break;
+
+        // Serial types 1-6 are integers of these sizes
+        static const int integerSizes[] = {0, 1, 2, 3, 4, 6, 8};
+        quint64 length = 0;
+        if (serialType >= 1 && serialType <= 6)
+            length = quint64(integerSizes[serialType]);
+        else if (serialType == 7)
+            length = 8;
+        else if (serialType >= 12)
+            length = (serialType - 12) / 2;
+
+        if (body + length > end)
+            break;
+
+        if (serialType == 0)
+            columns.append(QVariant());
+        else if (serialType <= 6)
+            columns.append(qlonglong(readSignedBigEndian(body, int(length))));
+        else if (serialType == 7)
+        {
+            quint64 bits = qFromBigEndian<quint64>(body);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            columns.append(value);
+        }
+        else if (serialType == 8 || serialType == 9)
+            columns.append(qlonglong(serialType - 8));
+        else if (serialType >= 12 && serialType % 2 == 0)
+            columns.append(QByteArray(reinterpret_cast<const char *>(body), int(length)));
+        else if (serialType >= 13)
+            columns.append(QString::fromUtf8(reinterpret_cast<const char *>(body), int(length)));
+        else
+            columns.append(QVariant());
+
+        body += length;
+    }
+    return columns;
+}
@@ -0,0 +1,52 @@
+#ifndef SQLITETABLEREADER_H
+#define SQLITETABLEREADER_H
+
+#include <QString>
+#include <QVariantList>
+#include <QFile>
+#include <QByteArray>
+#include <functional>
+
+// Read-only walker over the table b-trees of an SQLite 3 database file.
+// It decodes records straight from the mapped pages (following overflow
+// chains), so a table can be dumped without linking SQLite or Qt SQL.
+// Only committed pages are seen: changes still in a -wal file are not.
+// Indexes, WITHOUT ROWID tables and writing are not supported.
+class SqliteTableReader
+{
+public:
+    // Columns as qlonglong, double, QString (text) or QByteArray (blob);
+    // return false to stop the walk
+    using RowCallback = std::function<bool(qint64 rowId, const QVariantList &columns)>;
+
+    SqliteTableReader();
+    ~SqliteTableReader();
+
+    bool open(const QString &filePath);
+    void close();
+    bool isOpen() const;
+    QString errorString() const;
+
+    // Root page of a table listed in sqlite_master; 0 if there is none
+    quint32 tableRootPage(const QString &tableName) const;
+    bool readTable(quint32 rootPage, const RowCallback &callback) const;
+
+private:
+    Q_DISABLE_COPY(SqliteTableReader)
+
+    QFile m_file;
+    QByteArray m_buffer; // used when the file cannot be mapped
+    const uchar *m_data;
+    qint64 m_size;
+    quint32 m_pageSize;
+    quint32 m_usableSize;
+    quint32 m_pageCount;
+    QString m_error;
+
+    const uchar *page(quint32 number) const;
+    bool walk(quint32 pageNumber, int depth, const RowCallback &callback, bool &stopped) const;
+    QByteArray payload(const uchar *cell, const uchar *pageEnd, quint64 size) const;
+    static QVariantList decodeRecord(const QByteArray &record);
+};
+
+#endif // SQLITETABLEREADER_H
@@ -0,0 +1,253 @@
+#include "startupchangetransaction.h"
+#include <QDataStream>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+namespace
+{
+    const quint32 JournalMagic = 0x5253544A; // "RSTJ"
+    const quint32 JournalVersion = 2;
+}
+
+StartupChangeTransaction::StartupChangeTransaction(const QList<StartupSource *> &sources, const QString &journalPath)
+    : m_sources(sources), m_journalPath(journalPath), m_applied(0), m_rolledBack(false)
+{
+}
+
+void StartupChangeTransaction::add(const StartupProgram &program, bool enable)
+{
+    if (program.isEnabled == enable)
+        return;
+
+    Change change;
+    change.program = program;
+    change.enable = enable;
+    m_changes.append(change);
+}
+
+int StartupChangeTransaction::size() const
+{
+    return m_changes.size();
+}
+
+int StartupChangeTransaction::appliedCount() const
+{
+    return m_applied;
+}
+
+bool StartupChangeTransaction::wasRolledBack() const
+{
+    return m_rolledBack;
+}
+
+QString StartupChangeTransaction::errorString() const
+{
+    return m_error;
+}
+
+bool StartupChangeTransaction::commit()
+{
+    m_applied = 0;
+    m_rolledBack = false;
+    m_error.clear();
+
+    if (m_changes.isEmpty())
+        return true;
+
+    // Without an exact prior state an entry could not be put back as it was
+    for (Change &change : m_changes)
+    {
+        const StartupSource *source = findSource(m_sources, change.program.source);
+        QString error = "The source of this entry is no longer available.";
+        if (!source || !source->saveState(change.program, change.priorState, error))
+        {
+            m_error = QString("'%1': %2\n\nNothing was changed.").arg(change.program.name, error);
+            return false;
+        }
+    }
+
+    // Nothing is touched unless the prior state is on disk first
+    if (!writeJournal(m_journalPath, m_changes, 0))
+    {
+        m_error = "The change journal could not be written, so nothing was changed.";
+        return false;
+    }
+
+    for (int i = 0; i < m_changes.size(); ++i)
+    {
+        const Change &change = m_changes[i];
+        const StartupSource *source = findSource(m_sources, change.program.source);
+
+        QString error = "The source of this entry is no longer available.";
+        bool applied = source && source->setEnabled(change.program, change.enable, error);
+        if (applied)
+        {
+            ++m_applied;
+
+            // Going on with a stale journal would leave this change out of a later recovery
+            if (!writeJournal(m_journalPath, m_changes, m_applied))
+            {
+                applied = false;
+                error = "The change journal could not be updated.";
+            }
+        }
+
+        if (!applied)
+        {
+            m_error = QString("'%1': %2").arg(change.program.name, error);
+
+            QStringList failures;
+            m_rolledBack = rollBack(m_sources, m_changes, m_applied, false, failures);
+            if (m_rolledBack)
+            {
+                m_applied = 0;
+                QFile::remove(m_journalPath);
+            }
+            else
+            {
+                // The journal stays, so the next start can finish the job
+                m_error += "\n\nThese changes could not be undone: " + failures.join(", ");
+            }
+            return false;
+        }
+    }
+
+    QFile::remove(m_journalPath);
+    return true;
+}
+
+QString StartupChangeTransaction::defaultJournalPath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/startup_journal.dat";
+}
+
+bool StartupChangeTransaction::hasPendingJournal(const QString &journalPath)
+{
+    return QFile::exists(journalPath);
+}
+
+bool StartupChangeTransaction::recover(const QList<StartupSource *> &sources, QString &error, const QString &journalPath)
+{
+    QList<Change> changes;
+    int applied = 0;
+    if (!readJournal(journalPath, changes, applied))
+    {
+        // Unreadable journals cannot be acted on; keeping them would only block every start
+        QFile::remove(journalPath);
+        return true;
+    }
+
+    // Every change went through; only removing the journal was missed
+    if (applied == changes.size())
+    {
+        QFile::remove(journalPath);
+        return true;
+    }
+
+    // The change after the last recorded one may or may not have happened
+    QStringList failures;
+    if (!rollBack(sources, changes, applied, true, failures))
+    {
+        error = "These changes from an interrupted batch could not be undone: " + failures.join(", ");
+        return false;
+    }
+
+    QFile::remove(journalPath);
+    return true;
+}
+
+const StartupSource *StartupChangeTransaction::findSource(const QList<StartupSource *> &sources, const QString &id)
+{
+    for (const StartupSource *source : sources)
+    {
+        if (source->id() == id)
+            return source;
+    }
+    return nullptr;
+}
+
+bool StartupChangeTransaction::rollBack(const QList<StartupSource *> &sources, const QList<Change> &changes,
+                                        int applied, bool includeInFlight, QStringList &failures)
+{
+    int last = includeInFlight && applied < changes.size() ? applied : applied - 1;
+    for (int i = last; i >= 0; --i)
+    {
+        const Change &change = changes[i];
+        const StartupSource *source = findSource(sources, change.program.source);
+
+        QString error;
+        if (source && source->restoreState(change.program, change.priorState, error))
+            continue;
+
+        // An in-flight change that never happened has nothing to undo
+        if (i == applied)
+            continue;
+
+        qDebug() << "Could not undo the change of" << change.program.name << ":" << error;
+        failures.append(change.program.name);
+    }
+    return failures.isEmpty();
+}
+
+bool StartupChangeTransaction::writeJournal(const QString &path, const QList<Change> &changes, int applied)
+{
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << JournalMagic << JournalVersion << qint32(applied) << qint32(changes.size());
+
+    for (const Change &change : changes)
+    {
+        const StartupProgram &program = change.program;
+        out << program.name << program.startupType << program.command << program.location
+            << program.source << program.isEnabled << change.enable << change.priorState;
+    }
+
+    return out.status() == QDataStream::Ok && file.commit();
+}
+
+bool StartupChangeTransaction::readJournal(const QString &path, QList<Change> &changes, int &applied)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    qint32 appliedCount = 0;
+    qint32 count = 0;
+    in >> magic >> version >> appliedCount >> count;
+
+    if (magic != JournalMagic || version != JournalVersion || count < 0 || appliedCount < 0 || appliedCount > count)
+        return false;
+
+    QList<Change> read;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        Change change;
+        StartupProgram &program = change.program;
+        in >> program.name >> program.startupType >> program.command >> program.location
+            >> program.source >> program.isEnabled >> change.enable >> change.priorState;
+        read.append(change);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    changes = read;
+    applied = appliedCount;
+    return true;
+}
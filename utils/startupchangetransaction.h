@@ -0,0 +1,58 @@
+#ifndef STARTUPCHANGETRANSACTION_H
+#define STARTUPCHANGETRANSACTION_H
+
+#include "startupsource.h"
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+// Applies a batch of enable/disable changes as one unit. Before the first
+// change a journal with every entry's prior state, as its source saved it,
+// is written, and it is updated after each applied change. If a change
+// fails, or the journal cannot be updated, the ones already applied are
+// restored to that state in reverse order; if the program dies halfway, the
+// journal is left behind and recover() restores them at the next start.
+class StartupChangeTransaction
+{
+public:
+    explicit StartupChangeTransaction(const QList<StartupSource *> &sources,
+                                      const QString &journalPath = defaultJournalPath());
+
+    // Entries already in the requested state are skipped
+    void add(const StartupProgram &program, bool enable);
+    int size() const;
+
+    bool commit();
+    int appliedCount() const; // changes that stayed in effect
+    bool wasRolledBack() const;
+    QString errorString() const;
+
+    static QString defaultJournalPath();
+    static bool hasPendingJournal(const QString &journalPath = defaultJournalPath());
+    // Undoes what an interrupted transaction applied and removes its journal
+    static bool recover(const QList<StartupSource *> &sources, QString &error,
+                        const QString &journalPath = defaultJournalPath());
+
+private:
+    struct Change
+    {
+        StartupProgram program; // as listed before the change
+        bool enable = false;
+        QByteArray priorState; // from StartupSource::saveState()
+    };
+
+    QList<StartupSource *> m_sources;
+    QString m_journalPath;
+    QList<Change> m_changes;
+    int m_applied;
+    bool m_rolledBack;
+    QString m_error;
+
+    static const StartupSource *findSource(const QList<StartupSource *> &sources, const QString &id);
+    static bool rollBack(const QList<StartupSource *> &sources, const QList<Change> &changes,
+                         int applied, bool includeInFlight, QStringList &failures);
+    static bool writeJournal(const QString &path, const QList<Change> &changes, int applied);
+    static bool readJournal(const QString &path, QList<Change> &changes, int &applied);
+};
+
+#endif // STARTUPCHANGETRANSACTION_H
@@ -0,0 +1,129 @@
+#include "startupfoldersource.h"
+#include "shelllinkparser.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <shlobj.h>
+
+#pragma comment(lib, "shell32.lib")
+#pragma comment(lib, "ole32.lib")
+
+namespace
+{
+    QString knownFolderPath(REFKNOWNFOLDERID folder)
+    {
+        wchar_t *path = nullptr;
+        QString result;
+        if (SHGetKnownFolderPath(folder, 0, nullptr, &path) == S_OK)
+            result = QDir::fromNativeSeparators(QString::fromWCharArray(path));
+        CoTaskMemFree(path);
+        return result;
+    }
+}
+#endif
+
+namespace
+{
+    bool isStartupFile(const QFileInfo &entry)
+    {
+        QString suffix = entry.suffix().toLower();
+        return suffix == "lnk" || suffix == "exe" || suffix == "bat" || suffix == "cmd";
+    }
+}
+
+StartupFolderSource::StartupFolderSource(const QString &folderPath, const QString &label)
+    : m_folderPath(folderPath), m_label(label)
+{
+}
+
+QString StartupFolderSource::id() const
+{
+    return "folder:" + m_folderPath;
+}
+
+QList<StartupProgram> StartupFolderSource::scan() const
+{
+    QList<StartupProgram> programs;
+
+    const QString folders[] = {m_folderPath, m_folderPath + "/Disabled"};
+    for (const QString &folder : folders)
+    {
+        bool enabled = folder == m_folderPath;
+        QFileInfoList entries = QDir(folder).entryInfoList(QDir::Files | QDir::NoDotAndDotDot | QDir::System);
+        for (const QFileInfo &entry : entries)
+        {
+            if (!isStartupFile(entry))
+                continue;
+
+            StartupProgram program;
+            program.name = entry.baseName();
+            program.status = enabled ? "Enabled" : "Disabled";
+            program.startupType = "Startup Folder";
+            program.command = entry.absoluteFilePath();
+            if (entry.suffix().compare("lnk", Qt::CaseInsensitive) == 0)
+            {
+                ShellLink link;
+                QString error;
+                if (ShellLinkParser::parseFile(entry.absoluteFilePath(), link, error))
+                {
+                    program.target = QString("\"%1\"").arg(link.targetPath);
+                    if (!link.arguments.isEmpty())
+                        program.target += " " + link.arguments;
+                }
+            }
+            program.location = enabled ? m_label : m_label + " (Disabled)";
+            program.isEnabled = enabled;
+            program.source = id();
+            programs.append(program);
+        }
+    }
+
+    return programs;
+}
+
+bool StartupFolderSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    // Looked up by name in the folder it has to leave, so an entry listed in
+    // one state can also be switched back after it moved
+    QString fileName = QFileInfo(program.command).fileName();
+    QFileInfo file(QDir(enable ? m_folderPath + "/Disabled" : m_folderPath).absoluteFilePath(fileName));
+    QDir target(enable ? m_folderPath : m_folderPath + "/Disabled");
+    if (!file.exists())
+    {
+        error = QString("'%1' was not found in %2.").arg(fileName, QDir::toNativeSeparators(file.absolutePath()));
+        return false;
+    }
+
+    if (!target.exists() && !target.mkpath("."))
+    {
+        error = QString("Could not create %1.").arg(target.absolutePath());
+        return false;
+    }
+
+    if (!QFile::rename(file.absoluteFilePath(), target.absoluteFilePath(file.fileName())))
+    {
+        error = QString("Could not move '%1'. Please ensure you're running as Administrator.").arg(file.fileName());
+        return false;
+    }
+    return true;
+}
+
+QList<StartupSource *> StartupFolderSource::createDefault()
+{
+    QList<StartupSource *> sources;
+
+#ifdef Q_OS_WIN
+    QString userFolder = knownFolderPath(FOLDERID_Startup);
+    if (!userFolder.isEmpty())
+        sources.append(new StartupFolderSource(userFolder, "Current User"));
+
+    QString commonFolder = knownFolderPath(FOLDERID_CommonStartup);
+    if (!commonFolder.isEmpty())
+        sources.append(new StartupFolderSource(commonFolder, "All Users"));
+#endif
+
+    return sources;
+}
@@ -0,0 +1,26 @@
+#ifndef STARTUPFOLDERSOURCE_H
+#define STARTUPFOLDERSOURCE_H
+
+#include "startupsource.h"
+
+// Shortcuts and programs in a Startup folder of the Start menu. Disabled
+// entries are moved into a "Disabled" subfolder, which Windows ignores.
+class StartupFolderSource : public StartupSource
+{
+public:
+    // label is what the UI calls the folder ("Current User", "All Users")
+    StartupFolderSource(const QString &folderPath, const QString &label);
+
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+
+    // The current user's and the all-users Startup folders
+    static QList<StartupSource *> createDefault();
+
+private:
+    QString m_folderPath;
+    QString m_label;
+};
+
+#endif // STARTUPFOLDERSOURCE_H
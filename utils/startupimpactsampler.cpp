@@ -0,0 +1,572 @@
+#include "startupimpactsampler.h"
+#include "shelllinkparser.h"
+#include "logoncommand.h"
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QRegularExpression>
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <tlhelp32.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#elif defined(Q_OS_LINUX)
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const quint32 ImpactMagic = 0x5253494D; // "RSIM"
+    const quint32 ImpactVersion = 1;
+    const int DefaultWindowSeconds = 180;
+    const int SampleIntervalMs = 5000;
+    const int MaxParentDepth = 32;
+
+    LogonCommand measurerCommand()
+    {
+        return LogonCommand{"Raptor Startup Impact", "raptor-startup-impact.desktop",
+                            "Measures what startup programs use after logon", StartupImpactSampler::measureArgument()};
+    }
+
+#ifdef Q_OS_WIN
+    // FILETIME counts 100 ns units since 1601
+    qint64 fileTimeToMs(const FILETIME &time)
+    {
+        quint64 value = (quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+        return qint64(value / 10000) - 11644473600000LL;
+    }
+
+    qint64 durationToMs(const FILETIME &time)
+    {
+        return qint64(((quint64(time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10000);
+    }
+
+    bool queryUsage(DWORD pid, ProcessUsage &usage)
+    {
+        HANDLE process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION | PROCESS_VM_READ, FALSE, pid);
+        if (!process)
+            process = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, pid);
+        if (!process)
+            return false;
+
+        FILETIME created, exited, kernel, user;
+        bool ok = GetProcessTimes(process, &created, &exited, &kernel, &user);
+        if (ok)
+        {
+            usage.startedAt = fileTimeToMs(created);
+            usage.cpuMs = durationToMs(kernel) + durationToMs(user);
+        }
+
+        IO_COUNTERS io;
+        if (GetProcessIoCounters(process, &io))
+            usage.diskReadBytes = qint64(io.ReadTransferCount);
+
+        PROCESS_MEMORY_COUNTERS memory;
+        if (GetProcessMemoryInfo(process, &memory, sizeof(memory)))
+            usage.residentBytes = qint64(memory.WorkingSetSize);
+
+        wchar_t buffer[MAX_PATH * 4];
+        DWORD length = DWORD(sizeof(buffer) / sizeof(buffer[0]));
+        if (QueryFullProcessImageNameW(process, 0, buffer, &length))
+            usage.executablePath = QDir::fromNativeSeparators(QString::fromWCharArray(buffer, int(length)));
+
+        CloseHandle(process);
+        return ok;
+    }
+#elif defined(Q_OS_LINUX)
+    qint64 bootTimeMs()
+    {
+        QFile stat("/proc/stat");
+        if (!stat.open(QIODevice::ReadOnly))
+            return 0;
+
+        for (const QByteArray &line : stat.readAll().split('\n'))
+        {
+            if (line.startsWith("btime "))
+                return line.mid(6).trimmed().toLongLong() * 1000;
+        }
+        return 0;
+    }
+
+    // "pid (comm) state ppid ... utime stime ... starttime vsize rss ..."
+    bool readStat(const QString &procDir, qint64 bootMs, ProcessUsage &usage)
+    {
+        QFile stat(procDir + "/stat");
+        if (!stat.open(QIODevice::ReadOnly))
+            return false;
+
+        QByteArray line = stat.readAll();
+        int end = line.lastIndexOf(')');
+        if (end < 0)
+            return false;
+
+        // Counted from the state field, the third field of the line
+        QList<QByteArray> fields = line.mid(end + 2).split(' ');
+        if (fields.size() < 22)
+            return false;
+
+        static const qint64 ticksPerSecond = sysconf(_SC_CLK_TCK);
+        static const qint64 pageSize = sysconf(_SC_PAGESIZE);
+
+        usage.parentPid = fields[1].toUInt();
+        usage.cpuMs = (fields[11].toLongLong() + fields[12].toLongLong()) * 1000 / ticksPerSecond;
+        usage.startedAt = bootMs + fields[19].toLongLong() * 1000 / ticksPerSecond;
+        usage.residentBytes = fields[21].toLongLong() * pageSize;
+        return true;
+    }
+
+    qint64 readBytes(const QString &procDir)
+    {
+        // Only readable for the user's own processes
+        QFile io(procDir + "/io");
+        if (!io.open(QIODevice::ReadOnly))
+            return 0;
+
+        for (const QByteArray &line : io.readAll().split('\n'))
+        {
+            if (line.startsWith("read_bytes:"))
+                return line.mid(11).trimmed().toLongLong();
+        }
+        return 0;
+    }
+#endif
+}
+
+QString StartupImpact::level() const
+{
+    if (cpuMs > 1000 || diskReadBytes > 3 * 1024 * 1024)
+        return "High";
+    if (cpuMs > 300 || diskReadBytes > 300 * 1024)
+        return "Medium";
+    return "Low";
+}
+
+StartupImpactSampler::StartupImpactSampler(QObject *parent)
+    : QObject(parent), m_timer(new QTimer(this)), m_sampleWatcher(new QFutureWatcher<QList<ProcessUsage>>(this)),
+      m_windowSeconds(DefaultWindowSeconds)
+{
+    m_timer->setInterval(SampleIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &StartupImpactSampler::sample);
+    connect(m_sampleWatcher, &QFutureWatcher<QList<ProcessUsage>>::finished, this, &StartupImpactSampler::onSampleFinished);
+}
+
+StartupImpactSampler::~StartupImpactSampler()
+{
+    m_timer->stop();
+    m_sampleWatcher->waitForFinished();
+}
+
+void StartupImpactSampler::setTargets(const QHash<QString, QString> &executables)
+{
+    m_targets = executables;
+    if (!m_seen.isEmpty())
+    {
+        attribute();
+        emit impactsUpdated();
+    }
+}
+
+void StartupImpactSampler::start()
+{
+    QDateTime session = currentSessionStart();
+    if (QDateTime::currentDateTime() < session.addSecs(m_windowSeconds))
+    {
+        // Still inside the window: measure this session
+        m_sessionStart = session;
+        m_seen.clear();
+        m_peakResident.clear();
+        m_impacts.clear();
+        sample();
+        m_timer->start();
+        return;
+    }
+
+    // Too late to measure; show what the last measured session used
+    if (load(defaultFilePath()))
+        emit impactsUpdated();
+    emit finished();
+}
+
+bool StartupImpactSampler::isSampling() const
+{
+    return m_timer->isActive();
+}
+
+QHash<QString, StartupImpact> StartupImpactSampler::impacts() const
+{
+    return m_impacts;
+}
+
+QDateTime StartupImpactSampler::sessionStart() const
+{
+    return m_sessionStart;
+}
+
+void StartupImpactSampler::sample()
+{
+    if (m_sampleWatcher->isRunning())
+        return;
+    m_sampleWatcher->setFuture(QtConcurrent::run(&StartupImpactSampler::sampleProcesses));
+}
+
+void StartupImpactSampler::onSampleFinished()
+{
+    const QList<ProcessUsage> processes = m_sampleWatcher->result();
+    qint64 windowStart = m_sessionStart.toMSecsSinceEpoch();
+    qint64 windowStop = windowEnd().toMSecsSinceEpoch();
+    const quint32 ownPid = quint32(QCoreApplication::applicationPid());
+
+    for (const ProcessUsage &process : processes)
+    {
+        // The measurer shares its executable with the delayed start launcher
+        if (process.pid == ownPid || process.startedAt < windowStart || process.startedAt > windowStop)
+            continue;
+
+        // pid and start time together survive pid reuse
+        QString key = QString::number(process.pid) + ":" + QString::number(process.startedAt);
+        m_seen.insert(key, process);
+        qint64 &peak = m_peakResident[key];
+        peak = qMax(peak, process.residentBytes);
+    }
+
+    attribute();
+    emit impactsUpdated();
+
+    if (QDateTime::currentDateTime() >= windowEnd())
+    {
+        m_timer->stop();
+        save(defaultFilePath());
+        emit finished();
+    }
+}
+
+void StartupImpactSampler::attribute()
+{
+    QHash<QString, QString> entryByPath;
+    for (auto it = m_targets.constBegin(); it != m_targets.constEnd(); ++it)
+    {
+        if (!it.value().isEmpty())
+            entryByPath.insert(normalizedPath(it.value()), it.key());
+    }
+
+    QHash<quint32, const ProcessUsage *> byPid;
+    for (const ProcessUsage &process : m_seen)
+    {
+        const ProcessUsage *&known = byPid[process.pid];
+        if (!known || known->startedAt < process.startedAt)
+            known = &process;
+    }
+
+    m_impacts.clear();
+    for (auto it = m_seen.constBegin(); it != m_seen.constEnd(); ++it)
+    {
+        // A process counts for the entry that launched it or one of its ancestors
+        const ProcessUsage *current = &it.value();
+        QString entry;
+        for (int depth = 0; current && depth < MaxParentDepth; ++depth)
+        {
+            entry = entryByPath.value(normalizedPath(current->executablePath));
+            if (!entry.isEmpty())
+                break;
+
+            const ProcessUsage *parent = byPid.value(current->parentPid);
+            if (!parent || parent == current || parent->startedAt > current->startedAt)
+                break;
+            current = parent;
+        }
+        if (entry.isEmpty())
+            continue;
+
+        StartupImpact &impact = m_impacts[entry];
+        impact.cpuMs += it->cpuMs;
+        impact.diskReadBytes += it->diskReadBytes;
+        impact.peakResidentBytes += m_peakResident.value(it.key());
+        impact.processCount++;
+    }
+}
+
+QDateTime StartupImpactSampler::windowEnd() const
+{
+    return m_sessionStart.addSecs(m_windowSeconds);
+}
+
+QList<ProcessUsage> StartupImpactSampler::sampleProcesses()
+{
+    QList<ProcessUsage> processes;
+
+#ifdef Q_OS_WIN
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot == INVALID_HANDLE_VALUE)
+        return processes;
+
+    PROCESSENTRY32W entry;
+    entry.dwSize = sizeof(entry);
+    if (Process32FirstW(snapshot, &entry))
+    {
+        do
+        {
+            ProcessUsage usage;
+            usage.pid = entry.th32ProcessID;
+            usage.parentPid = entry.th32ParentProcessID;
+            if (usage.pid != 0 && queryUsage(entry.th32ProcessID, usage))
+                processes.append(usage);
+        } while (Process32NextW(snapshot, &entry));
+    }
+
+    CloseHandle(snapshot);
+#elif defined(Q_OS_LINUX)
+    qint64 bootMs = bootTimeMs();
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries)
+    {
+        bool isPid = false;
+        quint32 pid = entry.toUInt(&isPid);
+        if (!isPid)
+            continue;
+
+        QString procDir = "/proc/" + entry;
+        ProcessUsage usage;
+        usage.pid = pid;
+        if (!readStat(procDir, bootMs, usage))
+            continue;
+
+        usage.diskReadBytes = readBytes(procDir);
+        usage.executablePath = QFile::symLinkTarget(procDir + "/exe");
+        if (usage.executablePath.endsWith(" (deleted)"))
+            usage.executablePath.chop(10);
+        processes.append(usage);
+    }
+#endif
+
+    return processes;
+}
+
+QDateTime StartupImpactSampler::currentSessionStart()
+{
+    qint64 earliest = 0;
+
+#ifdef Q_OS_WIN
+    // The session's shell starts at logon
+    DWORD currentSession = 0;
+    ProcessIdToSessionId(GetCurrentProcessId(), &currentSession);
+
+    HANDLE snapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+    if (snapshot != INVALID_HANDLE_VALUE)
+    {
+        PROCESSENTRY32W entry;
+        entry.dwSize = sizeof(entry);
+        if (Process32FirstW(snapshot, &entry))
+        {
+            do
+            {
+                DWORD session = 0;
+                if (_wcsicmp(entry.szExeFile, L"explorer.exe") != 0 ||
+                    !ProcessIdToSessionId(entry.th32ProcessID, &session) || session != currentSession)
+                    continue;
+
+                ProcessUsage usage;
+                if (queryUsage(entry.th32ProcessID, usage) && (earliest == 0 || usage.startedAt < earliest))
+                    earliest = usage.startedAt;
+            } while (Process32NextW(snapshot, &entry));
+        }
+        CloseHandle(snapshot);
+    }
+
+    if (earliest == 0)
+        earliest = QDateTime::currentMSecsSinceEpoch() - qint64(GetTickCount64());
+#elif defined(Q_OS_LINUX)
+    // The user's oldest process is the login session (or its user manager)
+    qint64 bootMs = bootTimeMs();
+    const uint uid = getuid();
+    const QStringList entries = QDir("/proc").entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QString &entry : entries)
+    {
+        bool isPid = false;
+        entry.toUInt(&isPid);
+        if (!isPid)
+            continue;
+
+        QString procDir = "/proc/" + entry;
+        ProcessUsage usage;
+        if (QFileInfo(procDir).ownerId() == uid && readStat(procDir, bootMs, usage) &&
+            (earliest == 0 || usage.startedAt < earliest))
+            earliest = usage.startedAt;
+    }
+
+    if (earliest == 0)
+        earliest = bootMs;
+#endif
+
+    return earliest > 0 ? QDateTime::fromMSecsSinceEpoch(earliest) : QDateTime::currentDateTime();
+}
+
+QString StartupImpactSampler::executableFromCommand(const QString &command)
+{
+    QString text = command.trimmed();
+
+#ifdef Q_OS_WIN
+    // Run values are often REG_EXPAND_SZ: "%ProgramFiles%\App\app.exe"
+    static const QRegularExpression variable("%([^%]+)%");
+    QRegularExpressionMatch match = variable.match(text);
+    while (match.hasMatch())
+    {
+        QString value = qEnvironmentVariable(match.captured(1).toLocal8Bit().constData());
+        text.replace(match.capturedStart(), match.capturedLength(), value);
+        match = variable.match(text, match.capturedStart() + value.size());
+    }
+#endif
+
+    QString program;
+    if (text.startsWith('"'))
+    {
+        int end = text.indexOf('"', 1);
+        program = end > 0 ? text.mid(1, end - 1) : text.mid(1);
+    }
+    else
+    {
+#ifdef Q_OS_WIN
+        // Unquoted paths may contain spaces; the extension ends them
+        int exe = text.indexOf(".exe", 0, Qt::CaseInsensitive);
+        program = exe >= 0 ? text.left(exe + 4) : text.section(' ', 0, 0);
+#else
+        program = text.section(' ', 0, 0);
+#endif
+    }
+
+    if (program.isEmpty())
+        return QString();
+
+    // Shortcuts in the startup folders are read without going through the shell
+    if (program.endsWith(".lnk", Qt::CaseInsensitive))
+    {
+        ShellLink link;
+        QString error;
+        if (ShellLinkParser::parseFile(program, link, error) && !link.targetPath.isEmpty() &&
+            !link.targetPath.endsWith(".lnk", Qt::CaseInsensitive))
+            return executableFromCommand("\"" + link.targetPath + "\"");
+    }
+
+    if (QFileInfo(program).isRelative())
+    {
+        QString found = QStandardPaths::findExecutable(program);
+        if (!found.isEmpty())
+            program = found;
+    }
+
+    return QDir::fromNativeSeparators(program);
+}
+
+QString StartupImpactSampler::defaultFilePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/startup_impact.dat";
+}
+
+QString StartupImpactSampler::entryKey(const StartupProgram &program)
+{
+    QString subject = program.target.isEmpty() ? program.name : executableFromCommand(program.target);
+    return subject.toLower() + "|" + program.startupType;
+}
+
+QHash<QString, QString> StartupImpactSampler::targetsFor(const QList<StartupProgram> &programs)
+{
+    // Processes are attributed to entries through the executables they start
+    QHash<QString, QString> executables;
+    for (const StartupProgram &program : programs)
+    {
+        if (program.startupType == "Service" || program.startupType == "Scheduled Task" ||
+            program.command.contains(measureArgument()))
+            continue;
+        executables.insert(entryKey(program),
+                           executableFromCommand(program.target.isEmpty() ? program.command : program.target));
+    }
+    return executables;
+}
+
+QString StartupImpactSampler::measureArgument()
+{
+    return "--measure-startup";
+}
+
+bool StartupImpactSampler::isMeasurerRegistered()
+{
+    return measurerCommand().isRegistered();
+}
+
+bool StartupImpactSampler::setMeasurerRegistered(bool registered, QString &error)
+{
+    return measurerCommand().setRegistered(registered, error);
+}
+
+QString StartupImpactSampler::normalizedPath(const QString &path)
+{
+    QString cleaned = QDir::cleanPath(QDir::fromNativeSeparators(path));
+#ifdef Q_OS_WIN
+    return cleaned.toCaseFolded();
+#else
+    return cleaned;
+#endif
+}
+
+bool StartupImpactSampler::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    QDateTime session;
+    qint32 count = 0;
+    in >> magic >> version >> session >> count;
+
+    if (magic != ImpactMagic || version != ImpactVersion || count < 0)
+        return false;
+
+    QHash<QString, StartupImpact> impacts;
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i)
+    {
+        QString key;
+        StartupImpact impact;
+        qint32 processCount = 0;
+        in >> key >> impact.cpuMs >> impact.diskReadBytes >> impact.peakResidentBytes >> processCount;
+        impact.processCount = processCount;
+        impacts.insert(key, impact);
+    }
+
+    if (in.status() != QDataStream::Ok)
+        return false;
+
+    m_sessionStart = session;
+    m_impacts = impacts;
+    return true;
+}
+
+bool StartupImpactSampler::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << ImpactMagic << ImpactVersion << m_sessionStart << qint32(m_impacts.size());
+
+    for (auto it = m_impacts.constBegin(); it != m_impacts.constEnd(); ++it)
+    {
+        out << it.key() << it->cpuMs << it->diskReadBytes << it->peakResidentBytes << qint32(it->processCount);
+    }
+
+    return out.status() == QDataStream::Ok;
+}
@@ -0,0 +1,106 @@
+#ifndef STARTUPIMPACTSAMPLER_H
+#define STARTUPIMPACTSAMPLER_H
+
+#include <QObject>
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QDateTime>
+#include <QFutureWatcher>
+#include "startupsource.h"
+
+class QTimer;
+
+struct ProcessUsage
+{
+    quint32 pid = 0;
+    quint32 parentPid = 0;
+    QString executablePath;
+    qint64 startedAt = 0;     // ms since the epoch
+    qint64 cpuMs = 0;         // user + kernel time since the process started
+    qint64 diskReadBytes = 0; // bytes read since the process started
+    qint64 residentBytes = 0; // working set / RSS at sampling time
+};
+
+// What the processes of one startup entry, and the processes they spawned,
+// used during the measurement window after logon
+struct StartupImpact
+{
+    qint64 cpuMs = 0;
+    qint64 diskReadBytes = 0;
+    qint64 peakResidentBytes = 0;
+    int processCount = 0;
+
+    // Task Manager's thresholds: High above 1 s CPU or 3 MB read, Medium above 300 ms or 300 KB
+    QString level() const;
+};
+
+// Measures startup impact instead of guessing it. While the current logon
+// session is younger than the measurement window, every process is sampled
+// periodically (CPU time, bytes read and resident memory; from /proc on
+// Linux) and processes started inside the window are attributed to the
+// startup entry whose executable launched them, directly or through child
+// processes. Results are saved when the window closes, so later launches
+// show the last session's measurements. So that sessions are measured
+// without the window being opened right after logon, the user can register
+// the logon helper to run headless at logon with measureArgument().
+class StartupImpactSampler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit StartupImpactSampler(QObject *parent = nullptr);
+    ~StartupImpactSampler();
+
+    // Entry key -> executable path; entries without a path cannot be measured
+    void setTargets(const QHash<QString, QString> &executables);
+    void start();
+    bool isSampling() const;
+
+    QHash<QString, StartupImpact> impacts() const;
+    QDateTime sessionStart() const;
+
+    static QList<ProcessUsage> sampleProcesses();
+    static QDateTime currentSessionStart();
+    // The program a Run value or shortcut starts, without its arguments
+    static QString executableFromCommand(const QString &command);
+    static QString defaultFilePath();
+
+    // The key an entry's measurement is stored under; shortcuts share the program they launch
+    static QString entryKey(const StartupProgram &program);
+    // Services and tasks run before or apart from the logon being measured
+    static QHash<QString, QString> targetsFor(const QList<StartupProgram> &programs);
+
+    static QString measureArgument();
+    static bool isMeasurerRegistered();
+    static bool setMeasurerRegistered(bool registered, QString &error);
+
+signals:
+    void impactsUpdated();
+    // The window closed and the results were saved, or it had closed before start()
+    void finished();
+
+private slots:
+    void sample();
+    void onSampleFinished();
+
+private:
+    QTimer *m_timer;
+    QFutureWatcher<QList<ProcessUsage>> *m_sampleWatcher;
+    QHash<QString, QString> m_targets;
+    QHash<QString, StartupImpact> m_impacts;
+    QDateTime m_sessionStart;
+    int m_windowSeconds;
+
+    // Latest sample of every process started in the window, including exited ones
+    QHash<QString, ProcessUsage> m_seen;
+    QHash<QString, qint64> m_peakResident;
+
+    void attribute();
+    QDateTime windowEnd() const;
+    static QString normalizedPath(const QString &path);
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+};
+
+#endif // STARTUPIMPACTSAMPLER_H
@@ -0,0 +1,25 @@
+#include "startupsource.h"
+
+StartupSource::~StartupSource()
+{
+}
+
+bool StartupSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    Q_UNUSED(program);
+    Q_UNUSED(enable);
+    error = "This startup entry cannot be changed.";
+    return false;
+}
+
+bool StartupSource::saveState(const StartupProgram &program, QByteArray &state, QString &error) const
+{
+    Q_UNUSED(error);
+    state = program.isEnabled ? "enabled" : "disabled";
+    return true;
+}
+
+bool StartupSource::restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const
+{
+    return setEnabled(program, state == "enabled", error);
+}
@@ -0,0 +1,62 @@
+#ifndef STARTUPSOURCE_H
+#define STARTUPSOURCE_H
+
+#include <QString>
+#include <QList>
+#include <QDateTime>
+#include <QByteArray>
+
+struct StartupProgram
+{
+    QString name;
+    QString status;      // "Enabled" or "Disabled"
+    QString impact;      // "High", "Medium", "Low" or "Not measured"
+    QString startupType; // "Registry", "Startup Folder", "Service", "Scheduled Task", "Autostart", "Systemd Unit", "Cron"
+    QString command;
+    QString target; // what a shortcut launches, "\"path\" arguments"; empty for other entries
+    QString location;
+    bool isEnabled = false;
+    QString source; // id() of the StartupSource that listed it
+
+    // Measured in the minutes after logon by StartupImpactSampler
+    bool measured = false;
+    qint64 cpuMs = 0;
+    qint64 diskReadBytes = 0;
+    qint64 memoryBytes = 0;
+
+    // Launch history from the program's Windows Prefetch file, if it has one
+    int launchCount = 0;
+    QDateTime lastLaunch;
+    int launchFiles = 0;        // files read during a launch
+    qint64 launchReadBytes = 0; // estimated from the traced blocks
+
+    // Where a system unit stood in the last boot: "Critical path", "Parallel",
+    // "After boot" or "Not started"; empty for other entries
+    QString bootRole;
+    qint64 activationMs = 0; // from its start job beginning to active
+};
+
+// A place programs are started from at boot or logon (a Run key, a startup
+// folder, the service manager, XDG autostart, ...). Sources are scanned
+// concurrently on pool threads, so implementations must allow concurrent
+// const calls. Enabling and disabling happen on the GUI thread.
+class StartupSource
+{
+public:
+    virtual ~StartupSource();
+
+    // Stable name; StartupProgram::source refers to it
+    virtual QString id() const = 0;
+    virtual QList<StartupProgram> scan() const = 0;
+
+    // Moves a listed entry between its enabled and disabled state
+    virtual bool setEnabled(const StartupProgram &program, bool enable, QString &error) const;
+
+    // The entry's current state in the source's own terms, opaque to callers,
+    // for restoreState() to put back exactly; where enabled and disabled are
+    // the only states, that is all it records
+    virtual bool saveState(const StartupProgram &program, QByteArray &state, QString &error) const;
+    virtual bool restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const;
+};
+
+#endif // STARTUPSOURCE_H
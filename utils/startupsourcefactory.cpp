@@ -0,0 +1,28 @@
+#include "startupsourcefactory.h"
+#include "registrystartupsource.h"
+#include "startupfoldersource.h"
+#include "servicestartupsource.h"
+#include "scheduledtaskstartupsource.h"
+#include "xdgautostartsource.h"
+#include "systemdunitsource.h"
+#include "cronrebootsource.h"
+
+QList<StartupSource *> StartupSourceFactory::createDefaultSources()
+{
+    QList<StartupSource *> sources;
+
+#ifdef Q_OS_WIN
+    sources.append(new RegistryStartupSource("HKEY_CURRENT_USER\\Software\\Microsoft\\Windows\\CurrentVersion\\Run"));
+    sources.append(new RegistryStartupSource("HKEY_LOCAL_MACHINE\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run"));
+    sources.append(StartupFolderSource::createDefault());
+    sources.append(new ServiceStartupSource());
+    sources.append(new ScheduledTaskStartupSource());
+#elif defined(Q_OS_LINUX)
+    sources.append(new XdgAutostartSource());
+    sources.append(new SystemdUnitSource(SystemdUnitSource::User));
+    sources.append(new SystemdUnitSource(SystemdUnitSource::System));
+    sources.append(new CronRebootSource());
+#endif
+
+    return sources;
+}
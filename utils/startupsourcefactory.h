@@ -0,0 +1,17 @@
+#ifndef STARTUPSOURCEFACTORY_H
+#define STARTUPSOURCEFACTORY_H
+
+#include <QList>
+#include "startupsource.h"
+
+// The startup sources of the running system, shared by the Startup tab and
+// the logon helper, which has no window to build them from
+class StartupSourceFactory
+{
+public:
+    // Run keys, startup folders, services and scheduled tasks on Windows;
+    // XDG autostart, systemd units and cron @reboot jobs on Linux
+    static QList<StartupSource *> createDefaultSources();
+};
+
+#endif // STARTUPSOURCEFACTORY_H
@@ -0,0 +1,195 @@
+#include "systemdunitsource.h"
+#include "keywordclassifier.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QProcess>
+#include <QSet>
+
+namespace
+{
+    struct UnitFile
+    {
+        QString description;
+        QString execStart;
+        QStringList wantedBy;
+    };
+
+    UnitFile readUnitFile(const QString &path)
+    {
+        UnitFile unit;
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return unit;
+
+        QString section;
+        const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+        for (const QString &rawLine : lines)
+        {
+            QString line = rawLine.trimmed();
+            if (line.isEmpty() || line.startsWith('#') || line.startsWith(';'))
+                continue;
+            if (line.startsWith('['))
+            {
+                section = line;
+                continue;
+            }
+
+            int equals = line.indexOf('=');
+            if (equals <= 0)
+                continue;
+            QString key = line.left(equals).trimmed();
+            QString value = line.mid(equals + 1).trimmed();
+
+            if (section == "[Unit]" && key == "Description")
+                unit.description = value;
+            else if (section == "[Service]" && key == "ExecStart" && unit.execStart.isEmpty())
+                unit.execStart = value;
+            else if (section == "[Install]" && (key == "WantedBy" || key == "RequiredBy"))
+                unit.wantedBy += value.split(' ', Qt::SkipEmptyParts);
+        }
+        return unit;
+    }
+
+    // ExecStart may carry "-", "@", "+", "!" or ":" prefixes before the path
+    QString stripExecPrefixes(QString command)
+    {
+        while (!command.isEmpty() && QString("-@+!:").contains(command.at(0)))
+            command.remove(0, 1);
+        return command;
+    }
+}
+
+SystemdUnitSource::SystemdUnitSource(Scope scope)
+    : m_scope(scope), m_unitDirs(searchPath(scope)), m_configDirs(configDirs(scope))
+{
+}
+
+QStringList SystemdUnitSource::configDirs(Scope scope)
+{
+    if (scope == System)
+        return QStringList() << "/etc/systemd/system";
+
+    QString configHome = QString::fromLocal8Bit(qgetenv("XDG_CONFIG_HOME"));
+    if (configHome.isEmpty())
+        configHome = QDir::homePath() + "/.config";
+
+    // /etc/systemd/user holds links made with "systemctl --global enable"
+    return QStringList() << configHome + "/systemd/user" << "/etc/systemd/user";
+}
+
+QStringList SystemdUnitSource::searchPath(Scope scope)
+{
+    QStringList dirs = configDirs(scope);
+    if (scope == System)
+        dirs << "/run/systemd/system" << "/usr/local/lib/systemd/system" << "/usr/lib/systemd/system"
+             << "/lib/systemd/system";
+    else
+        dirs << QDir::homePath() + "/.local/share/systemd/user" << "/usr/local/lib/systemd/user"
+             << "/usr/lib/systemd/user";
+    return dirs;
+}
+
+QString SystemdUnitSource::id() const
+{
+    return m_scope == System ? "systemd:system" : "systemd:user";
+}
+
+QList<StartupProgram> SystemdUnitSource::scan() const
+{
+    static const QSet<QString> startTargets = {"multi-user.target", "graphical.target", "default.target",
+                                               "graphical-session.target"};
+
+    QList<StartupProgram> programs;
+    QSet<QString> seen;
+    const KeywordClassifier &classifier = KeywordClassifier::standard();
+
+    for (const QString &dirPath : m_unitDirs)
+    {
+        QFileInfoList files = QDir(dirPath).entryInfoList(QStringList() << "*.service", QDir::Files | QDir::System);
+        for (const QFileInfo &file : files)
+        {
+            // The first directory that has a unit name wins; templates have no single instance to list
+            QString unitName = file.fileName();
+            if (seen.contains(unitName) || unitName.contains('@'))
+                continue;
+            seen.insert(unitName);
+
+            // Masked units link to /dev/null and cannot be started at all
+            if (file.isSymLink() && file.symLinkTarget() == "/dev/null")
+                continue;
+
+            UnitFile unit = readUnitFile(file.absoluteFilePath());
+            QStringList targets;
+            for (const QString &target : unit.wantedBy)
+            {
+                if (startTargets.contains(target))
+                    targets.append(target);
+            }
+            if (targets.isEmpty())
+                continue;
+
+            QString name = file.completeBaseName();
+            if (m_scope == System &&
+                (classifier.classify(name, KeywordClassifier::Name) & KeywordCategory::SystemService))
+                continue;
+
+            bool isEnabled = false;
+            for (const QString &configDir : m_configDirs)
+            {
+                for (const QString &target : targets)
+                {
+                    QFileInfo link(configDir + "/" + target + ".wants/" + unitName);
+                    if (link.isSymLink() || link.exists())
+                        isEnabled = true;
+                }
+            }
+
+            StartupProgram program;
+            program.name = name;
+            program.status = isEnabled ? "Enabled" : "Disabled";
+            program.startupType = "Systemd Unit";
+            program.command = stripExecPrefixes(unit.execStart);
+            program.location = file.absoluteFilePath();
+            program.isEnabled = isEnabled;
+            program.source = id();
+            programs.append(program);
+        }
+    }
+
+    return programs;
+}
+
+bool SystemdUnitSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    QStringList args;
+    if (m_scope == User)
+        args << "--user";
+    args << (enable ? "enable" : "disable") << QFileInfo(program.location).fileName();
+
+    QProcess process;
+    process.setProcessChannelMode(QProcess::MergedChannels);
+    process.start("systemctl", args);
+
+    if (!process.waitForStarted(3000))
+    {
+        error = "systemctl could not be started.";
+        return false;
+    }
+
+    if (!process.waitForFinished(10000))
+    {
+        process.kill();
+        error = "systemctl did not finish in time.";
+        return false;
+    }
+
+    if (process.exitStatus() != QProcess::NormalExit || process.exitCode() != 0)
+    {
+        error = QString::fromLocal8Bit(process.readAll()).trimmed();
+        if (error.isEmpty())
+            error = "systemctl failed. System units need administrator rights.";
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef SYSTEMDUNITSOURCE_H
+#define SYSTEMDUNITSOURCE_H
+
+#include "startupsource.h"
+#include <QStringList>
+
+// systemd service units that can be enabled for boot (system scope) or for
+// the user's session (user scope), i.e. whose [Install] section is wanted by
+// one of the usual start targets. A unit is enabled when the target's .wants
+// directory links to it; changes go through systemctl.
+class SystemdUnitSource : public StartupSource
+{
+public:
+    enum Scope
+    {
+        System,
+        User
+    };
+
+    explicit SystemdUnitSource(Scope scope);
+
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+
+    // Unit directories of a scope, highest precedence first
+    static QStringList searchPath(Scope scope);
+
+private:
+    Scope m_scope;
+    QStringList m_unitDirs;   // search path, highest precedence first
+    QStringList m_configDirs; // where "systemctl enable" leaves its links
+
+    static QStringList configDirs(Scope scope);
+};
+
+#endif // SYSTEMDUNITSOURCE_H
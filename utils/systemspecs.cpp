@@ -0,0 +1,77 @@
+#include "systemspecs.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QStandardPaths>
+
+namespace
+{
+    const quint32 SpecsMagic = 0x52535053; // "RSPS"
+    const quint32 SpecsVersion = 1;
+}
+
+bool SystemSpecs::isEmpty() const
+{
+    return osName.isEmpty() && cpuName.isEmpty() && ramTotal.isEmpty() && storageTotal.isEmpty() && gpuName.isEmpty();
+}
+
+bool SystemSpecs::operator==(const SystemSpecs &other) const
+{
+    return osName == other.osName && cpuName == other.cpuName && cpuCores == other.cpuCores &&
+           ramTotal == other.ramTotal && ramSpeed == other.ramSpeed && storageTotal == other.storageTotal &&
+           gpuName == other.gpuName && gpuVRAM == other.gpuVRAM;
+}
+
+bool SystemSpecs::operator!=(const SystemSpecs &other) const
+{
+    return !(*this == other);
+}
+
+bool SystemSpecs::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    in >> magic >> version;
+    if (magic != SpecsMagic || version != SpecsVersion)
+        return false;
+
+    SystemSpecs specs;
+    in >> specs.osName >> specs.cpuName >> specs.cpuCores >> specs.ramTotal >> specs.ramSpeed >> specs.storageTotal >>
+        specs.gpuName >> specs.gpuVRAM >> specs.probedAt;
+
+    if (in.status() != QDataStream::Ok || specs.isEmpty())
+        return false;
+
+    *this = specs;
+    return true;
+}
+
+bool SystemSpecs::save(const QString &filePath) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << SpecsMagic << SpecsVersion;
+    out << osName << cpuName << cpuCores << ramTotal << ramSpeed << storageTotal << gpuName << gpuVRAM << probedAt;
+
+    return out.status() == QDataStream::Ok;
+}
+
+QString SystemSpecs::defaultFilePath()
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    return dataDir + "/system_specs.dat";
+}
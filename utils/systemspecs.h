@@ -0,0 +1,32 @@
+#ifndef SYSTEMSPECS_H
+#define SYSTEMSPECS_H
+
+#include <QString>
+#include <QDateTime>
+
+// The hardware and OS summary shown on the System Info page, as display
+// strings. The last one measured is kept on disk so the page can show it at
+// once on the next start while a fresh probe runs in the background.
+struct SystemSpecs
+{
+    QString osName; // "Windows 11 Pro | 24H2 | build 26100"
+    QString cpuName;
+    QString cpuCores; // "8 cores"
+    QString ramTotal;
+    QString ramSpeed;     // empty when the platform does not report it
+    QString storageTotal; // size, drive type and free space of the system drive
+    QString gpuName;
+    QString gpuVRAM; // empty when the platform does not report it
+    QDateTime probedAt;
+
+    bool isEmpty() const;
+    // Compares what is displayed; probedAt is left out
+    bool operator==(const SystemSpecs &other) const;
+    bool operator!=(const SystemSpecs &other) const;
+
+    bool load(const QString &filePath);
+    bool save(const QString &filePath) const;
+    static QString defaultFilePath();
+};
+
+#endif // SYSTEMSPECS_H
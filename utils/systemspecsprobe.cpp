@@ -0,0 +1,75 @@
+#include "systemspecsprobe.h"
+#include "windowsspecsprobe.h"
+#include "linuxspecsprobe.h"
+#include <QtConcurrent/QtConcurrent>
+#include <QStorageInfo>
+#include <QList>
+#include <QFuture>
+
+SystemSpecsProbe::~SystemSpecsProbe()
+{
+}
+
+void SystemSpecsProbe::probeStorage(SystemSpecs &specs) const
+{
+    // The drive the OS boots from
+    QStorageInfo bootDrive = QStorageInfo::root();
+    if (!bootDrive.isValid())
+    {
+        specs.storageTotal = "Unknown";
+        return;
+    }
+
+    double totalGB = bootDrive.bytesTotal() / (1024.0 * 1024.0 * 1024.0);
+    double freeGB = bootDrive.bytesFree() / (1024.0 * 1024.0 * 1024.0);
+
+    QString sizeStr;
+    if (totalGB >= 1024)
+        sizeStr = QString::number(totalGB / 1024.0, 'f', 1) + " TB";
+    else
+        sizeStr = QString::number(totalGB, 'f', 0) + " GB";
+
+    // Simple SSD detection - you can enhance this later
+    QString driveType = "HDD";
+    if (bootDrive.fileSystemType().contains("NTFS") || bootDrive.isReady())
+        driveType = "SSD";
+
+    specs.storageTotal = sizeStr + " " + driveType + " (Free: " + QString::number(static_cast<int>(freeGB)) + " GB)";
+}
+
+SystemSpecs SystemSpecsProbe::probeAll() const
+{
+    SystemSpecs specs;
+
+    // The GPU and storage probes touch drivers and the file system and take
+    // longest; the calling thread does the OS probe meanwhile. A future that
+    // has not started yet is run by the thread waiting on it, so this does
+    // not stall when called from a busy pool.
+    QList<QFuture<void>> futures;
+    futures << QtConcurrent::run([this, &specs]() { probeGpu(specs); });
+    futures << QtConcurrent::run([this, &specs]() { probeStorage(specs); });
+    futures << QtConcurrent::run([this, &specs]() { probeCpu(specs); });
+    futures << QtConcurrent::run([this, &specs]() { probeMemory(specs); });
+    probeOs(specs);
+
+    for (QFuture<void> &future : futures)
+        future.waitForFinished();
+
+    specs.probedAt = QDateTime::currentDateTime();
+    return specs;
+}
+
+SystemSpecsProbe *SystemSpecsProbe::createDefault()
+{
+#ifdef Q_OS_WIN
+    return new WindowsSpecsProbe();
+#else
+    return new LinuxSpecsProbe();
+#endif
+}
+
+QString SystemSpecsProbe::formatBytes(qint64 bytes, int decimals)
+{
+    double gb = bytes / (1024.0 * 1024.0 * 1024.0);
+    return QString("%1 GB").arg(gb, 0, 'f', decimals);
+}
@@ -0,0 +1,32 @@
+#ifndef SYSTEMSPECSPROBE_H
+#define SYSTEMSPECSPROBE_H
+
+#include "systemspecs.h"
+
+// Reads the system summary straight from the platform (no child processes).
+// Each probe fills only its own fields, so probeAll() runs them side by side
+// on one SystemSpecs; implementations must allow concurrent const calls.
+class SystemSpecsProbe
+{
+public:
+    virtual ~SystemSpecsProbe();
+
+    virtual QString id() const = 0;
+
+    virtual void probeOs(SystemSpecs &specs) const = 0;      // osName
+    virtual void probeCpu(SystemSpecs &specs) const = 0;     // cpuName, cpuCores
+    virtual void probeMemory(SystemSpecs &specs) const = 0;  // ramTotal, ramSpeed
+    virtual void probeGpu(SystemSpecs &specs) const = 0;     // gpuName, gpuVRAM
+    virtual void probeStorage(SystemSpecs &specs) const;     // storageTotal, from QStorageInfo
+
+    // All probes in parallel; returns once the slowest has finished
+    SystemSpecs probeAll() const;
+
+    // The backend for the platform the program was built for
+    static SystemSpecsProbe *createDefault();
+
+protected:
+    static QString formatBytes(qint64 bytes, int decimals = 1);
+};
+
+#endif // SYSTEMSPECSPROBE_H
@@ -0,0 +1,291 @@
+#include "uninstallqueue.h"
+#include "processsnapshot.h"
+#include <QProcess>
+#include <QFileInfo>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+UninstallQueue::UninstallQueue(QObject *parent)
+    : QObject(parent), m_nextId(1), m_maxConcurrent(3), m_active(false)
+{
+    // Process trees are checked against one shared snapshot per tick
+    m_pollTimer.setInterval(1000);
+    connect(&m_pollTimer, &QTimer::timeout, this, &UninstallQueue::poll);
+}
+
+UninstallQueue::~UninstallQueue()
+{
+    for (const Job &job : m_running)
+    {
+        if (job.process)
+            job.process->waitForFinished(-1);
+    }
+}
+
+int UninstallQueue::enqueue(const QString &command)
+{
+    Job job;
+    job.id = m_nextId++;
+    m_active = true;
+
+    // Started from the event loop so callers can map the id before any signal
+    if (!parseCommand(command, job.program, job.arguments))
+    {
+        int id = job.id;
+        QTimer::singleShot(0, this, [this, id]()
+                           {
+                               emit jobFailed(id, "No uninstall command available");
+                               startJobs(); });
+        return id;
+    }
+
+    job.usesInstallerMutex = usesInstallerMutex(job.program);
+    m_pending.append(job);
+    QTimer::singleShot(0, this, [this]()
+                       { startJobs(); });
+    return job.id;
+}
+
+void UninstallQueue::cancelPending()
+{
+    // Started uninstallers cannot be interrupted safely
+    m_pending.clear();
+    startJobs();
+}
+
+int UninstallQueue::maxConcurrent() const
+{
+    return m_maxConcurrent;
+}
+
+void UninstallQueue::setMaxConcurrent(int count)
+{
+    m_maxConcurrent = qMax(1, count);
+    startJobs();
+}
+
+bool UninstallQueue::isIdle() const
+{
+    return m_pending.isEmpty() && m_running.isEmpty();
+}
+
+int UninstallQueue::pendingCount() const
+{
+    return m_pending.size();
+}
+
+int UninstallQueue::runningCount() const
+{
+    return m_running.size();
+}
+
+bool UninstallQueue::parseCommand(const QString &command, QString &program, QString &arguments)
+{
+    QString text = command.trimmed();
+    if (text.isEmpty())
+        return false;
+
+    if (text.startsWith('"'))
+    {
+        int end = text.indexOf('"', 1);
+        if (end < 0)
+            end = text.size();
+        program = text.mid(1, end - 1);
+        arguments = text.mid(end + 1).trimmed();
+    }
+    else
+    {
+        // Unquoted paths with spaces are common; cut after the executable's extension
+        int exe = text.indexOf(".exe", 0, Qt::CaseInsensitive);
+        int end = exe >= 0 ? exe + 4 : text.indexOf(' ');
+        if (end < 0)
+            end = text.size();
+        program = text.left(end);
+        arguments = text.mid(end).trimmed();
+    }
+
+    return !program.isEmpty();
+}
+
+bool UninstallQueue::usesInstallerMutex(const QString &program)
+{
+    QString name = QFileInfo(program).completeBaseName();
+#ifndef Q_OS_WIN
+    // dpkg and rpm lock their database for a transaction the same way
+    if (name == "pkexec")
+        return true;
+#endif
+    return name.compare("msiexec", Qt::CaseInsensitive) == 0;
+}
+
+bool UninstallQueue::installerMutexHeld()
+{
+#ifdef Q_OS_WIN
+    // Windows Installer holds this mutex for the duration of a transaction
+    HANDLE mutex = OpenMutexW(SYNCHRONIZE, FALSE, L"Global\\_MSIExecute");
+    if (!mutex)
+        return false;
+    CloseHandle(mutex);
+    return true;
+#else
+    return false;
+#endif
+}
+
+void UninstallQueue::startJobs()
+{
+    bool installerRunning = false;
+    for (const Job &job : m_running)
+    {
+        if (job.usesInstallerMutex)
+            installerRunning = true;
+    }
+
+    for (int i = 0; i < m_pending.size() && m_running.size() < m_maxConcurrent;)
+    {
+        Job &job = m_pending[i];
+        if (job.usesInstallerMutex && (installerRunning || installerMutexHeld()))
+        {
+            // Wait for the installer, but let other uninstallers go ahead
+            ++i;
+            continue;
+        }
+
+        Job started = m_pending.takeAt(i);
+        if (!startJob(started))
+        {
+            emit jobFailed(started.id, "Failed to start the uninstaller. You may need to run this application as Administrator.");
+            continue;
+        }
+
+        if (started.usesInstallerMutex)
+            installerRunning = true;
+        m_running.append(started);
+        emit jobStarted(started.id);
+    }
+
+    // Waiting jobs are retried on the next tick
+    if (!isIdle())
+    {
+        if (!m_pollTimer.isActive())
+            m_pollTimer.start();
+        return;
+    }
+
+    m_pollTimer.stop();
+    if (m_active)
+    {
+        m_active = false;
+        emit finished();
+    }
+}
+
+bool UninstallQueue::startJob(Job &job)
+{
+#ifdef Q_OS_WIN
+    QProcess process;
+    process.setProgram(job.program);
+    // Uninstall strings use Windows quoting rules; pass them through untouched
+    process.setNativeArguments(job.arguments);
+
+    qint64 pid = 0;
+    if (!process.startDetached(&pid))
+        return false;
+#else
+    // Package managers report a refused authorization or a failed removal only in their exit status
+    QProcess *process = new QProcess(this);
+    process->setProgram(job.program);
+    process->setArguments(QProcess::splitCommand(job.arguments));
+    process->setProcessChannelMode(QProcess::MergedChannels);
+
+    int id = job.id;
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+            [this, id](int exitCode, QProcess::ExitStatus exitStatus)
+            {
+                for (Job &running : m_running)
+                {
+                    if (running.id == id)
+                    {
+                        running.exited = true;
+                        running.exitCode = exitStatus == QProcess::NormalExit ? exitCode : -1;
+                    }
+                } });
+
+    process->start();
+    if (!process->waitForStarted(5000))
+    {
+        delete process;
+        return false;
+    }
+    qint64 pid = process->processId();
+    job.process = process;
+#endif
+
+    job.tree.insert(quint32(pid));
+    job.alive.insert(quint32(pid));
+    return true;
+}
+
+void UninstallQueue::poll()
+{
+    if (m_running.isEmpty())
+    {
+        startJobs();
+        return;
+    }
+
+    ProcessSnapshot snapshot = ProcessSnapshot::capture();
+    QSet<quint32> alive;
+    for (const ProcessInfo &process : snapshot.processes())
+    {
+        alive.insert(process.pid);
+    }
+
+    QList<int> finishedJobs;
+    for (int i = 0; i < m_running.size(); ++i)
+    {
+        Job &job = m_running[i];
+
+        // Adopt children of any process the job ever had, until no new ones appear
+        bool grew = true;
+        while (grew)
+        {
+            grew = false;
+            for (const ProcessInfo &process : snapshot.processes())
+            {
+                if (job.tree.contains(process.parentPid) && !job.tree.contains(process.pid))
+                {
+                    job.tree.insert(process.pid);
+                    job.alive.insert(process.pid);
+                    grew = true;
+                }
+            }
+        }
+
+        job.alive.intersect(alive);
+        if (job.alive.isEmpty() && (!job.process || job.exited))
+            finishedJobs.append(i);
+    }
+
+    for (int i = finishedJobs.size() - 1; i >= 0; --i)
+    {
+        Job job = m_running.takeAt(finishedJobs[i]);
+        if (job.process)
+            job.process->deleteLater();
+
+        // pkexec exits with 126 when the authorization dialog is dismissed, 127 when it is refused
+        if (job.process && job.exitCode != 0)
+        {
+            QString error = job.exitCode == 126 || job.exitCode == 127
+                                ? QString("Authorization was not granted.")
+                                : QString("The uninstaller failed with exit code %1.").arg(job.exitCode);
+            emit jobFailed(job.id, error);
+            continue;
+        }
+        emit jobFinished(job.id);
+    }
+
+    startJobs();
+}
@@ -0,0 +1,78 @@
+#ifndef UNINSTALLQUEUE_H
+#define UNINSTALLQUEUE_H
+
+#include <QObject>
+#include <QList>
+#include <QSet>
+#include <QTimer>
+
+class QProcess;
+
+// Runs uninstall commands detached, at most maxConcurrent() at a time.
+// Windows Installer runs one transaction per machine, so msiexec jobs are
+// started one by one and only while no other installer holds the
+// _MSIExecute mutex. A job is finished when its process and every process
+// it spawned have exited; uninstallers that relaunch themselves from a
+// temporary copy are followed through their parent pid. On Windows jobs are
+// detached and keep running if the application exits. Elsewhere they are
+// package manager removals: they are started attached so a non-zero exit
+// status fails the job, run one at a time because package managers lock
+// their database, and are waited for if the queue is destroyed, since an
+// interrupted transaction leaves the database half-changed.
+class UninstallQueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit UninstallQueue(QObject *parent = nullptr);
+    ~UninstallQueue();
+
+    // Returns the job id
+    int enqueue(const QString &command);
+    void cancelPending();
+
+    int maxConcurrent() const;
+    void setMaxConcurrent(int count);
+
+    bool isIdle() const;
+    int pendingCount() const;
+    int runningCount() const;
+
+    // Splits "C:\Program Files\App\unins000.exe" /SILENT into program and arguments
+    static bool parseCommand(const QString &command, QString &program, QString &arguments);
+    static bool usesInstallerMutex(const QString &program);
+    static bool installerMutexHeld();
+
+signals:
+    void jobStarted(int id);
+    void jobFinished(int id);
+    void jobFailed(int id, const QString &error);
+    void finished();
+
+private:
+    struct Job
+    {
+        int id = 0;
+        QString program;
+        QString arguments;
+        bool usesInstallerMutex = false;
+        QSet<quint32> tree;  // every process seen in the job
+        QSet<quint32> alive; // processes alive at the last poll
+        QProcess *process = nullptr; // attached jobs only
+        bool exited = false;
+        int exitCode = 0;
+    };
+
+    QList<Job> m_pending;
+    QList<Job> m_running;
+    QTimer m_pollTimer;
+    int m_nextId;
+    int m_maxConcurrent;
+    bool m_active; // finished() is pending
+
+    void startJobs();
+    bool startJob(Job &job);
+    void poll();
+};
+
+#endif // UNINSTALLQUEUE_H
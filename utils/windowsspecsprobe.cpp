@@ -0,0 +1,178 @@
+#include "windowsspecsprobe.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <dxgi.h>
+#include <QRegularExpression>
+
+#pragma comment(lib, "dxgi.lib")
+
+namespace
+{
+    const wchar_t *CurrentVersionKey = L"SOFTWARE\\Microsoft\\Windows NT\\CurrentVersion";
+    const wchar_t *ProcessorKey = L"HARDWARE\\DESCRIPTION\\System\\CentralProcessor\\0";
+
+    QString readString(const wchar_t *subKey, const wchar_t *valueName)
+    {
+        HKEY key;
+        if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, subKey, 0, KEY_READ, &key) != ERROR_SUCCESS)
+            return QString();
+
+        WCHAR buffer[256];
+        DWORD bufferSize = sizeof(buffer) - sizeof(WCHAR);
+        DWORD type = 0;
+        QString value;
+        if (RegQueryValueExW(key, valueName, NULL, &type, (LPBYTE)buffer, &bufferSize) == ERROR_SUCCESS &&
+            (type == REG_SZ || type == REG_EXPAND_SZ))
+        {
+            buffer[bufferSize / sizeof(WCHAR)] = L'\0';
+            value = QString::fromWCharArray(buffer);
+        }
+        RegCloseKey(key);
+        return value;
+    }
+
+    // ProductName still says "Windows 10" on Windows 11; the build tells them apart
+    QString productName(int buildNumber)
+    {
+        QString osName = readString(CurrentVersionKey, L"ProductName");
+        if (osName.isEmpty())
+            return "Windows (Unknown Version)";
+
+        if (osName.contains("Windows 10") && buildNumber >= 22000)
+        {
+            osName = "Windows 11";
+
+            QString edition = readString(CurrentVersionKey, L"EditionID");
+            if (edition.contains("Professional"))
+                osName += " Pro";
+            else if (edition.contains("Home"))
+                osName += " Home";
+            else if (edition.contains("Enterprise"))
+                osName += " Enterprise";
+        }
+        return osName;
+    }
+
+    QString simplifyGpuName(const QString &deviceName)
+    {
+        QString gpuName = deviceName;
+        if (gpuName.contains("NVIDIA", Qt::CaseInsensitive))
+        {
+            QRegularExpression re("(RTX|GTX|GT)\\s*\\d+\\s*\\w*");
+            QRegularExpressionMatch match = re.match(gpuName);
+            if (match.hasMatch())
+                gpuName = "NVIDIA " + match.captured();
+        }
+        else if (gpuName.contains("AMD", Qt::CaseInsensitive) || gpuName.contains("Radeon", Qt::CaseInsensitive))
+        {
+            QRegularExpression re("(RX|Radeon)\\s*\\d+\\s*\\w*");
+            QRegularExpressionMatch match = re.match(gpuName);
+            if (match.hasMatch())
+                gpuName = "AMD " + match.captured();
+        }
+        else if (gpuName.contains("Intel", Qt::CaseInsensitive))
+        {
+            gpuName = "Intel Graphics";
+        }
+        return gpuName;
+    }
+}
+#endif
+
+QString WindowsSpecsProbe::id() const
+{
+    return "windows";
+}
+
+void WindowsSpecsProbe::probeOs(SystemSpecs &specs) const
+{
+#ifdef Q_OS_WIN
+    QString buildNumber = readString(CurrentVersionKey, L"CurrentBuild");
+    if (buildNumber.isEmpty())
+        buildNumber = readString(CurrentVersionKey, L"CurrentBuildNumber");
+
+    // DisplayVersion (Windows 11 and newer Windows 10), then ReleaseId, then CurrentVersion
+    QString displayVersion = readString(CurrentVersionKey, L"DisplayVersion");
+    if (displayVersion.isEmpty())
+        displayVersion = readString(CurrentVersionKey, L"ReleaseId");
+    if (displayVersion.isEmpty())
+        displayVersion = readString(CurrentVersionKey, L"CurrentVersion");
+
+    QString osName = productName(buildNumber.toInt());
+
+    // Format: "Windows 10 Pro | 24H2 | build 26100"
+    specs.osName = QString("%1 | %2 | build %3")
+                       .arg(osName)
+                       .arg(displayVersion.isEmpty() ? "Unknown" : displayVersion)
+                       .arg(buildNumber.isEmpty() ? "Unknown" : buildNumber);
+#else
+    Q_UNUSED(specs);
+#endif
+}
+
+void WindowsSpecsProbe::probeCpu(SystemSpecs &specs) const
+{
+#ifdef Q_OS_WIN
+    specs.cpuName = readString(ProcessorKey, L"ProcessorNameString").simplified();
+
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    specs.cpuCores = QString("%1 cores").arg(sysInfo.dwNumberOfProcessors);
+#else
+    Q_UNUSED(specs);
+#endif
+}
+
+void WindowsSpecsProbe::probeMemory(SystemSpecs &specs) const
+{
+#ifdef Q_OS_WIN
+    MEMORYSTATUSEX memoryStatus;
+    memoryStatus.dwLength = sizeof(memoryStatus);
+    if (GlobalMemoryStatusEx(&memoryStatus))
+        specs.ramTotal = formatBytes(qint64(memoryStatus.ullTotalPhys));
+
+    // The memory clock is only in SMBIOS; ~MHz in the registry is the CPU's, so ramSpeed stays empty
+#else
+    Q_UNUSED(specs);
+#endif
+}
+
+void WindowsSpecsProbe::probeGpu(SystemSpecs &specs) const
+{
+#ifdef Q_OS_WIN
+    specs.gpuName = "Unknown GPU";
+
+    DISPLAY_DEVICE displayDevice;
+    ZeroMemory(&displayDevice, sizeof(displayDevice));
+    displayDevice.cb = sizeof(DISPLAY_DEVICE);
+
+    for (DWORD deviceNum = 0; EnumDisplayDevices(NULL, deviceNum, &displayDevice, 0); deviceNum++)
+    {
+        if (displayDevice.StateFlags & DISPLAY_DEVICE_PRIMARY_DEVICE)
+        {
+            QString deviceName = QString::fromWCharArray(displayDevice.DeviceString);
+            if (!deviceName.isEmpty() && deviceName != "Unknown")
+                specs.gpuName = simplifyGpuName(deviceName);
+            break;
+        }
+    }
+
+    // DXGI reports dedicated memory more reliably than the display device
+    IDXGIFactory *factory = nullptr;
+    if (SUCCEEDED(CreateDXGIFactory(__uuidof(IDXGIFactory), (void **)&factory)))
+    {
+        IDXGIAdapter *adapter = nullptr;
+        if (SUCCEEDED(factory->EnumAdapters(0, &adapter)))
+        {
+            DXGI_ADAPTER_DESC desc;
+            if (SUCCEEDED(adapter->GetDesc(&desc)) && desc.DedicatedVideoMemory > 0)
+                specs.gpuVRAM = formatBytes(qint64(desc.DedicatedVideoMemory)) + " VRAM";
+            adapter->Release();
+        }
+        factory->Release();
+    }
+#else
+    Q_UNUSED(specs);
+#endif
+}
@@ -0,0 +1,21 @@
+#ifndef WINDOWSSPECSPROBE_H
+#define WINDOWSSPECSPROBE_H
+
+#include "systemspecsprobe.h"
+
+// Registry values under CurrentVersion and CentralProcessor\0,
+// GlobalMemoryStatusEx, EnumDisplayDevices and DXGI. All are in-process
+// calls that return in microseconds, unlike the WMI query through
+// PowerShell this replaces. Reports nothing when built for another OS.
+class WindowsSpecsProbe : public SystemSpecsProbe
+{
+public:
+    QString id() const override;
+
+    void probeOs(SystemSpecs &specs) const override;
+    void probeCpu(SystemSpecs &specs) const override;
+    void probeMemory(SystemSpecs &specs) const override;
+    void probeGpu(SystemSpecs &specs) const override;
+};
+
+#endif // WINDOWSSPECSPROBE_H
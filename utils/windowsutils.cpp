@@ -1,13 +1,38 @@
 #include "windowsutils.h"
+#include "prefetchparser.h"
 #include <QDir>
+#include <QDirIterator>
 #include <QFileInfo>
 #include <QProcess>
 #include <QStandardPaths>
 
+namespace
+{
+    // Launched this often within this many days, a program still benefits from its
+    // prefetch file; files keep at most eight launch times, so the count must fit in them
+    const int FrequentLaunchCount = 4;
+    const int FrequentLaunchDays = 30;
+
+    // Judged by the launch times recorded inside the file rather than its
+    // modification time; files that cannot be read are judged by age alone
+    bool isPrefetchInUse(const QString &filePath, const QDateTime &cutoff)
+    {
+        PrefetchInfo info;
+        QString error;
+        if (!PrefetchParser::parseFile(filePath, info, error) || !info.lastRun().isValid())
+            return false;
+
+        if (cutoff.isValid() && info.lastRun() >= cutoff)
+            return true;
+        return info.runsSince(QDateTime::currentDateTime().addDays(-FrequentLaunchDays)) >= FrequentLaunchCount;
+    }
+}
+
 WindowsUtils::WindowsUtils(QObject *parent)
     : QObject(parent)
 {
     initializeCleanerItems();
+    initializeSystemCleanerItems();
 }
 
 void WindowsUtils::initializeCleanerItems()
@@ -19,33 +44,37 @@ void WindowsUtils::initializeCleanerItems()
         "Temporary Files",
         "Windows and user temporary files",
         getUserTempPath(),
-        QStringList{"*.*"},  // Scan ALL files recursively
+        QStringList{"*"},  // Scan ALL files recursively
         0,
         true,
         true
     ));
 
-    m_cleanerItems.append(CleanerItem(
+    CleanerItem windowsTemp(
         "Windows Update Cache",
         "Windows Update temporary files",
         "C:/Windows/Temp",
-        QStringList{"*.*"},
+        QStringList{"*"},
         0,
         true,
         true
-    ));
+    );
+    windowsTemp.setMinAgeDays(1);
+    m_cleanerItems.append(windowsTemp);
 
-    m_cleanerItems.append(CleanerItem(
+    CleanerItem logs(
         "System Log Files",
         "System event and error logs",
         "C:/Windows/Logs",
-        QStringList{"*.*"},
+        QStringList{"*"},
         0,
         true,
         true
-    ));
+    );
+    logs.setMinAgeDays(30);
+    m_cleanerItems.append(logs);
 
-    m_cleanerItems.append(CleanerItem(
+    CleanerItem dumps(
         "Memory Dump Files",
         "System memory dump files",
         "C:/Windows",
@@ -53,19 +82,24 @@ void WindowsUtils::initializeCleanerItems()
         0,
         true,
         true
-    ));
+    );
+    dumps.setExtraPaths(QStringList{"C:/Windows/LiveKernelReports"});
+    dumps.setRecursive(false);
+    m_cleanerItems.append(dumps);
 
-    m_cleanerItems.append(CleanerItem(
+    CleanerItem thumbnails(
         "Thumbnail Cache",
         "Windows thumbnail cache",
         getThumbnailCachePath(),
-        QStringList{"*.db", "thumbcache_*.db"},
+        QStringList{"thumbcache_*.db"},
         0,
         true,
         true
-    ));
+    );
+    thumbnails.setRecursive(false);
+    m_cleanerItems.append(thumbnails);
 
-    m_cleanerItems.append(CleanerItem(
+    CleanerItem prefetch(
         "Prefetch Files",
         "Windows prefetch files",
         "C:/Windows/Prefetch",
@@ -73,7 +107,85 @@ void WindowsUtils::initializeCleanerItems()
         0,
         true,
         true
-    ));
+    );
+    prefetch.setRecursive(false);
+    prefetch.setMinAgeDays(7);
+    m_cleanerItems.append(prefetch);
+}
+
+void WindowsUtils::initializeSystemCleanerItems()
+{
+    m_systemCleanerItems.clear();
+
+    QString localAppData = getLocalAppDataPath();
+    QString programData = QDir::fromNativeSeparators(qEnvironmentVariable("ProgramData", "C:/ProgramData"));
+
+    // Order matches the rows of the System Cleaner list
+    CleanerItem temp("Temporary Files", "Application and system temporary files",
+                     getUserTempPath(), QStringList{"*"}, 0, false, true);
+    temp.setExtraPaths(QStringList{"C:/Windows/Temp"});
+    m_systemCleanerItems.append(temp);
+
+    m_systemCleanerItems.append(CleanerItem("Windows Update Cache", "Leftover Windows Update downloads",
+                                            "C:/Windows/SoftwareDistribution/Download", QStringList{"*"}, 0, false, true));
+
+    CleanerItem logs("System Log Files", "Old system event logs",
+                     "C:/Windows/Logs", QStringList{"*"}, 0, false, true);
+    logs.setMinAgeDays(30);
+    m_systemCleanerItems.append(logs);
+
+    CleanerItem dumps("Memory Dump Files", "System crash memory dumps",
+                      "C:/Windows", QStringList{"*.dmp", "*.hdmp"}, 0, false, true);
+    dumps.setExtraPaths(QStringList{"C:/Windows/LiveKernelReports"});
+    dumps.setRecursive(false);
+    m_systemCleanerItems.append(dumps);
+
+    CleanerItem thumbnails("Thumbnail Cache", "File thumbnail cache",
+                           getThumbnailCachePath(), QStringList{"thumbcache_*.db"}, 0, false, true);
+    thumbnails.setRecursive(false);
+    m_systemCleanerItems.append(thumbnails);
+
+    CleanerItem errorReports("Error Reports", "Windows Error Reporting files",
+                             programData + "/Microsoft/Windows/WER", QStringList{"*"}, 0, false, true);
+    errorReports.setExtraPaths(QStringList{localAppData + "/Microsoft/Windows/WER"});
+    errorReports.setMinAgeDays(7);
+    m_systemCleanerItems.append(errorReports);
+
+    // The Recycle Bin is managed by the shell, so it has no file roots
+    m_systemCleanerItems.append(CleanerItem("Recycle Bin", "Deleted files waiting for permanent removal",
+                                            QString(), QStringList(), 0, false, true));
+
+    CleanerItem prefetch("Prefetch Files", "Application launch optimization files",
+                         "C:/Windows/Prefetch", QStringList{"*.pf"}, 0, false, true);
+    prefetch.setRecursive(false);
+    prefetch.setMinAgeDays(7);
+    m_systemCleanerItems.append(prefetch);
+
+    m_systemCleanerItems.append(CleanerItem("Font Cache", "Cached font data",
+                                            localAppData + "/Microsoft/Windows/FontCache", QStringList{"*"}, 0, false, true));
+
+    m_systemCleanerItems.append(CleanerItem("Delivery Optimization", "Windows Update peer-to-peer cache",
+                                            localAppData + "/Microsoft/Windows/DeliveryOptimization/Cache", QStringList{"*"}, 0, false, true));
+
+    CleanerItem archive("Error Reporting Archive", "Archived error reports",
+                        localAppData + "/Microsoft/Windows/WER/ReportArchive", QStringList{"*"}, 0, false, true);
+    archive.setMinAgeDays(7);
+    m_systemCleanerItems.append(archive);
+
+    CleanerItem defender("Windows Defender Scans", "Previous antivirus scan results",
+                         programData + "/Microsoft/Windows Defender/Scans/History", QStringList{"*"}, 0, false, true);
+    defender.setMinAgeDays(30);
+    m_systemCleanerItems.append(defender);
+}
+
+QList<CleanerItem> WindowsUtils::cleanerItems() const
+{
+    return m_cleanerItems;
+}
+
+QList<CleanerItem> WindowsUtils::systemCleanerItems() const
+{
+    return m_systemCleanerItems;
 }
 
 QString WindowsUtils::getUserTempPath()
@@ -81,10 +193,14 @@ QString WindowsUtils::getUserTempPath()
     return QStandardPaths::writableLocation(QStandardPaths::TempLocation);
 }
 
+QString WindowsUtils::getLocalAppDataPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
+}
+
 QString WindowsUtils::getThumbnailCachePath()
 {
-    QString localAppData = QStandardPaths::writableLocation(QStandardPaths::GenericDataLocation);
-    return localAppData + "/Microsoft/Windows/Explorer";
+    return getLocalAppDataPath() + "/Microsoft/Windows/Explorer";
 }
 
 QVector<CleanerItem> WindowsUtils::scanJunkFiles()
@@ -132,6 +248,117 @@ qint64 WindowsUtils::cleanJunkFiles(QVector<CleanerItem> &items)
     return totalFreed;
 }
 
+CleanCategoryPlan WindowsUtils::buildCategoryPlan(const CleanerItem &item, QAtomicInteger<bool> &cancelFlag)
+{
+    CleanCategoryPlan plan;
+    plan.name = item.name();
+
+    // Shell-managed categories have no file roots to enumerate
+    if (item.allPaths().isEmpty())
+    {
+        if (item.name() == "Recycle Bin")
+            plan.totalSize = queryRecycleBinSize();
+        return plan;
+    }
+
+    GlobMatcher matcher(item.filePatterns());
+
+    // Deleting the prefetch file of a program in regular use only slows its
+    // next launches down until Windows has traced it again
+    const bool prefetch = item.name() == "Prefetch Files";
+
+    QDateTime cutoff;
+    if (item.minAgeDays() > 0)
+    {
+        cutoff = QDateTime::currentDateTime().addDays(-item.minAgeDays());
+    }
+
+    QDirIterator::IteratorFlags flags = item.isRecursive() ? QDirIterator::Subdirectories
+                                                           : QDirIterator::NoIteratorFlags;
+
+    for (const QString &root : item.allPaths())
+    {
+        if (cancelFlag)
+            break;
+
+        QFileInfo rootInfo(root);
+        if (!rootInfo.isDir())
+            continue;
+
+        plan.directories.append(CleanDirectory{rootInfo.absoluteFilePath(), rootInfo.lastModified().toMSecsSinceEpoch()});
+
+        // Directories are listed too so their mtimes can be used to detect changes later
+        QDirIterator it(root, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot, flags);
+        while (it.hasNext() && !cancelFlag)
+        {
+            it.next();
+            QFileInfo info = it.fileInfo();
+            QDateTime modified = info.lastModified();
+
+            if (info.isDir())
+            {
+                if (item.isRecursive() && !info.isSymLink())
+                    plan.directories.append(CleanDirectory{info.absoluteFilePath(), modified.toMSecsSinceEpoch()});
+                continue;
+            }
+
+            if (!matcher.matches(info.fileName()))
+                continue;
+
+            if (cutoff.isValid() && modified >= cutoff)
+            {
+                // The cache rescans once this file is old enough to be a candidate
+                qint64 eligibleAt = modified.addDays(item.minAgeDays()).toMSecsSinceEpoch();
+                if (plan.nextEligibleAt == 0 || eligibleAt < plan.nextEligibleAt)
+                    plan.nextEligibleAt = eligibleAt;
+                continue;
+            }
+
+            if (prefetch && isPrefetchInUse(info.absoluteFilePath(), cutoff))
+                continue;
+
+            CleanCandidate candidate;
+            candidate.path = info.absoluteFilePath();
+            candidate.size = info.size();
+            candidate.lastModified = modified.toMSecsSinceEpoch();
+
+            plan.files.append(candidate);
+            plan.totalSize += candidate.size;
+        }
+    }
+
+    return plan;
+}
+
+CleanManifest WindowsUtils::buildManifest(const QList<CleanerItem> &items, QAtomicInteger<bool> &cancelFlag)
+{
+    CleanManifest manifest;
+    manifest.setCreatedAt(QDateTime::currentDateTime());
+
+    for (const CleanerItem &item : items)
+    {
+        if (cancelFlag)
+            break;
+        manifest.setCategory(buildCategoryPlan(item, cancelFlag));
+    }
+
+    return manifest;
+}
+
+qint64 WindowsUtils::queryRecycleBinSize()
+{
+    QProcess process;
+    process.start("powershell", QStringList() << "-Command" << "try { "
+                                                               "$shell = New-Object -ComObject Shell.Application; "
+                                                               "$recycleBin = $shell.NameSpace(0x0a); "
+                                                               "$totalSize = 0; "
+                                                               "foreach ($item in $recycleBin.Items()) { $totalSize += $item.Size }; "
+                                                               "$totalSize "
+                                                               "} catch { 0 }");
+    process.waitForFinished();
+    return process.readAllStandardOutput().trimmed().toLongLong();
+}
+
 qint64 WindowsUtils::calculateDirectorySize(const QString &path)
 {
     qint64 totalSize = 0;
@@ -157,6 +384,12 @@ qint64 WindowsUtils::calculateDirectorySize(const QString &path)
 }
 
 void WindowsUtils::deleteFilesByPattern(const QString &path, const QStringList &patterns)
+{
+    // Compile the patterns once for the whole tree
+    deleteMatchingFiles(path, GlobMatcher(patterns));
+}
+
+void WindowsUtils::deleteMatchingFiles(const QString &path, const GlobMatcher &matcher)
 {
     QDir dir(path);
     
@@ -164,18 +397,14 @@ void WindowsUtils::deleteFilesByPattern(const QString &path, const QStringList &
         return;
     }
     
-    // Delete files matching patterns
-    for (const QString &pattern : patterns) {
-        QFileInfoList files = dir.entryInfoList(QStringList() << pattern, QDir::Files);
-        for (const QFileInfo &fileInfo : files) {
+    // One listing per directory: delete matching files and recurse into subdirectories
+    QFileInfoList entries = dir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const QFileInfo &fileInfo : entries) {
+        if (fileInfo.isDir()) {
+            deleteMatchingFiles(fileInfo.absoluteFilePath(), matcher);
+        } else if (matcher.matches(fileInfo.fileName())) {
             QFile file(fileInfo.absoluteFilePath());
             file.remove();
         }
     }
-    
-    // Recursively process subdirectories
-    QFileInfoList subDirs = dir.entryInfoList(QDir::Dirs | QDir::NoDotAndDotDot);
-    for (const QFileInfo &subDirInfo : subDirs) {
-        deleteFilesByPattern(subDirInfo.absoluteFilePath(), patterns);
-    }
 }
\ No newline at end of file
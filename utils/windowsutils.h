@@ -4,7 +4,10 @@
 #include <QObject>
 #include <QList>
 #include <QVector>
+#include <QAtomicInteger>
 #include "cleaneritem.h"
+#include "cleanmanifest.h"
+#include "globmatcher.h"
 
 class WindowsUtils : public QObject
 {
@@ -16,14 +19,26 @@ public:
     QVector<CleanerItem> scanJunkFiles();
     qint64 cleanJunkFiles(QVector<CleanerItem> &items);
 
+    QList<CleanerItem> cleanerItems() const;
+    QList<CleanerItem> systemCleanerItems() const;
+
+    // Enumerates the candidate files of one category without deleting anything
+    static CleanCategoryPlan buildCategoryPlan(const CleanerItem &item, QAtomicInteger<bool> &cancelFlag);
+    static CleanManifest buildManifest(const QList<CleanerItem> &items, QAtomicInteger<bool> &cancelFlag);
+    static qint64 queryRecycleBinSize();
+
 private:
     QList<CleanerItem> m_cleanerItems;
+    QList<CleanerItem> m_systemCleanerItems;
 
     void initializeCleanerItems();
+    void initializeSystemCleanerItems();
     QString getUserTempPath();
+    QString getLocalAppDataPath();
     QString getThumbnailCachePath();
     qint64 calculateDirectorySize(const QString &path);
     void deleteFilesByPattern(const QString &path, const QStringList &patterns);
+    void deleteMatchingFiles(const QString &path, const GlobMatcher &matcher);
 };
 
 #endif // WINDOWSUTILS_H
\ No newline at end of file
@@ -0,0 +1,229 @@
+#include "xdgautostartsource.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+
+namespace
+{
+    // Keys of the [Desktop Entry] group; localized keys are left out
+    QHash<QString, QString> readDesktopEntry(const QString &path)
+    {
+        QHash<QString, QString> entry;
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return entry;
+
+        bool inEntry = false;
+        const QStringList lines = QString::fromUtf8(file.readAll()).split('\n');
+        for (const QString &rawLine : lines)
+        {
+            QString line = rawLine.trimmed();
+            if (line.isEmpty() || line.startsWith('#'))
+                continue;
+            if (line.startsWith('['))
+            {
+                inEntry = line == "[Desktop Entry]";
+                continue;
+            }
+
+            int equals = line.indexOf('=');
+            if (!inEntry || equals <= 0)
+                continue;
+            QString key = line.left(equals).trimmed();
+            if (!key.contains('['))
+                entry.insert(key, line.mid(equals + 1).trimmed());
+        }
+        return entry;
+    }
+
+    bool isTrue(const QString &value)
+    {
+        return value.compare("true", Qt::CaseInsensitive) == 0;
+    }
+}
+
+XdgAutostartSource::XdgAutostartSource()
+{
+    QString configHome = QString::fromLocal8Bit(qgetenv("XDG_CONFIG_HOME"));
+    if (configHome.isEmpty())
+        configHome = QDir::homePath() + "/.config";
+    m_userDir = configHome + "/autostart";
+
+    QString configDirs = QString::fromLocal8Bit(qgetenv("XDG_CONFIG_DIRS"));
+    if (configDirs.isEmpty())
+        configDirs = "/etc/xdg";
+    for (const QString &dir : configDirs.split(':', Qt::SkipEmptyParts))
+        m_systemDirs.append(dir + "/autostart");
+}
+
+QString XdgAutostartSource::id() const
+{
+    return "xdg-autostart";
+}
+
+QList<StartupProgram> XdgAutostartSource::scan() const
+{
+    QList<StartupProgram> programs;
+    QSet<QString> seen;
+
+    // The first directory that has a file name wins
+    QStringList dirs = QStringList() << m_userDir << m_systemDirs;
+    for (const QString &dirPath : dirs)
+    {
+        QFileInfoList files = QDir(dirPath).entryInfoList(QStringList() << "*.desktop", QDir::Files);
+        for (const QFileInfo &file : files)
+        {
+            if (seen.contains(file.fileName()))
+                continue;
+            seen.insert(file.fileName());
+
+            QHash<QString, QString> entry = readDesktopEntry(file.absoluteFilePath());
+            if (entry.isEmpty() || entry.value("Type", "Application") != "Application")
+                continue;
+
+            bool isEnabled = !isTrue(entry.value("Hidden")) &&
+                             entry.value("X-GNOME-Autostart-enabled", "true").compare("false", Qt::CaseInsensitive) != 0;
+
+            StartupProgram program;
+            program.name = entry.value("Name", file.completeBaseName());
+            program.status = isEnabled ? "Enabled" : "Disabled";
+            program.startupType = "Autostart";
+            program.command = entry.value("Exec");
+            program.location = file.absoluteFilePath();
+            program.isEnabled = isEnabled;
+            program.source = id();
+            programs.append(program);
+        }
+    }
+
+    return programs;
+}
+
+bool XdgAutostartSource::setEnabled(const StartupProgram &program, bool enable, QString &error) const
+{
+    QFile original(program.location);
+    if (!original.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        error = QString("Could not read %1.").arg(program.location);
+        return false;
+    }
+    QStringList lines = QString::fromUtf8(original.readAll()).split('\n');
+    original.close();
+    while (!lines.isEmpty() && lines.last().isEmpty())
+        lines.removeLast();
+
+    // Rewrite Hidden (and GNOME's own switch) inside the [Desktop Entry] group
+    const QString hidden = enable ? "false" : "true";
+    const QString gnomeEnabled = enable ? "true" : "false";
+    bool inEntry = false;
+    bool wroteHidden = false;
+    int groupEnd = -1;
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        QString line = lines[i].trimmed();
+        if (line.startsWith('['))
+        {
+            if (inEntry && groupEnd < 0)
+                groupEnd = i;
+            inEntry = line == "[Desktop Entry]";
+            continue;
+        }
+        if (!inEntry)
+            continue;
+
+        QString key = line.section('=', 0, 0).trimmed();
+        if (key == "Hidden")
+        {
+            lines[i] = "Hidden=" + hidden;
+            wroteHidden = true;
+        }
+        else if (key == "X-GNOME-Autostart-enabled")
+        {
+            lines[i] = "X-GNOME-Autostart-enabled=" + gnomeEnabled;
+        }
+    }
+    if (!wroteHidden)
+    {
+        if (groupEnd < 0)
+            groupEnd = lines.size();
+        lines.insert(groupEnd, "Hidden=" + hidden);
+    }
+
+    // System files are never touched; the user copy overrides them
+    if (!QDir().mkpath(m_userDir))
+    {
+        error = QString("Could not create %1.").arg(m_userDir);
+        return false;
+    }
+
+    QSaveFile file(m_userDir + "/" + QFileInfo(program.location).fileName());
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        error = QString("Could not write %1.").arg(file.fileName());
+        return false;
+    }
+    file.write((lines.join('\n') + '\n').toUtf8());
+    if (!file.commit())
+    {
+        error = QString("Could not write %1.").arg(file.fileName());
+        return false;
+    }
+    return true;
+}
+
+bool XdgAutostartSource::saveState(const StartupProgram &program, QByteArray &state, QString &error) const
+{
+    // setEnabled() only ever writes the user copy
+    QFile userFile(m_userDir + "/" + QFileInfo(program.location).fileName());
+    if (!userFile.exists())
+    {
+        state = "absent";
+        return true;
+    }
+
+    if (!userFile.open(QIODevice::ReadOnly))
+    {
+        error = QString("Could not read %1.").arg(userFile.fileName());
+        return false;
+    }
+    state = "file\n" + userFile.readAll();
+    return true;
+}
+
+bool XdgAutostartSource::restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const
+{
+    QString userPath = m_userDir + "/" + QFileInfo(program.location).fileName();
+
+    if (state == "absent")
+    {
+        if (QFile::exists(userPath) && !QFile::remove(userPath))
+        {
+            error = QString("Could not remove %1.").arg(userPath);
+            return false;
+        }
+        return true;
+    }
+
+    if (!state.startsWith("file\n"))
+    {
+        error = QString("The saved state of '%1' is not valid.").arg(program.name);
+        return false;
+    }
+
+    QSaveFile file(userPath);
+    if (!QDir().mkpath(m_userDir) || !file.open(QIODevice::WriteOnly))
+    {
+        error = QString("Could not write %1.").arg(userPath);
+        return false;
+    }
+    file.write(state.mid(5));
+    if (!file.commit())
+    {
+        error = QString("Could not write %1.").arg(userPath);
+        return false;
+    }
+    return true;
+}
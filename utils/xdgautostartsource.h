@@ -0,0 +1,28 @@
+#ifndef XDGAUTOSTARTSOURCE_H
+#define XDGAUTOSTARTSOURCE_H
+
+#include "startupsource.h"
+#include <QStringList>
+
+// Desktop entries in the XDG autostart directories: the user's
+// $XDG_CONFIG_HOME/autostart first, then autostart in every $XDG_CONFIG_DIRS
+// entry. A user file hides a system file of the same name, which is also how
+// entries are disabled: a user copy with Hidden=true is written. Saved
+// states are the user copy as it was, or its absence.
+class XdgAutostartSource : public StartupSource
+{
+public:
+    XdgAutostartSource();
+
+    QString id() const override;
+    QList<StartupProgram> scan() const override;
+    bool setEnabled(const StartupProgram &program, bool enable, QString &error) const override;
+    bool saveState(const StartupProgram &program, QByteArray &state, QString &error) const override;
+    bool restoreState(const StartupProgram &program, const QByteArray &state, QString &error) const override;
+
+private:
+    QString m_userDir;
+    QStringList m_systemDirs;
+};
+
+#endif // XDGAUTOSTARTSOURCE_H
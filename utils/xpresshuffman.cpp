@@ -0,0 +1,206 @@
+#include "xpresshuffman.h"
+#include <QVector>
+#include <QtEndian>
+#include <algorithm>
+
+namespace
+{
+    const int SymbolCount = 512;
+    const int TableBytes = SymbolCount / 2;
+    const int MaxCodeLength = 15;
+    const qint64 ChunkSize = 65536;
+
+    // Prefetch files decompress to a few MB; refuse sizes no caller could mean
+    const qint64 MaxOutputSize = 256 * 1024 * 1024;
+
+    // Fills a lookup table indexed by the next 15 input bits with
+    // (symbol << 4) | code length. Codes are canonical, so handing out the
+    // ranges in (length, symbol) order assigns every code its prefix; entries
+    // no code reaches stay 0.
+    bool buildDecodingTable(const uchar *lengths, QVector<quint16> &table)
+    {
+        std::fill(table.begin(), table.end(), quint16(0));
+
+        int next = 0;
+        for (int length = 1; length <= MaxCodeLength; ++length)
+        {
+            for (int symbol = 0; symbol < SymbolCount; ++symbol)
+            {
+                int symbolLength = (symbol & 1) ? lengths[symbol / 2] >> 4 : lengths[symbol / 2] & 0x0F;
+                if (symbolLength != length)
+                    continue;
+
+                int span = 1 << (MaxCodeLength - length);
+                if (next + span > table.size())
+                    return false;
+                std::fill(table.begin() + next, table.begin() + next + span, quint16((symbol << 4) | length));
+                next += span;
+            }
+        }
+        return next > 0;
+    }
+
+    // MSB-first reader over 16-bit little-endian words that always holds at
+    // least 16 bits. Extended match lengths are plain bytes taken from the
+    // stream at its current position, between the words.
+    class BitReader
+    {
+    public:
+        BitReader(const uchar *data, qint64 size, qint64 position)
+            : m_data(data), m_size(size), m_position(position), m_bits(0), m_available(32)
+        {
+            m_bits = quint32(nextWord()) << 16;
+            m_bits |= nextWord();
+        }
+
+        quint32 peek(int count) const
+        {
+            return count > 0 ? m_bits >> (32 - count) : 0;
+        }
+
+        void skip(int count)
+        {
+            m_bits <<= count;
+            m_available -= count;
+            if (m_available < 16)
+            {
+                m_bits |= quint32(nextWord()) << (16 - m_available);
+                m_available += 16;
+            }
+        }
+
+        bool readBytes(int count, quint32 &value)
+        {
+            if (count > m_size - m_position)
+                return false;
+            value = 0;
+            for (int i = 0; i < count; ++i)
+                value |= quint32(m_data[m_position + i]) << (8 * i);
+            m_position += count;
+            return true;
+        }
+
+        qint64 position() const
+        {
+            return m_position;
+        }
+
+    private:
+        // The final words may be cut off; reading zeros there is harmless
+        // because the output size, not the input, ends decoding
+        quint16 nextWord()
+        {
+            if (m_size - m_position < 2)
+                return 0;
+            quint16 word = qFromLittleEndian<quint16>(m_data + m_position);
+            m_position += 2;
+            return word;
+        }
+
+        const uchar *m_data;
+        qint64 m_size;
+        qint64 m_position;
+        quint32 m_bits;
+        int m_available;
+    };
+}
+
+bool XpressHuffman::decompress(const QByteArray &input, qint64 outputSize, QByteArray &output, QString &error)
+{
+    output.clear();
+    if (outputSize < 0 || outputSize > MaxOutputSize)
+    {
+        error = QString("Unsupported decompressed size %1.").arg(outputSize);
+        return false;
+    }
+
+    const uchar *data = reinterpret_cast<const uchar *>(input.constData());
+    const qint64 size = input.size();
+
+    QByteArray result(int(outputSize), Qt::Uninitialized);
+    uchar *out = reinterpret_cast<uchar *>(result.data());
+    qint64 outPos = 0;
+    qint64 inPos = 0;
+    QVector<quint16> table(1 << MaxCodeLength);
+
+    while (outPos < outputSize)
+    {
+        if (TableBytes > size - inPos)
+        {
+            error = "The compressed data ends before its Huffman table.";
+            return false;
+        }
+        if (!buildDecodingTable(data + inPos, table))
+        {
+            error = QString("Invalid Huffman table at offset %1.").arg(inPos);
+            return false;
+        }
+
+        BitReader bits(data, size, inPos + TableBytes);
+        const qint64 chunkEnd = qMin(outPos + ChunkSize, outputSize);
+
+        while (outPos < chunkEnd)
+        {
+            quint16 entry = table[int(bits.peek(MaxCodeLength))];
+            if (entry == 0)
+            {
+                error = QString("Invalid Huffman code near offset %1.").arg(bits.position());
+                return false;
+            }
+            bits.skip(entry & 0x0F);
+
+            int symbol = entry >> 4;
+            if (symbol < 256)
+            {
+                out[outPos++] = uchar(symbol);
+                continue;
+            }
+
+            symbol -= 256;
+            int offsetBits = symbol >> 4;
+            quint32 length = symbol & 0x0F;
+            if (length == 15)
+            {
+                if (!bits.readBytes(1, length))
+                {
+                    error = "The compressed data ends inside a match length.";
+                    return false;
+                }
+                if (length == 255)
+                {
+                    if (!bits.readBytes(2, length) || (length == 0 && !bits.readBytes(4, length)))
+                    {
+                        error = "The compressed data ends inside a match length.";
+                        return false;
+                    }
+                    if (length < 15)
+                    {
+                        error = QString("Invalid match length near offset %1.").arg(bits.position());
+                        return false;
+                    }
+                    length -= 15;
+                }
+                length += 15;
+            }
+
+            qint64 matchLength = qint64(length) + 3;
+            qint64 offset = (qint64(1) << offsetBits) | bits.peek(offsetBits);
+            bits.skip(offsetBits);
+
+            if (offset > outPos || matchLength > outputSize - outPos)
+            {
+                error = QString("A match near offset %1 reaches outside the output.").arg(bits.position());
+                return false;
+            }
+
+            // Byte by byte: a match may overlap the bytes it produces
+            for (qint64 i = 0; i < matchLength; ++i, ++outPos)
+                out[outPos] = out[outPos - offset];
+        }
+
+        inPos = bits.position();
+    }
+
+    output = result;
+    return true;
+}
@@ -0,0 +1,21 @@
+#ifndef XPRESSHUFFMAN_H
+#define XPRESSHUFFMAN_H
+
+#include <QString>
+#include <QByteArray>
+
+// Decoder for the LZ77+Huffman variant of Microsoft's XPRESS compression
+// ([MS-XCA] 2.1/2.2), which Windows 8 and later use for Prefetch files and
+// which RtlDecompressBufferEx calls COMPRESSION_FORMAT_XPRESS_HUFF. Every
+// 64 KB of output starts with a table of 512 4-bit code lengths; symbols
+// below 256 are literals, the others encode a match length and the bit
+// count of its offset. All reads and back-references are bounds-checked,
+// so damaged input fails instead of reading or writing past a buffer.
+class XpressHuffman
+{
+public:
+    // The format does not record its own size; the caller must know it
+    static bool decompress(const QByteArray &input, qint64 outputSize, QByteArray &output, QString &error);
+};
+
+#endif // XPRESSHUFFMAN_H